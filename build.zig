@@ -572,16 +572,19 @@ fn addCSources(module: *std.Build.Module, use_openvpn: bool, use_wireguard: bool
         "src/c/portable/tun_darwin.c",
         "src/c/portable/tun_linux.c",
         "src/c/portable/tun_windows.c",
+        "src/c/portable/uring.c",
         "src/c/portable/zd.c",
     });
 
     if (use_openvpn) {
         addCSourceFiles(module, &.{
             "src/openvpn/c/control.c",
+            "src/openvpn/c/decompress.c",
             "src/openvpn/c/dp_framing.c",
             "src/openvpn/c/dp_mode.c",
             "src/openvpn/c/dp_mode_ad.c",
             "src/openvpn/c/dp_mode_hmac.c",
+            "src/openvpn/c/dp_stage.c",
             "src/openvpn/c/mss_fix.c",
             "src/openvpn/c/pkt_proc.c",
             "src/openvpn/c/test/openvpn_crypto_mock.c",
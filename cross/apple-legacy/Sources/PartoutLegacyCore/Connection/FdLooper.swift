@@ -156,7 +156,7 @@ public final class FdLooper: @unchecked Sendable {
 
                 // Perform the blocking call
                 var code: Int32 = 0
-                guard pp_mux_wait(mux, &code) >= 0 else {
+                guard pp_mux_wait(mux, -1, &code) >= 0 else {
                     pp_log(ctx, .core, .fault, "Looper: pp_mux_wait() failed (code=\(code))")
                     lastError = WaitError(code: code)
                     break
@@ -2,6 +2,12 @@
 //
 // SPDX-License-Identifier: GPL-3.0
 
+// Levels are filtered by pp_log_g
+@c(partout_log_enabled)
+public func partout_log_enabled(cLevel: Int) -> Bool {
+    true
+}
+
 @c(partout_log)
 public func partout_log(cLevel: Int, cMessage: UnsafePointer<CChar>?) {
     guard let cMessage else { return }
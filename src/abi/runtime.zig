@@ -15,6 +15,7 @@ const wireguard = @import("../wireguard/exports.zig");
 const api = core.api;
 const c = helpers.c;
 const c_common = c_mod.common;
+const profile_cache = core.profile_cache;
 const util = core.util;
 
 pub const RuntimeError = net.DaemonError || error{
@@ -43,12 +44,11 @@ pub const DaemonOptions = struct {
         // import call is required to obtain a profile from a serialized
         // module
         const profile_json = util.borrowedCString(c_profile);
-        var profile = api.Profile.parseWithErrorInfo(allocator, profile_json, error_info) catch |err| {
-            return switch (err) {
-                error.OutOfMemory => error.OutOfMemory,
-                else => error.InvalidProfile,
-            };
-        };
+        const explicit_cache_root = if (args.options.cache_dir) |value|
+            util.borrowedCString(value)
+        else
+            null;
+        var profile = try loadProfile(allocator, profile_json, explicit_cache_root, error_info);
         errdefer profile.deinit(allocator);
 
         // Leave early if the active connection module has no runtime
@@ -89,6 +89,46 @@ pub const DaemonOptions = struct {
         self.profile.deinit(allocator);
     }
 
+    /// Parses the profile JSON, going through the binary profile cache
+    /// when a cache directory is given.
+    fn loadProfile(
+        allocator: std.mem.Allocator,
+        profile_json: []const u8,
+        cache_root: ?[]const u8,
+        error_info: ?*api.JsonErrorInfo,
+    ) RuntimeError!api.Profile {
+        const root = cache_root orelse return parseProfile(allocator, profile_json, error_info);
+        const key = profile_cache.contentKey(profile_json);
+        const start_ns = core.concurrency.monotonicNs();
+        if (try profile_cache.load(allocator, root, key)) |profile| {
+            core.logging.writef(.debug, "Loaded cached profile in {d}us", .{
+                (core.concurrency.monotonicNs() - start_ns) / std.time.ns_per_us,
+            });
+            return profile;
+        }
+
+        var profile = try parseProfile(allocator, profile_json, error_info);
+        errdefer profile.deinit(allocator);
+        core.logging.writef(.debug, "Parsed profile JSON in {d}us", .{
+            (core.concurrency.monotonicNs() - start_ns) / std.time.ns_per_us,
+        });
+        profile_cache.store(allocator, root, key, &profile);
+        return profile;
+    }
+
+    fn parseProfile(
+        allocator: std.mem.Allocator,
+        profile_json: []const u8,
+        error_info: ?*api.JsonErrorInfo,
+    ) RuntimeError!api.Profile {
+        return api.Profile.parseWithErrorInfo(allocator, profile_json, error_info) catch |err| {
+            return switch (err) {
+                error.OutOfMemory => error.OutOfMemory,
+                else => error.InvalidProfile,
+            };
+        };
+    }
+
     fn validateSupportedImplementations(profile: *const api.Profile) RuntimeError!void {
         const module = api.findActiveConnectionModule(profile) orelse return;
         switch (api.moduleType(module)) {
@@ -197,4 +237,12 @@ pub const DaemonRuntime = struct {
     pub fn stop(self: *const DaemonRuntime) void {
         self.daemon.stop();
     }
+
+    /// The caller owns the returned JSON.
+    pub fn metricsJsonAlloc(
+        self: *const DaemonRuntime,
+        allocator: std.mem.Allocator,
+    ) error{OutOfMemory}![:0]u8 {
+        return util.encodeJsonValueZ(allocator, self.daemon.metricsSnapshot());
+    }
 };
@@ -300,15 +300,25 @@ typedef struct {
     size_t capacity;
 } pp_tls_buffer;
 
-struct __pp_tls_struct {
-    const pp_tls_options *_Nonnull opt;
-
+struct __pp_tls_ctx_struct {
     mbedtls_ssl_config conf;
-    mbedtls_ssl_context ssl;
     mbedtls_x509_crt ca;
     mbedtls_x509_crt cert;
     mbedtls_pk_context key;
     mbedtls_x509_crt_profile profile;
+};
+
+struct __pp_tls_session_struct {
+    size_t length;
+    uint8_t bytes[];
+};
+
+struct __pp_tls_struct {
+    const pp_tls_options *_Nonnull opt;
+    pp_tls_ctx _Nonnull ctx;
+    pp_tls_session _Nullable session;
+
+    mbedtls_ssl_context ssl;
 
     size_t buf_len;
     uint8_t *_Nonnull buf_cipher;
@@ -318,8 +328,12 @@ struct __pp_tls_struct {
     pp_tls_buffer plain_out;
 
     bool did_setup;
+    bool did_verify;
     bool did_fail_verify;
+    bool did_offer_session;
     bool is_connected;
+    // connected and every peer check passed, only then is the session exported
+    bool is_trusted;
 };
 
 static
@@ -483,31 +497,31 @@ bool pp_tls_pump_plain(pp_tls tls, pp_tls_error_code *_Nullable error) {
 }
 
 static
-void pp_tls_configure_profile(pp_tls tls) {
-    if (tls->opt->sec_level <= 0) {
-        tls->profile.allowed_mds = UINT32_MAX;
-        tls->profile.allowed_pks = UINT32_MAX;
-        tls->profile.allowed_curves = UINT32_MAX;
-        tls->profile.rsa_min_bitlen = 0;
-    } else if (tls->opt->sec_level == 1) {
-        tls->profile.allowed_mds = UINT32_MAX & ~MBEDTLS_X509_ID_FLAG(MBEDTLS_MD_MD5);
-        tls->profile.allowed_pks = UINT32_MAX;
-        tls->profile.allowed_curves = UINT32_MAX;
-        tls->profile.rsa_min_bitlen = 1024;
+void pp_tls_configure_profile(pp_tls_ctx ctx, int sec_level) {
+    if (sec_level <= 0) {
+        ctx->profile.allowed_mds = UINT32_MAX;
+        ctx->profile.allowed_pks = UINT32_MAX;
+        ctx->profile.allowed_curves = UINT32_MAX;
+        ctx->profile.rsa_min_bitlen = 0;
+    } else if (sec_level == 1) {
+        ctx->profile.allowed_mds = UINT32_MAX & ~MBEDTLS_X509_ID_FLAG(MBEDTLS_MD_MD5);
+        ctx->profile.allowed_pks = UINT32_MAX;
+        ctx->profile.allowed_curves = UINT32_MAX;
+        ctx->profile.rsa_min_bitlen = 1024;
     } else {
-        tls->profile = mbedtls_x509_crt_profile_default;
-        switch (tls->opt->sec_level) {
+        ctx->profile = mbedtls_x509_crt_profile_default;
+        switch (sec_level) {
         case 2:
-            tls->profile.rsa_min_bitlen = 2048;
+            ctx->profile.rsa_min_bitlen = 2048;
             break;
         case 3:
-            tls->profile.rsa_min_bitlen = 3072;
+            ctx->profile.rsa_min_bitlen = 3072;
             break;
         case 4:
-            tls->profile.rsa_min_bitlen = 7680;
+            ctx->profile.rsa_min_bitlen = 7680;
             break;
         default:
-            tls->profile.rsa_min_bitlen = 15360;
+            ctx->profile.rsa_min_bitlen = 15360;
             break;
         }
     }
@@ -518,8 +532,10 @@ int pp_tls_verify_peer(void *ctx, mbedtls_x509_crt *crt, int depth, uint32_t *fl
     (void)crt;
     (void)depth;
 
+    pp_tls tls = ctx;
+    // only a full handshake verifies the peer chain
+    tls->did_verify = true;
     if (flags && *flags) {
-        pp_tls tls = ctx;
         tls->did_fail_verify = true;
         pp_clog_v(PPLogLevelError,
                   "pp_tls_verify_peer: flags 0x%08x", (unsigned int)*flags);
@@ -576,60 +592,39 @@ bool pp_tls_verify_mbed_san_host(const mbedtls_ssl_context *ssl, const char *hos
 }
 
 static
-void pp_tls_free_internal(pp_tls tls, bool free_options) {
-    if (!tls) return;
-
-    mbedtls_ssl_free(&tls->ssl);
-    mbedtls_ssl_config_free(&tls->conf);
-    mbedtls_x509_crt_free(&tls->ca);
-    mbedtls_x509_crt_free(&tls->cert);
-    mbedtls_pk_free(&tls->key);
-
-    if (tls->buf_cipher) {
-        pp_zero(tls->buf_cipher, tls->buf_len);
-        pp_free(tls->buf_cipher);
-    }
-    if (tls->buf_plain) {
-        pp_zero(tls->buf_plain, tls->buf_len);
-        pp_free(tls->buf_plain);
-    }
-    pp_tls_buffer_free(&tls->cipher_in);
-    pp_tls_buffer_free(&tls->cipher_out);
-    pp_tls_buffer_free(&tls->plain_out);
-
-    if (free_options) {
-        pp_tls_options_free((pp_tls_options *)tls->opt);
-    }
-    pp_free(tls);
+void pp_tls_ctx_free_internal(pp_tls_ctx ctx) {
+    if (!ctx) return;
+
+    mbedtls_ssl_config_free(&ctx->conf);
+    mbedtls_x509_crt_free(&ctx->ca);
+    mbedtls_x509_crt_free(&ctx->cert);
+    mbedtls_pk_free(&ctx->key);
+    pp_free(ctx);
 }
 
-pp_tls pp_mbedtls_create(const pp_tls_options *opt, pp_tls_error_code *error) {
+pp_tls_ctx pp_mbedtls_ctx_create(const pp_tls_options *opt, pp_tls_error_code *error) {
     pp_tls_set_error(error, PPTLSErrorNone);
     if (!pp_tls_init_psa()) {
         pp_tls_set_error(error, PPTLSErrorHandshake);
         return NULL;
     }
 
-    pp_tls tls = pp_alloc(sizeof(*tls));
-    tls->opt = opt;
-    tls->buf_len = opt->buf_len;
-    tls->buf_cipher = pp_alloc(tls->buf_len);
-    tls->buf_plain = pp_alloc(tls->buf_len);
+    pp_tls_ctx ctx = pp_alloc(sizeof(*ctx));
+    mbedtls_ssl_config_init(&ctx->conf);
+    mbedtls_x509_crt_init(&ctx->ca);
+    mbedtls_x509_crt_init(&ctx->cert);
+    mbedtls_pk_init(&ctx->key);
 
-    mbedtls_ssl_config_init(&tls->conf);
-    mbedtls_ssl_init(&tls->ssl);
-    mbedtls_x509_crt_init(&tls->ca);
-    mbedtls_x509_crt_init(&tls->cert);
-    mbedtls_pk_init(&tls->key);
-
-    int ret = mbedtls_x509_crt_parse_file(&tls->ca, opt->ca_path);
+    int ret = mbedtls_x509_crt_parse(&ctx->ca,
+                                     (const unsigned char *)opt->ca_pem,
+                                     strlen(opt->ca_pem) + 1);
     if (ret != 0) {
-        pp_tls_log_mbed_error("mbedtls_x509_crt_parse_file", ret);
+        pp_tls_log_mbed_error("mbedtls_x509_crt_parse", ret);
         pp_tls_set_error(error, PPTLSErrorCAUse);
         goto failure;
     }
 
-    ret = mbedtls_ssl_config_defaults(&tls->conf,
+    ret = mbedtls_ssl_config_defaults(&ctx->conf,
                                       MBEDTLS_SSL_IS_CLIENT,
                                       MBEDTLS_SSL_TRANSPORT_STREAM,
                                       MBEDTLS_SSL_PRESET_DEFAULT);
@@ -639,17 +634,17 @@ pp_tls pp_mbedtls_create(const pp_tls_options *opt, pp_tls_error_code *error) {
         goto failure;
     }
 
-    pp_tls_configure_profile(tls);
-    mbedtls_ssl_conf_cert_profile(&tls->conf, &tls->profile);
-    mbedtls_ssl_conf_ca_chain(&tls->conf, &tls->ca, NULL);
-    mbedtls_ssl_conf_authmode(&tls->conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
+    pp_tls_configure_profile(ctx, opt->sec_level);
+    mbedtls_ssl_conf_cert_profile(&ctx->conf, &ctx->profile);
+    mbedtls_ssl_conf_ca_chain(&ctx->conf, &ctx->ca, NULL);
+    mbedtls_ssl_conf_authmode(&ctx->conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
 #if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
-    mbedtls_ssl_conf_session_tickets(&tls->conf,
-                                     MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+    mbedtls_ssl_conf_session_tickets(&ctx->conf,
+                                     MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
 #endif
 
     if (opt->cert_pem) {
-        ret = mbedtls_x509_crt_parse(&tls->cert,
+        ret = mbedtls_x509_crt_parse(&ctx->cert,
                                      (const unsigned char *)opt->cert_pem,
                                      strlen(opt->cert_pem) + 1);
         if (ret != 0) {
@@ -659,7 +654,7 @@ pp_tls pp_mbedtls_create(const pp_tls_options *opt, pp_tls_error_code *error) {
         }
 
         if (opt->key_pem) {
-            ret = pp_key_parse(&tls->key,
+            ret = pp_key_parse(&ctx->key,
                                (const unsigned char *)opt->key_pem,
                                strlen(opt->key_pem) + 1,
                                NULL,
@@ -669,7 +664,7 @@ pp_tls pp_mbedtls_create(const pp_tls_options *opt, pp_tls_error_code *error) {
                 pp_tls_set_error(error, PPTLSErrorClientKeyRead);
                 goto failure;
             }
-            ret = mbedtls_ssl_conf_own_cert(&tls->conf, &tls->cert, &tls->key);
+            ret = mbedtls_ssl_conf_own_cert(&ctx->conf, &ctx->cert, &ctx->key);
             if (ret != 0) {
                 pp_tls_log_mbed_error("mbedtls_ssl_conf_own_cert", ret);
                 pp_tls_set_error(error, PPTLSErrorClientKeyUse);
@@ -678,19 +673,72 @@ pp_tls pp_mbedtls_create(const pp_tls_options *opt, pp_tls_error_code *error) {
         }
     }
 
-    return tls;
+    return ctx;
 
 failure:
-    pp_tls_free_internal(tls, false);
+    pp_tls_ctx_free_internal(ctx);
     return NULL;
 }
 
+void pp_mbedtls_ctx_free(pp_tls_ctx ctx) {
+    pp_tls_ctx_free_internal(ctx);
+}
+
+pp_tls pp_mbedtls_create(const pp_tls_options *opt, pp_tls_ctx ctx, pp_tls_error_code *error) {
+    pp_tls_set_error(error, PPTLSErrorNone);
+
+    pp_tls tls = pp_alloc(sizeof(*tls));
+    tls->opt = opt;
+    tls->ctx = ctx;
+    tls->buf_len = opt->buf_len;
+    tls->buf_cipher = pp_alloc(tls->buf_len);
+    tls->buf_plain = pp_alloc(tls->buf_len);
+    mbedtls_ssl_init(&tls->ssl);
+    return tls;
+}
+
 void pp_mbedtls_free(pp_tls tls) {
-    pp_tls_free_internal(tls, true);
+    if (!tls) return;
+
+    mbedtls_ssl_free(&tls->ssl);
+
+    pp_zero(tls->buf_cipher, tls->buf_len);
+    pp_free(tls->buf_cipher);
+    pp_zero(tls->buf_plain, tls->buf_len);
+    pp_free(tls->buf_plain);
+    pp_tls_buffer_free(&tls->cipher_in);
+    pp_tls_buffer_free(&tls->cipher_out);
+    pp_tls_buffer_free(&tls->plain_out);
+
+    if (tls->session) pp_mbedtls_session_free(tls->session);
+    pp_tls_options_free((pp_tls_options *)tls->opt);
+    pp_free(tls);
+}
+
+static
+bool pp_tls_offer_session(pp_tls tls, const struct __pp_tls_session_struct *src) {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    int ret = mbedtls_ssl_session_load(&session, src->bytes, src->length);
+    if (ret == 0) {
+        ret = mbedtls_ssl_set_session(&tls->ssl, &session);
+    }
+    mbedtls_ssl_session_free(&session);
+    if (ret != 0) {
+        pp_tls_log_mbed_error("mbedtls_ssl_set_session", ret);
+        return false;
+    }
+    return true;
 }
 
 bool pp_mbedtls_start(pp_tls tls) {
     if (tls->did_setup) {
+        // resume the previous handshake, if any
+        pp_tls_session previous = pp_mbedtls_get_session(tls);
+        if (previous) {
+            if (tls->session) pp_mbedtls_session_free(tls->session);
+            tls->session = previous;
+        }
         mbedtls_ssl_free(&tls->ssl);
         mbedtls_ssl_init(&tls->ssl);
         tls->did_setup = false;
@@ -701,15 +749,21 @@ bool pp_mbedtls_start(pp_tls tls) {
     pp_tls_buffer_clear(&tls->cipher_in);
     pp_tls_buffer_clear(&tls->cipher_out);
     pp_tls_buffer_clear(&tls->plain_out);
+    tls->did_verify = false;
     tls->did_fail_verify = false;
+    tls->did_offer_session = false;
     tls->is_connected = false;
+    tls->is_trusted = false;
 
-    int ret = mbedtls_ssl_setup(&tls->ssl, &tls->conf);
+    int ret = mbedtls_ssl_setup(&tls->ssl, &tls->ctx->conf);
     if (ret != 0) {
         pp_tls_log_mbed_error("mbedtls_ssl_setup", ret);
         return false;
     }
     tls->did_setup = true;
+    if (tls->session) {
+        tls->did_offer_session = pp_tls_offer_session(tls, tls->session);
+    }
     mbedtls_ssl_set_bio(&tls->ssl, tls, pp_tls_send, pp_tls_recv, NULL);
     mbedtls_ssl_set_verify(&tls->ssl, pp_tls_verify_peer, tls);
 
@@ -758,6 +812,7 @@ pp_zd *pp_mbedtls_pull_cipher(pp_tls tls, pp_tls_error_code *error) {
                 return NULL;
             }
         }
+        tls->is_trusted = !tls->did_fail_verify;
     }
 
     pp_tls_error_code plain_error = PPTLSErrorNone;
@@ -841,6 +896,59 @@ bool pp_mbedtls_put_plain(pp_tls tls,
     return true;
 }
 
+// MARK: - Resumption
+
+pp_tls_session pp_mbedtls_get_session(pp_tls tls) {
+    // never resume a peer that failed verification, EKU or SAN checks
+    if (!tls->did_setup || !tls->is_trusted || !mbedtls_ssl_is_handshake_over(&tls->ssl)) {
+        return NULL;
+    }
+
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    pp_tls_session dst = NULL;
+    int ret = mbedtls_ssl_get_session(&tls->ssl, &session);
+    if (ret != 0) {
+        goto failure;
+    }
+
+    // serialized, so that one session can be offered to many contexts
+    size_t length = 0;
+    ret = mbedtls_ssl_session_save(&session, NULL, 0, &length);
+    if (ret != MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL || !length) {
+        goto failure;
+    }
+    dst = pp_alloc(sizeof(*dst) + length);
+    ret = mbedtls_ssl_session_save(&session, dst->bytes, length, &dst->length);
+    if (ret != 0) {
+        pp_mbedtls_session_free(dst);
+        dst = NULL;
+    }
+
+failure:
+    mbedtls_ssl_session_free(&session);
+    return dst;
+}
+
+void pp_mbedtls_set_session(pp_tls tls, pp_tls_session session) {
+    pp_tls_session copy = pp_alloc(sizeof(*copy) + session->length);
+    copy->length = session->length;
+    memcpy(copy->bytes, session->bytes, session->length);
+    if (tls->session) pp_mbedtls_session_free(tls->session);
+    tls->session = copy;
+}
+
+void pp_mbedtls_session_free(pp_tls_session session) {
+    pp_zero(session->bytes, session->length);
+    pp_free(session);
+}
+
+bool pp_mbedtls_is_resumed(pp_tls tls) {
+    return tls->did_offer_session &&
+           mbedtls_ssl_is_handshake_over(&tls->ssl) &&
+           !tls->did_verify;
+}
+
 // MARK: - MD5
 
 char *pp_mbedtls_ca_md5(const pp_tls tls) {
@@ -848,37 +956,27 @@ char *pp_mbedtls_ca_md5(const pp_tls tls) {
         return NULL;
     }
 
-    mbedtls_x509_crt cert;
-    mbedtls_x509_crt_init(&cert);
-
+    // the first certificate of the already parsed chain
+    const mbedtls_x509_crt *cert = &tls->ctx->ca;
     uint8_t md[16];
     size_t len = 0;
-    char *hex = NULL;
 
-    int ret = mbedtls_x509_crt_parse_file(&cert, tls->opt->ca_path);
-    if (ret != 0) {
-        pp_tls_log_mbed_error("mbedtls_x509_crt_parse_file", ret);
-        goto failure;
-    }
     if (psa_hash_compute(PSA_ALG_MD5,
-                         cert.raw.p,
-                         cert.raw.len,
+                         cert->raw.p,
+                         cert->raw.len,
                          md,
                          sizeof(md),
                          &len) != PSA_SUCCESS) {
-        goto failure;
+        return NULL;
     }
     pp_assert(len == sizeof(md));
 
-    hex = pp_alloc(2 * sizeof(md) + 1);
+    char *hex = pp_alloc(2 * sizeof(md) + 1);
     char *ptr = hex;
     for (size_t i = 0; i < sizeof(md); ++i) {
         ptr += snprintf(ptr, 3, "%02x", md[i]);
     }
     *ptr = '\0';
-
-failure:
-    mbedtls_x509_crt_free(&cert);
     return hex;
 }
 /*
@@ -909,6 +1007,8 @@ pp_crypto_fnt pp_crypto_fnt_mbedtls(void) {
         .key_decrypted_from_pem = pp_mbed_key_decrypted_from_pem,
 
         .tls = {
+            .ctx_create = pp_mbedtls_ctx_create,
+            .ctx_free = pp_mbedtls_ctx_free,
             .create = pp_mbedtls_create,
             .free = pp_mbedtls_free,
             .start = pp_mbedtls_start,
@@ -917,7 +1017,11 @@ pp_crypto_fnt pp_crypto_fnt_mbedtls(void) {
             .pull_plain = pp_mbedtls_pull_plain,
             .put_cipher = pp_mbedtls_put_cipher,
             .put_plain = pp_mbedtls_put_plain,
-            .ca_md5 = pp_mbedtls_ca_md5
+            .ca_md5 = pp_mbedtls_ca_md5,
+            .get_session = pp_mbedtls_get_session,
+            .set_session = pp_mbedtls_set_session,
+            .session_free = pp_mbedtls_session_free,
+            .is_resumed = pp_mbedtls_is_resumed
         }
     };
     return table;
@@ -30,7 +30,11 @@ char *_Nullable pp_mbed_key_decrypted_from_path(const char *path,
 char *_Nullable pp_mbed_key_decrypted_from_pem(const char *pem,
                                                const char *passphrase);
 
+pp_tls_ctx _Nullable pp_mbedtls_ctx_create(const pp_tls_options *opt,
+                                            pp_tls_error_code *error);
+void pp_mbedtls_ctx_free(pp_tls_ctx ctx);
 pp_tls _Nullable pp_mbedtls_create(const pp_tls_options *opt,
+                                    pp_tls_ctx ctx,
                                     pp_tls_error_code *error);
 void pp_mbedtls_free(pp_tls tls);
 bool pp_mbedtls_start(pp_tls tls);
@@ -48,5 +52,9 @@ bool pp_mbedtls_put_plain(pp_tls tls,
                            size_t src_len,
                            pp_tls_error_code *_Nullable error);
 char *_Nullable pp_mbedtls_ca_md5(const pp_tls tls);
+pp_tls_session _Nullable pp_mbedtls_get_session(pp_tls tls);
+void pp_mbedtls_set_session(pp_tls tls, pp_tls_session session);
+void pp_mbedtls_session_free(pp_tls_session session);
+bool pp_mbedtls_is_resumed(pp_tls tls);
 
 #pragma clang assume_nonnull end
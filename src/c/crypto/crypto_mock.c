@@ -109,9 +109,17 @@ static pp_crypto_ctx pp_mock_crypto_ctr_create(const char *cipher_name,
     return pp_mock_crypto_create(tag_len);
 }
 
+// Not a digest, only deterministic, so that the PRF derives keys
 static size_t pp_mock_hmac_do(pp_hmac_ctx *ctx) {
-    (void)ctx;
-    return 0;
+    const size_t len = 16;
+    if (ctx->dst_len < len) return 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t byte = (uint8_t)i;
+        if (ctx->secret_len) byte ^= ctx->secret[i % ctx->secret_len];
+        if (ctx->data_len) byte ^= ctx->data[i % ctx->data_len];
+        ctx->dst[i] = byte;
+    }
+    return len;
 }
 
 static char *_Nullable pp_mock_key_decrypted_from_path(const char *path,
@@ -128,9 +136,22 @@ static char *_Nullable pp_mock_key_decrypted_from_pem(const char *pem,
     return NULL;
 }
 
+static pp_tls_ctx _Nullable pp_mock_tls_ctx_create(const pp_tls_options *opt,
+                                                   pp_tls_error_code *error) {
+    (void)opt;
+    if (error) *error = PPTLSErrorNone;
+    return NULL;
+}
+
+static void pp_mock_tls_ctx_free(pp_tls_ctx ctx) {
+    (void)ctx;
+}
+
 static pp_tls _Nullable pp_mock_tls_create(const pp_tls_options *opt,
+                                           pp_tls_ctx ctx,
                                            pp_tls_error_code *error) {
     (void)opt;
+    (void)ctx;
     if (error) *error = PPTLSErrorNone;
     return NULL;
 }
@@ -208,6 +229,8 @@ pp_crypto_fnt pp_crypto_fnt_mock(void) {
         .key_decrypted_from_path = pp_mock_key_decrypted_from_path,
         .key_decrypted_from_pem = pp_mock_key_decrypted_from_pem,
         .tls = {
+            .ctx_create = pp_mock_tls_ctx_create,
+            .ctx_free = pp_mock_tls_ctx_free,
             .create = pp_mock_tls_create,
             .free = pp_mock_tls_free,
             .start = pp_mock_tls_start,
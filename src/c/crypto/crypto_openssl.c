@@ -825,6 +825,7 @@ char *pp_openssl_key_decrypted_from_pem(const char *pem, const char *passphrase)
  */
 
 #include <openssl/bio.h>
+#include <openssl/pem.h>
 #include <openssl/ssl.h>
 #include <openssl/x509v3.h>
 #include <openssl/err.h>
@@ -850,6 +851,11 @@ struct __pp_tls_struct {
     BIO *_Nonnull bio_cipher_in;
     BIO *_Nonnull bio_cipher_out;
     bool is_connected;
+    // connected and every peer check passed, only then is the session exported
+    bool is_trusted;
+
+    // offered on the next start
+    SSL_SESSION *_Nullable session;
 };
 
 static
@@ -877,9 +883,46 @@ int pp_tls_verify_peer(int ok, X509_STORE_CTX *_Nonnull ctx) {
     return ok;
 }
 
+static
+bool pp_tls_load_ca_pem(SSL_CTX *_Nonnull ssl_ctx, const char *_Nonnull pem) {
+    BIO *bio = create_BIO_from_PEM(pem);
+    if (!bio) {
+        return false;
+    }
+    STACK_OF(X509_INFO) *infos = PEM_X509_INFO_read_bio(bio, NULL, NULL, NULL);
+    BIO_free(bio);
+    if (!infos) {
+        return false;
+    }
+    X509_STORE *store = SSL_CTX_get_cert_store(ssl_ctx);
+    int count = 0;
+    for (int i = 0; i < sk_X509_INFO_num(infos); ++i) {
+        X509_INFO *info = sk_X509_INFO_value(infos, i);
+        if (info->x509 && X509_STORE_add_cert(store, info->x509)) {
+            ++count;
+        }
+        if (info->crl) {
+            X509_STORE_add_crl(store, info->crl);
+        }
+    }
+    sk_X509_INFO_pop_free(infos, X509_INFO_free);
+    return count > 0;
+}
+
+// the control channel never sends close_notify, and OpenSSL would otherwise
+// invalidate the session of an SSL freed without a shutdown
+static
+void pp_tls_mark_shutdown(SSL *_Nonnull ssl) {
+    SSL_set_shutdown(ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+}
+
 // MARK: -
 
-pp_tls pp_openssl_tls_create(const pp_tls_options *opt, pp_tls_error_code *error) {
+struct __pp_tls_ctx_struct {
+    SSL_CTX *_Nonnull ssl_ctx;
+};
+
+pp_tls_ctx pp_openssl_tls_ctx_create(const pp_tls_options *opt, pp_tls_error_code *error) {
     SSL_CTX *ssl_ctx = SSL_CTX_new(TLS_client_method());
     X509 *cert = NULL;
     BIO *cert_bio = NULL;
@@ -890,11 +933,9 @@ pp_tls pp_openssl_tls_create(const pp_tls_options *opt, pp_tls_error_code *error
     SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_PEER, pp_tls_verify_peer);
     SSL_CTX_set_security_level(ssl_ctx, opt->sec_level);
 
-    if (opt->ca_path) {
-        if (!SSL_CTX_load_verify_locations(ssl_ctx, opt->ca_path, NULL)) {
-            PP_CRYPTO_SET_ERROR(PPTLSErrorCAUse)
-            goto failure;
-        }
+    if (!pp_tls_load_ca_pem(ssl_ctx, opt->ca_pem)) {
+        PP_CRYPTO_SET_ERROR(PPTLSErrorCAUse)
+        goto failure;
     }
     if (opt->cert_pem) {
         cert_bio = create_BIO_from_PEM(opt->cert_pem);
@@ -938,13 +979,9 @@ pp_tls pp_openssl_tls_create(const pp_tls_options *opt, pp_tls_error_code *error
 
     // no longer fails
 
-    pp_tls tls = pp_alloc(sizeof(*tls));
-    tls->opt = opt;
-    tls->ssl_ctx = ssl_ctx;
-    tls->buf_len = tls->opt->buf_len;
-    tls->buf_cipher = pp_alloc(tls->buf_len);
-    tls->buf_plain = pp_alloc(tls->buf_len);
-    return tls;
+    pp_tls_ctx ctx = pp_alloc(sizeof(*ctx));
+    ctx->ssl_ctx = ssl_ctx;
+    return ctx;
 
 failure:
     ERR_print_errors_fp(stdout);
@@ -956,6 +993,27 @@ failure:
     return NULL;
 }
 
+void pp_openssl_tls_ctx_free(pp_tls_ctx ctx) {
+    if (!ctx) return;
+    SSL_CTX_free(ctx->ssl_ctx);
+    pp_free(ctx);
+}
+
+pp_tls pp_openssl_tls_create(const pp_tls_options *opt, pp_tls_ctx ctx, pp_tls_error_code *error) {
+    PP_CRYPTO_SET_ERROR(PPTLSErrorNone)
+
+    // SSL objects created later retain the SSL_CTX on their own
+    SSL_CTX_up_ref(ctx->ssl_ctx);
+
+    pp_tls tls = pp_alloc(sizeof(*tls));
+    tls->opt = opt;
+    tls->ssl_ctx = ctx->ssl_ctx;
+    tls->buf_len = tls->opt->buf_len;
+    tls->buf_cipher = pp_alloc(tls->buf_len);
+    tls->buf_plain = pp_alloc(tls->buf_len);
+    return tls;
+}
+
 void pp_openssl_tls_free(pp_tls tls) {
     if (!tls) return;
 
@@ -970,6 +1028,7 @@ void pp_openssl_tls_free(pp_tls tls) {
         BIO_free_all(tls->bio_plain);
     }
     if (tls->ssl) {
+        pp_tls_mark_shutdown(tls->ssl);
         SSL_free(tls->ssl);
     }
 
@@ -977,11 +1036,23 @@ void pp_openssl_tls_free(pp_tls tls) {
     pp_zero(tls->buf_plain, tls->opt->buf_len);
     pp_free(tls->buf_cipher);
     pp_free(tls->buf_plain);
+    if (tls->session) {
+        SSL_SESSION_free(tls->session);
+    }
     pp_tls_options_free((pp_tls_options *)tls->opt);
     SSL_CTX_free(tls->ssl_ctx);
+    pp_free(tls);
 }
 
 bool pp_openssl_tls_start(pp_tls tls) {
+    if (tls->ssl) {
+        // resume the previous handshake, if any
+        pp_tls_session previous = pp_openssl_tls_get_session(tls);
+        if (previous) {
+            pp_openssl_tls_set_session(tls, previous);
+            pp_openssl_tls_session_free(previous);
+        }
+    }
     if (tls->bio_plain) {
         BIO_free_all(tls->bio_plain);
         tls->bio_plain = NULL;
@@ -989,12 +1060,14 @@ bool pp_openssl_tls_start(pp_tls tls) {
         tls->bio_cipher_out = NULL;
     }
     if (tls->ssl) {
+        pp_tls_mark_shutdown(tls->ssl);
         SSL_free(tls->ssl);
         tls->ssl = NULL;
     }
     pp_zero(tls->buf_cipher, tls->opt->buf_len);
     pp_zero(tls->buf_plain, tls->opt->buf_len);
     tls->is_connected = false;
+    tls->is_trusted = false;
 
     tls->ssl = SSL_new(tls->ssl_ctx);
     tls->bio_plain = BIO_new(BIO_f_ssl());
@@ -1002,6 +1075,9 @@ bool pp_openssl_tls_start(pp_tls tls) {
     tls->bio_cipher_out = BIO_new(BIO_s_mem());
 
     SSL_set_connect_state(tls->ssl);
+    if (tls->session && !SSL_set_session(tls->ssl, tls->session)) {
+        pp_clog(PPLogLevelError, "pp_openssl_tls_start: unable to offer session");
+    }
     SSL_set_bio(tls->ssl, tls->bio_cipher_in, tls->bio_cipher_out);
     BIO_set_ssl(tls->bio_plain, tls->ssl, BIO_NOCLOSE);
 
@@ -1048,6 +1124,8 @@ pp_zd *pp_openssl_tls_pull_cipher(pp_tls tls, pp_tls_error_code *error) {
                 return NULL;
             }
         }
+        // SSL_VERIFY_PEER fails the handshake on a bad chain
+        tls->is_trusted = SSL_get_verify_result(tls->ssl) == X509_V_OK;
     }
     if ((ret < 0) && !BIO_should_retry(tls->bio_cipher_out)) {
         if (error) {
@@ -1110,6 +1188,42 @@ bool pp_openssl_tls_put_plain(pp_tls tls,
     return true;
 }
 
+// MARK: - Resumption
+
+pp_tls_session pp_openssl_tls_get_session(pp_tls tls) {
+    // never resume a peer that failed verification, EKU or SAN checks
+    if (!tls->ssl || !tls->is_trusted || !SSL_is_init_finished(tls->ssl)) {
+        return NULL;
+    }
+    // TLS 1.3 tickets arrive after the handshake and update the session
+    SSL_SESSION *session = SSL_get1_session(tls->ssl);
+    if (!session) {
+        return NULL;
+    }
+    if (!SSL_SESSION_is_resumable(session)) {
+        SSL_SESSION_free(session);
+        return NULL;
+    }
+    return (pp_tls_session)session;
+}
+
+void pp_openssl_tls_set_session(pp_tls tls, pp_tls_session session) {
+    SSL_SESSION *ssl_session = (SSL_SESSION *)session;
+    SSL_SESSION_up_ref(ssl_session);
+    if (tls->session) {
+        SSL_SESSION_free(tls->session);
+    }
+    tls->session = ssl_session;
+}
+
+void pp_openssl_tls_session_free(pp_tls_session session) {
+    SSL_SESSION_free((SSL_SESSION *)session);
+}
+
+bool pp_openssl_tls_is_resumed(pp_tls tls) {
+    return tls->ssl && SSL_session_reused(tls->ssl);
+}
+
 // MARK: - MD5
 
 char *pp_openssl_tls_ca_md5(const pp_tls tls) {
@@ -1117,17 +1231,17 @@ char *pp_openssl_tls_ca_md5(const pp_tls tls) {
     uint8_t md[16];
     unsigned int len;
 
-    FILE *pem = pp_fopen(tls->opt->ca_path, "r");
+    BIO *pem = create_BIO_from_PEM(tls->opt->ca_pem);
     if (!pem) {
-        goto failure;
+        return NULL;
     }
-    X509 *cert = PEM_read_X509(pem, NULL, NULL, NULL);
+    X509 *cert = PEM_read_bio_X509(pem, NULL, NULL, NULL);
+    BIO_free(pem);
     if (!cert) {
-        goto failure;
+        return NULL;
     }
     X509_digest(cert, alg, md, &len);
     X509_free(cert);
-    fclose(pem);
     pp_assert(len == sizeof(md));//, @"Unexpected MD5 size (%d != %lu)", len, sizeof(md));
 
     char *hex = pp_alloc(2 * sizeof(md) + 1);
@@ -1137,10 +1251,6 @@ char *pp_openssl_tls_ca_md5(const pp_tls tls) {
     }
     *ptr = '\0';
     return hex;
-
-failure:
-    if (pem) fclose(pem);
-    return NULL;
 }
 
 // MARK: - Verifications
@@ -1271,6 +1381,8 @@ pp_crypto_fnt pp_crypto_fnt_openssl(void) {
         .key_decrypted_from_pem = pp_openssl_key_decrypted_from_pem,
 
         .tls = {
+            .ctx_create = pp_openssl_tls_ctx_create,
+            .ctx_free = pp_openssl_tls_ctx_free,
             .create = pp_openssl_tls_create,
             .free = pp_openssl_tls_free,
             .start = pp_openssl_tls_start,
@@ -1279,7 +1391,11 @@ pp_crypto_fnt pp_crypto_fnt_openssl(void) {
             .pull_plain = pp_openssl_tls_pull_plain,
             .put_cipher = pp_openssl_tls_put_cipher,
             .put_plain = pp_openssl_tls_put_plain,
-            .ca_md5 = pp_openssl_tls_ca_md5
+            .ca_md5 = pp_openssl_tls_ca_md5,
+            .get_session = pp_openssl_tls_get_session,
+            .set_session = pp_openssl_tls_set_session,
+            .session_free = pp_openssl_tls_session_free,
+            .is_resumed = pp_openssl_tls_is_resumed
         }
     };
     return table;
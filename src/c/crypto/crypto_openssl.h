@@ -56,7 +56,11 @@ char *_Nullable pp_openssl_key_decrypted_from_path(const char *path,
 char *_Nullable pp_openssl_key_decrypted_from_pem(const char *pem,
                                                   const char *passphrase);
 
+pp_tls_ctx _Nullable pp_openssl_tls_ctx_create(const pp_tls_options *opt,
+                                               pp_tls_error_code *error);
+void pp_openssl_tls_ctx_free(pp_tls_ctx ctx);
 pp_tls _Nullable pp_openssl_tls_create(const pp_tls_options *opt,
+                                       pp_tls_ctx ctx,
                                        pp_tls_error_code *error);
 void pp_openssl_tls_free(pp_tls tls);
 bool pp_openssl_tls_start(pp_tls tls);
@@ -74,5 +78,9 @@ bool pp_openssl_tls_put_plain(pp_tls tls,
                               size_t src_len,
                               pp_tls_error_code *_Nullable error);
 char *_Nullable pp_openssl_tls_ca_md5(const pp_tls tls);
+pp_tls_session _Nullable pp_openssl_tls_get_session(pp_tls tls);
+void pp_openssl_tls_set_session(pp_tls tls, pp_tls_session session);
+void pp_openssl_tls_session_free(pp_tls_session session);
+bool pp_openssl_tls_is_resumed(pp_tls tls);
 
 #pragma clang assume_nonnull end
@@ -24,6 +24,8 @@ typedef struct {
 } pp_crypto_enc_fnt;
 
 typedef struct {
+    pp_tls_ctx_create_fn ctx_create;
+    pp_tls_ctx_free_fn ctx_free;
     pp_tls_create_fn create;
     pp_tls_free_fn free;
     pp_tls_start_fn start;
@@ -33,6 +35,10 @@ typedef struct {
     pp_tls_put_cipher_fn put_cipher;
     pp_tls_put_plain_fn put_plain;
     pp_tls_ca_md5_fn ca_md5;
+    pp_tls_get_session_fn _Nullable get_session;
+    pp_tls_set_session_fn _Nullable set_session;
+    pp_tls_session_free_fn _Nullable session_free;
+    pp_tls_is_resumed_fn _Nullable is_resumed;
 } pp_crypto_tls_fnt;
 
 typedef struct {
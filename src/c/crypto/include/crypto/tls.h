@@ -31,7 +31,7 @@ typedef struct {
     size_t buf_len;
     bool eku;
     bool san_host;
-    const char *ca_path;
+    const char *ca_pem;
     const char *_Nullable cert_pem;
     const char *_Nullable key_pem;
     const char *_Nullable hostname;
@@ -43,7 +43,7 @@ pp_tls_options *pp_tls_options_create(int sec_level,
                                       size_t buf_len,
                                       bool eku,
                                       bool san_host,
-                                      const char *ca_path,
+                                      const char *ca_pem,
                                       const char *_Nullable cert_pem,
                                       const char *_Nullable key_pem,
                                       const char *_Nullable hostname,
@@ -54,9 +54,22 @@ void pp_tls_options_free(pp_tls_options *opt);
 
 /* Function table. */
 
+typedef struct __pp_tls_ctx_struct *pp_tls_ctx;
 typedef struct __pp_tls_struct *pp_tls;
+typedef struct __pp_tls_session_struct *pp_tls_session;
 
+/*
+ * A context holds the immutable part of a TLS configuration, i.e. the trust
+ * store, the client identity, and the security level. It only reads those
+ * fields of the options, and may be shared by any number of TLS objects.
+ */
+typedef pp_tls_ctx _Nullable (*pp_tls_ctx_create_fn)(const pp_tls_options *opt,
+                                                     pp_tls_error_code *error);
+typedef void (*pp_tls_ctx_free_fn)(pp_tls_ctx ctx);
+
+/* The context is borrowed and must outlive the TLS object. */
 typedef pp_tls _Nullable (*pp_tls_create_fn)(const pp_tls_options *opt,
+                                             pp_tls_ctx ctx,
                                              pp_tls_error_code *error);
 typedef void (*pp_tls_free_fn)(pp_tls tls);
 typedef bool (*pp_tls_start_fn)(pp_tls tls);
@@ -79,4 +92,17 @@ typedef bool (*pp_tls_put_plain_fn)(pp_tls tls,
 
 typedef char *_Nullable (*pp_tls_ca_md5_fn)(const pp_tls tls);
 
+/*
+ * Session resumption, optional in the function table.
+ *
+ * A session is immutable and may be offered to any TLS object created from
+ * the same context. `set_session` does not take ownership, and the session
+ * is offered on the next `start`. Restarting a TLS object (e.g. on a soft
+ * reset) offers the session of its previous handshake on its own.
+ */
+typedef pp_tls_session _Nullable (*pp_tls_get_session_fn)(pp_tls tls);
+typedef void (*pp_tls_set_session_fn)(pp_tls tls, pp_tls_session session);
+typedef void (*pp_tls_session_free_fn)(pp_tls_session session);
+typedef bool (*pp_tls_is_resumed_fn)(pp_tls tls);
+
 #pragma clang assume_nonnull end
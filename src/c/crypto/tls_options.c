@@ -11,20 +11,20 @@ pp_tls_options *pp_tls_options_create(int sec_level,
                                       size_t buf_len,
                                       bool eku,
                                       bool san_host,
-                                      const char *ca_path,
+                                      const char *ca_pem,
                                       const char *_Nullable cert_pem,
                                       const char *_Nullable key_pem,
                                       const char *_Nullable hostname,
                                       void (*on_verify_failure)(void *ctx),
                                       void *ctx) {
-    pp_assert(ca_path && on_verify_failure);
+    pp_assert(ca_pem && on_verify_failure);
 
     pp_tls_options *opt = pp_alloc(sizeof(pp_tls_options));
     opt->sec_level = sec_level;
     opt->buf_len = buf_len;
     opt->eku = eku;
     opt->san_host = san_host;
-    opt->ca_path = pp_dup(ca_path);
+    opt->ca_pem = pp_dup(ca_pem);
     opt->cert_pem = cert_pem ? pp_dup(cert_pem) : NULL;
     opt->key_pem = key_pem ? pp_dup(key_pem) : NULL;
     opt->hostname = hostname ? pp_dup(hostname) : NULL;
@@ -34,7 +34,7 @@ pp_tls_options *pp_tls_options_create(int sec_level,
 }
 
 void pp_tls_options_free(pp_tls_options *opt) {
-    pp_free((char *)opt->ca_path);
+    pp_free((char *)opt->ca_pem);
     pp_free((char *)opt->cert_pem);
     pp_free((char *)opt->key_pem);
     pp_free((char *)opt->hostname);
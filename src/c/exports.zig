@@ -18,6 +18,7 @@ pub const io = @cImport({
     @cInclude("portable/mux.h");
     @cInclude("portable/socket.h");
     @cInclude("portable/tun.h");
+    @cInclude("portable/uring.h");
 });
 
 pub const crypto = @cImport({
@@ -24,13 +24,58 @@
 #include <time.h>
 
 #if !PARTOUT_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if PARTOUT_APPLE
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
 #endif
 
 const int PPIOErrorWouldBlock   = -11;
 const int PPIOErrorNoBufs       = -12;
 const int PPIOErrorNoSpace      = -13;
 
+static _Thread_local pp_alloc_scope pp_alloc_current_scope;
+
+pp_alloc_scope pp_alloc_scope_enter(const pp_alloc_hooks *hooks, void *ctx) {
+    const pp_alloc_scope previous = pp_alloc_current_scope;
+    pp_alloc_current_scope.hooks = hooks;
+    pp_alloc_current_scope.ctx = ctx;
+    return previous;
+}
+
+void pp_alloc_scope_leave(pp_alloc_scope previous) {
+    pp_alloc_current_scope = previous;
+}
+
+static inline
+size_t pp_alloc_usable_size(void *ptr) {
+#if PARTOUT_APPLE
+    return malloc_size(ptr);
+#elif PARTOUT_WINDOWS
+    return _msize(ptr);
+#else
+    return malloc_usable_size(ptr);
+#endif
+}
+
+void pp_alloc_did_alloc(void *ptr) {
+    const pp_alloc_hooks *hooks = pp_alloc_current_scope.hooks;
+    if (!hooks) return;
+    hooks->did_alloc(pp_alloc_current_scope.ctx, pp_alloc_usable_size(ptr));
+}
+
+void pp_alloc_will_free(void *ptr) {
+    const pp_alloc_hooks *hooks = pp_alloc_current_scope.hooks;
+    if (!hooks) return;
+    hooks->will_free(pp_alloc_current_scope.ctx, pp_alloc_usable_size(ptr));
+}
+
 char *pp_dup(const char *str) {
 #if PARTOUT_WINDOWS
     char *ptr = _strdup(str);
@@ -41,6 +86,7 @@ char *pp_dup(const char *str) {
         pp_clog(PPLogLevelFault, "pp_dup: strdup() call failed");
         abort();
     }
+    pp_alloc_did_alloc(ptr);
     return ptr;
 }
 
@@ -54,12 +100,17 @@ FILE *pp_fopen(const char *filename, const char *mode) {
 }
 
 void pp_clog_v(pp_log_level level, const char *fmt, ...) {
+    if (!partout_log_enabled(level)) {
+        return;
+    }
 #if !PARTOUT_WINDOWS
     const int saved_errno = errno;
 #endif
+    // Format once on the stack, and only retry when longer
+    char stack_msg[512];
     va_list args;
     va_start(args, fmt);
-    const int formatted_len = vsnprintf(NULL, 0, fmt, args);
+    const int formatted_len = vsnprintf(stack_msg, sizeof(stack_msg), fmt, args);
     va_end(args);
     if (formatted_len < 0) {
 #if !PARTOUT_WINDOWS
@@ -67,13 +118,17 @@ void pp_clog_v(pp_log_level level, const char *fmt, ...) {
 #endif
         return;
     }
-    const size_t msg_len = (size_t)formatted_len + 1;
-    char *msg = pp_alloc(msg_len);
-    va_start(args, fmt);
-    vsnprintf(msg, msg_len, fmt, args);
-    va_end(args);
-    partout_log(level, msg);
-    pp_free(msg);
+    if ((size_t)formatted_len < sizeof(stack_msg)) {
+        partout_log(level, stack_msg);
+    } else {
+        const size_t msg_len = (size_t)formatted_len + 1;
+        char *msg = pp_alloc(msg_len);
+        va_start(args, fmt);
+        vsnprintf(msg, msg_len, fmt, args);
+        va_end(args);
+        partout_log(level, msg);
+        pp_free(msg);
+    }
 #if !PARTOUT_WINDOWS
     errno = saved_errno;
 #endif
@@ -88,8 +143,7 @@ char *pp_file_read(const char *rel_path, const char *parent) {
     if (parent) {
         const int path_len = snprintf(NULL, 0, "%s/%s", parent, rel_path);
         if (path_len < 0) goto failure;
-        abs_path = calloc(1, path_len + 1);
-        if (!abs_path) goto failure;
+        abs_path = pp_alloc(path_len + 1);
         snprintf(abs_path, path_len + 1, "%s/%s", parent, rel_path);
     } else {
         abs_path = pp_dup(rel_path);
@@ -99,7 +153,7 @@ char *pp_file_read(const char *rel_path, const char *parent) {
     /* Open file at absolute path. */
     file = pp_fopen(abs_path, "rb");
     if (!file) goto failure;
-    free(abs_path);
+    pp_free(abs_path);
     abs_path = NULL;
 
     /* Compute file size. */
@@ -120,11 +174,12 @@ char *pp_file_read(const char *rel_path, const char *parent) {
 
     if (read_size != buffer_size) goto failure;
     buffer[buffer_size] = '\0';
+    pp_alloc_did_alloc(buffer);
     return buffer;
 failure:
     if (buffer) free(buffer);
     if (file) fclose(file);
-    if (abs_path) free(abs_path);
+    pp_free(abs_path);
     return NULL;
 }
 
@@ -140,6 +195,137 @@ bool pp_file_is_directory(const char *path) {
 #endif
 }
 
+bool pp_file_map(const char *path, pp_file_mapping *mapping) {
+    memset(mapping, 0, sizeof(*mapping));
+#if PARTOUT_WINDOWS
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!map) return false;
+    const void *bytes = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!bytes) {
+        CloseHandle(map);
+        return false;
+    }
+    mapping->bytes = bytes;
+    mapping->length = (size_t)size.QuadPart;
+    mapping->handle = map;
+    return true;
+#else
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode) ||
+        (uint64_t)status.st_size > SIZE_MAX) {
+        close(fd);
+        return false;
+    }
+    if (status.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    void *bytes = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED) return false;
+    mapping->bytes = bytes;
+    mapping->length = (size_t)status.st_size;
+    return true;
+#endif
+}
+
+void pp_file_unmap(pp_file_mapping *mapping) {
+    if (mapping->bytes) {
+#if PARTOUT_WINDOWS
+        UnmapViewOfFile(mapping->bytes);
+        CloseHandle(mapping->handle);
+#else
+        munmap((void *)mapping->bytes, mapping->length);
+#endif
+    }
+    memset(mapping, 0, sizeof(*mapping));
+}
+
+bool pp_file_write_atomic(const char *path, const uint8_t *bytes, size_t length) {
+#if PARTOUT_WINDOWS
+    // Unique per process and call, and not shared while written
+    static volatile LONG counter = 0;
+    const unsigned long pid = GetCurrentProcessId();
+    const long sequence = InterlockedIncrement(&counter);
+    const int tmp_len = snprintf(NULL, 0, "%s.%lu.%ld.tmp", path, pid, sequence);
+    if (tmp_len < 0) return false;
+    char *tmp_path = calloc(1, (size_t)tmp_len + 1);
+    if (!tmp_path) return false;
+    snprintf(tmp_path, (size_t)tmp_len + 1, "%s.%lu.%ld.tmp", path, pid, sequence);
+
+    HANDLE file = CreateFileA(tmp_path, GENERIC_WRITE, 0, NULL,
+                              CREATE_NEW, FILE_ATTRIBUTE_TEMPORARY, NULL);
+    if (file == INVALID_HANDLE_VALUE) goto failure;
+    bool written = true;
+    for (size_t offset = 0; offset < length;) {
+        const size_t remaining = length - offset;
+        const DWORD chunk = remaining > MAXDWORD ? MAXDWORD : (DWORD)remaining;
+        DWORD count = 0;
+        if (!WriteFile(file, bytes + offset, chunk, &count, NULL) || count == 0) {
+            written = false;
+            break;
+        }
+        offset += count;
+    }
+    if (!CloseHandle(file) || !written) {
+        DeleteFileA(tmp_path);
+        goto failure;
+    }
+    if (!MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(tmp_path);
+        goto failure;
+    }
+#else
+    // Created by mkstemp() with O_EXCL and 0600, as contents may be private
+    const int tmp_len = snprintf(NULL, 0, "%s.XXXXXX", path);
+    if (tmp_len < 0) return false;
+    char *tmp_path = calloc(1, (size_t)tmp_len + 1);
+    if (!tmp_path) return false;
+    snprintf(tmp_path, (size_t)tmp_len + 1, "%s.XXXXXX", path);
+
+    const int fd = mkstemp(tmp_path);
+    if (fd < 0) goto failure;
+    bool written = true;
+    for (size_t offset = 0; offset < length;) {
+        const ssize_t count = write(fd, bytes + offset, length - offset);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            written = false;
+            break;
+        }
+        offset += (size_t)count;
+    }
+    if (close(fd) != 0 || !written) {
+        unlink(tmp_path);
+        goto failure;
+    }
+    if (rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        goto failure;
+    }
+#endif
+    free(tmp_path);
+    return true;
+failure:
+    free(tmp_path);
+    return false;
+}
+
 static bool pp_file_create_single_directory(const char *path) {
 #if PARTOUT_WINDOWS
     if (CreateDirectoryA(path, NULL)) return true;
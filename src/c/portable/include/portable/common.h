@@ -26,12 +26,13 @@ typedef enum {
     PPLogLevelDebug
 } pp_log_level;
 
-/* This callback forwards to the logger from partout_init(). */
-// extern bool partout_log_enabled(void);
+/* These callbacks forward to the logger from partout_init(). */
+extern bool partout_log_enabled(pp_log_level level);
 extern void partout_log(pp_log_level level, const char *message);
 
 static inline
 void pp_clog(pp_log_level level, const char *message) {
+    if (!partout_log_enabled(level)) return;
     partout_log(level, message);
 }
 
@@ -45,6 +46,30 @@ void pp_assert(bool condition) {
     (void)condition;
 }
 
+/*
+ * Accounting of pp_alloc/pp_free, routed per thread. A scope entered on a
+ * thread reports the usable size of every block allocated or freed there
+ * with pp_alloc, pp_dup or pp_free, until the previous scope is restored.
+ * Blocks keep no owner, so a block freed in another scope is reported to
+ * that scope.
+ */
+typedef struct {
+    void (*did_alloc)(void *_Nullable ctx, size_t size);
+    void (*will_free)(void *_Nullable ctx, size_t size);
+} pp_alloc_hooks;
+
+typedef struct {
+    const pp_alloc_hooks *_Nullable hooks;
+    void *_Nullable ctx;
+} pp_alloc_scope;
+
+/* Returns the previous scope, to pass to pp_alloc_scope_leave(). */
+pp_alloc_scope pp_alloc_scope_enter(const pp_alloc_hooks *_Nullable hooks, void *_Nullable ctx);
+void pp_alloc_scope_leave(pp_alloc_scope previous);
+
+void pp_alloc_did_alloc(void *ptr);
+void pp_alloc_will_free(void *ptr);
+
 static inline
 void *pp_alloc(size_t size) {
     void *memory = calloc(1, size);
@@ -52,12 +77,14 @@ void *pp_alloc(size_t size) {
         pp_clog(PPLogLevelFault, "pp_alloc: malloc() call failed");
         abort();
     }
+    pp_alloc_did_alloc(memory);
     return memory;
 }
 
 static inline
 void pp_free(void *_Nullable ptr) {
     if (!ptr) return;
+    pp_alloc_will_free(ptr);
     free(ptr);
 }
 
@@ -82,6 +109,24 @@ bool pp_file_create_directory(const char *path);
 /* Return whether a path identifies a directory. */
 bool pp_file_is_directory(const char *path);
 
+/* A read-only mapping of a whole file. */
+typedef struct {
+    const uint8_t *_Nullable bytes;
+    size_t length;
+    void *_Nullable handle;
+} pp_file_mapping;
+
+/* Map a whole file read-only, or return false if it cannot be opened or
+ * mapped. An empty file maps to a NULL range. */
+bool pp_file_map(const char *path, pp_file_mapping *mapping);
+void pp_file_unmap(pp_file_mapping *mapping);
+
+/* Replace a file with the given bytes through a temporary file renamed
+ * over it, so that readers never see a partial write. The temporary file
+ * has a unique name, and is private to the owner on POSIX and not shared
+ * while written on Windows. */
+bool pp_file_write_atomic(const char *path, const uint8_t *_Nullable bytes, size_t length);
+
 /* Return seconds since the Unix epoch, or zero if unavailable. */
 uint32_t pp_time_unix_seconds(void);
 
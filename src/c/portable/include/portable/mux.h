@@ -8,24 +8,48 @@
 #include "portable/conditionals.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "portable/socket.h"
 
 #pragma clang assume_nonnull begin
 
 typedef struct __pp_mux *pp_mux;
 
+typedef enum {
+    PPMuxEventReadable = 1 << 0,
+    PPMuxEventWritable = 1 << 1
+} pp_mux_event_flags;
+
+typedef struct {
+    pp_fd fd;
+    int flags;
+    void *_Nullable user_data;
+} pp_mux_event;
+
 extern const int PPMuxErrorNull;
+extern const uint64_t PPMuxNoDeadline;
 
 pp_mux _Nullable pp_mux_create(int num);
 void pp_mux_free(pp_mux mux);
 
 bool pp_mux_add(pp_mux mux, pp_fd fd);
 bool pp_mux_delete(pp_mux mux, pp_fd fd);
+bool pp_mux_set_user_data(pp_mux mux, pp_fd fd, void *_Nullable user_data);
 bool pp_mux_set_read(pp_mux mux, pp_fd fd, bool enable);
 bool pp_mux_set_write(pp_mux mux, pp_fd fd, bool enable);
 void pp_mux_set_on_readable(pp_mux mux, void (*callback)(void *ctx, pp_fd fd), void *ctx);
 void pp_mux_set_on_writable(pp_mux mux, void (*callback)(void *ctx, pp_fd fd), void *ctx);
-int pp_mux_wait(pp_mux mux, int *_Nullable error_code);
+/* Blocks for at most timeout_ms (-1 waits indefinitely) and returns 0 on timeout. */
+int pp_mux_wait(pp_mux mux, int timeout_ms, int *_Nullable error_code);
+/*
+ * Blocks until deadline_ns (PPMuxNoDeadline waits indefinitely) and stores at
+ * most max ready descriptors into events, with the user data they were
+ * registered with. Returns the number of events, 0 on timeout or wake. The
+ * deadline is measured on the pp_mux_now_ns() clock.
+ */
+int pp_mux_wait_until(pp_mux mux, uint64_t deadline_ns, pp_mux_event *events, int max, int *_Nullable error_code);
+/* Same clock as the core monotonicNs(), which includes system suspend. */
+uint64_t pp_mux_now_ns(void);
 bool pp_mux_wake(pp_mux mux);
 
 #pragma clang assume_nonnull end
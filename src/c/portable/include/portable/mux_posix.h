@@ -7,16 +7,29 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <stdint.h>
+#include <time.h>
 #include <unistd.h>
 #include <errno.h>
 #include "portable/mux.h"
 
+/* Keep in sync with monotonicNs() in core/concurrency.zig. */
+#if PARTOUT_LINUX || PARTOUT_ANDROID
+#define PP_MUX_CLOCK CLOCK_BOOTTIME
+#elif PARTOUT_APPLE
+#define PP_MUX_CLOCK CLOCK_MONOTONIC_RAW
+#elif defined(__FreeBSD__) || defined(__DragonFly__)
+#define PP_MUX_CLOCK CLOCK_MONOTONIC_FAST
+#else
+#define PP_MUX_CLOCK CLOCK_MONOTONIC
+#endif
+
 #define PP_MUX_ERROR_EVENTS (POLLERR | POLLHUP | POLLNVAL)
 
 struct pp_mux_entry {
     pp_fd fd;
     bool read;
     bool write;
+    void *user_data;
 };
 
 struct __pp_mux {
@@ -24,6 +37,7 @@ struct __pp_mux {
     int entries_len;
     pp_fd wake_pipe[2];
     struct pollfd *pollfds;
+    pp_mux_event *events;
     int num_tracked;
     void (*on_readable)(void *ctx, pp_fd fd);
     void (*on_writable)(void *ctx, pp_fd fd);
@@ -50,6 +64,7 @@ static struct pp_mux_entry *pp_mux_track_fd(pp_mux mux, pp_fd fd) {
     tracked->fd = fd;
     tracked->read = false;
     tracked->write = false;
+    tracked->user_data = NULL;
     ++mux->num_tracked;
     return tracked;
 }
@@ -129,6 +144,7 @@ pp_mux pp_mux_create(int num) {
     mux->wake_pipe[1] = wake_pipe[1];
     /* Adds 1 to account for wake_pipe. */
     mux->pollfds = pp_alloc((1 + num) * sizeof(struct pollfd));
+    mux->events = pp_alloc(num * sizeof(pp_mux_event));
 
     return mux;
 }
@@ -137,6 +153,7 @@ void pp_mux_free(pp_mux mux) {
     if (!mux) return;
     close(mux->wake_pipe[1]);
     close(mux->wake_pipe[0]);
+    pp_free(mux->events);
     pp_free(mux->pollfds);
     pp_free(mux->entries);
     pp_free(mux);
@@ -159,6 +176,14 @@ bool pp_mux_delete(pp_mux mux, pp_fd fd) {
     return true;
 }
 
+bool pp_mux_set_user_data(pp_mux mux, pp_fd fd, void *user_data) {
+    if (!mux) return false;
+    struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
+    if (!tracked) return false;
+    tracked->user_data = user_data;
+    return true;
+}
+
 bool pp_mux_set_read(pp_mux mux, pp_fd fd, bool enable) {
     if (!mux) return false;
     struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
@@ -189,12 +214,19 @@ void pp_mux_set_on_writable(pp_mux mux, void (*callback)(void *ctx, pp_fd fd), v
     mux->write_ctx = ctx;
 }
 
-int pp_mux_wait(pp_mux mux, int *error_code) {
-    if (!mux) return PPMuxErrorNull;
-
+/*
+ * Polls until deadline_ns and collects at most max events. Returns the poll()
+ * result, so that a wake counts as a ready descriptor.
+ */
+static int pp_mux_poll(pp_mux mux, uint64_t deadline_ns, pp_mux_event *events, int max,
+                       int *num_events, int *error_code) {
+    *num_events = 0;
     const int pollfds_count = pp_mux_build_pollfds(mux);
     int num;
-    PP_IO_RETRY(num, poll(mux->pollfds, (nfds_t)pollfds_count, -1));
+    do {
+        /* Recomputed on EINTR, so that signals do not extend the wait. */
+        num = poll(mux->pollfds, (nfds_t)pollfds_count, pp_mux_timeout_until(deadline_ns));
+    } while (num < 0 && errno == EINTR);
     if (num < 0) {
         pp_clog_v(PPLogLevelFault, "pp_mux_wait poll() failed: errno=%d", errno);
         if (error_code) *error_code = errno;
@@ -214,21 +246,57 @@ int pp_mux_wait(pp_mux mux, int *error_code) {
             }
             continue;
         }
+        /* Left for the next wait, poll() is level-triggered. */
+        if (*num_events >= max) continue;
         const struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
         if (!tracked) continue;
         const bool failed = revents & PP_MUX_ERROR_EVENTS;
-        const bool readable = tracked->read && ((revents & POLLIN) || failed);
-        const bool writable = tracked->write && ((revents & POLLOUT) || failed);
-        if (readable && mux->on_readable) {
-            mux->on_readable(mux->read_ctx, fd);
+        int flags = 0;
+        if (tracked->read && ((revents & POLLIN) || failed)) flags |= PPMuxEventReadable;
+        if (tracked->write && ((revents & POLLOUT) || failed)) flags |= PPMuxEventWritable;
+        if (flags == 0) continue;
+        pp_mux_event *event = events + *num_events;
+        event->fd = fd;
+        event->flags = flags;
+        event->user_data = tracked->user_data;
+        ++*num_events;
+    }
+    return num;
+}
+
+int pp_mux_wait(pp_mux mux, int timeout_ms, int *error_code) {
+    if (!mux) return PPMuxErrorNull;
+
+    int num_events;
+    const int num = pp_mux_poll(mux, pp_mux_deadline_after(timeout_ms), mux->events,
+                                mux->entries_len, &num_events, error_code);
+    for (int i = 0; i < num_events; ++i) {
+        const pp_mux_event *event = mux->events + i;
+        if ((event->flags & PPMuxEventReadable) && mux->on_readable) {
+            mux->on_readable(mux->read_ctx, event->fd);
         }
-        if (writable && mux->on_writable) {
-            mux->on_writable(mux->write_ctx, fd);
+        if ((event->flags & PPMuxEventWritable) && mux->on_writable) {
+            mux->on_writable(mux->write_ctx, event->fd);
         }
     }
     return num;
 }
 
+int pp_mux_wait_until(pp_mux mux, uint64_t deadline_ns, pp_mux_event *events, int max, int *error_code) {
+    if (!mux) return PPMuxErrorNull;
+
+    int num_events;
+    const int num = pp_mux_poll(mux, deadline_ns, events, max, &num_events, error_code);
+    if (num < 0) return num;
+    return num_events;
+}
+
+uint64_t pp_mux_now_ns(void) {
+    struct timespec ts;
+    if (clock_gettime(PP_MUX_CLOCK, &ts) != 0) return 0;
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
 bool pp_mux_wake(pp_mux mux) {
     if (!mux) return false;
     const uint8_t byte = 1;
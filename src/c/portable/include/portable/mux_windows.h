@@ -10,6 +10,7 @@ struct pp_mux_entry {
     pp_fd fd;
     bool read;
     bool write;
+    void *user_data;
 };
 
 struct __pp_mux {
@@ -17,6 +18,7 @@ struct __pp_mux {
     int entries_len;
     pp_fd wake_event;
     pp_fd *handles;
+    pp_mux_event *events;
     int num_tracked;
     void (*on_readable)(void *ctx, pp_fd fd);
     void (*on_writable)(void *ctx, pp_fd fd);
@@ -47,6 +49,7 @@ static struct pp_mux_entry *pp_mux_track_fd(pp_mux mux, pp_fd fd) {
     tracked->fd = fd;
     tracked->read = false;
     tracked->write = false;
+    tracked->user_data = NULL;
     ++mux->num_tracked;
     return tracked;
 }
@@ -82,7 +85,8 @@ pp_mux pp_mux_create(int num) {
     /* Adds 1 to account for wake_event. */
     if (num > MAXIMUM_WAIT_OBJECTS - 1) return NULL;
 
-    pp_fd wake_event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    /* Manual-reset, so that probing handles never consumes a wake. */
+    pp_fd wake_event = CreateEventW(NULL, TRUE, FALSE, NULL);
     if (!wake_event) return NULL;
 
     pp_mux mux = pp_alloc(sizeof(*mux));
@@ -90,6 +94,7 @@ pp_mux pp_mux_create(int num) {
     mux->entries_len = num;
     mux->wake_event = wake_event;
     mux->handles = pp_alloc((1 + num) * sizeof(pp_fd));
+    mux->events = pp_alloc(num * sizeof(pp_mux_event));
 
     return mux;
 }
@@ -97,6 +102,7 @@ pp_mux pp_mux_create(int num) {
 void pp_mux_free(pp_mux mux) {
     if (!mux) return;
     CloseHandle(mux->wake_event);
+    pp_free(mux->events);
     pp_free(mux->handles);
     pp_free(mux->entries);
     pp_free(mux);
@@ -119,6 +125,14 @@ bool pp_mux_delete(pp_mux mux, pp_fd fd) {
     return true;
 }
 
+bool pp_mux_set_user_data(pp_mux mux, pp_fd fd, void *user_data) {
+    if (!mux) return false;
+    struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
+    if (!tracked) return false;
+    tracked->user_data = user_data;
+    return true;
+}
+
 bool pp_mux_set_read(pp_mux mux, pp_fd fd, bool enable) {
     if (!mux) return false;
     struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
@@ -149,11 +163,35 @@ void pp_mux_set_on_writable(pp_mux mux, void (*callback)(void *ctx, pp_fd fd), v
     mux->write_ctx = ctx;
 }
 
-int pp_mux_wait(pp_mux mux, int *error_code) {
-    if (!mux) return PPMuxErrorNull;
+static void pp_mux_collect(pp_mux mux, pp_fd fd, pp_mux_event *events, int max, int *num_events) {
+    if (fd == mux->wake_event || *num_events >= max) return;
+    const struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
+    if (!tracked) return;
+    int flags = 0;
+    if (tracked->read) flags |= PPMuxEventReadable;
+    if (tracked->write) flags |= PPMuxEventWritable;
+    if (flags == 0) return;
+    pp_mux_event *event = events + *num_events;
+    event->fd = fd;
+    event->flags = flags;
+    event->user_data = tracked->user_data;
+    ++*num_events;
+}
 
+/*
+ * Waits until deadline_ns and collects at most max events. Returns the number
+ * of signaled handles, so that a wake counts as a ready descriptor.
+ */
+static int pp_mux_poll(pp_mux mux, uint64_t deadline_ns, pp_mux_event *events, int max,
+                       int *num_events, int *error_code) {
+    *num_events = 0;
     const int handles_count = pp_mux_build_handles(mux);
-    const DWORD ret = WaitForMultipleObjects((DWORD)handles_count, mux->handles, FALSE, INFINITE);
+    const int timeout_ms = pp_mux_timeout_until(deadline_ns);
+    const DWORD timeout = timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms;
+    const DWORD ret = WaitForMultipleObjects((DWORD)handles_count, mux->handles, FALSE, timeout);
+    if (ret == WAIT_TIMEOUT) {
+        return 0;
+    }
     if (ret == WAIT_FAILED) {
         const DWORD error = GetLastError();
         pp_clog_v(PPLogLevelFault, "pp_mux_wait WaitForMultipleObjects() failed: error=%lu", error);
@@ -169,21 +207,60 @@ int pp_mux_wait(pp_mux mux, int *error_code) {
         return -1;
     }
 
+    /* The wake event is only reset once reported. A wake set meanwhile
+     * merges with this one, whose caller checks its queue afterwards. */
     const int index = (int)(ret - WAIT_OBJECT_0);
-    const pp_fd fd = mux->handles[index];
-    if (fd == mux->wake_event) {
-        return 1;
-    }
+    if (index == 0) ResetEvent(mux->wake_event);
 
-    const struct pp_mux_entry *tracked = pp_mux_entry_find(mux, fd);
-    if (!tracked) return 1;
-    if (tracked->read && mux->on_readable) {
-        mux->on_readable(mux->read_ctx, fd);
+    /* WaitForMultipleObjects() only reports the lowest signaled index, so
+     * probe the following handles without blocking to batch them too. */
+    int num = 1;
+    pp_mux_collect(mux, mux->handles[index], events, max, num_events);
+    for (int i = index + 1; i < handles_count; ++i) {
+        if (WaitForSingleObject(mux->handles[i], 0) != WAIT_OBJECT_0) continue;
+        ++num;
+        pp_mux_collect(mux, mux->handles[i], events, max, num_events);
     }
-    if (tracked->write && mux->on_writable) {
-        mux->on_writable(mux->write_ctx, fd);
+    return num;
+}
+
+int pp_mux_wait(pp_mux mux, int timeout_ms, int *error_code) {
+    if (!mux) return PPMuxErrorNull;
+
+    int num_events;
+    const int num = pp_mux_poll(mux, pp_mux_deadline_after(timeout_ms), mux->events,
+                                mux->entries_len, &num_events, error_code);
+    for (int i = 0; i < num_events; ++i) {
+        const pp_mux_event *event = mux->events + i;
+        if ((event->flags & PPMuxEventReadable) && mux->on_readable) {
+            mux->on_readable(mux->read_ctx, event->fd);
+        }
+        if ((event->flags & PPMuxEventWritable) && mux->on_writable) {
+            mux->on_writable(mux->write_ctx, event->fd);
+        }
     }
-    return 1;
+    return num;
+}
+
+int pp_mux_wait_until(pp_mux mux, uint64_t deadline_ns, pp_mux_event *events, int max, int *error_code) {
+    if (!mux) return PPMuxErrorNull;
+
+    int num_events;
+    const int num = pp_mux_poll(mux, deadline_ns, events, max, &num_events, error_code);
+    if (num < 0) return num;
+    return num_events;
+}
+
+/* Keep in sync with monotonicNs() in core/concurrency.zig. */
+uint64_t pp_mux_now_ns(void) {
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!QueryPerformanceFrequency(&frequency) || !QueryPerformanceCounter(&counter)) return 0;
+    if (frequency.QuadPart <= 0 || counter.QuadPart < 0) return 0;
+    const uint64_t ticks = (uint64_t)counter.QuadPart;
+    const uint64_t ticks_per_second = (uint64_t)frequency.QuadPart;
+    return (ticks / ticks_per_second) * 1000000000 +
+           (ticks % ticks_per_second) * 1000000000 / ticks_per_second;
 }
 
 bool pp_mux_wake(pp_mux mux) {
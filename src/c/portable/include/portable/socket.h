@@ -70,6 +70,20 @@ int pp_socket_read(pp_socket sock,
                    uint8_t *dst, size_t dst_len);
 int pp_socket_write(pp_socket sock,
                     const uint8_t *src, size_t src_len);
+
+/* Gathered I/O for stream sockets. At most PPSocketMaxChunks are written
+ * with a single system call, and the write may be partial. Returns the
+ * amount of written bytes, or PPIOErrorWouldBlock/PPIOErrorNoBufs when
+ * nothing was written. */
+#define PPSocketMaxChunks 64
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+} pp_socket_chunk;
+
+int pp_socket_writev(pp_socket sock,
+                     const pp_socket_chunk *chunks, size_t count);
 bool pp_socket_set_buffers(pp_socket sock,
                            int recvbuf_len,
                            int sendbuf_len);
@@ -8,6 +8,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/select.h>
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -80,6 +81,15 @@ static inline int local_send_fd(pp_socket_fd fd, const void *src, size_t src_len
     return (int)write(fd, src, src_len);
 }
 
+static inline int local_sendv_fd(pp_socket_fd fd, const pp_socket_chunk *chunks, size_t count) {
+    struct iovec iov[PPSocketMaxChunks];
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = (void *)chunks[i].bytes;
+        iov[i].iov_len = chunks[i].length;
+    }
+    return (int)writev(fd, iov, (int)count);
+}
+
 static inline int local_select_nfds(pp_socket_fd fd) {
     return fd + 1;
 }
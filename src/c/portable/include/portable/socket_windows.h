@@ -87,6 +87,19 @@ static inline int local_send_fd(pp_socket_fd fd, const void *src, size_t src_len
     return (int)send(fd, src, (int)src_len, 0);
 }
 
+static inline int local_sendv_fd(pp_socket_fd fd, const pp_socket_chunk *chunks, size_t count) {
+    WSABUF bufs[PPSocketMaxChunks];
+    for (size_t i = 0; i < count; ++i) {
+        bufs[i].buf = (CHAR *)chunks[i].bytes;
+        bufs[i].len = (ULONG)chunks[i].length;
+    }
+    DWORD sent = 0;
+    if (WSASend(fd, bufs, (DWORD)count, &sent, 0, NULL, NULL) == SOCKET_ERROR) {
+        return -1;
+    }
+    return (int)sent;
+}
+
 static inline int local_select_nfds(pp_socket_fd fd) {
     (void)fd;
     return 0;
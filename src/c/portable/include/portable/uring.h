@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Davide De Rosa
+ *
+ * SPDX-License-Identifier: GPL-3.0
+ */
+
+#pragma once
+#include "portable/conditionals.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "portable/common.h"
+
+#pragma clang assume_nonnull begin
+
+/*
+ A receive ring reads from a descriptor with io_uring on Linux:
+
+ - The descriptor is registered with the ring
+ - Packets land in a ring of provided buffers (slots) owned by the ring
+ - A multishot receive keeps reading without a submission per packet
+
+ Received slots are borrowed until released, and the kernel stops
+ receiving when all slots are borrowed. The descriptor must not be
+ read elsewhere while the ring exists. Completions make the ring
+ descriptor readable, so it can be watched with pp_mux in place of the
+ original descriptor for read events.
+
+ pp_uring_rx_create() returns NULL where io_uring or any of the
+ required features is unavailable (e.g. not Linux, seccomp, kernels
+ older than 6.0 for sockets or 6.7 for other descriptors, or kernels
+ that reject multishot receive), and callers should fall back to
+ regular reads.
+ */
+
+typedef struct __pp_uring_rx *pp_uring_rx;
+
+typedef struct {
+    uint8_t *bytes;
+    size_t length;
+    uint16_t id;
+} pp_uring_slot;
+
+/* slot_count must be a power of 2, up to 32768. The descriptor is
+ * borrowed and must outlive the ring. Only streams end on an empty
+ * read, empty datagrams are skipped. */
+pp_uring_rx _Nullable pp_uring_rx_create(pp_fd fd,
+                                         bool is_socket,
+                                         bool is_stream,
+                                         size_t slot_len,
+                                         size_t slot_count);
+void pp_uring_rx_free(pp_uring_rx rx);
+
+/* The descriptor to watch for read events. */
+pp_fd pp_uring_rx_get_watch_fd(pp_uring_rx rx);
+
+/* Borrows up to max received slots without blocking. Returns the number
+ * of slots, PPIOErrorWouldBlock when none is available, 0 at the end of
+ * a stream, or -1 on failure. Slots received before the end of a stream
+ * are returned before it. */
+int pp_uring_rx_read(pp_uring_rx rx, pp_uring_slot *slots, size_t max);
+
+/* Returns borrowed slots to the ring. */
+void pp_uring_rx_release(pp_uring_rx rx, const pp_uring_slot *slots, size_t count);
+
+int pp_uring_rx_last_error(pp_uring_rx rx);
+
+#pragma clang assume_nonnull end
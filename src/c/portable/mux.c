@@ -10,9 +10,27 @@
 #include <Windows.h>
 #endif
 
+#include <limits.h>
 #include "portable/common.h"
+#include "portable/mux.h"
 
 const int PPMuxErrorNull = -2;
+const uint64_t PPMuxNoDeadline = UINT64_MAX;
+
+/* Rounds up to never return before the deadline, -1 without a deadline. */
+static int pp_mux_timeout_until(uint64_t deadline_ns) {
+    if (deadline_ns == PPMuxNoDeadline) return -1;
+    const uint64_t now_ns = pp_mux_now_ns();
+    if (deadline_ns <= now_ns) return 0;
+    const uint64_t remaining_ms = (deadline_ns - now_ns + 999999) / 1000000;
+    return remaining_ms > INT_MAX ? INT_MAX : (int)remaining_ms;
+}
+
+/* Converts a relative timeout of pp_mux_wait() to a deadline. */
+static uint64_t pp_mux_deadline_after(int timeout_ms) {
+    if (timeout_ms < 0) return PPMuxNoDeadline;
+    return pp_mux_now_ns() + (uint64_t)timeout_ms * 1000000;
+}
 
 #if PARTOUT_WINDOWS
 #include "portable/mux_windows.h"
@@ -42,6 +42,7 @@ static int local_close_fd(pp_socket_fd fd);
 static int local_shutdown_fd(pp_socket_fd fd);
 static int local_recv_fd(pp_socket_fd fd, void *dst, size_t dst_len);
 static int local_send_fd(pp_socket_fd fd, const void *src, size_t src_len);
+static int local_sendv_fd(pp_socket_fd fd, const pp_socket_chunk *chunks, size_t count);
 static int local_select_nfds(pp_socket_fd fd);
 static bool local_init_socket(pp_socket sock);
 static void local_cleanup_socket(pp_socket sock);
@@ -324,6 +325,42 @@ int pp_socket_write(pp_socket sock, const uint8_t *src, size_t src_len) {
     return (int)offset;
 }
 
+/* Write up to PPSocketMaxChunks chunks with one system call. Unlike
+ * pp_socket_write(), partial writes are returned to the caller, which
+ * is expected to resume from the returned offset. */
+int pp_socket_writev(pp_socket sock, const pp_socket_chunk *chunks, size_t count) {
+    if (!local_is_valid_socket(sock)) {
+        local_set_not_socket_error();
+        return -1;
+    }
+    if (count > PPSocketMaxChunks) {
+        count = PPSocketMaxChunks;
+    }
+
+    while (true) {
+        const int written_len = local_sendv_fd(sock->fd, chunks, count);
+        if (written_len < 0) {
+            if (local_is_interrupted()) {
+                continue;
+            }
+            if (local_is_wouldblock()) {
+                return PPIOErrorWouldBlock;
+            }
+            if (local_is_nobufs()) {
+                return PPIOErrorNoBufs;
+            }
+            local_print_error("writev()");
+            return written_len;
+        }
+        if (written_len == 0 && count > 0) {
+            local_set_reset_error();
+            local_print_error("writev()");
+            return -1;
+        }
+        return written_len;
+    }
+}
+
 bool pp_socket_set_buffers(pp_socket sock, int recvbuf_len, int sendbuf_len) {
     if (!local_is_valid_socket(sock)) {
         local_set_not_socket_error();
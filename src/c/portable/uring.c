@@ -0,0 +1,489 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Davide De Rosa
+ *
+ * SPDX-License-Identifier: GPL-3.0
+ */
+
+#include "portable/common.h"
+#include "portable/uring.h"
+
+#if PARTOUT_LINUX
+#include <linux/version.h>
+#include <sys/syscall.h>
+/* Provided buffer rings and multishot receive require 6.0 headers. */
+#if defined(__NR_io_uring_setup) && LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0)
+#define PP_URING_SUPPORTED 1
+#endif
+#endif
+#ifndef PP_URING_SUPPORTED
+#define PP_URING_SUPPORTED 0
+#endif
+
+#if PP_URING_SUPPORTED
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include "portable/io_posix.h"
+
+#define PP_URING_SQ_ENTRIES     8
+#define PP_URING_BUF_GROUP      0
+#define PP_URING_RECV_DATA      1
+#define PP_URING_CANCEL_DATA    2
+
+/* Probed at runtime, older headers lack the opcode. */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 7, 0)
+#define IORING_OP_READ_MULTISHOT 49
+#endif
+
+struct __pp_uring_rx {
+    int ring_fd;
+    bool is_socket;
+    bool is_stream;
+    bool did_end;
+    int last_error;
+    int pending_error;
+
+    // Submission queue
+    void *sq_ptr;
+    size_t sq_len;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned sq_entries;
+    struct io_uring_sqe *sqes;
+    size_t sqes_len;
+
+    // Completion queue
+    void *cq_ptr;
+    size_t cq_len;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    // Provided buffers
+    struct io_uring_buf_ring *buf_ring;
+    size_t buf_ring_len;
+    uint16_t buf_tail;
+    uint8_t *slots;
+    size_t slot_len;
+    size_t slot_count;
+    size_t borrowed;
+    size_t inflight;
+};
+
+static int local_setup(unsigned entries, struct io_uring_params *params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int local_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int local_register(int ring_fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+static bool local_supports_read_multishot(int ring_fd) {
+    const size_t len = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = pp_alloc(len);
+    bool supported = false;
+    if (local_register(ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+        probe->last_op >= IORING_OP_READ_MULTISHOT) {
+        supported = (probe->ops[IORING_OP_READ_MULTISHOT].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+    pp_free(probe);
+    return supported;
+}
+
+static bool local_map_rings(pp_uring_rx rx, const struct io_uring_params *params) {
+    rx->sq_len = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+    rx->cq_len = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+    if (rx->cq_len > rx->sq_len) {
+        rx->sq_len = rx->cq_len;
+    }
+    rx->sq_ptr = mmap(NULL, rx->sq_len, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, rx->ring_fd, IORING_OFF_SQ_RING);
+    if (rx->sq_ptr == MAP_FAILED) {
+        rx->sq_ptr = NULL;
+        return false;
+    }
+    // IORING_FEAT_SINGLE_MMAP is checked by the caller
+    rx->cq_ptr = rx->sq_ptr;
+    rx->cq_len = 0;
+
+    uint8_t *sq = rx->sq_ptr;
+    rx->sq_head = (unsigned *)(sq + params->sq_off.head);
+    rx->sq_tail = (unsigned *)(sq + params->sq_off.tail);
+    rx->sq_mask = (unsigned *)(sq + params->sq_off.ring_mask);
+    rx->sq_array = (unsigned *)(sq + params->sq_off.array);
+    rx->sq_entries = params->sq_entries;
+
+    uint8_t *cq = rx->cq_ptr;
+    rx->cq_head = (unsigned *)(cq + params->cq_off.head);
+    rx->cq_tail = (unsigned *)(cq + params->cq_off.tail);
+    rx->cq_mask = (unsigned *)(cq + params->cq_off.ring_mask);
+    rx->cqes = (struct io_uring_cqe *)(cq + params->cq_off.cqes);
+
+    rx->sqes_len = params->sq_entries * sizeof(struct io_uring_sqe);
+    rx->sqes = mmap(NULL, rx->sqes_len, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, rx->ring_fd, IORING_OFF_SQES);
+    if (rx->sqes == MAP_FAILED) {
+        rx->sqes = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void local_provide(pp_uring_rx rx, uint16_t id) {
+    const uint16_t mask = (uint16_t)(rx->slot_count - 1);
+    struct io_uring_buf *buf = &rx->buf_ring->bufs[rx->buf_tail & mask];
+    buf->addr = (uint64_t)(uintptr_t)(rx->slots + (size_t)id * rx->slot_len);
+    buf->len = (uint32_t)rx->slot_len;
+    buf->bid = id;
+    ++rx->buf_tail;
+}
+
+static void local_publish(pp_uring_rx rx) {
+    __atomic_store_n(&rx->buf_ring->tail, rx->buf_tail, __ATOMIC_RELEASE);
+}
+
+static bool local_map_buffers(pp_uring_rx rx) {
+    rx->buf_ring_len = rx->slot_count * sizeof(struct io_uring_buf);
+    void *ring = mmap(NULL, rx->buf_ring_len, PROT_READ | PROT_WRITE,
+                      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring == MAP_FAILED) {
+        return false;
+    }
+    rx->buf_ring = ring;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring;
+    reg.ring_entries = (uint32_t)rx->slot_count;
+    reg.bgid = PP_URING_BUF_GROUP;
+    if (local_register(rx->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        return false;
+    }
+
+    rx->slots = pp_alloc(rx->slot_count * rx->slot_len);
+    for (size_t i = 0; i < rx->slot_count; ++i) {
+        local_provide(rx, (uint16_t)i);
+    }
+    local_publish(rx);
+    return true;
+}
+
+static struct io_uring_sqe *_Nullable local_next_sqe(pp_uring_rx rx) {
+    const unsigned head = __atomic_load_n(rx->sq_head, __ATOMIC_ACQUIRE);
+    const unsigned tail = *rx->sq_tail;
+    if (tail - head >= rx->sq_entries) {
+        return NULL;
+    }
+    const unsigned index = tail & *rx->sq_mask;
+    struct io_uring_sqe *sqe = &rx->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    rx->sq_array[index] = index;
+    return sqe;
+}
+
+static bool local_submit(pp_uring_rx rx, unsigned count) {
+    __atomic_store_n(rx->sq_tail, *rx->sq_tail + count, __ATOMIC_RELEASE);
+    int ret;
+    PP_IO_RETRY(ret, local_enter(rx->ring_fd, count, 0, 0));
+    if (ret < 0) {
+        rx->last_error = errno;
+        return false;
+    }
+    return true;
+}
+
+/* Keeps a multishot receive in flight while slots are available. The
+ * kernel ends it when it runs out of slots. */
+static bool local_arm(pp_uring_rx rx) {
+    if (rx->did_end || rx->inflight > 0 || rx->borrowed == rx->slot_count) {
+        return true;
+    }
+    struct io_uring_sqe *sqe = local_next_sqe(rx);
+    if (!sqe) {
+        return true;
+    }
+    sqe->fd = 0; // registered index
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->buf_group = PP_URING_BUF_GROUP;
+    sqe->user_data = PP_URING_RECV_DATA;
+    if (rx->is_socket) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+    } else {
+        // Unlike single reads, waits for data on O_NONBLOCK descriptors
+        sqe->opcode = IORING_OP_READ_MULTISHOT;
+        sqe->off = (uint64_t)-1;
+    }
+    ++rx->inflight;
+    return local_submit(rx, 1);
+}
+
+/* Kernels without multishot receive reject it on submission, which
+ * completes before io_uring_enter() returns. Leaves the queue as is. */
+static bool local_rejects_multishot(pp_uring_rx rx) {
+    const unsigned tail = __atomic_load_n(rx->cq_tail, __ATOMIC_ACQUIRE);
+    for (unsigned head = *rx->cq_head; head != tail; ++head) {
+        const struct io_uring_cqe *cqe = &rx->cqes[head & *rx->cq_mask];
+        if (cqe->user_data == PP_URING_RECV_DATA && cqe->res == -EINVAL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void local_unmap(pp_uring_rx rx) {
+    if (rx->sqes) munmap(rx->sqes, rx->sqes_len);
+    if (rx->sq_ptr) munmap(rx->sq_ptr, rx->sq_len);
+    if (rx->buf_ring) munmap(rx->buf_ring, rx->buf_ring_len);
+    pp_free(rx->slots);
+}
+
+pp_uring_rx pp_uring_rx_create(pp_fd fd,
+                               bool is_socket,
+                               bool is_stream,
+                               size_t slot_len,
+                               size_t slot_count) {
+    pp_assert(slot_count > 0 && slot_count <= 32768);
+    pp_assert((slot_count & (slot_count - 1)) == 0);
+    pp_assert(slot_len > 0 && slot_len <= UINT32_MAX);
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    // At least as many as submission entries
+    params.cq_entries = (unsigned)(slot_count > PP_URING_SQ_ENTRIES ? slot_count : PP_URING_SQ_ENTRIES) * 2;
+    const int ring_fd = local_setup(PP_URING_SQ_ENTRIES, &params);
+    if (ring_fd < 0) {
+        pp_clog_v(PPLogLevelInfo, "uring: io_uring_setup() unavailable (errno=%d)", errno);
+        return NULL;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        pp_clog(PPLogLevelInfo, "uring: Required io_uring features are unavailable");
+        close(ring_fd);
+        return NULL;
+    }
+
+    if (!is_socket && !local_supports_read_multishot(ring_fd)) {
+        pp_clog(PPLogLevelInfo, "uring: Multishot read is unavailable");
+        close(ring_fd);
+        return NULL;
+    }
+
+    pp_uring_rx rx = pp_alloc(sizeof(*rx));
+    rx->ring_fd = ring_fd;
+    rx->is_socket = is_socket;
+    rx->is_stream = is_stream;
+    rx->slot_len = slot_len;
+    rx->slot_count = slot_count;
+
+    if (!local_map_rings(rx, &params)) {
+        pp_clog_v(PPLogLevelInfo, "uring: Unable to map rings (errno=%d)", errno);
+        goto failure;
+    }
+    int fds[1] = { fd };
+    if (local_register(ring_fd, IORING_REGISTER_FILES, fds, 1) != 0) {
+        pp_clog_v(PPLogLevelInfo, "uring: Unable to register descriptor (errno=%d)", errno);
+        goto failure;
+    }
+    if (!local_map_buffers(rx)) {
+        pp_clog_v(PPLogLevelInfo, "uring: Unable to provide buffers (errno=%d)", errno);
+        goto failure;
+    }
+    if (!local_arm(rx)) {
+        pp_clog_v(PPLogLevelInfo, "uring: Unable to submit receive (errno=%d)", rx->last_error);
+        goto failure;
+    }
+    if (is_socket && local_rejects_multishot(rx)) {
+        pp_clog(PPLogLevelInfo, "uring: Multishot receive is unavailable");
+        goto failure;
+    }
+    pp_clog_v(PPLogLevelInfo, "uring: Receiving from fd=%d with %zu slots", fd, slot_count);
+    return rx;
+
+failure:
+    close(ring_fd);
+    local_unmap(rx);
+    pp_free(rx);
+    return NULL;
+}
+
+void pp_uring_rx_free(pp_uring_rx rx) {
+    if (!rx) return;
+
+    // Wait for cancellation, the kernel may still write into the slots
+    struct io_uring_sqe *sqe = rx->inflight > 0 ? local_next_sqe(rx) : NULL;
+    if (sqe) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = PP_URING_RECV_DATA;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = PP_URING_CANCEL_DATA;
+        if (local_submit(rx, 1)) {
+            while (rx->inflight > 0) {
+                unsigned head = *rx->cq_head;
+                const unsigned tail = __atomic_load_n(rx->cq_tail, __ATOMIC_ACQUIRE);
+                if (head == tail) {
+                    int ret;
+                    PP_IO_RETRY(ret, local_enter(rx->ring_fd, 0, 1, IORING_ENTER_GETEVENTS));
+                    if (ret < 0) break;
+                    continue;
+                }
+                for (; head != tail; ++head) {
+                    const struct io_uring_cqe *cqe = &rx->cqes[head & *rx->cq_mask];
+                    if (cqe->user_data == PP_URING_RECV_DATA && !(cqe->flags & IORING_CQE_F_MORE)) {
+                        --rx->inflight;
+                    }
+                }
+                __atomic_store_n(rx->cq_head, head, __ATOMIC_RELEASE);
+            }
+        }
+    }
+    close(rx->ring_fd);
+    local_unmap(rx);
+    pp_free(rx);
+}
+
+pp_fd pp_uring_rx_get_watch_fd(pp_uring_rx rx) {
+    return rx->ring_fd;
+}
+
+int pp_uring_rx_read(pp_uring_rx rx, pp_uring_slot *slots, size_t max) {
+    size_t count = 0;
+    unsigned head = *rx->cq_head;
+    const unsigned tail = __atomic_load_n(rx->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail && count < max && !rx->pending_error && !rx->did_end) {
+        const struct io_uring_cqe *cqe = &rx->cqes[head & *rx->cq_mask];
+        ++head;
+        if (cqe->user_data != PP_URING_RECV_DATA) {
+            continue;
+        }
+        if (!(cqe->flags & IORING_CQE_F_MORE)) {
+            --rx->inflight;
+        }
+        if (cqe->res < 0) {
+            // Out of slots or interrupted, resubmitted below
+            if (cqe->res == -ENOBUFS || cqe->res == -EAGAIN || cqe->res == -EINTR) {
+                continue;
+            }
+            rx->pending_error = -cqe->res;
+            continue;
+        }
+        // End of a stream or an empty datagram, hand back the slot now
+        if (cqe->res == 0) {
+            if (cqe->flags & IORING_CQE_F_BUFFER) {
+                local_provide(rx, (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+                local_publish(rx);
+            }
+            if (rx->is_stream) {
+                rx->did_end = true;
+            }
+            continue;
+        }
+        // No buffer to read from, the receive is rearmed below if it ended
+        if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+            continue;
+        }
+        pp_uring_slot *slot = &slots[count++];
+        slot->id = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        slot->bytes = rx->slots + (size_t)slot->id * rx->slot_len;
+        slot->length = (size_t)cqe->res;
+        ++rx->borrowed;
+    }
+    __atomic_store_n(rx->cq_head, head, __ATOMIC_RELEASE);
+
+    if (count > 0) {
+        if (!local_arm(rx)) {
+            rx->pending_error = rx->last_error;
+        }
+        return (int)count;
+    }
+    if (rx->pending_error) {
+        rx->last_error = rx->pending_error;
+        rx->pending_error = 0;
+        errno = rx->last_error;
+        return -1;
+    }
+    if (rx->did_end) {
+        return 0;
+    }
+    if (!local_arm(rx)) {
+        errno = rx->last_error;
+        return -1;
+    }
+    return PPIOErrorWouldBlock;
+}
+
+void pp_uring_rx_release(pp_uring_rx rx, const pp_uring_slot *slots, size_t count) {
+    bool did_provide = false;
+    for (size_t i = 0; i < count; ++i) {
+        pp_assert(rx->borrowed > 0);
+        local_provide(rx, slots[i].id);
+        --rx->borrowed;
+        did_provide = true;
+    }
+    if (!did_provide) {
+        return;
+    }
+    local_publish(rx);
+    if (!local_arm(rx)) {
+        rx->pending_error = rx->last_error;
+    }
+}
+
+int pp_uring_rx_last_error(pp_uring_rx rx) {
+    return rx->last_error;
+}
+
+#else
+
+pp_uring_rx pp_uring_rx_create(pp_fd fd,
+                               bool is_socket,
+                               bool is_stream,
+                               size_t slot_len,
+                               size_t slot_count) {
+    (void)fd;
+    (void)is_socket;
+    (void)is_stream;
+    (void)slot_len;
+    (void)slot_count;
+    return NULL;
+}
+
+void pp_uring_rx_free(pp_uring_rx rx) {
+    (void)rx;
+}
+
+pp_fd pp_uring_rx_get_watch_fd(pp_uring_rx rx) {
+    (void)rx;
+    pp_assert(false && "io_uring is unavailable");
+    return (pp_fd)(intptr_t)-1;
+}
+
+int pp_uring_rx_read(pp_uring_rx rx, pp_uring_slot *slots, size_t max) {
+    (void)rx;
+    (void)slots;
+    (void)max;
+    return -1;
+}
+
+void pp_uring_rx_release(pp_uring_rx rx, const pp_uring_slot *slots, size_t count) {
+    (void)rx;
+    (void)slots;
+    (void)count;
+}
+
+int pp_uring_rx_last_error(pp_uring_rx rx) {
+    (void)rx;
+    return 0;
+}
+
+#endif
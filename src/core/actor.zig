@@ -11,6 +11,7 @@
 const std = @import("std");
 
 const concurrency = @import("concurrency.zig");
+const logging = @import("logging.zig");
 
 pub fn Actor(
     comptime Context: type,
@@ -202,6 +203,7 @@ pub fn ActorWithFinish(
         }
 
         fn run(self: *Self) void {
+            defer logging.releaseThread();
             defer if (on_finish) |callback| callback(self.context);
 
             self.mutex.lock();
@@ -86,6 +86,7 @@ pub const WireGuardModule = gen.WireGuardModule;
 pub const WireGuardRemoteInterface = gen.WireGuardRemoteInterface;
 
 pub const containsDefaultRoute = extensions.containsDefaultRoute;
+pub const encodeJsonWriter = gen.encodeJsonWriter;
 pub const encodeModule = extensions.encodeModule;
 pub const encodeModuleZ = extensions.encodeModuleZ;
 pub const encodeProfile = extensions.encodeProfile;
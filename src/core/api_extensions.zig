@@ -5,7 +5,6 @@
 const std = @import("std");
 
 const gen = @import("api_generated.zig");
-const util = @import("util.zig");
 const uuid = @import("uuid.zig");
 
 /// Encodes a tagged module as JSON.
@@ -133,10 +132,7 @@ pub fn parseModule(
     allocator: std.mem.Allocator,
     text: []const u8,
 ) gen.DecodeError!gen.TaggedModule {
-    var parsed = try util.parseJsonValue(allocator, text);
-    defer parsed.deinit();
-
-    return gen.TaggedModule.parseValue(allocator, parsed.value);
+    return gen.TaggedModule.parse(allocator, text);
 }
 
 /// Reports whether a module type can establish a tunnel connection by itself.
@@ -70,6 +70,12 @@ pub fn encodeJsonValueZ(allocator: std.mem.Allocator, value: anytype) EncodeErro
     return out.toOwnedSliceSentinel(0) catch error.OutOfMemory;
 }
 
+/// Encodes into a caller-owned writer, e.g. a buffered file or socket
+/// writer, without an intermediate allocation.
+pub fn encodeJsonWriter(writer: *std.Io.Writer, value: anytype) EncodeError!void {
+    std.json.Stringify.value(value, .{}, writer) catch |err| return mapJsonStringifyError(err);
+}
+
 fn mapJsonStringifyError(err: JsonStringifyError) EncodeError {
     return switch (err) {
         error.WriteFailed => error.Stringify,
@@ -258,6 +264,302 @@ fn isNullValue(value: std.json.Value) bool {
     };
 }
 
+// Streaming decoding
+//
+// Generated types read straight from a `std.json.Scanner`, without building
+// a `std.json.Value` tree first. Manual types that are not strings, flattened
+// unions and values of wrapped unions preceding their discriminator still
+// go through a tree, limited to their subtree and freed right after.
+
+const JsonString = struct {
+    bytes: []const u8,
+    owned: bool,
+
+    fn deinit(self: JsonString, allocator: std.mem.Allocator) void {
+        if (self.owned) allocator.free(self.bytes);
+    }
+};
+
+fn parseJsonText(comptime T: type, allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!T {
+    var source = std.json.Scanner.initCompleteInput(allocator, text);
+    defer source.deinit();
+    var result = try parseTokens(T, allocator, &source, error_info);
+    errdefer deinitJson(T, allocator, &result);
+    const token = source.next() catch return error.InvalidJson;
+    return switch (token) {
+        .end_of_document => result,
+        else => error.InvalidJson,
+    };
+}
+
+fn parseTokens(comptime T: type, allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!T {
+    if (comptime T == uuid.UUID) {
+        const raw = try nextJsonString(allocator, source) orelse return error.InvalidModel;
+        defer raw.deinit(allocator);
+        return uuid.parse(raw.bytes) orelse error.InvalidModel;
+    }
+
+    if (comptime std.meta.hasFn(T, "parseTokensWithErrorInfo")) {
+        return T.parseTokensWithErrorInfo(allocator, source, error_info);
+    }
+
+    if (comptime std.meta.hasFn(T, "parseFromRaw")) {
+        return parseEnumTokens(T, allocator, source);
+    }
+
+    if (comptime std.meta.hasFn(T, "parseValueWithErrorInfo") or std.meta.hasFn(T, "parseValue")) {
+        // Most manual types are strings, which need no tree
+        const next = source.peekNextTokenType() catch |err| return mapJsonTokenError(err);
+        if (next == .string) {
+            const raw = (try nextJsonString(allocator, source)).?;
+            defer raw.deinit(allocator);
+            return parseJsonWithErrorInfo(T, allocator, .{ .string = raw.bytes }, error_info);
+        }
+        var arena = std.heap.ArenaAllocator.init(allocator);
+        defer arena.deinit();
+        const value = try parseJsonTree(arena.allocator(), source);
+        return parseJsonWithErrorInfo(T, allocator, value, error_info);
+    }
+
+    switch (@typeInfo(T)) {
+        .bool => {
+            const token = try nextJsonToken(allocator, source);
+            defer freeJsonToken(allocator, token);
+            return switch (token) {
+                .true => true,
+                .false => false,
+                else => error.InvalidModel,
+            };
+        },
+        .int, .comptime_int => {
+            const token = try nextJsonToken(allocator, source);
+            defer freeJsonToken(allocator, token);
+            const raw = numberToken(token) orelse return error.InvalidModel;
+            return std.fmt.parseInt(T, raw, 10) catch error.InvalidModel;
+        },
+        .float, .comptime_float => {
+            const token = try nextJsonToken(allocator, source);
+            defer freeJsonToken(allocator, token);
+            const raw = numberToken(token) orelse return error.InvalidModel;
+            return std.fmt.parseFloat(T, raw) catch error.InvalidModel;
+        },
+        .pointer => |pointer| {
+            if (pointer.size != .slice) @compileError("only slices are supported");
+            if (pointer.child == u8) {
+                const raw = try nextJsonString(allocator, source) orelse return error.InvalidModel;
+                if (raw.owned) return raw.bytes;
+                return try allocator.dupe(u8, raw.bytes);
+            }
+            const token = try nextJsonToken(allocator, source);
+            switch (token) {
+                .array_begin => {},
+                else => {
+                    freeJsonToken(allocator, token);
+                    return error.InvalidModel;
+                },
+            }
+            var items: std.ArrayList(pointer.child) = .empty;
+            errdefer {
+                for (items.items) |*item| deinitJson(pointer.child, allocator, item);
+                items.deinit(allocator);
+            }
+            while (true) {
+                const next = source.peekNextTokenType() catch |err| return mapJsonTokenError(err);
+                if (next == .array_end) break;
+                try items.ensureUnusedCapacity(allocator, 1);
+                items.appendAssumeCapacity(try parseTokens(pointer.child, allocator, source, error_info));
+            }
+            _ = source.next() catch |err| return mapJsonTokenError(err);
+            return try items.toOwnedSlice(allocator);
+        },
+        else => @compileError("unsupported generated OpenAPI type: " ++ @typeName(T)),
+    }
+}
+
+fn parseEnumTokens(comptime T: type, allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!T {
+    const Raw = @typeInfo(@TypeOf(T.parseFromRaw)).@"fn".params[0].type.?;
+    if (comptime Raw == []const u8) {
+        const raw = try nextJsonString(allocator, source) orelse return error.InvalidModel;
+        defer raw.deinit(allocator);
+        return T.parseFromRaw(raw.bytes) orelse error.UnsupportedModel;
+    } else {
+        const token = try nextJsonToken(allocator, source);
+        defer freeJsonToken(allocator, token);
+        const raw = numberToken(token) orelse return error.InvalidModel;
+        const raw_value = std.fmt.parseInt(Raw, raw, 10) catch return error.InvalidModel;
+        return T.parseFromRaw(raw_value) orelse error.UnsupportedModel;
+    }
+}
+
+/// Parses a required (`nullable = false`) or optional field value into
+/// `field`, rejecting repeated keys like the tree parser does.
+fn parseTokensField(comptime T: type, comptime nullable: bool, allocator: std.mem.Allocator, source: *std.json.Scanner, field: *?T, key: []const u8, error_info: ?*JsonErrorInfo) DecodeError!void {
+    if (field.* != null) return error.InvalidJson;
+    if (nullable) {
+        const next = source.peekNextTokenType() catch |err| return mapJsonTokenError(err);
+        if (next == .null) return skipJsonValue(source);
+    }
+    field.* = parseTokens(T, allocator, source, error_info) catch |err| {
+        setJsonErrorKeyForError(error_info, key, err);
+        return err;
+    };
+}
+
+fn missingJsonField(error_info: ?*JsonErrorInfo, key: []const u8) DecodeError {
+    setJsonErrorKey(error_info, key);
+    return error.InvalidModel;
+}
+
+/// A wrapped union object, read up to the value of its variant.
+///
+/// The value is left in the scanner when the discriminator precedes it, as
+/// in encoded output, and held as a tree otherwise.
+const TaggedJsonObject = struct {
+    allocator: std.mem.Allocator,
+    source: *std.json.Scanner,
+    discriminator: []const u8,
+    value_key: []const u8,
+    raw_type: JsonString,
+    at_value: bool,
+    arena: std.heap.ArenaAllocator,
+    held_value: ?std.json.Value,
+
+    fn begin(allocator: std.mem.Allocator, source: *std.json.Scanner, discriminator: []const u8, value_key: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TaggedJsonObject {
+        try beginJsonObject(allocator, source);
+        var arena = std.heap.ArenaAllocator.init(allocator);
+        errdefer arena.deinit();
+        var raw_type: ?JsonString = null;
+        errdefer if (raw_type) |value| value.deinit(allocator);
+        var held_value: ?std.json.Value = null;
+        var at_value = false;
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, discriminator)) {
+                if (raw_type != null) return error.InvalidJson;
+                raw_type = try nextJsonString(allocator, source) orelse {
+                    setJsonErrorKey(error_info, discriminator);
+                    return error.InvalidModel;
+                };
+            } else if (std.mem.eql(u8, key.bytes, value_key)) {
+                if (held_value != null) return error.InvalidJson;
+                if (raw_type != null) {
+                    at_value = true;
+                    break;
+                }
+                held_value = try parseJsonTree(arena.allocator(), source);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .allocator = allocator,
+            .source = source,
+            .discriminator = discriminator,
+            .value_key = value_key,
+            .raw_type = raw_type orelse return missingJsonField(error_info, discriminator),
+            .at_value = at_value,
+            .arena = arena,
+            .held_value = held_value,
+        };
+    }
+
+    fn deinit(self: *TaggedJsonObject) void {
+        self.raw_type.deinit(self.allocator);
+        self.arena.deinit();
+    }
+
+    fn parseValue(self: *TaggedJsonObject, comptime T: type, error_info: ?*JsonErrorInfo) DecodeError!T {
+        if (!self.at_value) {
+            const value = self.held_value orelse return missingJsonField(error_info, self.value_key);
+            return parseJsonWithErrorInfo(T, self.allocator, value, error_info) catch |err| {
+                setJsonErrorKeyForError(error_info, self.value_key, err);
+                return err;
+            };
+        }
+        var result = parseTokens(T, self.allocator, self.source, error_info) catch |err| {
+            setJsonErrorKeyForError(error_info, self.value_key, err);
+            return err;
+        };
+        errdefer deinitJson(T, self.allocator, &result);
+        while (try nextJsonObjectKey(self.allocator, self.source)) |key| {
+            defer key.deinit(self.allocator);
+            if (std.mem.eql(u8, key.bytes, self.discriminator) or std.mem.eql(u8, key.bytes, self.value_key)) {
+                return error.InvalidJson;
+            }
+            try skipJsonValue(self.source);
+        }
+        return result;
+    }
+};
+
+fn parseJsonTree(arena: std.mem.Allocator, source: *std.json.Scanner) DecodeError!std.json.Value {
+    return std.json.innerParse(std.json.Value, arena, source, .{
+        .max_value_len = std.json.default_max_value_len,
+        .allocate = .alloc_always,
+        .parse_numbers = false,
+    }) catch |err| mapJsonTokenError(err);
+}
+
+fn beginJsonObject(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!void {
+    const token = try nextJsonToken(allocator, source);
+    defer freeJsonToken(allocator, token);
+    switch (token) {
+        .object_begin => {},
+        else => return error.InvalidModel,
+    }
+}
+
+fn nextJsonObjectKey(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!?JsonString {
+    return switch (try nextJsonToken(allocator, source)) {
+        .object_end => null,
+        .string => |bytes| .{ .bytes = bytes, .owned = false },
+        .allocated_string => |bytes| .{ .bytes = bytes, .owned = true },
+        else => error.InvalidJson,
+    };
+}
+
+fn nextJsonString(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!?JsonString {
+    const token = try nextJsonToken(allocator, source);
+    return switch (token) {
+        .string => |bytes| .{ .bytes = bytes, .owned = false },
+        .allocated_string => |bytes| .{ .bytes = bytes, .owned = true },
+        else => {
+            freeJsonToken(allocator, token);
+            return null;
+        },
+    };
+}
+
+fn nextJsonToken(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!std.json.Token {
+    return source.nextAllocMax(allocator, .alloc_if_needed, std.json.default_max_value_len) catch |err| mapJsonTokenError(err);
+}
+
+fn freeJsonToken(allocator: std.mem.Allocator, token: std.json.Token) void {
+    switch (token) {
+        .allocated_number, .allocated_string => |bytes| allocator.free(bytes),
+        else => {},
+    }
+}
+
+fn numberToken(token: std.json.Token) ?[]const u8 {
+    return switch (token) {
+        .number => |bytes| bytes,
+        .allocated_number => |bytes| bytes,
+        else => null,
+    };
+}
+
+fn skipJsonValue(source: *std.json.Scanner) DecodeError!void {
+    source.skipValue() catch |err| return mapJsonTokenError(err);
+}
+
+fn mapJsonTokenError(err: anyerror) DecodeError {
+    return switch (err) {
+        error.OutOfMemory => error.OutOfMemory,
+        else => error.InvalidJson,
+    };
+}
+
 pub const ABIErrorPayload = struct {
     code: PartoutErrorCode,
     user_info: ?RawJsonValue = null,
@@ -268,9 +570,7 @@ pub const ABIErrorPayload = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!ABIErrorPayload {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(ABIErrorPayload, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!ABIErrorPayload {
@@ -292,6 +592,28 @@ pub const ABIErrorPayload = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!ABIErrorPayload {
+        try beginJsonObject(allocator, source);
+        var field_0: ?PartoutErrorCode = null;
+        errdefer if (field_0) |*value| deinitJson(PartoutErrorCode, allocator, value);
+        var field_1: ?RawJsonValue = null;
+        errdefer if (field_1) |*value| deinitJson(RawJsonValue, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "code")) {
+                try parseTokensField(PartoutErrorCode, false, allocator, source, &field_0, "code", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "userInfo")) {
+                try parseTokensField(RawJsonValue, true, allocator, source, &field_1, "userInfo", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .code = field_0 orelse return missingJsonField(error_info, "code"),
+            .user_info = field_1,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -325,9 +647,7 @@ pub const ParseErrorInfo = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!ParseErrorInfo {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(ParseErrorInfo, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!ParseErrorInfo {
@@ -344,6 +664,28 @@ pub const ParseErrorInfo = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!ParseErrorInfo {
+        try beginJsonObject(allocator, source);
+        var field_0: ?[]const u8 = null;
+        errdefer if (field_0) |*value| deinitJson([]const u8, allocator, value);
+        var field_1: ?[]const u8 = null;
+        errdefer if (field_1) |*value| deinitJson([]const u8, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "name")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_0, "name", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "details")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_1, "details", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .name = field_0 orelse return missingJsonField(error_info, "name"),
+            .details = field_1 orelse return missingJsonField(error_info, "details"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -414,9 +756,7 @@ pub const DNSModule = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!DNSModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(DNSModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!DNSModule {
@@ -439,6 +779,58 @@ pub const DNSModule = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!DNSModule {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?DNSModuleProtocolType = null;
+        errdefer if (field_1) |*value| deinitJson(DNSModuleProtocolType, allocator, value);
+        var field_2: ?[]const manual.Address = null;
+        errdefer if (field_2) |*value| deinitJson([]const manual.Address, allocator, value);
+        var field_3: ?manual.Address = null;
+        errdefer if (field_3) |*value| deinitJson(manual.Address, allocator, value);
+        var field_4: ?[]const manual.Address = null;
+        errdefer if (field_4) |*value| deinitJson([]const manual.Address, allocator, value);
+        var field_5: ?bool = null;
+        errdefer if (field_5) |*value| deinitJson(bool, allocator, value);
+        var field_6: ?DNSModuleDomainPolicy = null;
+        errdefer if (field_6) |*value| deinitJson(DNSModuleDomainPolicy, allocator, value);
+        var field_7: ?bool = null;
+        errdefer if (field_7) |*value| deinitJson(bool, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "protocolType")) {
+                try parseTokensField(DNSModuleProtocolType, false, allocator, source, &field_1, "protocolType", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "servers")) {
+                try parseTokensField([]const manual.Address, false, allocator, source, &field_2, "servers", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "domainName")) {
+                try parseTokensField(manual.Address, true, allocator, source, &field_3, "domainName", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "searchDomains")) {
+                try parseTokensField([]const manual.Address, true, allocator, source, &field_4, "searchDomains", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "inheritsVPN")) {
+                try parseTokensField(bool, true, allocator, source, &field_5, "inheritsVPN", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "domainPolicy")) {
+                try parseTokensField(DNSModuleDomainPolicy, true, allocator, source, &field_6, "domainPolicy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "routesThroughVPN")) {
+                try parseTokensField(bool, true, allocator, source, &field_7, "routesThroughVPN", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .protocol_type = field_1 orelse return missingJsonField(error_info, "protocolType"),
+            .servers = field_2 orelse return missingJsonField(error_info, "servers"),
+            .domain_name = field_3,
+            .search_domains = field_4,
+            .inherits_vpn = field_5,
+            .domain_policy = field_6,
+            .routes_through_vpn = field_7,
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -522,9 +914,7 @@ pub const DNSModuleProtocolTypeCleartext = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolTypeCleartext {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(DNSModuleProtocolTypeCleartext, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!DNSModuleProtocolTypeCleartext {
@@ -539,6 +929,16 @@ pub const DNSModuleProtocolTypeCleartext = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolTypeCleartext {
+        try beginJsonObject(allocator, source);
+        _ = error_info;
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            key.deinit(allocator);
+            try skipJsonValue(source);
+        }
+        return .{};
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -566,9 +966,7 @@ pub const DNSModuleProtocolTypeHttps = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolTypeHttps {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(DNSModuleProtocolTypeHttps, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!DNSModuleProtocolTypeHttps {
@@ -584,6 +982,23 @@ pub const DNSModuleProtocolTypeHttps = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolTypeHttps {
+        try beginJsonObject(allocator, source);
+        var field_0: ?[]const u8 = null;
+        errdefer if (field_0) |*value| deinitJson([]const u8, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "url")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_0, "url", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .url = field_0 orelse return missingJsonField(error_info, "url"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -611,9 +1026,7 @@ pub const DNSModuleProtocolTypeTls = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolTypeTls {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(DNSModuleProtocolTypeTls, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!DNSModuleProtocolTypeTls {
@@ -629,6 +1042,23 @@ pub const DNSModuleProtocolTypeTls = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolTypeTls {
+        try beginJsonObject(allocator, source);
+        var field_0: ?[]const u8 = null;
+        errdefer if (field_0) |*value| deinitJson([]const u8, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "hostname")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_0, "hostname", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .hostname = field_0 orelse return missingJsonField(error_info, "hostname"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -658,9 +1088,7 @@ pub const DNSModuleProtocolType = union(enum) {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!DNSModuleProtocolType {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(DNSModuleProtocolType, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!DNSModuleProtocolType {
@@ -764,9 +1192,7 @@ pub const DataCount = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!DataCount {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(DataCount, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!DataCount {
@@ -783,6 +1209,28 @@ pub const DataCount = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!DataCount {
+        try beginJsonObject(allocator, source);
+        var field_0: ?u64 = null;
+        errdefer if (field_0) |*value| deinitJson(u64, allocator, value);
+        var field_1: ?u64 = null;
+        errdefer if (field_1) |*value| deinitJson(u64, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "received")) {
+                try parseTokensField(u64, false, allocator, source, &field_0, "received", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "sent")) {
+                try parseTokensField(u64, false, allocator, source, &field_1, "sent", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .received = field_0 orelse return missingJsonField(error_info, "received"),
+            .sent = field_1 orelse return missingJsonField(error_info, "sent"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -817,9 +1265,7 @@ pub const HTTPProxyModule = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!HTTPProxyModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(HTTPProxyModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!HTTPProxyModule {
@@ -839,6 +1285,43 @@ pub const HTTPProxyModule = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!HTTPProxyModule {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?manual.Endpoint = null;
+        errdefer if (field_1) |*value| deinitJson(manual.Endpoint, allocator, value);
+        var field_2: ?manual.Endpoint = null;
+        errdefer if (field_2) |*value| deinitJson(manual.Endpoint, allocator, value);
+        var field_3: ?[]const u8 = null;
+        errdefer if (field_3) |*value| deinitJson([]const u8, allocator, value);
+        var field_4: ?[]const manual.Address = null;
+        errdefer if (field_4) |*value| deinitJson([]const manual.Address, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "proxy")) {
+                try parseTokensField(manual.Endpoint, true, allocator, source, &field_1, "proxy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "secureProxy")) {
+                try parseTokensField(manual.Endpoint, true, allocator, source, &field_2, "secureProxy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "pacURL")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_3, "pacURL", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "bypassDomains")) {
+                try parseTokensField([]const manual.Address, false, allocator, source, &field_4, "bypassDomains", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .proxy = field_1,
+            .secure_proxy = field_2,
+            .pac_url = field_3,
+            .bypass_domains = field_4 orelse return missingJsonField(error_info, "bypassDomains"),
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -887,9 +1370,7 @@ pub const IPModule = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!IPModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(IPModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!IPModule {
@@ -908,6 +1389,38 @@ pub const IPModule = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!IPModule {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?IPSettings = null;
+        errdefer if (field_1) |*value| deinitJson(IPSettings, allocator, value);
+        var field_2: ?IPSettings = null;
+        errdefer if (field_2) |*value| deinitJson(IPSettings, allocator, value);
+        var field_3: ?i32 = null;
+        errdefer if (field_3) |*value| deinitJson(i32, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "ipv4")) {
+                try parseTokensField(IPSettings, true, allocator, source, &field_1, "ipv4", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "ipv6")) {
+                try parseTokensField(IPSettings, true, allocator, source, &field_2, "ipv6", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "mtu")) {
+                try parseTokensField(i32, true, allocator, source, &field_3, "mtu", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .ipv4 = field_1,
+            .ipv6 = field_2,
+            .mtu = field_3,
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -952,9 +1465,7 @@ pub const IPSettings = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!IPSettings {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(IPSettings, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!IPSettings {
@@ -972,6 +1483,33 @@ pub const IPSettings = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!IPSettings {
+        try beginJsonObject(allocator, source);
+        var field_0: ?[]const manual.Subnet = null;
+        errdefer if (field_0) |*value| deinitJson([]const manual.Subnet, allocator, value);
+        var field_1: ?[]const Route = null;
+        errdefer if (field_1) |*value| deinitJson([]const Route, allocator, value);
+        var field_2: ?[]const Route = null;
+        errdefer if (field_2) |*value| deinitJson([]const Route, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "subnets")) {
+                try parseTokensField([]const manual.Subnet, false, allocator, source, &field_0, "subnets", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "includedRoutes")) {
+                try parseTokensField([]const Route, false, allocator, source, &field_1, "includedRoutes", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "excludedRoutes")) {
+                try parseTokensField([]const Route, false, allocator, source, &field_2, "excludedRoutes", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .subnets = field_0 orelse return missingJsonField(error_info, "subnets"),
+            .included_routes = field_1 orelse return missingJsonField(error_info, "includedRoutes"),
+            .excluded_routes = field_2 orelse return missingJsonField(error_info, "excludedRoutes"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1097,9 +1635,7 @@ pub const OnDemandModule = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OnDemandModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OnDemandModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OnDemandModule {
@@ -1123,6 +1659,38 @@ pub const OnDemandModule = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OnDemandModule {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?OnDemandModulePolicy = null;
+        errdefer if (field_1) |*value| deinitJson(OnDemandModulePolicy, allocator, value);
+        var field_2: ?RawJsonValue = null;
+        errdefer if (field_2) |*value| deinitJson(RawJsonValue, allocator, value);
+        var field_3: ?[]const OnDemandModuleOtherNetwork = null;
+        errdefer if (field_3) |*value| deinitJson([]const OnDemandModuleOtherNetwork, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "policy")) {
+                try parseTokensField(OnDemandModulePolicy, false, allocator, source, &field_1, "policy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "withSSIDs")) {
+                try parseTokensField(RawJsonValue, false, allocator, source, &field_2, "withSSIDs", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "withOtherNetworks")) {
+                try parseTokensField([]const OnDemandModuleOtherNetwork, false, allocator, source, &field_3, "withOtherNetworks", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .policy = field_1 orelse return missingJsonField(error_info, "policy"),
+            .with_ssids = field_2 orelse return missingJsonField(error_info, "withSSIDs"),
+            .with_other_networks = field_3 orelse return missingJsonField(error_info, "withOtherNetworks"),
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1362,9 +1930,7 @@ pub const OpenVPNConfiguration = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNConfiguration {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNConfiguration, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNConfiguration {
@@ -1420,6 +1986,223 @@ pub const OpenVPNConfiguration = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNConfiguration {
+        try beginJsonObject(allocator, source);
+        var field_0: ?OpenVPNCipher = null;
+        errdefer if (field_0) |*value| deinitJson(OpenVPNCipher, allocator, value);
+        var field_1: ?[]const OpenVPNCipher = null;
+        errdefer if (field_1) |*value| deinitJson([]const OpenVPNCipher, allocator, value);
+        var field_2: ?OpenVPNDigest = null;
+        errdefer if (field_2) |*value| deinitJson(OpenVPNDigest, allocator, value);
+        var field_3: ?OpenVPNCompressionFraming = null;
+        errdefer if (field_3) |*value| deinitJson(OpenVPNCompressionFraming, allocator, value);
+        var field_4: ?OpenVPNCompressionAlgorithm = null;
+        errdefer if (field_4) |*value| deinitJson(OpenVPNCompressionAlgorithm, allocator, value);
+        var field_5: ?manual.OpenVPNCryptoContainer = null;
+        errdefer if (field_5) |*value| deinitJson(manual.OpenVPNCryptoContainer, allocator, value);
+        var field_6: ?manual.OpenVPNCryptoContainer = null;
+        errdefer if (field_6) |*value| deinitJson(manual.OpenVPNCryptoContainer, allocator, value);
+        var field_7: ?manual.OpenVPNCryptoContainer = null;
+        errdefer if (field_7) |*value| deinitJson(manual.OpenVPNCryptoContainer, allocator, value);
+        var field_8: ?OpenVPNTLSWrap = null;
+        errdefer if (field_8) |*value| deinitJson(OpenVPNTLSWrap, allocator, value);
+        var field_9: ?i32 = null;
+        errdefer if (field_9) |*value| deinitJson(i32, allocator, value);
+        var field_10: ?f64 = null;
+        errdefer if (field_10) |*value| deinitJson(f64, allocator, value);
+        var field_11: ?f64 = null;
+        errdefer if (field_11) |*value| deinitJson(f64, allocator, value);
+        var field_12: ?f64 = null;
+        errdefer if (field_12) |*value| deinitJson(f64, allocator, value);
+        var field_13: ?[]const manual.ExtendedEndpoint = null;
+        errdefer if (field_13) |*value| deinitJson([]const manual.ExtendedEndpoint, allocator, value);
+        var field_14: ?bool = null;
+        errdefer if (field_14) |*value| deinitJson(bool, allocator, value);
+        var field_15: ?bool = null;
+        errdefer if (field_15) |*value| deinitJson(bool, allocator, value);
+        var field_16: ?[]const u8 = null;
+        errdefer if (field_16) |*value| deinitJson([]const u8, allocator, value);
+        var field_17: ?bool = null;
+        errdefer if (field_17) |*value| deinitJson(bool, allocator, value);
+        var field_18: ?bool = null;
+        errdefer if (field_18) |*value| deinitJson(bool, allocator, value);
+        var field_19: ?bool = null;
+        errdefer if (field_19) |*value| deinitJson(bool, allocator, value);
+        var field_20: ?i32 = null;
+        errdefer if (field_20) |*value| deinitJson(i32, allocator, value);
+        var field_21: ?bool = null;
+        errdefer if (field_21) |*value| deinitJson(bool, allocator, value);
+        var field_22: ?bool = null;
+        errdefer if (field_22) |*value| deinitJson(bool, allocator, value);
+        var field_23: ?[]const u8 = null;
+        errdefer if (field_23) |*value| deinitJson([]const u8, allocator, value);
+        var field_24: ?u32 = null;
+        errdefer if (field_24) |*value| deinitJson(u32, allocator, value);
+        var field_25: ?IPSettings = null;
+        errdefer if (field_25) |*value| deinitJson(IPSettings, allocator, value);
+        var field_26: ?IPSettings = null;
+        errdefer if (field_26) |*value| deinitJson(IPSettings, allocator, value);
+        var field_27: ?[]const Route = null;
+        errdefer if (field_27) |*value| deinitJson([]const Route, allocator, value);
+        var field_28: ?[]const Route = null;
+        errdefer if (field_28) |*value| deinitJson([]const Route, allocator, value);
+        var field_29: ?manual.Address = null;
+        errdefer if (field_29) |*value| deinitJson(manual.Address, allocator, value);
+        var field_30: ?manual.Address = null;
+        errdefer if (field_30) |*value| deinitJson(manual.Address, allocator, value);
+        var field_31: ?[]const []const u8 = null;
+        errdefer if (field_31) |*value| deinitJson([]const []const u8, allocator, value);
+        var field_32: ?[]const u8 = null;
+        errdefer if (field_32) |*value| deinitJson([]const u8, allocator, value);
+        var field_33: ?[]const []const u8 = null;
+        errdefer if (field_33) |*value| deinitJson([]const []const u8, allocator, value);
+        var field_34: ?manual.Endpoint = null;
+        errdefer if (field_34) |*value| deinitJson(manual.Endpoint, allocator, value);
+        var field_35: ?manual.Endpoint = null;
+        errdefer if (field_35) |*value| deinitJson(manual.Endpoint, allocator, value);
+        var field_36: ?[]const u8 = null;
+        errdefer if (field_36) |*value| deinitJson([]const u8, allocator, value);
+        var field_37: ?[]const []const u8 = null;
+        errdefer if (field_37) |*value| deinitJson([]const []const u8, allocator, value);
+        var field_38: ?[]const OpenVPNRoutingPolicy = null;
+        errdefer if (field_38) |*value| deinitJson([]const OpenVPNRoutingPolicy, allocator, value);
+        var field_39: ?[]const OpenVPNPullMask = null;
+        errdefer if (field_39) |*value| deinitJson([]const OpenVPNPullMask, allocator, value);
+        var field_40: ?OpenVPNObfuscationMethod = null;
+        errdefer if (field_40) |*value| deinitJson(OpenVPNObfuscationMethod, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "cipher")) {
+                try parseTokensField(OpenVPNCipher, true, allocator, source, &field_0, "cipher", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "dataCiphers")) {
+                try parseTokensField([]const OpenVPNCipher, true, allocator, source, &field_1, "dataCiphers", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "digest")) {
+                try parseTokensField(OpenVPNDigest, true, allocator, source, &field_2, "digest", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "compressionFraming")) {
+                try parseTokensField(OpenVPNCompressionFraming, true, allocator, source, &field_3, "compressionFraming", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "compressionAlgorithm")) {
+                try parseTokensField(OpenVPNCompressionAlgorithm, true, allocator, source, &field_4, "compressionAlgorithm", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "ca")) {
+                try parseTokensField(manual.OpenVPNCryptoContainer, true, allocator, source, &field_5, "ca", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "clientCertificate")) {
+                try parseTokensField(manual.OpenVPNCryptoContainer, true, allocator, source, &field_6, "clientCertificate", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "clientKey")) {
+                try parseTokensField(manual.OpenVPNCryptoContainer, true, allocator, source, &field_7, "clientKey", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "tlsWrap")) {
+                try parseTokensField(OpenVPNTLSWrap, true, allocator, source, &field_8, "tlsWrap", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "tlsSecurityLevel")) {
+                try parseTokensField(i32, true, allocator, source, &field_9, "tlsSecurityLevel", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "keepAliveInterval")) {
+                try parseTokensField(f64, true, allocator, source, &field_10, "keepAliveInterval", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "keepAliveTimeout")) {
+                try parseTokensField(f64, true, allocator, source, &field_11, "keepAliveTimeout", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "renegotiatesAfter")) {
+                try parseTokensField(f64, true, allocator, source, &field_12, "renegotiatesAfter", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "remotes")) {
+                try parseTokensField([]const manual.ExtendedEndpoint, true, allocator, source, &field_13, "remotes", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "checksEKU")) {
+                try parseTokensField(bool, true, allocator, source, &field_14, "checksEKU", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "checksSANHost")) {
+                try parseTokensField(bool, true, allocator, source, &field_15, "checksSANHost", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "sanHost")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_16, "sanHost", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "randomizeEndpoint")) {
+                try parseTokensField(bool, true, allocator, source, &field_17, "randomizeEndpoint", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "randomizeHostnames")) {
+                try parseTokensField(bool, true, allocator, source, &field_18, "randomizeHostnames", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "usesPIAPatches")) {
+                try parseTokensField(bool, true, allocator, source, &field_19, "usesPIAPatches", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "mtu")) {
+                try parseTokensField(i32, true, allocator, source, &field_20, "mtu", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "authUserPass")) {
+                try parseTokensField(bool, true, allocator, source, &field_21, "authUserPass", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "staticChallenge")) {
+                try parseTokensField(bool, true, allocator, source, &field_22, "staticChallenge", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "authToken")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_23, "authToken", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "peerId")) {
+                try parseTokensField(u32, true, allocator, source, &field_24, "peerId", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "ipv4")) {
+                try parseTokensField(IPSettings, true, allocator, source, &field_25, "ipv4", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "ipv6")) {
+                try parseTokensField(IPSettings, true, allocator, source, &field_26, "ipv6", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "routes4")) {
+                try parseTokensField([]const Route, true, allocator, source, &field_27, "routes4", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "routes6")) {
+                try parseTokensField([]const Route, true, allocator, source, &field_28, "routes6", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "routeGateway4")) {
+                try parseTokensField(manual.Address, true, allocator, source, &field_29, "routeGateway4", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "routeGateway6")) {
+                try parseTokensField(manual.Address, true, allocator, source, &field_30, "routeGateway6", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "dnsServers")) {
+                try parseTokensField([]const []const u8, true, allocator, source, &field_31, "dnsServers", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "dnsDomain")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_32, "dnsDomain", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "searchDomains")) {
+                try parseTokensField([]const []const u8, true, allocator, source, &field_33, "searchDomains", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "httpProxy")) {
+                try parseTokensField(manual.Endpoint, true, allocator, source, &field_34, "httpProxy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "httpsProxy")) {
+                try parseTokensField(manual.Endpoint, true, allocator, source, &field_35, "httpsProxy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "proxyAutoConfigurationURL")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_36, "proxyAutoConfigurationURL", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "proxyBypassDomains")) {
+                try parseTokensField([]const []const u8, true, allocator, source, &field_37, "proxyBypassDomains", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "routingPolicies")) {
+                try parseTokensField([]const OpenVPNRoutingPolicy, true, allocator, source, &field_38, "routingPolicies", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "noPullMask")) {
+                try parseTokensField([]const OpenVPNPullMask, true, allocator, source, &field_39, "noPullMask", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "xorMethod")) {
+                try parseTokensField(OpenVPNObfuscationMethod, true, allocator, source, &field_40, "xorMethod", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .cipher = field_0,
+            .data_ciphers = field_1,
+            .digest = field_2,
+            .compression_framing = field_3,
+            .compression_algorithm = field_4,
+            .ca = field_5,
+            .client_certificate = field_6,
+            .client_key = field_7,
+            .tls_wrap = field_8,
+            .tls_security_level = field_9,
+            .keep_alive_interval = field_10,
+            .keep_alive_timeout = field_11,
+            .renegotiates_after = field_12,
+            .remotes = field_13,
+            .checks_eku = field_14,
+            .checks_san_host = field_15,
+            .san_host = field_16,
+            .randomize_endpoint = field_17,
+            .randomize_hostnames = field_18,
+            .uses_pia_patches = field_19,
+            .mtu = field_20,
+            .auth_user_pass = field_21,
+            .static_challenge = field_22,
+            .auth_token = field_23,
+            .peer_id = field_24,
+            .ipv4 = field_25,
+            .ipv6 = field_26,
+            .routes4 = field_27,
+            .routes6 = field_28,
+            .route_gateway4 = field_29,
+            .route_gateway6 = field_30,
+            .dns_servers = field_31,
+            .dns_domain = field_32,
+            .search_domains = field_33,
+            .http_proxy = field_34,
+            .https_proxy = field_35,
+            .proxy_auto_configuration_url = field_36,
+            .proxy_bypass_domains = field_37,
+            .routing_policies = field_38,
+            .no_pull_mask = field_39,
+            .xor_method = field_40,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1652,9 +2435,7 @@ pub const OpenVPNCredentials = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNCredentials {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNCredentials, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNCredentials {
@@ -1678,6 +2459,38 @@ pub const OpenVPNCredentials = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNCredentials {
+        try beginJsonObject(allocator, source);
+        var field_0: ?[]const u8 = null;
+        errdefer if (field_0) |*value| deinitJson([]const u8, allocator, value);
+        var field_1: ?[]const u8 = null;
+        errdefer if (field_1) |*value| deinitJson([]const u8, allocator, value);
+        var field_2: ?OpenVPNCredentialsOTPMethod = null;
+        errdefer if (field_2) |*value| deinitJson(OpenVPNCredentialsOTPMethod, allocator, value);
+        var field_3: ?[]const u8 = null;
+        errdefer if (field_3) |*value| deinitJson([]const u8, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "username")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_0, "username", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "password")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_1, "password", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "otpMethod")) {
+                try parseTokensField(OpenVPNCredentialsOTPMethod, false, allocator, source, &field_2, "otpMethod", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "otp")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_3, "otp", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .username = field_0 orelse return missingJsonField(error_info, "username"),
+            .password = field_1 orelse return missingJsonField(error_info, "password"),
+            .otp_method = field_2 orelse return missingJsonField(error_info, "otpMethod"),
+            .otp = field_3,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1782,9 +2595,7 @@ pub const OpenVPNObfuscationMethodObfuscate = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodObfuscate {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNObfuscationMethodObfuscate, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNObfuscationMethodObfuscate {
@@ -1800,6 +2611,23 @@ pub const OpenVPNObfuscationMethodObfuscate = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodObfuscate {
+        try beginJsonObject(allocator, source);
+        var field_0: ?manual.SecureData = null;
+        errdefer if (field_0) |*value| deinitJson(manual.SecureData, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "mask")) {
+                try parseTokensField(manual.SecureData, false, allocator, source, &field_0, "mask", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .mask = field_0 orelse return missingJsonField(error_info, "mask"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1825,9 +2653,7 @@ pub const OpenVPNObfuscationMethodReverse = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodReverse {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNObfuscationMethodReverse, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNObfuscationMethodReverse {
@@ -1842,6 +2668,16 @@ pub const OpenVPNObfuscationMethodReverse = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodReverse {
+        try beginJsonObject(allocator, source);
+        _ = error_info;
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            key.deinit(allocator);
+            try skipJsonValue(source);
+        }
+        return .{};
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1869,9 +2705,7 @@ pub const OpenVPNObfuscationMethodXormask = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodXormask {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNObfuscationMethodXormask, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNObfuscationMethodXormask {
@@ -1887,6 +2721,23 @@ pub const OpenVPNObfuscationMethodXormask = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodXormask {
+        try beginJsonObject(allocator, source);
+        var field_0: ?manual.SecureData = null;
+        errdefer if (field_0) |*value| deinitJson(manual.SecureData, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "mask")) {
+                try parseTokensField(manual.SecureData, false, allocator, source, &field_0, "mask", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .mask = field_0 orelse return missingJsonField(error_info, "mask"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1912,9 +2763,7 @@ pub const OpenVPNObfuscationMethodXorptrpos = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodXorptrpos {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNObfuscationMethodXorptrpos, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNObfuscationMethodXorptrpos {
@@ -1929,6 +2778,16 @@ pub const OpenVPNObfuscationMethodXorptrpos = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethodXorptrpos {
+        try beginJsonObject(allocator, source);
+        _ = error_info;
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            key.deinit(allocator);
+            try skipJsonValue(source);
+        }
+        return .{};
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -1959,9 +2818,7 @@ pub const OpenVPNObfuscationMethod = union(enum) {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNObfuscationMethod {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNObfuscationMethod, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNObfuscationMethod {
@@ -2102,9 +2959,7 @@ pub const OpenVPNStaticKey = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNStaticKey {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNStaticKey, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNStaticKey {
@@ -2121,6 +2976,28 @@ pub const OpenVPNStaticKey = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNStaticKey {
+        try beginJsonObject(allocator, source);
+        var field_0: ?manual.SecureData = null;
+        errdefer if (field_0) |*value| deinitJson(manual.SecureData, allocator, value);
+        var field_1: ?OpenVPNStaticKeyDirection = null;
+        errdefer if (field_1) |*value| deinitJson(OpenVPNStaticKeyDirection, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "data")) {
+                try parseTokensField(manual.SecureData, false, allocator, source, &field_0, "data", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "dir")) {
+                try parseTokensField(OpenVPNStaticKeyDirection, true, allocator, source, &field_1, "dir", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .data = field_0 orelse return missingJsonField(error_info, "data"),
+            .dir = field_1,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2184,9 +3061,7 @@ pub const OpenVPNTLSWrap = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNTLSWrap {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNTLSWrap, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNTLSWrap {
@@ -2209,6 +3084,33 @@ pub const OpenVPNTLSWrap = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNTLSWrap {
+        try beginJsonObject(allocator, source);
+        var field_0: ?OpenVPNTLSWrapStrategy = null;
+        errdefer if (field_0) |*value| deinitJson(OpenVPNTLSWrapStrategy, allocator, value);
+        var field_1: ?OpenVPNStaticKey = null;
+        errdefer if (field_1) |*value| deinitJson(OpenVPNStaticKey, allocator, value);
+        var field_2: ?manual.SecureData = null;
+        errdefer if (field_2) |*value| deinitJson(manual.SecureData, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "strategy")) {
+                try parseTokensField(OpenVPNTLSWrapStrategy, false, allocator, source, &field_0, "strategy", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "key")) {
+                try parseTokensField(OpenVPNStaticKey, false, allocator, source, &field_1, "key", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "wrappedKey")) {
+                try parseTokensField(manual.SecureData, true, allocator, source, &field_2, "wrappedKey", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .strategy = field_0 orelse return missingJsonField(error_info, "strategy"),
+            .key = field_1 orelse return missingJsonField(error_info, "key"),
+            .wrapped_key = field_2,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2277,9 +3179,7 @@ pub const OpenVPNModule = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(OpenVPNModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!OpenVPNModule {
@@ -2298,6 +3198,38 @@ pub const OpenVPNModule = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!OpenVPNModule {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?OpenVPNConfiguration = null;
+        errdefer if (field_1) |*value| deinitJson(OpenVPNConfiguration, allocator, value);
+        var field_2: ?OpenVPNCredentials = null;
+        errdefer if (field_2) |*value| deinitJson(OpenVPNCredentials, allocator, value);
+        var field_3: ?bool = null;
+        errdefer if (field_3) |*value| deinitJson(bool, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "configuration")) {
+                try parseTokensField(OpenVPNConfiguration, true, allocator, source, &field_1, "configuration", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "credentials")) {
+                try parseTokensField(OpenVPNCredentials, true, allocator, source, &field_2, "credentials", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "requiresInteractiveCredentials")) {
+                try parseTokensField(bool, true, allocator, source, &field_3, "requiresInteractiveCredentials", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .configuration = field_1,
+            .credentials = field_2,
+            .requires_interactive_credentials = field_3,
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2508,9 +3440,7 @@ pub const Profile = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!Profile {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(Profile, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!Profile {
@@ -2532,6 +3462,53 @@ pub const Profile = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!Profile {
+        try beginJsonObject(allocator, source);
+        var field_0: ?i32 = null;
+        errdefer if (field_0) |*value| deinitJson(i32, allocator, value);
+        var field_1: ?uuid.UUID = null;
+        errdefer if (field_1) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_2: ?[]const u8 = null;
+        errdefer if (field_2) |*value| deinitJson([]const u8, allocator, value);
+        var field_3: ?[]const TaggedModule = null;
+        errdefer if (field_3) |*value| deinitJson([]const TaggedModule, allocator, value);
+        var field_4: ?[]const uuid.UUID = null;
+        errdefer if (field_4) |*value| deinitJson([]const uuid.UUID, allocator, value);
+        var field_5: ?ProfileBehavior = null;
+        errdefer if (field_5) |*value| deinitJson(ProfileBehavior, allocator, value);
+        var field_6: ?RawJsonValue = null;
+        errdefer if (field_6) |*value| deinitJson(RawJsonValue, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "version")) {
+                try parseTokensField(i32, true, allocator, source, &field_0, "version", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_1, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "name")) {
+                try parseTokensField([]const u8, false, allocator, source, &field_2, "name", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "modules")) {
+                try parseTokensField([]const TaggedModule, false, allocator, source, &field_3, "modules", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "activeModulesIds")) {
+                try parseTokensField([]const uuid.UUID, false, allocator, source, &field_4, "activeModulesIds", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "behavior")) {
+                try parseTokensField(ProfileBehavior, true, allocator, source, &field_5, "behavior", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "userInfo")) {
+                try parseTokensField(RawJsonValue, true, allocator, source, &field_6, "userInfo", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .version = field_0,
+            .id = field_1 orelse return missingJsonField(error_info, "id"),
+            .name = field_2 orelse return missingJsonField(error_info, "name"),
+            .modules = field_3 orelse return missingJsonField(error_info, "modules"),
+            .active_modules_ids = field_4 orelse return missingJsonField(error_info, "activeModulesIds"),
+            .behavior = field_5,
+            .user_info = field_6,
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2584,9 +3561,7 @@ pub const ProfileBehavior = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!ProfileBehavior {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(ProfileBehavior, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!ProfileBehavior {
@@ -2603,6 +3578,28 @@ pub const ProfileBehavior = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!ProfileBehavior {
+        try beginJsonObject(allocator, source);
+        var field_0: ?bool = null;
+        errdefer if (field_0) |*value| deinitJson(bool, allocator, value);
+        var field_1: ?bool = null;
+        errdefer if (field_1) |*value| deinitJson(bool, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "disconnectsOnSleep")) {
+                try parseTokensField(bool, false, allocator, source, &field_0, "disconnectsOnSleep", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "includesAllNetworks")) {
+                try parseTokensField(bool, true, allocator, source, &field_1, "includesAllNetworks", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .disconnects_on_sleep = field_0 orelse return missingJsonField(error_info, "disconnectsOnSleep"),
+            .includes_all_networks = field_1,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2636,9 +3633,7 @@ pub const Route = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!Route {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(Route, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!Route {
@@ -2655,6 +3650,28 @@ pub const Route = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!Route {
+        try beginJsonObject(allocator, source);
+        var field_0: ?manual.Subnet = null;
+        errdefer if (field_0) |*value| deinitJson(manual.Subnet, allocator, value);
+        var field_1: ?manual.Address = null;
+        errdefer if (field_1) |*value| deinitJson(manual.Address, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "destination")) {
+                try parseTokensField(manual.Subnet, true, allocator, source, &field_0, "destination", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "gateway")) {
+                try parseTokensField(manual.Address, true, allocator, source, &field_1, "gateway", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .destination = field_0,
+            .gateway = field_1,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2733,9 +3750,7 @@ pub const TaggedModule = union(enum) {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TaggedModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(TaggedModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!TaggedModule {
@@ -2763,6 +3778,20 @@ pub const TaggedModule = union(enum) {
         return error.UnsupportedModel;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!TaggedModule {
+        var object = try TaggedJsonObject.begin(allocator, source, "type", "value", error_info);
+        defer object.deinit();
+        const raw_type = object.raw_type.bytes;
+        if (std.mem.eql(u8, raw_type, "DNS")) return .{ .DNS = try object.parseValue(DNSModule, error_info) };
+        if (std.mem.eql(u8, raw_type, "HTTPProxy")) return .{ .HTTPProxy = try object.parseValue(HTTPProxyModule, error_info) };
+        if (std.mem.eql(u8, raw_type, "IP")) return .{ .IP = try object.parseValue(IPModule, error_info) };
+        if (std.mem.eql(u8, raw_type, "OnDemand")) return .{ .OnDemand = try object.parseValue(OnDemandModule, error_info) };
+        if (std.mem.eql(u8, raw_type, "OpenVPN")) return .{ .OpenVPN = try object.parseValue(OpenVPNModule, error_info) };
+        if (std.mem.eql(u8, raw_type, "WireGuard")) return .{ .WireGuard = try object.parseValue(WireGuardModule, error_info) };
+        setJsonErrorKey(error_info, "type");
+        return error.UnsupportedModel;
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2834,9 +3863,7 @@ pub const TunnelControllerOptions = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TunnelControllerOptions {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(TunnelControllerOptions, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!TunnelControllerOptions {
@@ -2853,6 +3880,28 @@ pub const TunnelControllerOptions = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!TunnelControllerOptions {
+        try beginJsonObject(allocator, source);
+        var field_0: ?[]const []const u8 = null;
+        errdefer if (field_0) |*value| deinitJson([]const []const u8, allocator, value);
+        var field_1: ?bool = null;
+        errdefer if (field_1) |*value| deinitJson(bool, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "dnsFallbackServers")) {
+                try parseTokensField([]const []const u8, false, allocator, source, &field_0, "dnsFallbackServers", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "logsSnapshots")) {
+                try parseTokensField(bool, false, allocator, source, &field_1, "logsSnapshots", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .dns_fallback_servers = field_0 orelse return missingJsonField(error_info, "dnsFallbackServers"),
+            .logs_snapshots = field_1 orelse return missingJsonField(error_info, "logsSnapshots"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2887,9 +3936,7 @@ pub const TunnelRemoteInfoWrapper = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TunnelRemoteInfoWrapper {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(TunnelRemoteInfoWrapper, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!TunnelRemoteInfoWrapper {
@@ -2909,6 +3956,43 @@ pub const TunnelRemoteInfoWrapper = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!TunnelRemoteInfoWrapper {
+        try beginJsonObject(allocator, source);
+        var field_0: ?Profile = null;
+        errdefer if (field_0) |*value| deinitJson(Profile, allocator, value);
+        var field_1: ?uuid.UUID = null;
+        errdefer if (field_1) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_2: ?manual.Address = null;
+        errdefer if (field_2) |*value| deinitJson(manual.Address, allocator, value);
+        var field_3: ?bool = null;
+        errdefer if (field_3) |*value| deinitJson(bool, allocator, value);
+        var field_4: ?[]const TaggedModule = null;
+        errdefer if (field_4) |*value| deinitJson([]const TaggedModule, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "profile")) {
+                try parseTokensField(Profile, false, allocator, source, &field_0, "profile", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "originalModuleId")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_1, "originalModuleId", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "address")) {
+                try parseTokensField(manual.Address, true, allocator, source, &field_2, "address", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "requiresVirtualDevice")) {
+                try parseTokensField(bool, false, allocator, source, &field_3, "requiresVirtualDevice", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "modules")) {
+                try parseTokensField([]const TaggedModule, true, allocator, source, &field_4, "modules", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .profile = field_0 orelse return missingJsonField(error_info, "profile"),
+            .original_module_id = field_1 orelse return missingJsonField(error_info, "originalModuleId"),
+            .address = field_2,
+            .requires_virtual_device = field_3 orelse return missingJsonField(error_info, "requiresVirtualDevice"),
+            .modules = field_4,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -2956,9 +4040,7 @@ pub const TunnelSnapshot = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TunnelSnapshot {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(TunnelSnapshot, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!TunnelSnapshot {
@@ -2983,6 +4065,43 @@ pub const TunnelSnapshot = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!TunnelSnapshot {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?bool = null;
+        errdefer if (field_1) |*value| deinitJson(bool, allocator, value);
+        var field_2: ?TunnelStatus = null;
+        errdefer if (field_2) |*value| deinitJson(TunnelStatus, allocator, value);
+        var field_3: ?bool = null;
+        errdefer if (field_3) |*value| deinitJson(bool, allocator, value);
+        var field_4: ?TunnelSnapshotEnvironment = null;
+        errdefer if (field_4) |*value| deinitJson(TunnelSnapshotEnvironment, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "isEnabled")) {
+                try parseTokensField(bool, false, allocator, source, &field_1, "isEnabled", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "status")) {
+                try parseTokensField(TunnelStatus, false, allocator, source, &field_2, "status", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "onDemand")) {
+                try parseTokensField(bool, false, allocator, source, &field_3, "onDemand", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "environment")) {
+                try parseTokensField(TunnelSnapshotEnvironment, true, allocator, source, &field_4, "environment", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .is_enabled = field_1 orelse return missingJsonField(error_info, "isEnabled"),
+            .status = field_2 orelse return missingJsonField(error_info, "status"),
+            .on_demand = field_3 orelse return missingJsonField(error_info, "onDemand"),
+            .environment = field_4,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -3026,9 +4145,7 @@ pub const TunnelSnapshotEnvironment = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TunnelSnapshotEnvironment {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(TunnelSnapshotEnvironment, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!TunnelSnapshotEnvironment {
@@ -3051,6 +4168,33 @@ pub const TunnelSnapshotEnvironment = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!TunnelSnapshotEnvironment {
+        try beginJsonObject(allocator, source);
+        var field_0: ?ConnectionStatus = null;
+        errdefer if (field_0) |*value| deinitJson(ConnectionStatus, allocator, value);
+        var field_1: ?DataCount = null;
+        errdefer if (field_1) |*value| deinitJson(DataCount, allocator, value);
+        var field_2: ?[]const u8 = null;
+        errdefer if (field_2) |*value| deinitJson([]const u8, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "connectionStatus")) {
+                try parseTokensField(ConnectionStatus, false, allocator, source, &field_0, "connectionStatus", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "dataCount")) {
+                try parseTokensField(DataCount, false, allocator, source, &field_1, "dataCount", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "lastErrorCode")) {
+                try parseTokensField([]const u8, true, allocator, source, &field_2, "lastErrorCode", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .connection_status = field_0 orelse return missingJsonField(error_info, "connectionStatus"),
+            .data_count = field_1 orelse return missingJsonField(error_info, "dataCount"),
+            .last_error_code = field_2,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -3120,9 +4264,7 @@ pub const WireGuardConfiguration = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!WireGuardConfiguration {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(WireGuardConfiguration, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!WireGuardConfiguration {
@@ -3139,6 +4281,28 @@ pub const WireGuardConfiguration = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!WireGuardConfiguration {
+        try beginJsonObject(allocator, source);
+        var field_0: ?WireGuardLocalInterface = null;
+        errdefer if (field_0) |*value| deinitJson(WireGuardLocalInterface, allocator, value);
+        var field_1: ?[]const WireGuardRemoteInterface = null;
+        errdefer if (field_1) |*value| deinitJson([]const WireGuardRemoteInterface, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "interface")) {
+                try parseTokensField(WireGuardLocalInterface, false, allocator, source, &field_0, "interface", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "peers")) {
+                try parseTokensField([]const WireGuardRemoteInterface, false, allocator, source, &field_1, "peers", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .interface = field_0 orelse return missingJsonField(error_info, "interface"),
+            .peers = field_1 orelse return missingJsonField(error_info, "peers"),
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -3173,9 +4337,7 @@ pub const WireGuardLocalInterface = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!WireGuardLocalInterface {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(WireGuardLocalInterface, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!WireGuardLocalInterface {
@@ -3195,6 +4357,43 @@ pub const WireGuardLocalInterface = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!WireGuardLocalInterface {
+        try beginJsonObject(allocator, source);
+        var field_0: ?manual.WireGuardKey = null;
+        errdefer if (field_0) |*value| deinitJson(manual.WireGuardKey, allocator, value);
+        var field_1: ?[]const manual.Subnet = null;
+        errdefer if (field_1) |*value| deinitJson([]const manual.Subnet, allocator, value);
+        var field_2: ?u16 = null;
+        errdefer if (field_2) |*value| deinitJson(u16, allocator, value);
+        var field_3: ?DNSModule = null;
+        errdefer if (field_3) |*value| deinitJson(DNSModule, allocator, value);
+        var field_4: ?u16 = null;
+        errdefer if (field_4) |*value| deinitJson(u16, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "privateKey")) {
+                try parseTokensField(manual.WireGuardKey, false, allocator, source, &field_0, "privateKey", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "addresses")) {
+                try parseTokensField([]const manual.Subnet, false, allocator, source, &field_1, "addresses", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "listenPort")) {
+                try parseTokensField(u16, true, allocator, source, &field_2, "listenPort", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "dns")) {
+                try parseTokensField(DNSModule, true, allocator, source, &field_3, "dns", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "mtu")) {
+                try parseTokensField(u16, true, allocator, source, &field_4, "mtu", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .private_key = field_0 orelse return missingJsonField(error_info, "privateKey"),
+            .addresses = field_1 orelse return missingJsonField(error_info, "addresses"),
+            .listen_port = field_2,
+            .dns = field_3,
+            .mtu = field_4,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -3244,9 +4443,7 @@ pub const WireGuardRemoteInterface = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!WireGuardRemoteInterface {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(WireGuardRemoteInterface, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!WireGuardRemoteInterface {
@@ -3266,6 +4463,43 @@ pub const WireGuardRemoteInterface = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!WireGuardRemoteInterface {
+        try beginJsonObject(allocator, source);
+        var field_0: ?manual.WireGuardKey = null;
+        errdefer if (field_0) |*value| deinitJson(manual.WireGuardKey, allocator, value);
+        var field_1: ?manual.WireGuardKey = null;
+        errdefer if (field_1) |*value| deinitJson(manual.WireGuardKey, allocator, value);
+        var field_2: ?manual.Endpoint = null;
+        errdefer if (field_2) |*value| deinitJson(manual.Endpoint, allocator, value);
+        var field_3: ?[]const manual.Subnet = null;
+        errdefer if (field_3) |*value| deinitJson([]const manual.Subnet, allocator, value);
+        var field_4: ?u16 = null;
+        errdefer if (field_4) |*value| deinitJson(u16, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "publicKey")) {
+                try parseTokensField(manual.WireGuardKey, false, allocator, source, &field_0, "publicKey", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "preSharedKey")) {
+                try parseTokensField(manual.WireGuardKey, true, allocator, source, &field_1, "preSharedKey", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "endpoint")) {
+                try parseTokensField(manual.Endpoint, true, allocator, source, &field_2, "endpoint", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "allowedIPs")) {
+                try parseTokensField([]const manual.Subnet, false, allocator, source, &field_3, "allowedIPs", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "keepAlive")) {
+                try parseTokensField(u16, true, allocator, source, &field_4, "keepAlive", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .public_key = field_0 orelse return missingJsonField(error_info, "publicKey"),
+            .pre_shared_key = field_1,
+            .endpoint = field_2,
+            .allowed_ips = field_3 orelse return missingJsonField(error_info, "allowedIPs"),
+            .keep_alive = field_4,
+        };
+    }
+
     pub fn clone(self: @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -3312,9 +4546,7 @@ pub const WireGuardModule = struct {
 
     pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!WireGuardModule {
         resetJsonErrorInfo(error_info);
-        var parsed = try util.parseJsonValue(allocator, text);
-        defer parsed.deinit();
-        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        return parseJsonText(WireGuardModule, allocator, text, error_info);
     }
 
     pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!WireGuardModule {
@@ -3331,6 +4563,28 @@ pub const WireGuardModule = struct {
         return result;
     }
 
+    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!WireGuardModule {
+        try beginJsonObject(allocator, source);
+        var field_0: ?uuid.UUID = null;
+        errdefer if (field_0) |*value| deinitJson(uuid.UUID, allocator, value);
+        var field_1: ?WireGuardConfiguration = null;
+        errdefer if (field_1) |*value| deinitJson(WireGuardConfiguration, allocator, value);
+        while (try nextJsonObjectKey(allocator, source)) |key| {
+            defer key.deinit(allocator);
+            if (std.mem.eql(u8, key.bytes, "id")) {
+                try parseTokensField(uuid.UUID, false, allocator, source, &field_0, "id", error_info);
+            } else if (std.mem.eql(u8, key.bytes, "configuration")) {
+                try parseTokensField(WireGuardConfiguration, true, allocator, source, &field_1, "configuration", error_info);
+            } else {
+                try skipJsonValue(source);
+            }
+        }
+        return .{
+            .id = field_0 orelse return missingJsonField(error_info, "id"),
+            .configuration = field_1,
+        };
+    }
+
     pub fn clone(self: *const @This(), allocator: std.mem.Allocator) DecodeError!@This() {
         const encoded = try util.encodeJsonValue(allocator, self);
         defer allocator.free(encoded);
@@ -13,6 +13,8 @@
 const builtin = @import("builtin");
 const std = @import("std");
 
+const logging = @import("logging.zig");
+
 /// Exclusive, non-recursive mutex backed by the host operating system.
 ///
 /// A mutex is ready for use as `Mutex{}`. The caller must ensure that it is
@@ -440,6 +442,7 @@ pub const RunAfter = struct {
     /// and serializes callback execution. It exits only after entering
     /// `.stopping`.
     fn run(self: *RunAfter) void {
+        defer logging.releaseThread();
         while (true) {
             self.mutex.lock();
             while (self.state == .idle) {
@@ -956,7 +959,7 @@ fn nanosecondsUntil(deadline_ns: u64, now_ns: u64) u64 {
 ///
 /// Rounding up prevents the scheduler from firing before a sub-millisecond
 /// remainder elapses. A clock jump past the deadline returns zero immediately.
-fn millisecondsUntil(deadline_ns: u64, now_ns: u64) u64 {
+pub fn millisecondsUntil(deadline_ns: u64, now_ns: u64) u64 {
     const remaining_ns = nanosecondsUntil(deadline_ns, now_ns);
     if (remaining_ns == 0) return 0;
     return (remaining_ns - 1) / std.time.ns_per_ms + 1;
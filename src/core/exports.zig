@@ -17,22 +17,31 @@ pub const actor = @import("actor.zig");
 pub const api = @import("api.zig");
 pub const concurrency = @import("concurrency.zig");
 pub const logging = @import("logging.zig");
+pub const memory = @import("memory.zig");
+pub const metrics = @import("metrics.zig");
+pub const prefix_trie = @import("prefix_trie.zig");
+pub const profile_cache = @import("profile_cache.zig");
 pub const util = @import("util.zig");
 
 const registry = @import("registry.zig");
+const timer_wheel = @import("timer_wheel.zig");
 const uuid = @import("uuid.zig");
 
+pub const AccountingAllocator = memory.AccountingAllocator;
 pub const Actor = actor.Actor;
 pub const Condition = concurrency.Condition;
 pub const Drainer = concurrency.Drainer;
 pub const ImportContext = registry.ImportContext;
 pub const ImportError = registry.ImportError;
+pub const Metrics = metrics.Metrics;
 pub const ModuleImplementation = registry.ModuleImplementation;
 pub const Mutex = concurrency.Mutex;
+pub const PrefixTrie = prefix_trie.PrefixTrie;
 pub const Registry = registry.Registry;
 pub const RunAfter = concurrency.RunAfter;
 pub const SerializeError = registry.SerializeError;
 pub const SerializedExecutor = concurrency.SerializedExecutor;
+pub const TimerWheel = timer_wheel.TimerWheel;
 
 pub const isGeneratedId = uuid.isV4;
 pub const newId = uuid.newId;
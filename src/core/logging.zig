@@ -8,6 +8,7 @@ const build_options = @import("build_options");
 
 const api = @import("api.zig");
 const concurrency = @import("concurrency.zig");
+const queue = @import("logging_queue.zig");
 const util = @import("util.zig");
 
 /// Log severity values exposed through the C ABI.
@@ -29,27 +30,35 @@ const Logger = *const fn (
 /// `message` must be a zero-terminated string.
 pub const Callback = ?Logger;
 
-var mutex: concurrency.Mutex = .{};
-var logs_private_data: bool = false;
-var external_logger: Callback = null;
+var max_level = std.atomic.Value(c_int).init(@intFromEnum(Level.debug));
+var logs_private_data = std.atomic.Value(bool).init(false);
+var external_logger = std.atomic.Value(Callback).init(null);
+var pipeline = std.atomic.Value(?*queue.Pipeline).init(null);
+var pipeline_mutex: concurrency.Mutex = .{};
+
+/// Longest `writef` message formatted without heap allocations.
+const stack_message_len = 1024;
 
 /// C ABI entry point used by foreign callers to forward a log message.
 fn partoutLog(
     level: c_int,
     message: [*:0]const u8,
 ) callconv(.c) void {
-    mutex.lock();
-    const logger = external_logger orelse {
-        mutex.unlock();
-        return;
-    };
-    mutex.unlock();
-    dispatchCString(logger, level, message);
+    if (level > max_level.load(.monotonic)) return;
+    const logger = external_logger.load(.acquire) orelse return;
+    deliverCString(logger, level, message);
+}
+
+/// C ABI level check, so that foreign callers skip formatting too.
+fn partoutLogEnabled(level: c_int) callconv(.c) bool {
+    return level <= max_level.load(.monotonic) and
+        external_logger.load(.monotonic) != null;
 }
 
 comptime {
     if (!build_options.legacy_build) {
         @export(&partoutLog, .{ .name = "partout_log" });
+        @export(&partoutLogEnabled, .{ .name = "partout_log_enabled" });
     }
 }
 
@@ -61,32 +70,65 @@ pub fn init(
     private_data: bool,
     logger: Callback,
 ) void {
-    mutex.lock();
-    defer mutex.unlock();
-    logs_private_data = private_data;
-    external_logger = logger;
+    logs_private_data.store(private_data, .release);
+    external_logger.store(logger, .release);
 }
 
 /// Resets global logging state to its disabled defaults.
 pub fn deinit() void {
-    mutex.lock();
-    defer mutex.unlock();
-    logs_private_data = false;
-    external_logger = null;
+    logs_private_data.store(false, .release);
+    external_logger.store(null, .release);
+    max_level.store(@intFromEnum(Level.debug), .release);
+}
+
+/// Drops the messages less severe than `level` before formatting them.
+pub fn setLevel(level: Level) void {
+    max_level.store(@intFromEnum(level), .release);
+}
+
+/// Reports whether messages at `level` reach the host logger.
+pub fn isEnabled(level: Level) bool {
+    return @intFromEnum(level) <= max_level.load(.monotonic) and
+        external_logger.load(.monotonic) != null;
+}
+
+/// Delivers the messages to the host logger on a background thread from
+/// now on, rather than on the logging thread. Calling this function more
+/// than once is harmless. Delivery stays asynchronous until process exit.
+pub fn startAsync(options: queue.Pipeline.Options) (std.mem.Allocator.Error || std.Thread.SpawnError)!void {
+    pipeline_mutex.lock();
+    defer pipeline_mutex.unlock();
+    if (pipeline.load(.acquire) != null) return;
+    const value = try queue.Pipeline.create(std.heap.c_allocator, .{
+        .context = null,
+        .callback = deliverQueued,
+    }, options);
+    errdefer value.destroy();
+    try value.start();
+    pipeline.store(value, .release);
+}
+
+/// Waits until the asynchronous messages are delivered.
+pub fn flush() void {
+    const value = pipeline.load(.acquire) orelse return;
+    value.flush();
+}
+
+/// Releases the asynchronous logging state of the calling thread, which
+/// must be about to exit.
+pub fn releaseThread() void {
+    const value = pipeline.load(.acquire) orelse return;
+    value.releaseThread();
 }
 
 /// Reports whether logging sensitive values is currently allowed.
 pub fn logsPrivateData() bool {
-    mutex.lock();
-    defer mutex.unlock();
-    return logs_private_data;
+    return logs_private_data.load(.acquire);
 }
 
 /// Reports whether a host logger callback is currently installed.
 pub fn hasLogger() bool {
-    mutex.lock();
-    defer mutex.unlock();
-    return external_logger != null;
+    return external_logger.load(.acquire) != null;
 }
 
 /// Marks a value as sensitive so `writef` applies the current privacy policy.
@@ -98,13 +140,9 @@ pub fn sensitive(value: anytype) SensitiveValue(@TypeOf(value)) {
 ///
 /// The borrowed message remains valid for the duration of the callback.
 pub fn write(level: Level, message: [:0]const u8) void {
-    mutex.lock();
-    const logger = external_logger orelse {
-        mutex.unlock();
-        return;
-    };
-    mutex.unlock();
-    dispatchSlice(logger, @intFromEnum(level), message);
+    if (!isEnabled(level)) return;
+    const logger = external_logger.load(.acquire) orelse return;
+    deliver(logger, @intFromEnum(level), message);
 }
 
 /// Formats and writes a core log message.
@@ -113,15 +151,15 @@ pub fn write(level: Level, message: [:0]const u8) void {
 /// `redacted_value` unless private logging is enabled. Otherwise, their debug
 /// representation is substituted into the format arguments. Privacy-aware
 /// arguments therefore use the `{s}` format specifier.
+///
+/// Disabled levels return before formatting, and short messages are
+/// formatted on the stack.
 pub fn writef(level: Level, comptime fmt: []const u8, args: anytype) void {
-    mutex.lock();
-    const private_data = logs_private_data;
-    const logger = external_logger orelse {
-        mutex.unlock();
-        return;
-    };
-    mutex.unlock();
-    var arena = std.heap.ArenaAllocator.init(std.heap.c_allocator);
+    if (!isEnabled(level)) return;
+    const private_data = logs_private_data.load(.acquire);
+    const logger = external_logger.load(.acquire) orelse return;
+    var stack = std.heap.stackFallback(stack_message_len, std.heap.c_allocator);
+    var arena = std.heap.ArenaAllocator.init(stack.get());
     defer arena.deinit();
     const allocator = arena.allocator();
     const prepared = prepareArguments(
@@ -130,18 +168,14 @@ pub fn writef(level: Level, comptime fmt: []const u8, args: anytype) void {
         private_data,
     ) catch return;
     const message = std.fmt.allocPrintSentinel(allocator, fmt, prepared, 0) catch return;
-    dispatchSlice(logger, @intFromEnum(level), message);
+    deliver(logger, @intFromEnum(level), message);
 }
 
 /// Forwards a borrowed C string directly to the configured C logger.
 pub fn writeCString(level: Level, message: [*:0]const u8) void {
-    mutex.lock();
-    const logger = external_logger orelse {
-        mutex.unlock();
-        return;
-    };
-    mutex.unlock();
-    dispatchCString(logger, @intFromEnum(level), message);
+    if (!isEnabled(level)) return;
+    const logger = external_logger.load(.acquire) orelse return;
+    deliverCString(logger, @intFromEnum(level), message);
 }
 
 /// Logs a profile using the structured layout of the legacy Apple runtime.
@@ -191,11 +225,37 @@ pub fn writefAndFailDebug(comptime fmt: []const u8, args: anytype) void {
     }
 }
 
-fn dispatchSlice(
+/// Queues the message when asynchronous, or dispatches it right away.
+/// Faults usually precede an abort, so they are delivered on the calling
+/// thread after the queued messages rather than queued.
+fn deliver(
     logger: Logger,
     level: c_int,
     message: [:0]const u8,
 ) void {
+    if (pipeline.load(.acquire)) |value| {
+        if (level > @intFromEnum(Level.fault)) {
+            if (value.push(level, message)) return;
+        } else {
+            value.flush();
+        }
+    }
+    dispatchCString(logger, level, message.ptr);
+}
+
+/// Only measures `message` when queued.
+fn deliverCString(
+    logger: Logger,
+    level: c_int,
+    message: [*:0]const u8,
+) void {
+    if (pipeline.load(.acquire) != null) return deliver(logger, level, std.mem.span(message));
+    dispatchCString(logger, level, message);
+}
+
+/// Delivers a queued message with the current configuration.
+fn deliverQueued(_: ?*anyopaque, level: c_int, message: [:0]const u8) void {
+    const logger = external_logger.load(.acquire) orelse return;
     dispatchCString(logger, level, message.ptr);
 }
 
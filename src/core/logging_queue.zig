@@ -0,0 +1,396 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Asynchronous delivery of log messages.
+//!
+//! Producer threads copy formatted messages into rings of records, and a
+//! background thread hands them to the sink in timestamp order, so that
+//! threads never wait for the host logger:
+//!
+//! - Each producer thread claims a single-producer ring of its own, which
+//!   needs no lock on either side. Threads beyond `max_rings` share a ring
+//!   behind a mutex.
+//! - A full ring applies the `OverflowPolicy`, and the drainer reports the
+//!   dropped messages once there is room.
+//! - Threads release their ring with `releaseThread` before exiting, and a
+//!   released ring is reused by the next thread that logs.
+
+const std = @import("std");
+
+const concurrency = @import("concurrency.zig");
+
+/// Level of the dropped messages report, as `logging.Level.notice`.
+const report_level: c_int = 2;
+
+pub const OverflowPolicy = enum {
+    /// Drops the messages that don't fit.
+    drop,
+    /// Delivers the messages that don't fit on the calling thread, out of
+    /// order with the queued messages.
+    dispatch,
+};
+
+/// Receives the queued messages on the drainer thread.
+pub const Sink = struct {
+    context: ?*anyopaque,
+    callback: *const fn (context: ?*anyopaque, level: c_int, message: [:0]const u8) void,
+};
+
+/// A queued message, borrowed until popped from its ring.
+pub const Record = struct {
+    level: c_int,
+    timestamp_ns: u64,
+    message: [:0]const u8,
+    /// Bytes taken in the ring.
+    size: usize,
+};
+
+/// Single-producer, single-consumer ring of variable-length records.
+pub const Ring = struct {
+    const Header = extern struct {
+        len: u32,
+        level: c_int,
+        timestamp_ns: u64,
+    };
+    /// Keeps room for a header at the end of the storage.
+    const record_align = @sizeOf(Header);
+    /// Skips to the start of the storage.
+    const padding_len = std.math.maxInt(u32);
+
+    storage: []align(record_align) u8,
+    // Monotonic byte positions, wrapped by the storage size.
+    head: std.atomic.Value(usize) = .init(0),
+    tail: std.atomic.Value(usize) = .init(0),
+    /// Whether a producer thread claimed the ring.
+    owned: std.atomic.Value(bool) = .init(false),
+
+    /// `size` must be a power of 2.
+    pub fn init(allocator: std.mem.Allocator, size: usize) std.mem.Allocator.Error!Ring {
+        std.debug.assert(std.math.isPowerOfTwo(size));
+        std.debug.assert(size >= 2 * @sizeOf(Header));
+        return .{ .storage = try allocator.alignedAlloc(u8, .fromByteUnits(record_align), size) };
+    }
+
+    pub fn deinit(self: *Ring, allocator: std.mem.Allocator) void {
+        allocator.free(self.storage);
+    }
+
+    /// Returns the longest message that fits a record.
+    pub fn maxMessageLen(self: *const Ring) usize {
+        return self.storage.len / 2 - @sizeOf(Header) - 1;
+    }
+
+    /// Copies a message into a new record, or returns false when full.
+    /// Only the producer may call this.
+    pub fn push(self: *Ring, level: c_int, timestamp_ns: u64, message: []const u8) bool {
+        std.debug.assert(message.len <= self.maxMessageLen());
+        const size = recordSize(message.len);
+        const tail = self.tail.load(.monotonic);
+        const head = self.head.load(.acquire);
+        var offset = tail & (self.storage.len - 1);
+        const to_end = self.storage.len - offset;
+        const padding = if (size > to_end) to_end else 0;
+        if (tail + padding + size - head > self.storage.len) return false;
+
+        if (padding > 0) {
+            self.header(offset).len = padding_len;
+            offset = 0;
+        }
+        self.header(offset).* = .{
+            .len = @intCast(message.len),
+            .level = level,
+            .timestamp_ns = timestamp_ns,
+        };
+        const text = self.storage[offset + @sizeOf(Header) ..];
+        @memcpy(text[0..message.len], message);
+        text[message.len] = 0;
+        // Totally ordered with `Pipeline.sleeping`: either the producer sees
+        // the drainer asleep, or the drainer sees this record before waiting
+        self.tail.store(tail + padding + size, .seq_cst);
+        return true;
+    }
+
+    /// Returns the oldest record without removing it. Only the consumer may
+    /// call this.
+    pub fn peek(self: *Ring) ?Record {
+        var head = self.head.load(.monotonic);
+        const tail = self.tail.load(.acquire);
+        while (head != tail) {
+            const offset = head & (self.storage.len - 1);
+            const current = self.header(offset);
+            if (current.len == padding_len) {
+                head += self.storage.len - offset;
+                self.head.store(head, .release);
+                continue;
+            }
+            const start = offset + @sizeOf(Header);
+            return .{
+                .level = current.level,
+                .timestamp_ns = current.timestamp_ns,
+                .message = self.storage[start .. start + current.len :0],
+                .size = recordSize(current.len),
+            };
+        }
+        return null;
+    }
+
+    /// Removes the record returned by `peek`.
+    pub fn pop(self: *Ring, record: Record) void {
+        _ = self.head.fetchAdd(record.size, .release);
+    }
+
+    pub fn isEmpty(self: *const Ring) bool {
+        return self.head.load(.acquire) == self.tail.load(.seq_cst);
+    }
+
+    fn header(self: *Ring, offset: usize) *Header {
+        return @ptrCast(@alignCast(self.storage[offset..].ptr));
+    }
+
+    fn recordSize(len: usize) usize {
+        return std.mem.alignForward(usize, @sizeOf(Header) + len + 1, record_align);
+    }
+};
+
+pub const Pipeline = struct {
+    pub const Options = struct {
+        /// Bytes of each ring, a power of 2. Messages longer than half the
+        /// ring are delivered on the calling thread.
+        ring_size: usize = 16 * 1024,
+        /// Threads with a ring of their own.
+        max_rings: usize = 16,
+        overflow: OverflowPolicy = .drop,
+        /// Longest sleep of the drainer without wakeups.
+        idle_ns: u64 = 50 * std.time.ns_per_ms,
+    };
+
+    const ThreadRing = struct {
+        pipeline_id: u64 = 0,
+        /// Null when sharing `shared`.
+        ring: ?*Ring = null,
+    };
+
+    threadlocal var thread_ring: ThreadRing = .{};
+    threadlocal var is_drainer = false;
+    var next_id = std.atomic.Value(u64).init(1);
+
+    allocator: std.mem.Allocator,
+    options: Options,
+    sink: Sink,
+    /// Tells apart the rings claimed by `thread_ring`.
+    id: u64,
+
+    // Claimed rings, published by `ring_count`.
+    rings: []*Ring,
+    ring_count: std.atomic.Value(usize) = .init(0),
+    shared: *Ring,
+    shared_mutex: concurrency.Mutex = .{},
+    dropped: std.atomic.Value(u64) = .init(0),
+
+    // Drainer thread and wakeups, under `mutex`.
+    mutex: concurrency.Mutex = .{},
+    condition: concurrency.Condition = .{},
+    sleeping: std.atomic.Value(bool) = .init(false),
+    stopping: std.atomic.Value(bool) = .init(false),
+    thread: ?std.Thread = null,
+
+    pub fn create(
+        allocator: std.mem.Allocator,
+        sink: Sink,
+        options: Options,
+    ) std.mem.Allocator.Error!*Pipeline {
+        const self = try allocator.create(Pipeline);
+        errdefer allocator.destroy(self);
+        const rings = try allocator.alloc(*Ring, options.max_rings);
+        errdefer allocator.free(rings);
+        const shared = try createRing(allocator, options.ring_size);
+        self.* = .{
+            .allocator = allocator,
+            .options = options,
+            .sink = sink,
+            .id = next_id.fetchAdd(1, .monotonic),
+            .rings = rings,
+            .shared = shared,
+        };
+        return self;
+    }
+
+    /// Stops the drainer after delivering the queued messages. No thread
+    /// may log through the pipeline anymore.
+    pub fn destroy(self: *Pipeline) void {
+        self.stop();
+        for (self.rings[0..self.ring_count.load(.acquire)]) |ring| {
+            destroyRing(self.allocator, ring);
+        }
+        destroyRing(self.allocator, self.shared);
+        self.allocator.free(self.rings);
+        self.condition.deinit();
+        self.mutex.deinit();
+        self.shared_mutex.deinit();
+        self.allocator.destroy(self);
+    }
+
+    pub fn start(self: *Pipeline) std.Thread.SpawnError!void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        if (self.thread != null) return;
+        self.thread = try std.Thread.spawn(.{}, run, .{self});
+    }
+
+    pub fn stop(self: *Pipeline) void {
+        self.mutex.lock();
+        const thread = self.thread orelse {
+            self.mutex.unlock();
+            return;
+        };
+        self.thread = null;
+        self.stopping.store(true, .release);
+        self.condition.broadcast();
+        self.mutex.unlock();
+        thread.join();
+        self.stopping.store(false, .release);
+    }
+
+    /// Queues a message for the drainer. Returns false when the caller must
+    /// deliver the message itself.
+    pub fn push(self: *Pipeline, level: c_int, message: []const u8) bool {
+        if (message.len > self.shared.maxMessageLen()) return false;
+        const timestamp_ns = concurrency.monotonicNs();
+        const did_push = if (self.threadRing()) |ring|
+            ring.push(level, timestamp_ns, message)
+        else shared: {
+            self.shared_mutex.lock();
+            defer self.shared_mutex.unlock();
+            break :shared self.shared.push(level, timestamp_ns, message);
+        };
+        if (!did_push) {
+            if (self.options.overflow == .dispatch) return false;
+            _ = self.dropped.fetchAdd(1, .monotonic);
+            return true;
+        }
+        if (self.sleeping.load(.seq_cst)) {
+            self.mutex.lock();
+            self.condition.broadcast();
+            self.mutex.unlock();
+        }
+        return true;
+    }
+
+    /// Waits until the queued messages are delivered. Returns at once on the
+    /// drainer thread, or without one.
+    pub fn flush(self: *Pipeline) void {
+        if (is_drainer) return;
+        while (!self.isEmpty()) {
+            self.mutex.lock();
+            const is_running = self.thread != null;
+            self.condition.broadcast();
+            self.mutex.unlock();
+            if (!is_running) return;
+            std.Thread.yield() catch {};
+        }
+    }
+
+    /// Returns the ring of the calling thread for reuse. The queued messages
+    /// are still delivered.
+    pub fn releaseThread(self: *Pipeline) void {
+        if (thread_ring.pipeline_id != self.id) return;
+        if (thread_ring.ring) |ring| ring.owned.store(false, .release);
+        thread_ring = .{};
+    }
+
+    /// Delivers the queued messages in timestamp order, and returns how
+    /// many. Only the drainer may call this.
+    pub fn drain(self: *Pipeline) usize {
+        var count: usize = 0;
+        while (true) {
+            const dropped = self.dropped.swap(0, .monotonic);
+            if (dropped > 0) self.reportDropped(dropped);
+
+            var oldest: ?*Ring = null;
+            var oldest_record: ?Record = null;
+            for (self.rings[0..self.ring_count.load(.acquire)]) |ring| {
+                const record = ring.peek() orelse continue;
+                if (oldest_record == null or record.timestamp_ns < oldest_record.?.timestamp_ns) {
+                    oldest = ring;
+                    oldest_record = record;
+                }
+            }
+            if (self.shared.peek()) |record| {
+                if (oldest_record == null or record.timestamp_ns < oldest_record.?.timestamp_ns) {
+                    oldest = self.shared;
+                    oldest_record = record;
+                }
+            }
+            const record = oldest_record orelse return count;
+            self.sink.callback(self.sink.context, record.level, record.message);
+            oldest.?.pop(record);
+            count += 1;
+        }
+    }
+
+    fn isEmpty(self: *const Pipeline) bool {
+        for (self.rings[0..self.ring_count.load(.acquire)]) |ring| {
+            if (!ring.isEmpty()) return false;
+        }
+        return self.shared.isEmpty() and self.dropped.load(.monotonic) == 0;
+    }
+
+    fn run(self: *Pipeline) void {
+        is_drainer = true;
+        while (true) {
+            if (self.drain() > 0) continue;
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            if (self.stopping.load(.acquire)) break;
+            // Producers check the flag after pushing
+            self.sleeping.store(true, .seq_cst);
+            if (self.isEmpty()) {
+                self.condition.waitUntil(&self.mutex, concurrency.monotonicNs() + self.options.idle_ns);
+            }
+            self.sleeping.store(false, .seq_cst);
+        }
+        _ = self.drain();
+    }
+
+    fn threadRing(self: *Pipeline) ?*Ring {
+        if (thread_ring.pipeline_id != self.id) {
+            thread_ring = .{ .pipeline_id = self.id, .ring = self.claimRing() };
+        }
+        return thread_ring.ring;
+    }
+
+    /// Reuses a released ring, or creates one while under `max_rings`.
+    fn claimRing(self: *Pipeline) ?*Ring {
+        for (self.rings[0..self.ring_count.load(.acquire)]) |ring| {
+            if (ring.owned.cmpxchgStrong(false, true, .acquire, .monotonic) == null) return ring;
+        }
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        const count = self.ring_count.load(.monotonic);
+        if (count == self.rings.len) return null;
+        const ring = createRing(self.allocator, self.options.ring_size) catch return null;
+        ring.owned.store(true, .monotonic);
+        self.rings[count] = ring;
+        self.ring_count.store(count + 1, .release);
+        return ring;
+    }
+
+    fn reportDropped(self: *Pipeline, dropped: u64) void {
+        var buffer: [64]u8 = undefined;
+        const message = std.fmt.bufPrintZ(&buffer, "Dropped {d} log messages", .{dropped}) catch return;
+        self.sink.callback(self.sink.context, report_level, message);
+    }
+
+    fn createRing(allocator: std.mem.Allocator, size: usize) std.mem.Allocator.Error!*Ring {
+        const ring = try allocator.create(Ring);
+        errdefer allocator.destroy(ring);
+        ring.* = try Ring.init(allocator, size);
+        return ring;
+    }
+
+    fn destroyRing(allocator: std.mem.Allocator, ring: *Ring) void {
+        ring.deinit(allocator);
+        allocator.destroy(ring);
+    }
+};
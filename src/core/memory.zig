@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Memory accounting of the objects owned by a session.
+//!
+//! `AccountingAllocator` forwards to a child allocator and keeps the live
+//! and peak bytes of what it hands out. C objects allocate with `pp_alloc`
+//! rather than with an allocator, so their bytes are only counted on threads
+//! that entered the native scope of the accounting allocator.
+//!
+//! Counters are atomic, so that usage may be read from any thread. The
+//! memory gauges are only updated when the live bytes cross a multiple of
+//! `gauge_granularity`, or drop to zero, so that most allocations don't
+//! touch the shared metrics.
+
+const std = @import("std");
+const c_mod = @import("../c/exports.zig");
+const metrics_mod = @import("metrics.zig");
+
+const c = c_mod.common;
+const Metrics = metrics_mod.Metrics;
+
+pub const Usage = struct {
+    /// Live bytes, native bytes included. Zig allocations count the
+    /// requested length, native allocations the usable size.
+    bytes: u64 = 0,
+    /// Highest `bytes` so far.
+    peak_bytes: u64 = 0,
+    /// Live bytes allocated with `pp_alloc`.
+    native_bytes: u64 = 0,
+};
+
+/// Must stay at a stable address while any allocator or native scope
+/// obtained from it is in use.
+pub const AccountingAllocator = struct {
+    child: std.mem.Allocator,
+    /// Borrowed, mirrors the usage into the memory gauges.
+    metrics: ?*Metrics,
+    bytes: std.atomic.Value(u64) = .init(0),
+    peak_bytes: std.atomic.Value(u64) = .init(0),
+    native_bytes: std.atomic.Value(u64) = .init(0),
+
+    /// The gauges lag the usage by less than this many bytes.
+    pub const gauge_granularity = 4096;
+
+    const vtable: std.mem.Allocator.VTable = .{
+        .alloc = alloc,
+        .resize = resize,
+        .remap = remap,
+        .free = free,
+    };
+
+    const native_hooks: c.pp_alloc_hooks = .{
+        .did_alloc = nativeDidAlloc,
+        .will_free = nativeWillFree,
+    };
+
+    /// Restores the native scope that was current on `enterNative`.
+    pub const NativeScope = struct {
+        previous: c.pp_alloc_scope,
+
+        pub fn leave(self: NativeScope) void {
+            c.pp_alloc_scope_leave(self.previous);
+        }
+    };
+
+    pub fn init(child: std.mem.Allocator, metrics: ?*Metrics) AccountingAllocator {
+        return .{ .child = child, .metrics = metrics };
+    }
+
+    pub fn allocator(self: *AccountingAllocator) std.mem.Allocator {
+        return .{ .ptr = self, .vtable = &vtable };
+    }
+
+    pub fn usage(self: *const AccountingAllocator) Usage {
+        return .{
+            .bytes = self.bytes.load(.monotonic),
+            .peak_bytes = self.peak_bytes.load(.monotonic),
+            .native_bytes = self.native_bytes.load(.monotonic),
+        };
+    }
+
+    /// Counts `pp_alloc` and `pp_free` on the calling thread until the scope
+    /// is left. Scopes nest.
+    pub fn enterNative(self: *AccountingAllocator) NativeScope {
+        return .{ .previous = c.pp_alloc_scope_enter(&native_hooks, self) };
+    }
+
+    fn didAllocate(self: *AccountingAllocator, len: u64) void {
+        const previous = self.bytes.fetchAdd(len, .monotonic);
+        const bytes = previous + len;
+        _ = self.peak_bytes.fetchMax(bytes, .monotonic);
+        self.publish(previous, bytes);
+    }
+
+    fn didFree(self: *AccountingAllocator, len: u64) void {
+        const previous = self.bytes.fetchSub(len, .monotonic);
+        self.publish(previous, previous - len);
+    }
+
+    fn publish(self: *const AccountingAllocator, previous: u64, bytes: u64) void {
+        const metrics = self.metrics orelse return;
+        if (bytes != 0 and previous / gauge_granularity == bytes / gauge_granularity) return;
+        metrics.set(.memory_bytes, bytes);
+        metrics.raise(.memory_peak_bytes, self.peak_bytes.load(.monotonic));
+        metrics.set(.native_memory_bytes, self.native_bytes.load(.monotonic));
+    }
+
+    fn alloc(raw: *anyopaque, len: usize, alignment: std.mem.Alignment, ret_addr: usize) ?[*]u8 {
+        const self: *AccountingAllocator = @ptrCast(@alignCast(raw));
+        const memory = self.child.rawAlloc(len, alignment, ret_addr) orelse return null;
+        self.didAllocate(len);
+        return memory;
+    }
+
+    fn resize(
+        raw: *anyopaque,
+        memory: []u8,
+        alignment: std.mem.Alignment,
+        new_len: usize,
+        ret_addr: usize,
+    ) bool {
+        const self: *AccountingAllocator = @ptrCast(@alignCast(raw));
+        if (!self.child.rawResize(memory, alignment, new_len, ret_addr)) return false;
+        self.didResize(memory.len, new_len);
+        return true;
+    }
+
+    fn remap(
+        raw: *anyopaque,
+        memory: []u8,
+        alignment: std.mem.Alignment,
+        new_len: usize,
+        ret_addr: usize,
+    ) ?[*]u8 {
+        const self: *AccountingAllocator = @ptrCast(@alignCast(raw));
+        const remapped = self.child.rawRemap(memory, alignment, new_len, ret_addr) orelse return null;
+        self.didResize(memory.len, new_len);
+        return remapped;
+    }
+
+    fn free(raw: *anyopaque, memory: []u8, alignment: std.mem.Alignment, ret_addr: usize) void {
+        const self: *AccountingAllocator = @ptrCast(@alignCast(raw));
+        self.child.rawFree(memory, alignment, ret_addr);
+        self.didFree(memory.len);
+    }
+
+    fn didResize(self: *AccountingAllocator, old_len: usize, new_len: usize) void {
+        if (new_len > old_len) {
+            self.didAllocate(new_len - old_len);
+        } else if (new_len < old_len) {
+            self.didFree(old_len - new_len);
+        }
+    }
+
+    fn nativeDidAlloc(ctx: ?*anyopaque, size: usize) callconv(.c) void {
+        const self: *AccountingAllocator = @ptrCast(@alignCast(ctx.?));
+        _ = self.native_bytes.fetchAdd(size, .monotonic);
+        self.didAllocate(size);
+    }
+
+    fn nativeWillFree(ctx: ?*anyopaque, size: usize) callconv(.c) void {
+        const self: *AccountingAllocator = @ptrCast(@alignCast(ctx.?));
+        // Blocks allocated out of scope may be freed in scope, never count
+        // more than was allocated
+        var native = self.native_bytes.load(.monotonic);
+        while (self.native_bytes.cmpxchgWeak(native, native -| size, .monotonic, .monotonic)) |actual| {
+            native = actual;
+        }
+        const released = @min(native, size);
+        if (released > 0) self.didFree(released);
+    }
+};
@@ -0,0 +1,271 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Low-overhead runtime counters, gauges and latency histograms.
+//!
+//! Recording is wait-free. Counters are spread over cache-line-padded slots,
+//! and each thread is assigned one slot on first use, so the hot path only
+//! adds to a line that other threads seldom touch. Histograms are shared and
+//! updated with relaxed atomics, since latencies are only recorded by the
+//! looper thread of the owning session.
+//!
+//! Readers aggregate the slots with `snapshot`, which may run on any thread
+//! and observes each value atomically, though not the set as a whole.
+
+const std = @import("std");
+
+/// Monotonic events counted along the packet path.
+pub const Counter = enum {
+    tun_read_packets,
+    tun_read_bytes,
+    tun_write_packets,
+    tun_write_bytes,
+    link_read_packets,
+    link_read_bytes,
+    link_write_packets,
+    link_write_bytes,
+    encrypt_packets,
+    encrypt_bytes,
+    decrypt_packets,
+    decrypt_bytes,
+    decrypt_failures_peer_id,
+    decrypt_failures_compression,
+    decrypt_failures_crypto,
+    decrypt_failures_other,
+    replay_rejects,
+    keep_alives,
+    backpressure_events,
+    read_batches,
+    read_batch_grows,
+    read_batch_shrinks,
+    read_syscalls,
+    write_batches,
+    write_syscalls,
+    write_drops,
+    allocations,
+};
+
+/// Latencies sampled across the data path.
+pub const Latency = enum {
+    /// From the TUN read to the LINK write submission.
+    tun_to_link,
+    /// From the LINK read to the TUN write submission.
+    link_to_tun,
+    /// From the first read of a batch to its delivery.
+    read_batch,
+};
+
+/// Last values set along the packet path.
+pub const Gauge = enum {
+    tun_read_batch_limit,
+    link_read_batch_limit,
+    /// Live bytes of the current session, native bytes included. Lags by
+    /// less than `AccountingAllocator.gauge_granularity`, exact at zero.
+    memory_bytes,
+    /// Highest `memory_bytes` of any session.
+    memory_peak_bytes,
+    /// Live bytes of the current session allocated by the C code.
+    native_memory_bytes,
+};
+
+const counter_count = @typeInfo(Counter).@"enum".fields.len;
+const latency_count = @typeInfo(Latency).@"enum".fields.len;
+const gauge_count = @typeInfo(Gauge).@"enum".fields.len;
+
+/// HDR-style histogram of nanosecond values. Each power of two is split into
+/// `2^sub_bucket_bits` linear buckets, which bounds the relative error of
+/// reported percentiles to 12.5% over the whole `u64` range.
+pub const Histogram = struct {
+    const sub_bucket_bits = 3;
+    const sub_bucket_count = 1 << sub_bucket_bits;
+    const bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+    buckets: [bucket_count]std.atomic.Value(u64) = @splat(.init(0)),
+    count: std.atomic.Value(u64) = .init(0),
+    sum: std.atomic.Value(u64) = .init(0),
+    max: std.atomic.Value(u64) = .init(0),
+
+    /// Percentiles reported by `summarize`, in nanoseconds.
+    pub const Summary = struct {
+        count: u64 = 0,
+        mean: u64 = 0,
+        p50: u64 = 0,
+        p90: u64 = 0,
+        p99: u64 = 0,
+        p999: u64 = 0,
+        max: u64 = 0,
+    };
+
+    pub fn record(self: *Histogram, value: u64) void {
+        _ = self.buckets[bucketIndex(value)].fetchAdd(1, .monotonic);
+        _ = self.count.fetchAdd(1, .monotonic);
+        _ = self.sum.fetchAdd(value, .monotonic);
+        _ = self.max.fetchMax(value, .monotonic);
+    }
+
+    pub fn reset(self: *Histogram) void {
+        for (&self.buckets) |*bucket| bucket.store(0, .monotonic);
+        self.count.store(0, .monotonic);
+        self.sum.store(0, .monotonic);
+        self.max.store(0, .monotonic);
+    }
+
+    pub fn summarize(self: *const Histogram) Summary {
+        var counts: [bucket_count]u64 = undefined;
+        var total: u64 = 0;
+        for (&counts, &self.buckets) |*count, *bucket| {
+            count.* = bucket.load(.monotonic);
+            total += count.*;
+        }
+        if (total == 0) return .{};
+        const max = self.max.load(.monotonic);
+        return .{
+            .count = total,
+            .mean = self.sum.load(.monotonic) / total,
+            .p50 = @min(percentile(&counts, total, 500), max),
+            .p90 = @min(percentile(&counts, total, 900), max),
+            .p99 = @min(percentile(&counts, total, 990), max),
+            .p999 = @min(percentile(&counts, total, 999), max),
+            .max = max,
+        };
+    }
+
+    /// Returns the upper bound of the bucket holding the given per-mille.
+    fn percentile(counts: *const [bucket_count]u64, total: u64, per_mille: u64) u64 {
+        const rank = @max(1, std.math.divCeil(u64, total *| per_mille, 1000) catch unreachable);
+        var seen: u64 = 0;
+        for (counts, 0..) |count, index| {
+            seen += count;
+            if (seen >= rank) return bucketUpperBound(index);
+        }
+        return bucketUpperBound(bucket_count - 1);
+    }
+
+    fn bucketIndex(value: u64) usize {
+        if (value < sub_bucket_count) return @intCast(value);
+        const magnitude: u6 = @intCast(63 - @clz(value));
+        const shift = magnitude - sub_bucket_bits;
+        const sub_bucket: usize = @intCast((value >> shift) & (sub_bucket_count - 1));
+        return (@as(usize, shift) + 1) * sub_bucket_count + sub_bucket;
+    }
+
+    fn bucketUpperBound(index: usize) u64 {
+        if (index < sub_bucket_count) return index;
+        const shift: u6 = @intCast(index / sub_bucket_count - 1);
+        const base = @as(u64, sub_bucket_count + index % sub_bucket_count) << shift;
+        return base + ((@as(u64, 1) << shift) - 1);
+    }
+};
+
+/// Per-session metrics, shared by reference with the components that record
+/// them. The owner must keep the instance at a stable address.
+pub const Metrics = struct {
+    const slot_count = 8;
+
+    const Slot = struct {
+        counters: [counter_count]std.atomic.Value(u64) align(std.atomic.cache_line) = @splat(.init(0)),
+    };
+
+    slots: [slot_count]Slot = @splat(.{}),
+    latencies: [latency_count]Histogram = @splat(.{}),
+    gauges: [gauge_count]std.atomic.Value(u64) = @splat(.init(0)),
+
+    /// Round-robin assignment of slots to threads.
+    var next_slot = std.atomic.Value(usize).init(0);
+    threadlocal var thread_slot: ?usize = null;
+
+    pub fn add(self: *Metrics, counter: Counter, value: u64) void {
+        const slot = &self.slots[currentSlot()];
+        _ = slot.counters[@intFromEnum(counter)].fetchAdd(value, .monotonic);
+    }
+
+    pub fn increment(self: *Metrics, counter: Counter) void {
+        self.add(counter, 1);
+    }
+
+    pub fn recordLatency(self: *Metrics, latency: Latency, ns: u64) void {
+        self.latencies[@intFromEnum(latency)].record(ns);
+    }
+
+    pub fn set(self: *Metrics, gauge: Gauge, value: u64) void {
+        self.gauges[@intFromEnum(gauge)].store(value, .monotonic);
+    }
+
+    /// Same as `set`, unless the gauge already holds a higher value.
+    pub fn raise(self: *Metrics, gauge: Gauge, value: u64) void {
+        _ = self.gauges[@intFromEnum(gauge)].fetchMax(value, .monotonic);
+    }
+
+    /// Clears every value, e.g. when a new session starts.
+    pub fn reset(self: *Metrics) void {
+        for (&self.slots) |*slot| {
+            for (&slot.counters) |*counter| counter.store(0, .monotonic);
+        }
+        for (&self.latencies) |*histogram| histogram.reset();
+        for (&self.gauges) |*gauge| gauge.store(0, .monotonic);
+    }
+
+    pub fn snapshot(self: *const Metrics) Snapshot {
+        var result: Snapshot = .{};
+        for (&self.slots) |*slot| {
+            for (&result.counters, &slot.counters) |*total, *counter| {
+                total.* +%= counter.load(.monotonic);
+            }
+        }
+        for (&result.latencies, &self.latencies) |*summary, *histogram| {
+            summary.* = histogram.summarize();
+        }
+        for (&result.gauges, &self.gauges) |*value, *gauge| {
+            value.* = gauge.load(.monotonic);
+        }
+        return result;
+    }
+
+    fn currentSlot() usize {
+        if (thread_slot) |slot| return slot;
+        const slot = next_slot.fetchAdd(1, .monotonic) % slot_count;
+        thread_slot = slot;
+        return slot;
+    }
+};
+
+/// Point-in-time aggregate of `Metrics`. Serializes to a flat JSON object
+/// keyed by counter, gauge and latency names.
+pub const Snapshot = struct {
+    counters: [counter_count]u64 = @splat(0),
+    latencies: [latency_count]Histogram.Summary = @splat(.{}),
+    gauges: [gauge_count]u64 = @splat(0),
+
+    pub fn get(self: Snapshot, counter: Counter) u64 {
+        return self.counters[@intFromEnum(counter)];
+    }
+
+    pub fn latency(self: Snapshot, which: Latency) Histogram.Summary {
+        return self.latencies[@intFromEnum(which)];
+    }
+
+    pub fn gauge(self: Snapshot, which: Gauge) u64 {
+        return self.gauges[@intFromEnum(which)];
+    }
+
+    pub fn jsonStringify(self: Snapshot, jw: anytype) std.json.Stringify.Error!void {
+        try jw.beginObject();
+        inline for (@typeInfo(Counter).@"enum".fields) |field| {
+            try jw.objectField(field.name);
+            try jw.write(self.counters[field.value]);
+        }
+        inline for (@typeInfo(Gauge).@"enum".fields) |field| {
+            try jw.objectField(field.name);
+            try jw.write(self.gauges[field.value]);
+        }
+        try jw.objectField("latency_ns");
+        try jw.beginObject();
+        inline for (@typeInfo(Latency).@"enum".fields) |field| {
+            try jw.objectField(field.name);
+            try jw.write(self.latencies[field.value]);
+        }
+        try jw.endObject();
+        try jw.endObject();
+    }
+};
@@ -0,0 +1,330 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Compressed binary radix trie of IP prefixes.
+//!
+//! Each node holds a whole prefix, so chains of single-child nodes are
+//! skipped and a lookup visits at most one node per distinct prefix length
+//! on its path. Branch nodes without a value only exist where two prefixes
+//! diverge, so a trie of n prefixes has fewer than 2n nodes.
+//!
+//! Nodes live in a single array and link by index. Values are removed in
+//! place, and the nodes they leave behind are only reclaimed by `deinit`.
+
+const std = @import("std");
+
+pub const Family = enum {
+    v4,
+    v6,
+
+    pub fn bitCount(self: Family) u8 {
+        return switch (self) {
+            .v4 => 32,
+            .v6 => 128,
+        };
+    }
+};
+
+/// A network prefix with its host bits cleared. IPv4 prefixes use the first
+/// 4 bytes.
+pub const Prefix = struct {
+    bytes: [16]u8 = @splat(0),
+    len: u8 = 0,
+
+    pub fn init(bytes: [16]u8, len: u8) Prefix {
+        var result: Prefix = .{ .bytes = bytes, .len = len };
+        var full_bytes: usize = len / 8;
+        if (full_bytes < result.bytes.len) {
+            const remaining_bits = len % 8;
+            if (remaining_bits > 0) {
+                const shift: u3 = @intCast(8 - remaining_bits);
+                result.bytes[full_bytes] &= @as(u8, 0xff) << shift;
+                full_bytes += 1;
+            }
+            @memset(result.bytes[full_bytes..], 0);
+        }
+        return result;
+    }
+
+    /// Parses a textual address of `family` as a prefix of `len` bits.
+    pub fn parse(family: Family, raw: []const u8, len: u8) ?Prefix {
+        if (len > family.bitCount()) return null;
+        var bytes: [16]u8 = @splat(0);
+        switch (family) {
+            .v4 => {
+                const parsed = std.Io.net.Ip4Address.parse(raw, 0) catch return null;
+                @memcpy(bytes[0..4], &parsed.bytes);
+            },
+            .v6 => {
+                const parsed = std.Io.net.Ip6Address.parse(raw, 0) catch return null;
+                bytes = parsed.bytes;
+            },
+        }
+        return init(bytes, len);
+    }
+
+    pub fn bit(self: Prefix, index: u8) u1 {
+        const shift: u3 = @intCast(7 - index % 8);
+        return @intCast((self.bytes[index / 8] >> shift) & 1);
+    }
+
+    /// Returns whether `other` is equal to or more specific than `self`.
+    pub fn contains(self: Prefix, other: Prefix) bool {
+        return self.len <= other.len and commonLength(self, other) >= self.len;
+    }
+
+    pub fn eql(self: Prefix, other: Prefix) bool {
+        return self.len == other.len and std.mem.eql(u8, &self.bytes, &other.bytes);
+    }
+
+    /// Returns the number of leading bits shared by both prefixes, up to
+    /// the shorter length.
+    fn commonLength(lhs: Prefix, rhs: Prefix) u8 {
+        const limit = @min(lhs.len, rhs.len);
+        var index: usize = 0;
+        while (index * 8 < limit) : (index += 1) {
+            const diff = lhs.bytes[index] ^ rhs.bytes[index];
+            if (diff != 0) {
+                const bits: u8 = @intCast(index * 8 + @clz(diff));
+                return @min(bits, limit);
+            }
+        }
+        return limit;
+    }
+};
+
+pub fn PrefixTrie(comptime V: type) type {
+    return struct {
+        const Self = @This();
+        const Index = u32;
+        const none = std.math.maxInt(Index);
+
+        const Node = struct {
+            prefix: Prefix,
+            value: ?V,
+            children: [2]Index = .{ none, none },
+        };
+
+        pub const Entry = struct {
+            prefix: Prefix,
+            value: V,
+        };
+
+        family: Family,
+        nodes: std.ArrayList(Node) = .empty,
+        root: Index = none,
+        count: usize = 0,
+
+        pub fn init(family: Family) Self {
+            return .{ .family = family };
+        }
+
+        pub fn deinit(self: *Self, allocator: std.mem.Allocator) void {
+            self.nodes.deinit(allocator);
+            self.* = undefined;
+        }
+
+        /// Adds `value` for `prefix`, unless the prefix is already present.
+        /// Returns whether it was added.
+        pub fn insert(
+            self: *Self,
+            allocator: std.mem.Allocator,
+            prefix: Prefix,
+            value: V,
+        ) std.mem.Allocator.Error!bool {
+            std.debug.assert(prefix.len <= self.family.bitCount());
+            // Links point into the nodes, so no append may reallocate below
+            try self.nodes.ensureUnusedCapacity(allocator, 2);
+
+            var link = &self.root;
+            while (link.* != none) {
+                const node = &self.nodes.items[link.*];
+                const common = Prefix.commonLength(node.prefix, prefix);
+                if (common == node.prefix.len) {
+                    if (prefix.len == node.prefix.len) {
+                        if (node.value != null) return false;
+                        node.value = value;
+                        self.count += 1;
+                        return true;
+                    }
+                    link = &node.children[prefix.bit(node.prefix.len)];
+                    continue;
+                }
+
+                // The new prefix diverges within this node
+                const existing = link.*;
+                if (common == prefix.len) {
+                    const parent = self.appendNode(.{ .prefix = prefix, .value = value });
+                    self.nodes.items[parent].children[node.prefix.bit(common)] = existing;
+                    link.* = parent;
+                } else {
+                    const branch = self.appendNode(.{
+                        .prefix = Prefix.init(prefix.bytes, common),
+                        .value = null,
+                    });
+                    const leaf = self.appendNode(.{ .prefix = prefix, .value = value });
+                    const children = &self.nodes.items[branch].children;
+                    children[prefix.bit(common)] = leaf;
+                    children[self.nodes.items[existing].prefix.bit(common)] = existing;
+                    link.* = branch;
+                }
+                self.count += 1;
+                return true;
+            }
+            link.* = self.appendNode(.{ .prefix = prefix, .value = value });
+            self.count += 1;
+            return true;
+        }
+
+        /// Returns the value of exactly `prefix`.
+        pub fn get(self: *const Self, prefix: Prefix) ?V {
+            var index = self.root;
+            while (index != none) {
+                const node = &self.nodes.items[index];
+                if (!node.prefix.contains(prefix)) return null;
+                if (node.prefix.len == prefix.len) return node.value;
+                index = node.children[prefix.bit(node.prefix.len)];
+            }
+            return null;
+        }
+
+        /// Returns the most specific entry containing `prefix`, typically a
+        /// full-length address.
+        pub fn longestMatch(self: *const Self, prefix: Prefix) ?Entry {
+            var best: ?Entry = null;
+            var index = self.root;
+            while (index != none) {
+                const node = &self.nodes.items[index];
+                if (!node.prefix.contains(prefix)) break;
+                if (node.value) |value| best = .{ .prefix = node.prefix, .value = value };
+                if (node.prefix.len == prefix.len) break;
+                index = node.children[prefix.bit(node.prefix.len)];
+            }
+            return best;
+        }
+
+        /// Returns whether any entry contains or is contained by `prefix`.
+        pub fn overlaps(self: *const Self, prefix: Prefix) bool {
+            var index = self.root;
+            while (index != none) {
+                const node = &self.nodes.items[index];
+                if (prefix.contains(node.prefix)) return self.hasValue(index);
+                if (!node.prefix.contains(prefix)) return false;
+                if (node.value != null) return true;
+                index = node.children[prefix.bit(node.prefix.len)];
+            }
+            return false;
+        }
+
+        /// Appends the entries that contain or are contained by `prefix`,
+        /// from the least to the most specific.
+        pub fn collectOverlaps(
+            self: *const Self,
+            allocator: std.mem.Allocator,
+            prefix: Prefix,
+            out: *std.ArrayList(Entry),
+        ) std.mem.Allocator.Error!void {
+            var index = self.root;
+            while (index != none) {
+                const node = &self.nodes.items[index];
+                if (prefix.contains(node.prefix)) return self.collectSubtree(allocator, index, out);
+                if (!node.prefix.contains(prefix)) return;
+                if (node.value) |value| try out.append(allocator, .{ .prefix = node.prefix, .value = value });
+                index = node.children[prefix.bit(node.prefix.len)];
+            }
+        }
+
+        /// Appends all entries in prefix order, shorter prefixes first.
+        pub fn collect(
+            self: *const Self,
+            allocator: std.mem.Allocator,
+            out: *std.ArrayList(Entry),
+        ) std.mem.Allocator.Error!void {
+            try out.ensureUnusedCapacity(allocator, self.count);
+            if (self.root != none) try self.collectSubtree(allocator, self.root, out);
+        }
+
+        /// Merges entries without changing the value of the longest match
+        /// of any address:
+        ///
+        /// - Two halves of a prefix with equal values become that prefix,
+        ///   except for the halves of the whole space, which only beat a
+        ///   default route elsewhere as long as they are more specific.
+        /// - Entries equal to their closest containing entry are dropped.
+        ///
+        /// Entries for which `context.isPinned(prefix)` holds are left
+        /// alone, and no prefix is merged over them. `context.eql(a, b)`
+        /// compares values.
+        pub fn aggregate(self: *Self, context: anytype) void {
+            if (self.root == none) return;
+            self.mergeHalves(self.root, context);
+            self.dropRedundant(self.root, null, context);
+        }
+
+        fn appendNode(self: *Self, node: Node) Index {
+            const index: Index = @intCast(self.nodes.items.len);
+            self.nodes.appendAssumeCapacity(node);
+            return index;
+        }
+
+        fn hasValue(self: *const Self, index: Index) bool {
+            if (index == none) return false;
+            const node = &self.nodes.items[index];
+            return node.value != null or
+                self.hasValue(node.children[0]) or
+                self.hasValue(node.children[1]);
+        }
+
+        fn collectSubtree(
+            self: *const Self,
+            allocator: std.mem.Allocator,
+            index: Index,
+            out: *std.ArrayList(Entry),
+        ) std.mem.Allocator.Error!void {
+            const node = &self.nodes.items[index];
+            if (node.value) |value| try out.append(allocator, .{ .prefix = node.prefix, .value = value });
+            for (node.children) |child| {
+                if (child != none) try self.collectSubtree(allocator, child, out);
+            }
+        }
+
+        /// Works bottom-up, so that merged halves merge again one level up.
+        fn mergeHalves(self: *Self, index: Index, context: anytype) void {
+            const children = self.nodes.items[index].children;
+            for (children) |child| {
+                if (child != none) self.mergeHalves(child, context);
+            }
+            const node = &self.nodes.items[index];
+            if (node.prefix.len == 0) return;
+            if (node.value != null or children[0] == none or children[1] == none) return;
+            const lhs = &self.nodes.items[children[0]];
+            const rhs = &self.nodes.items[children[1]];
+            if (lhs.prefix.len != node.prefix.len + 1 or rhs.prefix.len != node.prefix.len + 1) return;
+            const lhs_value = lhs.value orelse return;
+            const rhs_value = rhs.value orelse return;
+            if (!context.eql(lhs_value, rhs_value)) return;
+            if (context.isPinned(lhs.prefix) or context.isPinned(rhs.prefix)) return;
+            node.value = lhs_value;
+            lhs.value = null;
+            rhs.value = null;
+            self.count -= 1;
+        }
+
+        fn dropRedundant(self: *Self, index: Index, covering: ?V, context: anytype) void {
+            const node = &self.nodes.items[index];
+            var next_covering = covering;
+            if (node.value) |value| {
+                if (covering != null and context.eql(covering.?, value) and !context.isPinned(node.prefix)) {
+                    node.value = null;
+                    self.count -= 1;
+                } else {
+                    next_covering = value;
+                }
+            }
+            for (node.children) |child| {
+                if (child != none) self.dropRedundant(child, next_covering, context);
+            }
+        }
+    };
+}
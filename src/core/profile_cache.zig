@@ -0,0 +1,494 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Binary cache of parsed profiles.
+//!
+//! Decoding a profile from JSON tokenizes the text and validates every
+//! address, key and identifier again on each daemon start. The cache stores
+//! the parsed `api.Profile` in a compact binary form that decodes with bounds
+//! checks only, keyed by the SHA-256 of the original JSON.
+//!
+//! Profiles carry credentials and private keys, so the payload is sealed
+//! with ChaCha20-Poly1305 under a key derived from the JSON, which is never
+//! stored. Without the JSON, an entry can be neither read nor forged, and a
+//! hit decodes to what parsing the JSON validated when it was stored.
+//!
+//! A cache file is mapped read-only and laid out as a 96-byte header followed
+//! by the sealed payload, all integers little-endian:
+//!
+//! - 0..4: magic `PPPC`
+//! - 4..8: format version
+//! - 8..16: fingerprint of the `api.Profile` type layout
+//! - 16..48: content hash of the profile JSON
+//! - 48..56: payload length
+//! - 56..68: nonce
+//! - 68..84: tag of the payload and of the header up to the nonce
+//!
+//! A file that fails any check is a miss, and is replaced by the next store.
+//! Files live in a few slots of the cache directory, chosen by hash, so that
+//! edited profiles never accumulate stale entries.
+
+const std = @import("std");
+
+const api = @import("api.zig");
+const c_mod = @import("../c/exports.zig");
+const concurrency = @import("concurrency.zig");
+const log = @import("logging.zig");
+
+const c = c_mod.common;
+
+pub const format_version: u32 = 2;
+pub const slot_count = 4;
+
+const magic = "PPPC";
+const header_len = 96;
+const authenticated_len = 56;
+/// Payloads up to this length are opened on the stack.
+const stack_payload_len = 4096;
+
+const Aead = std.crypto.aead.chacha_poly.ChaCha20Poly1305;
+const Hkdf = std.crypto.kdf.hkdf.HkdfSha256;
+
+pub const ContentHash = [std.crypto.hash.sha2.Sha256.digest_length]u8;
+
+/// Identifies and seals the cache entry of a profile JSON.
+pub const ContentKey = struct {
+    /// Stored in the header.
+    hash: ContentHash,
+    /// Never stored.
+    secret: [Aead.key_length]u8,
+};
+
+pub const DecodeError = std.mem.Allocator.Error || error{
+    /// The file was written for other contents, or by another build.
+    Stale,
+    /// The file is truncated or damaged.
+    Corrupt,
+};
+
+pub fn contentHash(text: []const u8) ContentHash {
+    var hash: ContentHash = undefined;
+    std.crypto.hash.sha2.Sha256.hash(text, &hash, .{});
+    return hash;
+}
+
+pub fn contentKey(text: []const u8) ContentKey {
+    return .{
+        .hash = contentHash(text),
+        .secret = Hkdf.extract("partout-profile-cache", text),
+    };
+}
+
+/// Returns the path of the cache slot for `hash` in `cache_root`.
+pub fn slotPathAlloc(
+    allocator: std.mem.Allocator,
+    cache_root: []const u8,
+    hash: ContentHash,
+) std.mem.Allocator.Error![:0]u8 {
+    return std.fmt.allocPrintSentinel(allocator, "{s}/partout-profile-{d}.cache", .{
+        cache_root,
+        hash[0] % slot_count,
+    }, 0);
+}
+
+/// Loads the profile cached for `key`, or returns null on a miss.
+pub fn load(
+    allocator: std.mem.Allocator,
+    cache_root: []const u8,
+    key: ContentKey,
+) std.mem.Allocator.Error!?api.Profile {
+    const path = try slotPathAlloc(allocator, cache_root, key.hash);
+    defer allocator.free(path);
+
+    var mapping: c.pp_file_mapping = undefined;
+    if (!c.pp_file_map(path.ptr, &mapping)) return null;
+    defer c.pp_file_unmap(&mapping);
+    const bytes = if (mapping.bytes) |ptr| ptr[0..mapping.length] else return null;
+
+    const start_ns = concurrency.monotonicNs();
+    const profile = decode(allocator, bytes, key) catch |err| {
+        if (err == error.OutOfMemory) return error.OutOfMemory;
+        log.writef(.debug, "Profile cache miss: {s}", .{@errorName(err)});
+        return null;
+    };
+    log.writef(.debug, "Profile cache hit, decoded in {d}us", .{
+        (concurrency.monotonicNs() - start_ns) / std.time.ns_per_us,
+    });
+    return profile;
+}
+
+/// Caches `profile` for `key`. Failures are logged and otherwise ignored,
+/// since the cache is never required.
+pub fn store(
+    allocator: std.mem.Allocator,
+    cache_root: []const u8,
+    key: ContentKey,
+    profile: *const api.Profile,
+) void {
+    storeOrFail(allocator, cache_root, key, profile) catch |err| {
+        log.writef(.info, "Unable to cache profile: {s}", .{@errorName(err)});
+    };
+}
+
+fn storeOrFail(
+    allocator: std.mem.Allocator,
+    cache_root: []const u8,
+    key: ContentKey,
+    profile: *const api.Profile,
+) error{ OutOfMemory, RandomFailure, CacheDirectory, CacheWrite }!void {
+    const encoded = try encodeAlloc(allocator, profile, key);
+    defer allocator.free(encoded);
+    const root = try allocator.dupeZ(u8, cache_root);
+    defer allocator.free(root);
+    if (!c.pp_file_create_directory(root.ptr)) return error.CacheDirectory;
+    const path = try slotPathAlloc(allocator, cache_root, key.hash);
+    defer allocator.free(path);
+    if (!c.pp_file_write_atomic(path.ptr, encoded.ptr, encoded.len)) return error.CacheWrite;
+}
+
+/// Encodes a whole cache file for `profile`. The plain payload is wiped
+/// before returning.
+pub fn encodeAlloc(
+    allocator: std.mem.Allocator,
+    profile: *const api.Profile,
+    key: ContentKey,
+) error{ OutOfMemory, RandomFailure }![]u8 {
+    // Sized upfront, as a growing buffer would leave copies behind
+    var counter: Writer = .{};
+    encodeValue(api.Profile, &counter, profile);
+    const payload = try allocator.alloc(u8, counter.len);
+    defer {
+        std.crypto.secureZero(u8, payload);
+        allocator.free(payload);
+    }
+    var writer: Writer = .{ .bytes = payload };
+    encodeValue(api.Profile, &writer, profile);
+    std.debug.assert(writer.len == payload.len);
+
+    const encoded = try allocator.alloc(u8, header_len + payload.len);
+    errdefer allocator.free(encoded);
+    const header = encoded[0..header_len];
+    @memset(header, 0);
+    @memcpy(header[0..4], magic);
+    std.mem.writeInt(u32, header[4..8], format_version, .little);
+    std.mem.writeInt(u64, header[8..16], fingerprint, .little);
+    @memcpy(header[16..48], &key.hash);
+    std.mem.writeInt(u64, header[48..56], payload.len, .little);
+    if (!c.pp_prng_do(header[56..68].ptr, Aead.nonce_length)) return error.RandomFailure;
+    Aead.encrypt(
+        encoded[header_len..],
+        header[68..84],
+        payload,
+        header[0..authenticated_len],
+        header[56..68].*,
+        key.secret,
+    );
+    return encoded;
+}
+
+/// Decodes a whole cache file, checking that it was sealed for `key`.
+pub fn decode(
+    allocator: std.mem.Allocator,
+    bytes: []const u8,
+    key: ContentKey,
+) DecodeError!api.Profile {
+    if (bytes.len < header_len) return error.Corrupt;
+    const header = bytes[0..header_len];
+    if (!std.mem.eql(u8, header[0..4], magic)) return error.Corrupt;
+    if (std.mem.readInt(u32, header[4..8], .little) != format_version) return error.Stale;
+    if (std.mem.readInt(u64, header[8..16], .little) != fingerprint) return error.Stale;
+    if (!std.mem.eql(u8, header[16..48], &key.hash)) return error.Stale;
+    const sealed = bytes[header_len..];
+    if (std.mem.readInt(u64, header[48..56], .little) != sealed.len) return error.Corrupt;
+
+    var stack = std.heap.stackFallback(stack_payload_len, allocator);
+    const payload_allocator = stack.get();
+    const payload = try payload_allocator.alloc(u8, sealed.len);
+    defer {
+        std.crypto.secureZero(u8, payload);
+        payload_allocator.free(payload);
+    }
+    Aead.decrypt(
+        payload,
+        sealed,
+        header[68..84].*,
+        header[0..authenticated_len],
+        header[56..68].*,
+        key.secret,
+    ) catch return error.Corrupt;
+
+    var reader: Reader = .{ .bytes = payload };
+    const profile = try decodeValue(api.Profile, allocator, &reader);
+    if (reader.pos != payload.len) {
+        deinitValue(api.Profile, allocator, &profile);
+        return error.Corrupt;
+    }
+    return profile;
+}
+
+// Layout
+//
+// Values are encoded field by field in declaration order, without names:
+// integers and floats as fixed-size little-endian, enums as their integer
+// tag, optionals and booleans as a leading byte, slices as a u32 count
+// followed by the items, and unions as a u16 tag index followed by the
+// payload. The `owned` flags of the manual types are implied, since
+// decoded values always own their memory.
+
+/// Changes whenever a type reachable from `api.Profile` changes shape.
+const fingerprint: u64 = blk: {
+    @setEvalBranchQuota(1_000_000);
+    break :blk std.hash.Wyhash.hash(format_version, layoutName(api.Profile));
+};
+
+fn layoutName(comptime T: type) []const u8 {
+    return switch (@typeInfo(T)) {
+        .@"struct" => |info| blk: {
+            var name: []const u8 = "{";
+            for (info.fields) |field| {
+                if (isOwnedFlag(field)) continue;
+                name = name ++ field.name ++ ":" ++ layoutName(field.type) ++ ",";
+            }
+            break :blk name ++ "}";
+        },
+        .@"union" => |info| blk: {
+            var name: []const u8 = "union{";
+            for (info.fields) |field| {
+                name = name ++ field.name ++ ":" ++ layoutName(field.type) ++ ",";
+            }
+            break :blk name ++ "}";
+        },
+        .@"enum" => |info| blk: {
+            var name: []const u8 = "enum(" ++ @typeName(info.tag_type) ++ "){";
+            for (info.fields) |field| {
+                name = name ++ field.name ++ std.fmt.comptimePrint("={d},", .{field.value});
+            }
+            break :blk name ++ "}";
+        },
+        .optional => |info| "?" ++ layoutName(info.child),
+        .pointer => |info| "[]" ++ layoutName(info.child),
+        .array => |info| std.fmt.comptimePrint("[{d}]", .{info.len}) ++ layoutName(info.child),
+        else => @typeName(T),
+    };
+}
+
+fn isOwnedFlag(comptime field: std.builtin.Type.StructField) bool {
+    return field.type == bool and std.mem.eql(u8, field.name, "owned");
+}
+
+fn encodeValue(comptime T: type, out: *Writer, value: *const T) void {
+    switch (@typeInfo(T)) {
+        .bool => out.appendByte(@intFromBool(value.*)),
+        .int => encodeInt(T, out, value.*),
+        .float => {
+            const Bits = std.meta.Int(.unsigned, @bitSizeOf(T));
+            encodeInt(Bits, out, @bitCast(value.*));
+        },
+        .@"enum" => |info| encodeInt(info.tag_type, out, @intFromEnum(value.*)),
+        .optional => |info| {
+            if (value.*) |*inner| {
+                out.appendByte(1);
+                encodeValue(info.child, out, inner);
+            } else {
+                out.appendByte(0);
+            }
+        },
+        .array => |info| {
+            if (info.child == u8) {
+                out.append(value);
+            } else {
+                for (value) |*item| encodeValue(info.child, out, item);
+            }
+        },
+        .pointer => |info| {
+            if (info.size != .slice) @compileError("only slices are supported");
+            encodeInt(u32, out, @intCast(value.len));
+            if (info.child == u8) {
+                out.append(value.*);
+            } else {
+                for (value.*) |*item| encodeValue(info.child, out, item);
+            }
+        },
+        .@"struct" => |info| {
+            inline for (info.fields) |field| {
+                if (comptime isOwnedFlag(field)) continue;
+                encodeValue(field.type, out, &@field(value.*, field.name));
+            }
+        },
+        .@"union" => {
+            encodeInt(u16, out, @intFromEnum(value.*));
+            switch (value.*) {
+                inline else => |*payload| encodeValue(@TypeOf(payload.*), out, payload),
+            }
+        },
+        else => @compileError("unsupported profile cache type: " ++ @typeName(T)),
+    }
+}
+
+fn encodeInt(comptime T: type, out: *Writer, value: T) void {
+    const Aligned = alignedInt(T);
+    var bytes: [@sizeOf(Aligned)]u8 = undefined;
+    std.mem.writeInt(Aligned, &bytes, value, .little);
+    out.append(&bytes);
+}
+
+fn alignedInt(comptime T: type) type {
+    return std.meta.Int(@typeInfo(T).int.signedness, @sizeOf(T) * 8);
+}
+
+/// Only counts the length without `bytes`.
+const Writer = struct {
+    bytes: []u8 = &.{},
+    len: usize = 0,
+
+    fn append(self: *Writer, slice: []const u8) void {
+        if (self.bytes.len > 0) @memcpy(self.bytes[self.len..][0..slice.len], slice);
+        self.len += slice.len;
+    }
+
+    fn appendByte(self: *Writer, byte: u8) void {
+        self.append(&.{byte});
+    }
+};
+
+const Reader = struct {
+    bytes: []const u8,
+    pos: usize = 0,
+
+    fn take(self: *Reader, count: usize) DecodeError![]const u8 {
+        if (count > self.bytes.len - self.pos) return error.Corrupt;
+        const slice = self.bytes[self.pos..][0..count];
+        self.pos += count;
+        return slice;
+    }
+
+    fn takeInt(self: *Reader, comptime T: type) DecodeError!T {
+        const Aligned = alignedInt(T);
+        const slice = try self.take(@sizeOf(Aligned));
+        const value = std.mem.readInt(Aligned, slice[0..@sizeOf(Aligned)], .little);
+        return std.math.cast(T, value) orelse error.Corrupt;
+    }
+
+    fn takeFlag(self: *Reader) DecodeError!bool {
+        return switch ((try self.take(1))[0]) {
+            0 => false,
+            1 => true,
+            else => error.Corrupt,
+        };
+    }
+
+    fn remaining(self: Reader) usize {
+        return self.bytes.len - self.pos;
+    }
+};
+
+fn decodeValue(comptime T: type, allocator: std.mem.Allocator, reader: *Reader) DecodeError!T {
+    switch (@typeInfo(T)) {
+        .bool => return reader.takeFlag(),
+        .int => return reader.takeInt(T),
+        .float => {
+            const Bits = std.meta.Int(.unsigned, @bitSizeOf(T));
+            return @bitCast(try reader.takeInt(Bits));
+        },
+        .@"enum" => |info| {
+            const raw = try reader.takeInt(info.tag_type);
+            inline for (info.fields) |field| {
+                if (raw == field.value) return @enumFromInt(field.value);
+            }
+            return error.Corrupt;
+        },
+        .optional => |info| {
+            if (!try reader.takeFlag()) return null;
+            return try decodeValue(info.child, allocator, reader);
+        },
+        .array => |info| {
+            var result: T = undefined;
+            if (info.child == u8) {
+                @memcpy(&result, try reader.take(info.len));
+            } else {
+                for (&result) |*item| item.* = try decodeValue(info.child, allocator, reader);
+            }
+            return result;
+        },
+        .pointer => |info| {
+            if (info.size != .slice) @compileError("only slices are supported");
+            const len = try reader.takeInt(u32);
+            if (len > reader.remaining()) return error.Corrupt;
+            if (info.child == u8) return try allocator.dupe(u8, try reader.take(len));
+
+            const items = try allocator.alloc(info.child, len);
+            var decoded: usize = 0;
+            errdefer {
+                for (items[0..decoded]) |*item| deinitValue(info.child, allocator, item);
+                allocator.free(items);
+            }
+            for (items) |*item| {
+                item.* = try decodeValue(info.child, allocator, reader);
+                decoded += 1;
+            }
+            return items;
+        },
+        .@"struct" => |info| {
+            if (comptime info.fields.len == 0) return .{};
+            var result: T = undefined;
+            var decoded: usize = 0;
+            errdefer {
+                inline for (info.fields, 0..) |field, index| {
+                    if (comptime !isOwnedFlag(field)) {
+                        if (index < decoded) deinitValue(field.type, allocator, &@field(result, field.name));
+                    }
+                }
+            }
+            inline for (info.fields) |field| {
+                if (comptime isOwnedFlag(field)) {
+                    @field(result, field.name) = true;
+                } else {
+                    @field(result, field.name) = try decodeValue(field.type, allocator, reader);
+                }
+                decoded += 1;
+            }
+            return result;
+        },
+        .@"union" => |info| {
+            const index = try reader.takeInt(u16);
+            inline for (info.fields, 0..) |field, field_index| {
+                if (index == field_index) {
+                    return @unionInit(T, field.name, try decodeValue(field.type, allocator, reader));
+                }
+            }
+            return error.Corrupt;
+        },
+        else => @compileError("unsupported profile cache type: " ++ @typeName(T)),
+    }
+}
+
+/// Frees what `decodeValue` allocated, field by field, so that it also
+/// applies to partially decoded values.
+fn deinitValue(comptime T: type, allocator: std.mem.Allocator, value: *const T) void {
+    switch (@typeInfo(T)) {
+        .optional => |info| if (value.*) |*inner| deinitValue(info.child, allocator, inner),
+        .array => |info| {
+            if (info.child != u8) {
+                for (value) |*item| deinitValue(info.child, allocator, item);
+            }
+        },
+        .pointer => |info| {
+            if (info.child != u8) {
+                for (value.*) |*item| deinitValue(info.child, allocator, item);
+            }
+            if (value.len > 0) allocator.free(value.*);
+        },
+        .@"struct" => |info| {
+            inline for (info.fields) |field| {
+                if (comptime !isOwnedFlag(field)) {
+                    deinitValue(field.type, allocator, &@field(value.*, field.name));
+                }
+            }
+        },
+        .@"union" => switch (value.*) {
+            inline else => |*payload| deinitValue(@TypeOf(payload.*), allocator, payload),
+        },
+        else => {},
+    }
+}
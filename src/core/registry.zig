@@ -6,7 +6,6 @@ const std = @import("std");
 
 const api = @import("api.zig");
 const log = @import("logging.zig");
-const util = @import("util.zig");
 const uuid = @import("uuid.zig");
 
 /// Errors returned while importing profiles or modules from serialized input.
@@ -247,42 +246,41 @@ pub const Registry = struct {
         text: []const u8,
         name: ?[]const u8,
     ) ImportError!api.Profile {
-        // If the input is not a JSON, parse it as Module
+        // Try to parse the JSON as profile, and return it on success
         log.write(.debug, "Parse profile as JSON");
-        var parsed = util.parseJsonValue(allocator, text) catch |json_err| {
-            switch (json_err) {
+        var profile = api.Profile.parse(allocator, text) catch |profile_err| {
+            switch (profile_err) {
                 error.OutOfMemory => return error.OutOfMemory,
+                // If the input is not a JSON, parse it as Module
                 error.InvalidJson => {
                     log.writef(.debug, "Unable to parse JSON, parse profile from text: {s}", .{
-                        @errorName(json_err),
+                        @errorName(profile_err),
                     });
                     return self.importModuleAsProfile(allocator, text, name);
                 },
+                error.InvalidModel, error.UnsupportedModel => {},
             }
-        };
-        defer parsed.deinit();
-
-        // Try to parse the JSON as profile, and return it on success
-        var profile = api.Profile.parseValue(allocator, parsed.value) catch |profile_err| {
-            if (profile_err == error.OutOfMemory) return error.OutOfMemory;
 
             // The JSON is not a profile, parse it as module
             log.writef(.debug, "Unable to parse profile JSON, parse as module: {s}", .{
                 @errorName(profile_err),
             });
-            var module = api.TaggedModule.parseValue(allocator, parsed.value) catch |module_err| {
-                return switch (module_err) {
-                    error.OutOfMemory => error.OutOfMemory,
-                    error.InvalidJson,
-                    error.InvalidModel,
-                    error.UnsupportedModel,
-                    => {
-                        log.writef(.err, "Unable to parse module JSON, fail: {s}", .{
-                            @errorName(module_err),
-                        });
-                        return ImportError.InvalidProfile;
-                    },
-                };
+            var module = api.TaggedModule.parse(allocator, text) catch |module_err| {
+                if (module_err == error.OutOfMemory) return error.OutOfMemory;
+
+                // Parsing streams, so a model error may precede a syntax
+                // error further in the input
+                const is_json = std.json.validate(allocator, text) catch return error.OutOfMemory;
+                if (!is_json) {
+                    log.writef(.debug, "Unable to parse JSON, parse profile from text: {s}", .{
+                        @errorName(module_err),
+                    });
+                    return self.importModuleAsProfile(allocator, text, name);
+                }
+                log.writef(.err, "Unable to parse module JSON, fail: {s}", .{
+                    @errorName(module_err),
+                });
+                return ImportError.InvalidProfile;
             };
             errdefer module.deinit(allocator);
 
@@ -0,0 +1,270 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Hierarchical hashed timer wheel for single-threaded event loops.
+//!
+//! `TimerWheel` does not own a thread or a clock. The owner reads the earliest
+//! deadline with `nextDeadlineNs`, bounds its own blocking wait accordingly,
+//! and calls `advance` with the current monotonic time. Due entries are then
+//! drained one at a time with `popDue`, so a callback may safely cancel or
+//! re-arm any other entry, including one that is already due.
+//!
+//! Entries are intrusive and caller-owned. Scheduling and cancellation run in
+//! constant time and never allocate. The wheel is not thread-safe.
+
+const std = @import("std");
+
+pub const TimerWheel = struct {
+    /// Bits of the tick consumed by each level.
+    const level_bits = 6;
+    /// Slots per level.
+    const level_slots = 1 << level_bits;
+    /// Number of cascading levels. With 1ms ticks, four levels cover ~4.6h
+    /// before deadlines are clamped to the outermost slot and re-cascaded.
+    const levels = 4;
+    /// Largest tick delta addressable without clamping.
+    const max_delta = 1 << (level_bits * levels);
+
+    /// Resolution of one tick.
+    pub const tick_ns = std.time.ns_per_ms;
+
+    /// Caller-owned handle linked into at most one wheel bucket at a time.
+    ///
+    /// An entry must stay at a stable address while it is scheduled or due.
+    pub const Entry = struct {
+        /// Absolute expiration tick, rounded up to never fire early.
+        deadline_tick: u64 = 0,
+
+        /// Private intrusive bucket linkage.
+        prev: ?*Entry = null,
+        next: ?*Entry = null,
+        bucket: ?*Bucket = null,
+
+        /// Returns whether the entry is scheduled or waiting in the due list.
+        pub fn isLinked(self: *const Entry) bool {
+            return self.bucket != null;
+        }
+    };
+
+    /// Doubly-linked FIFO of entries sharing one slot.
+    const Bucket = struct {
+        head: ?*Entry = null,
+        tail: ?*Entry = null,
+
+        fn append(self: *Bucket, entry: *Entry) void {
+            entry.prev = self.tail;
+            entry.next = null;
+            entry.bucket = self;
+            if (self.tail) |tail| {
+                tail.next = entry;
+            } else {
+                self.head = entry;
+            }
+            self.tail = entry;
+        }
+
+        fn unlink(self: *Bucket, entry: *Entry) void {
+            if (entry.prev) |prev| {
+                prev.next = entry.next;
+            } else {
+                self.head = entry.next;
+            }
+            if (entry.next) |next| {
+                next.prev = entry.prev;
+            } else {
+                self.tail = entry.prev;
+            }
+            entry.prev = null;
+            entry.next = null;
+            entry.bucket = null;
+        }
+
+        fn take(self: *Bucket) ?*Entry {
+            const head = self.head;
+            self.head = null;
+            self.tail = null;
+            return head;
+        }
+
+        fn isEmpty(self: *const Bucket) bool {
+            return self.head == null;
+        }
+    };
+
+    /// Monotonic origin of tick zero.
+    origin_ns: u64,
+
+    /// Last tick processed by `advance`.
+    current_tick: u64 = 0,
+
+    /// Number of scheduled entries, excluding the due list.
+    count: usize = 0,
+
+    /// Wheel storage and per-level occupancy bitmaps.
+    buckets: [levels][level_slots]Bucket = [_][level_slots]Bucket{
+        [_]Bucket{.{}} ** level_slots,
+    } ** levels,
+    occupied: [levels]u64 = [_]u64{0} ** levels,
+
+    /// Entries whose deadline elapsed, in expiration order.
+    due: Bucket = .{},
+
+    pub fn init(now_ns: u64) TimerWheel {
+        return .{ .origin_ns = now_ns };
+    }
+
+    /// Arms `entry` at an absolute monotonic deadline, replacing any previous
+    /// schedule of the same entry.
+    pub fn schedule(self: *TimerWheel, entry: *Entry, deadline_ns: u64) void {
+        self.cancel(entry);
+        entry.deadline_tick = @max(self.tickCeil(deadline_ns), self.current_tick + 1);
+        self.place(entry);
+        self.count += 1;
+    }
+
+    /// Unlinks `entry` whether it is pending or already due. Cancelling an
+    /// unlinked entry is a no-op.
+    pub fn cancel(self: *TimerWheel, entry: *Entry) void {
+        const bucket = entry.bucket orelse return;
+        bucket.unlink(entry);
+        if (bucket == &self.due) return;
+        self.count -= 1;
+        self.refreshOccupied(bucket);
+    }
+
+    /// Returns a lower bound of the earliest pending deadline, or null if
+    /// nothing is scheduled. Due entries that were not drained are reported
+    /// as already elapsed.
+    pub fn nextDeadlineNs(self: *const TimerWheel) ?u64 {
+        if (!self.due.isEmpty()) return self.origin_ns;
+        if (self.count == 0) return null;
+        var earliest: ?u64 = null;
+        for (0..levels) |level| {
+            const bitmap = self.occupied[level];
+            if (bitmap == 0) continue;
+            const shift: u6 = @intCast(level * level_bits);
+            // Slots are visited starting right after the current position.
+            const position = (self.current_tick >> shift) + 1;
+            const offset: u6 = @truncate(position);
+            const distance = @ctz(std.math.rotr(u64, bitmap, offset));
+            const tick = (position + distance) << shift;
+            // Outer levels report their next cascade, which may precede an
+            // entry that was placed in the innermost level later on.
+            earliest = if (earliest) |value| @min(value, tick) else tick;
+        }
+        return self.origin_ns +| ((earliest orelse return null) *| tick_ns);
+    }
+
+    /// Processes every tick up to `now_ns`, cascading higher levels and moving
+    /// elapsed entries to the due list.
+    pub fn advance(self: *TimerWheel, now_ns: u64) void {
+        const target = self.tickFloor(now_ns);
+        while (self.current_tick < target) {
+            if (self.count == 0) {
+                self.current_tick = target;
+                return;
+            }
+            // Skip idle stretches of the innermost level in one step.
+            if (self.occupied[0] == 0) {
+                const boundary = (self.current_tick | (level_slots - 1)) + 1;
+                if (boundary > target) {
+                    self.current_tick = target;
+                    return;
+                }
+                self.current_tick = boundary - 1;
+            }
+            self.current_tick += 1;
+            const tick = self.current_tick;
+            self.cascade(tick);
+            const slot = &self.buckets[0][@as(usize, @truncate(tick & (level_slots - 1)))];
+            var current = slot.take();
+            self.refreshOccupied(slot);
+            while (current) |entry| {
+                current = entry.next;
+                entry.bucket = null;
+                self.count -= 1;
+                self.due.append(entry);
+            }
+        }
+    }
+
+    /// Pops the next due entry, if any.
+    pub fn popDue(self: *TimerWheel) ?*Entry {
+        const entry = self.due.head orelse return null;
+        self.due.unlink(entry);
+        return entry;
+    }
+
+    /// Unlinks every scheduled and due entry without notifying them.
+    pub fn clear(self: *TimerWheel) void {
+        for (&self.buckets) |*level| {
+            for (level) |*bucket| clearBucket(bucket);
+        }
+        clearBucket(&self.due);
+        self.occupied = [_]u64{0} ** levels;
+        self.count = 0;
+    }
+
+    fn clearBucket(bucket: *Bucket) void {
+        while (bucket.head) |entry| bucket.unlink(entry);
+    }
+
+    fn cascade(self: *TimerWheel, tick: u64) void {
+        var level: usize = 1;
+        while (level < levels) : (level += 1) {
+            const shift: u6 = @intCast(level * level_bits);
+            const lower_mask = (@as(u64, 1) << shift) - 1;
+            if (tick & lower_mask != 0) return;
+            const index: usize = @truncate((tick >> shift) & (level_slots - 1));
+            const bucket = &self.buckets[level][index];
+            var current = bucket.take();
+            self.refreshOccupied(bucket);
+            while (current) |entry| {
+                current = entry.next;
+                entry.prev = null;
+                entry.next = null;
+                entry.bucket = null;
+                self.place(entry);
+            }
+        }
+    }
+
+    fn place(self: *TimerWheel, entry: *Entry) void {
+        const delta = entry.deadline_tick -| self.current_tick;
+        var level: usize = 0;
+        var tick = entry.deadline_tick;
+        if (delta >= max_delta) {
+            // Park far deadlines in the last outer slot to re-cascade later.
+            level = levels - 1;
+            tick = self.current_tick + max_delta - 1;
+        } else {
+            while (level < levels - 1) : (level += 1) {
+                const span = @as(u64, 1) << @intCast((level + 1) * level_bits);
+                if (delta < span) break;
+            }
+        }
+        const shift: u6 = @intCast(level * level_bits);
+        const index: usize = @truncate((tick >> shift) & (level_slots - 1));
+        self.buckets[level][index].append(entry);
+        self.occupied[level] |= @as(u64, 1) << @intCast(index);
+    }
+
+    fn refreshOccupied(self: *TimerWheel, bucket: *const Bucket) void {
+        if (!bucket.isEmpty()) return;
+        const base = @intFromPtr(&self.buckets[0][0]);
+        const offset = (@intFromPtr(bucket) - base) / @sizeOf(Bucket);
+        const level = offset / level_slots;
+        const index: u6 = @intCast(offset % level_slots);
+        self.occupied[level] &= ~(@as(u64, 1) << index);
+    }
+
+    fn tickFloor(self: *const TimerWheel, ns: u64) u64 {
+        return (ns -| self.origin_ns) / tick_ns;
+    }
+
+    fn tickCeil(self: *const TimerWheel, ns: u64) u64 {
+        const elapsed = ns -| self.origin_ns;
+        return elapsed / tick_ns + @intFromBool(elapsed % tick_ns != 0);
+    }
+};
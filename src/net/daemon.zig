@@ -144,6 +144,7 @@ pub const Daemon = struct {
     connection_runtime: ?ConnectionRuntime,
     gate: ?ConnectionGate,
     snapshot_publisher: SnapshotPublisher,
+    metrics: *core.Metrics,
     resume_gate_timer: core.RunAfter,
     is_evaluating_connection: bool,
     cancellation_requested: bool,
@@ -166,6 +167,9 @@ pub const Daemon = struct {
 
         const daemon = try allocator.create(Daemon);
         errdefer allocator.destroy(daemon);
+        const metrics = try allocator.create(core.Metrics);
+        errdefer allocator.destroy(metrics);
+        metrics.* = .{};
         const actor = Actor.create(allocator, daemon) catch return error.OutOfMemory;
 
         daemon.* = .{
@@ -188,6 +192,7 @@ pub const Daemon = struct {
                 daemon,
                 context.options.min_data_count_delta,
             ),
+            .metrics = metrics,
             .resume_gate_timer = .{},
             .is_evaluating_connection = false,
             .cancellation_requested = false,
@@ -233,11 +238,18 @@ pub const Daemon = struct {
         if (self.connection_runtime != null)
             @panic("Daemon.destroy() cannot release a live connection runtime");
         self.profile.deinit(self.allocator);
+        self.allocator.destroy(self.metrics);
         self.allocator.destroy(self);
 
         log.write(.debug, "Deinit daemon");
     }
 
+    /// Aggregates the metrics of the current connection. Safe to call from
+    /// any thread while the daemon is alive.
+    pub fn metricsSnapshot(self: *const Daemon) core.metrics.Snapshot {
+        return self.metrics.snapshot();
+    }
+
     pub fn isConnectionProfile(self: Daemon) bool {
         return activeConnectionModule(&self.profile) != null;
     }
@@ -816,6 +828,8 @@ pub const Daemon = struct {
             @panic("Cannot initialize a second daemon connection runtime");
         const module = activeConnectionModule(&self.profile) orelse return;
 
+        // Metrics are scoped to the connection runtime.
+        self.metrics.reset();
         const looper = try self.allocator.create(Looper);
         errdefer self.allocator.destroy(looper);
         looper.* = Looper.init(self.allocator, .{
@@ -823,6 +837,7 @@ pub const Daemon = struct {
                 .context = self,
                 .callback = onLooperTerminate,
             },
+            .metrics = self.metrics,
         }) catch |err| switch (err) {
             error.OutOfMemory => return error.OutOfMemory,
             error.MuxFailure => return error.LooperFailure,
@@ -29,6 +29,8 @@ const util = core.util;
 pub const FileDescriptor = c.pp_fd;
 pub const ReachabilityInfo = c.pp_reachability;
 pub const SocketDescriptor = c.pp_socket_fd;
+/// A received packet borrowed from a receive ring.
+pub const ReceiveSlot = c.pp_uring_slot;
 
 pub const Side = enum {
     link,
@@ -52,6 +54,15 @@ pub const IOInterface = struct {
         reset_events: *const fn (*anyopaque) Error!void,
         read: *const fn (*anyopaque, []u8) Error!?usize,
         write: *const fn (*anyopaque, []const u8, usize) Error!usize,
+        /// Only set for byte streams, where packet boundaries are not
+        /// preserved and consecutive packets can be gathered.
+        write_vectored: ?*const fn (*anyopaque, []const []const u8, usize) Error!usize = null,
+        /// Only set where packets can be received in place from a ring of
+        /// buffers (io_uring on Linux).
+        open_receive_ring: ?*const fn (*anyopaque, usize, usize) ?FileDescriptor = null,
+        close_receive_ring: ?*const fn (*anyopaque) void = null,
+        receive: ?*const fn (*anyopaque, []ReceiveSlot) Error!usize = null,
+        release: ?*const fn (*anyopaque, []const ReceiveSlot) void = null,
         cleanup: *const fn (*anyopaque) void,
         last_error_code: *const fn (*anyopaque) c_int,
     };
@@ -72,6 +83,45 @@ pub const IOInterface = struct {
         return self.vtable.write(self.ptr, data, offset);
     }
 
+    /// Returns whether queued packets may be gathered with `writeVectored`.
+    pub fn gathersWrites(self: IOInterface) bool {
+        return self.vtable.write_vectored != null;
+    }
+
+    /// Writes `chunks` with a single call, starting at `offset` in the first
+    /// chunk. Returns the amount of written bytes, which may be partial.
+    pub fn writeVectored(self: IOInterface, chunks: []const []const u8, offset: usize) Error!usize {
+        const write_vectored = self.vtable.write_vectored orelse return error.LibcFailure;
+        return write_vectored(self.ptr, chunks, offset);
+    }
+
+    /// Starts receiving into `slot_count` buffers of `slot_len` bytes, and
+    /// returns the descriptor to watch for reads in place of the original
+    /// one. Returns null where unsupported, `read` must be used then.
+    pub fn openReceiveRing(self: IOInterface, slot_len: usize, slot_count: usize) ?FileDescriptor {
+        const open_receive_ring = self.vtable.open_receive_ring orelse return null;
+        return open_receive_ring(self.ptr, slot_len, slot_count);
+    }
+
+    /// Stops receiving through the ring opened by `openReceiveRing`, e.g.
+    /// when its descriptor can't be watched. No slot may be borrowed.
+    pub fn closeReceiveRing(self: IOInterface) void {
+        const close_receive_ring = self.vtable.close_receive_ring orelse return;
+        close_receive_ring(self.ptr);
+    }
+
+    /// Borrows up to `slots.len` received packets without copying them.
+    /// Returns the number of slots, which must be released afterwards.
+    pub fn receive(self: IOInterface, slots: []ReceiveSlot) Error!usize {
+        const receive_fn = self.vtable.receive orelse return error.LibcFailure;
+        return receive_fn(self.ptr, slots);
+    }
+
+    pub fn release(self: IOInterface, slots: []const ReceiveSlot) void {
+        const release_fn = self.vtable.release orelse return;
+        release_fn(self.ptr, slots);
+    }
+
     pub fn cleanup(self: IOInterface) void {
         self.vtable.cleanup(self.ptr);
     }
@@ -98,6 +148,7 @@ pub const SocketWrapper = struct {
     socket: c.pp_socket,
     options: SocketOptions,
     closes_on_empty_read: bool,
+    receive_ring: c.pp_uring_rx = null,
     is_closed: bool = false,
     owner_allocator: ?std.mem.Allocator = null,
 
@@ -157,9 +208,13 @@ pub const SocketWrapper = struct {
     }
 
     pub fn nativeIO(self: *SocketWrapper) IOInterface {
+        const owned = self.owner_allocator != null;
         return .{
             .ptr = self,
-            .vtable = if (self.owner_allocator != null) &owned_socket_vtable else &socket_vtable,
+            .vtable = if (self.isReliable())
+                (if (owned) &owned_stream_socket_vtable else &stream_socket_vtable)
+            else
+                (if (owned) &owned_socket_vtable else &socket_vtable),
         };
     }
 
@@ -182,9 +237,49 @@ pub const SocketWrapper = struct {
         return mapWriteResult(.link, written, false);
     }
 
+    pub fn writeVectored(self: *const SocketWrapper, chunks: []const []const u8, offset: usize) Error!usize {
+        if (chunks.len == 0) return 0;
+        if (offset > chunks[0].len) return error.LibcFailure;
+        var c_chunks: [c.PPSocketMaxChunks]c.pp_socket_chunk = undefined;
+        const count = @min(chunks.len, c_chunks.len);
+        for (chunks[0..count], c_chunks[0..count], 0..) |chunk, *c_chunk, i| {
+            const skipped = if (i == 0) offset else 0;
+            c_chunk.* = .{
+                .bytes = chunk.ptr + skipped,
+                .length = chunk.len - skipped,
+            };
+        }
+        const written = c.pp_socket_writev(self.socket, &c_chunks, count);
+        return mapWriteResult(.link, written, false);
+    }
+
+    pub fn openReceiveRing(self: *SocketWrapper, slot_len: usize, slot_count: usize) ?FileDescriptor {
+        if (self.receive_ring == null) {
+            const fd = self.muxDescriptor() orelse return null;
+            self.receive_ring = c.pp_uring_rx_create(fd, true, self.closes_on_empty_read, slot_len, slot_count);
+        }
+        const ring = self.receive_ring orelse return null;
+        return c.pp_uring_rx_get_watch_fd(ring);
+    }
+
+    pub fn closeReceiveRing(self: *SocketWrapper) void {
+        if (self.receive_ring) |ring| c.pp_uring_rx_free(ring);
+        self.receive_ring = null;
+    }
+
+    pub fn receive(self: *const SocketWrapper, slots: []ReceiveSlot) Error!usize {
+        return receiveFromRing(self.receive_ring.?, slots);
+    }
+
+    pub fn release(self: *const SocketWrapper, slots: []const ReceiveSlot) void {
+        c.pp_uring_rx_release(self.receive_ring.?, slots.ptr, slots.len);
+    }
+
     pub fn cleanup(self: *SocketWrapper) void {
         if (self.is_closed) return;
         self.is_closed = true;
+        // Before closing the descriptor it reads from
+        self.closeReceiveRing();
         c.pp_socket_free_and_close(self.socket, true);
     }
 
@@ -221,6 +316,7 @@ pub const SocketWrapper = struct {
 
 pub const TunWrapper = struct {
     tun: c.pp_tun,
+    receive_ring: c.pp_uring_rx = null,
     is_closed: bool = false,
 
     pub fn init(tun: c.pp_tun) TunWrapper {
@@ -265,9 +361,33 @@ pub const TunWrapper = struct {
         return mapWriteResult(.tun, written, true);
     }
 
+    pub fn openReceiveRing(self: *TunWrapper, slot_len: usize, slot_count: usize) ?FileDescriptor {
+        if (self.receive_ring == null) {
+            const fd = self.muxDescriptor() orelse return null;
+            self.receive_ring = c.pp_uring_rx_create(fd, false, false, slot_len, slot_count);
+        }
+        const ring = self.receive_ring orelse return null;
+        return c.pp_uring_rx_get_watch_fd(ring);
+    }
+
+    pub fn closeReceiveRing(self: *TunWrapper) void {
+        if (self.receive_ring) |ring| c.pp_uring_rx_free(ring);
+        self.receive_ring = null;
+    }
+
+    pub fn receive(self: *const TunWrapper, slots: []ReceiveSlot) Error!usize {
+        return receiveFromRing(self.receive_ring.?, slots);
+    }
+
+    pub fn release(self: *const TunWrapper, slots: []const ReceiveSlot) void {
+        c.pp_uring_rx_release(self.receive_ring.?, slots.ptr, slots.len);
+    }
+
     pub fn cleanup(self: *TunWrapper) void {
         if (self.is_closed) return;
         self.is_closed = true;
+        // Before closing the descriptor it reads from
+        self.closeReceiveRing();
         c.pp_tun_free_and_close(self.tun, true);
     }
 
@@ -298,6 +418,10 @@ const socket_vtable = IOInterface.VTable{
     .reset_events = socketResetEvents,
     .read = socketRead,
     .write = socketWrite,
+    .open_receive_ring = socketOpenReceiveRing,
+    .close_receive_ring = socketCloseReceiveRing,
+    .receive = socketReceive,
+    .release = socketRelease,
     .cleanup = socketCleanup,
     .last_error_code = socketLastErrorCode,
 };
@@ -322,6 +446,31 @@ fn socketWrite(ptr: *anyopaque, data: []const u8, offset: usize) Error!usize {
     return self.write(data, offset);
 }
 
+fn socketWriteVectored(ptr: *anyopaque, chunks: []const []const u8, offset: usize) Error!usize {
+    const self: *SocketWrapper = @ptrCast(@alignCast(ptr));
+    return self.writeVectored(chunks, offset);
+}
+
+fn socketOpenReceiveRing(ptr: *anyopaque, slot_len: usize, slot_count: usize) ?FileDescriptor {
+    const self: *SocketWrapper = @ptrCast(@alignCast(ptr));
+    return self.openReceiveRing(slot_len, slot_count);
+}
+
+fn socketCloseReceiveRing(ptr: *anyopaque) void {
+    const self: *SocketWrapper = @ptrCast(@alignCast(ptr));
+    self.closeReceiveRing();
+}
+
+fn socketReceive(ptr: *anyopaque, slots: []ReceiveSlot) Error!usize {
+    const self: *SocketWrapper = @ptrCast(@alignCast(ptr));
+    return self.receive(slots);
+}
+
+fn socketRelease(ptr: *anyopaque, slots: []const ReceiveSlot) void {
+    const self: *SocketWrapper = @ptrCast(@alignCast(ptr));
+    self.release(slots);
+}
+
 fn socketCleanup(ptr: *anyopaque) void {
     const self: *SocketWrapper = @ptrCast(@alignCast(ptr));
     self.cleanup();
@@ -337,6 +486,38 @@ const owned_socket_vtable = IOInterface.VTable{
     .reset_events = socketResetEvents,
     .read = socketRead,
     .write = socketWrite,
+    .open_receive_ring = socketOpenReceiveRing,
+    .close_receive_ring = socketCloseReceiveRing,
+    .receive = socketReceive,
+    .release = socketRelease,
+    .cleanup = ownedSocketCleanup,
+    .last_error_code = socketLastErrorCode,
+};
+
+const stream_socket_vtable = IOInterface.VTable{
+    .set_event_mask = socketSetEventMask,
+    .reset_events = socketResetEvents,
+    .read = socketRead,
+    .write = socketWrite,
+    .write_vectored = socketWriteVectored,
+    .open_receive_ring = socketOpenReceiveRing,
+    .close_receive_ring = socketCloseReceiveRing,
+    .receive = socketReceive,
+    .release = socketRelease,
+    .cleanup = socketCleanup,
+    .last_error_code = socketLastErrorCode,
+};
+
+const owned_stream_socket_vtable = IOInterface.VTable{
+    .set_event_mask = socketSetEventMask,
+    .reset_events = socketResetEvents,
+    .read = socketRead,
+    .write = socketWrite,
+    .write_vectored = socketWriteVectored,
+    .open_receive_ring = socketOpenReceiveRing,
+    .close_receive_ring = socketCloseReceiveRing,
+    .receive = socketReceive,
+    .release = socketRelease,
     .cleanup = ownedSocketCleanup,
     .last_error_code = socketLastErrorCode,
 };
@@ -357,6 +538,10 @@ const tun_vtable = IOInterface.VTable{
     .reset_events = tunResetEvents,
     .read = tunRead,
     .write = tunWrite,
+    .open_receive_ring = tunOpenReceiveRing,
+    .close_receive_ring = tunCloseReceiveRing,
+    .receive = tunReceive,
+    .release = tunRelease,
     .cleanup = tunCleanup,
     .last_error_code = tunLastErrorCode,
 };
@@ -381,6 +566,26 @@ fn tunWrite(ptr: *anyopaque, data: []const u8, offset: usize) Error!usize {
     return self.write(data, offset);
 }
 
+fn tunOpenReceiveRing(ptr: *anyopaque, slot_len: usize, slot_count: usize) ?FileDescriptor {
+    const self: *TunWrapper = @ptrCast(@alignCast(ptr));
+    return self.openReceiveRing(slot_len, slot_count);
+}
+
+fn tunCloseReceiveRing(ptr: *anyopaque) void {
+    const self: *TunWrapper = @ptrCast(@alignCast(ptr));
+    self.closeReceiveRing();
+}
+
+fn tunReceive(ptr: *anyopaque, slots: []ReceiveSlot) Error!usize {
+    const self: *TunWrapper = @ptrCast(@alignCast(ptr));
+    return self.receive(slots);
+}
+
+fn tunRelease(ptr: *anyopaque, slots: []const ReceiveSlot) void {
+    const self: *TunWrapper = @ptrCast(@alignCast(ptr));
+    self.release(slots);
+}
+
 fn tunCleanup(ptr: *anyopaque) void {
     const self: *TunWrapper = @ptrCast(@alignCast(ptr));
     self.cleanup();
@@ -409,6 +614,16 @@ fn mapReadResult(_: Side, result: c_int, closes_on_empty_read: bool) Error!?usiz
     return @intCast(result);
 }
 
+/// The ring skips empty datagrams itself, and only reports the end of a
+/// stream after the packets received before it.
+fn receiveFromRing(ring: c.pp_uring_rx, slots: []ReceiveSlot) Error!usize {
+    const result = c.pp_uring_rx_read(ring, slots.ptr, slots.len);
+    if (result == c.PPIOErrorWouldBlock) return error.WouldBlock;
+    if (result < 0) return error.LibcFailure;
+    if (result == 0) return error.EndOfStream;
+    return @intCast(result);
+}
+
 fn mapWriteResult(_: Side, result: c_int, comptime maps_no_space: bool) Error!usize {
     if (result == c.PPIOErrorWouldBlock) return error.WouldBlock;
     if (result == c.PPIOErrorNoBufs) return error.Backpressure;
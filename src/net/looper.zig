@@ -16,6 +16,7 @@ const std = @import("std");
 
 const core = @import("../core/exports.zig");
 const io = @import("io.zig");
+const batch_mod = @import("looper_batch.zig");
 const queue_mod = @import("looper_queue.zig");
 const c = io.c;
 const log = core.logging;
@@ -23,8 +24,14 @@ const log = core.logging;
 pub const Looper = struct {
     /// Max number of attached sides.
     const number_of_descriptors = 2;
+    /// Sides with a receive ring are watched by two descriptors.
+    const number_of_mux_entries = 2 * number_of_descriptors;
+    /// Max number of buffers of a receive ring.
+    const max_ring_slots = 32768;
     /// Hardcoded delay on backpressure (ENOBUFS).
     const no_buf_retry_delay_ms = 10;
+    /// Max number of queued packets gathered into one stream write.
+    const max_gathered_writes = c.PPSocketMaxChunks;
 
     // Scheduling.
     pub const Packet = queue_mod.Packet;
@@ -51,7 +58,16 @@ pub const Looper = struct {
     const Command = queue_mod.Command;
     const CommandNode = queue_mod.CommandNode;
     const CommandQueue = queue_mod.CommandQueue;
+    const TimerCommand = queue_mod.TimerCommand;
+    const TimerNode = queue_mod.TimerNode;
+    const TimerPool = queue_mod.TimerPool;
     const WriteQueue = queue_mod.WriteQueue;
+    pub const WriteLimits = WriteQueue.Limits;
+    const default_write_limits: WriteLimits = .{
+        .max_packets = 1024,
+        .max_bytes = 4 * 1024 * 1024,
+    };
+    const BatchController = batch_mod.BatchController;
 
     /// Looper state.
     const State = enum {
@@ -85,13 +101,25 @@ pub const Looper = struct {
         tun_buf_size: usize = 16 * 1024,
         max_read_size: usize = 256 * 1024,
         max_read_count: usize = 128,
+        /// Added latency targeted by adaptive read batches, which never
+        /// exceed the limits above. Zero always reads up to the limits.
+        read_latency_target_ns: u64 = 200 * std.time.ns_per_us,
+        /// Buffers of a receive ring, as large as the read buffer of the
+        /// side and rounded down to a power of 2. Zero always reads with
+        /// copies into the read buffer.
+        receive_ring_slots: usize = 32,
+        /// Bounds and drop policy of the queued writes to each side.
+        link_write_limits: WriteLimits = default_write_limits,
+        tun_write_limits: WriteLimits = default_write_limits,
         on_finish: OnFinish,
+        /// Borrowed, must outlive the looper.
+        metrics: ?*core.Metrics = null,
     };
 
     const Errors = queue_mod.Errors;
     const SubmissionError = std.mem.Allocator.Error || Errors.LooperUnavailable;
     const CompletionError = queue_mod.CompletionError;
-    const RetryScheduleError = std.mem.Allocator.Error || std.Thread.SpawnError;
+    const RetryScheduleError = std.mem.Allocator.Error;
     pub const ScheduleTimerError = std.mem.Allocator.Error || Errors.LooperUnavailable;
     pub const InitError = std.mem.Allocator.Error || Errors.MuxFailure;
     pub const StartError = std.mem.Allocator.Error ||
@@ -124,14 +152,14 @@ pub const Looper = struct {
     stop_completion: ?*Completion,
     waiter_count: usize,
 
-    // Delayed command scheduler.
-    scheduler: core.RunAfter,
-    timers_head: ?*CommandNode,
+    // Delayed commands, confined to the looper thread. The wheel bounds the
+    // mux wait, so timers need neither a scheduler thread nor a lock.
+    timers: core.TimerWheel,
+    timer_pool: TimerPool,
     next_timer_id: u64,
 
     // Mux-owned resources.
     mux: c.pp_mux,
-    fd_set: ?DescriptorSet,
 
     // Attached sides and their scheduled retries.
     link: ?*SideIO,
@@ -149,7 +177,7 @@ pub const Looper = struct {
     threadlocal var borrowed_callback_depth: usize = 0;
 
     pub fn init(allocator: std.mem.Allocator, options: Options) InitError!Looper {
-        const mux = c.pp_mux_create(number_of_descriptors) orelse {
+        const mux = c.pp_mux_create(number_of_mux_entries) orelse {
             log.writef(.err, "Unable to create mux", .{});
             return error.MuxFailure;
         };
@@ -168,11 +196,10 @@ pub const Looper = struct {
             .completions = .{},
             .stop_completion = null,
             .waiter_count = 0,
-            .scheduler = .{},
-            .timers_head = null,
+            .timers = core.TimerWheel.init(core.concurrency.monotonicNs()),
+            .timer_pool = TimerPool.init(allocator),
             .next_timer_id = 1,
             .mux = mux,
-            .fd_set = null,
             .link = null,
             .tun = null,
             .next_side_id = 1,
@@ -213,8 +240,6 @@ pub const Looper = struct {
         }
         self.lock.unlock();
 
-        self.scheduler.deinit();
-
         // The loop owns every live SideIO. It must be fully joined before
         // descriptor callbacks or storage are released.
         self.joinWorker();
@@ -238,34 +263,8 @@ pub const Looper = struct {
         self.state = .starting;
         self.lock.unlock();
 
-        const fd_set = DescriptorSet.init(self.allocator) catch |err| {
-            self.lock.lock();
-            self.state = .idle;
-            self.condition.broadcast();
-            self.lock.unlock();
-            return err;
-        };
-
-        self.lock.lock();
-        self.fd_set = fd_set;
-        c.pp_mux_set_on_readable(self.mux, onMuxReadable, &self.fd_set.?);
-        c.pp_mux_set_on_writable(self.mux, onMuxWritable, &self.fd_set.?);
-        self.lock.unlock();
-
-        self.scheduler.start() catch |err| {
-            self.lock.lock();
-            self.fd_set.?.deinit();
-            self.fd_set = null;
-            self.state = .idle;
-            self.condition.broadcast();
-            self.lock.unlock();
-            return err;
-        };
-
         const worker = std.Thread.spawn(.{}, loopMain, .{self}) catch |err| {
             self.lock.lock();
-            self.fd_set.?.deinit();
-            self.fd_set = null;
             self.state = .idle;
             self.condition.broadcast();
             self.lock.unlock();
@@ -289,6 +288,7 @@ pub const Looper = struct {
         self.loop_thread_id = loop_thread_id;
         self.lock.unlock();
 
+        defer log.releaseThread();
         defer self.clearLoopThread(loop_thread_id);
         while (self.loopOnce()) {}
         self.cleanupAfterLoop();
@@ -300,22 +300,29 @@ pub const Looper = struct {
             self.lock.unlock();
             return false;
         }
-        const fd_set = if (self.fd_set) |*value| value else {
-            self.lock.unlock();
-            return false;
-        };
         self.lock.unlock();
 
-        fd_set.resetReadable();
+        if (self.link) |link| link.readable = false;
+        if (self.tun) |tun| tun.readable = false;
+        var events: [number_of_mux_entries]c.pp_mux_event = undefined;
         var code: c_int = 0;
-        if (c.pp_mux_wait(self.mux, &code) < 0) {
-            log.writef(.err, "Looper: pp_mux_wait() failed (code={})", .{code});
+        const count = c.pp_mux_wait_until(
+            self.mux,
+            self.waitDeadlineNs(),
+            &events,
+            events.len,
+            &code,
+        );
+        if (count < 0) {
+            log.writef(.err, "Looper: pp_mux_wait_until() failed (code={})", .{code});
             self.finish(.{ .wait = code });
             return false;
         }
-        if (fd_set.allocation_failed) {
-            self.finish(.{ .system = error.OutOfMemory });
-            return false;
+        // Sides are only destroyed on this thread, so user data is live.
+        for (events[0..@intCast(count)]) |event| {
+            const side_io: *SideIO = @ptrCast(@alignCast(event.user_data.?));
+            if (event.flags & c.PPMuxEventReadable != 0) side_io.readable = true;
+            if (event.flags & c.PPMuxEventWritable != 0) side_io.writable = true;
         }
 
         self.lock.lock();
@@ -326,7 +333,7 @@ pub const Looper = struct {
             return false;
         }
 
-        const command_outcome = self.handleCommands(fd_set);
+        const command_outcome = self.handleCommands();
         self.lock.lock();
         const deinitializing_after_commands = self.state == .deinitializing;
         self.lock.unlock();
@@ -351,7 +358,18 @@ pub const Looper = struct {
             return false;
         }
 
-        const process_outcome = self.process(fd_set);
+        if (self.runDueTimers()) |failure| {
+            self.finish(failure);
+            return false;
+        }
+        self.lock.lock();
+        const deinitializing_after_timers = self.state == .deinitializing;
+        self.lock.unlock();
+        if (deinitializing_after_timers) {
+            return false;
+        }
+
+        const process_outcome = self.process();
         self.lock.lock();
         const deinitializing_after_process = self.state == .deinitializing;
         self.lock.unlock();
@@ -526,8 +544,10 @@ pub const Looper = struct {
 
     /// Replaces one delayed task and executes its callback on the looper.
     ///
-    /// This operation is queue-confined. The looper owns the internal command;
-    /// `timer` is only an identity token and its address is never retained.
+    /// This operation is queue-confined and runs in constant time. The looper
+    /// owns the internal timer node; `timer` is only an identity token and its
+    /// address is never retained. Replacing a pending task re-arms its node in
+    /// place, so periodic timers do not allocate.
     pub fn scheduleReplacing(
         self: *Looper,
         timer: *Timer,
@@ -537,43 +557,32 @@ pub const Looper = struct {
         if (!self.isOnQueue())
             @panic("Looper.scheduleReplacing() must run on the looper queue");
 
-        const node = try self.createCommandNode(.{ .timed_task = .{
-            .id = 0,
-            .task = task,
-        } });
-        errdefer self.allocator.destroy(node);
-
         self.lock.lock();
-        defer self.lock.unlock();
-        if (self.state != .started) return error.LooperUnavailable;
+        const is_started = self.state == .started;
+        self.lock.unlock();
+        if (!is_started) return error.LooperUnavailable;
+
+        if (self.pendingTimerNode(timer)) |node| {
+            node.command = .{ .timed_task = task };
+            self.timers.schedule(&node.entry, deadlineAfterMs(delay_ms));
+            return;
+        }
+        const node = try self.armTimer(delay_ms, .{ .timed_task = task });
+        timer.* = .{ .id = node.id, .node = node };
+    }
 
-        const id = self.nextTimerIdLocked();
-        node.command.timed_task.id = id;
-        self.registerTimerLocked(node);
-        // start() owns scheduler thread creation, so scheduling while the
-        // looper is started cannot fail with a thread-spawn error.
-        self.scheduler.scheduleAppending(
-            &node.timer,
-            delay_ms,
-            onScheduledCommand,
-            self,
-        ) catch unreachable;
-
-        if (timer.id) |previous_id| self.cancelTimerLocked(previous_id);
-        timer.id = id;
-    }
-
-    /// Cancels one delayed task. After this returns, its borrowed callback
-    /// context cannot be invoked, even if the scheduler deadline races with
-    /// cancellation. A token whose task has already run is harmless.
+    /// Cancels one delayed task in constant time. After this returns, its
+    /// borrowed callback context cannot be invoked, even if its deadline has
+    /// already elapsed in the current loop iteration. A token whose task has
+    /// already run is harmless.
     pub fn cancelTimer(self: *Looper, timer: *Timer) void {
         if (!self.isOnQueue())
             @panic("Looper.cancelTimer() must run on the looper queue");
-        const id = timer.id orelse return;
-        self.lock.lock();
-        self.cancelTimerLocked(id);
-        self.lock.unlock();
-        timer.id = null;
+        if (self.pendingTimerNode(timer)) |node| {
+            self.timers.cancel(&node.entry);
+            self.timer_pool.release(node);
+        }
+        timer.* = .{};
     }
 
     /// Ownership of `arguments.pair.io` transfers only after successful attach.
@@ -724,6 +733,13 @@ pub const Looper = struct {
         try attached.write_queue.append(processed);
         self.commands.append(command);
         self.wakeLocked();
+
+        // One copy and one node per queued packet, plus the command. Head
+        // drops may also evict older packets, so this is a lower bound.
+        const drops = attached.write_queue.takeDrops();
+        self.countPackets(side, .write, processed);
+        if (drops > 0) self.countMetric(.write_drops, drops);
+        self.countMetric(.allocations, 2 * (processed.len -| drops) + 1);
     }
 
     pub fn writeQueued(self: *Looper, packets: Packets, side: io.Side) WriteError!void {
@@ -776,19 +792,12 @@ pub const Looper = struct {
                 return error.WriteIncomplete;
             }
         }
+        self.countPackets(side, .write, processed);
+        self.countMetric(.write_syscalls, processed.len);
+        self.countMetric(.write_batches, 1);
     }
 
-    fn onMuxReadable(context: ?*anyopaque, fd: io.FileDescriptor) callconv(.c) void {
-        const fd_set: *DescriptorSet = @ptrCast(@alignCast(context.?));
-        fd_set.insertReadable(fd);
-    }
-
-    fn onMuxWritable(context: ?*anyopaque, fd: io.FileDescriptor) callconv(.c) void {
-        const fd_set: *DescriptorSet = @ptrCast(@alignCast(context.?));
-        fd_set.insertWritable(fd);
-    }
-
-    fn handleCommands(self: *Looper, fd_set: *DescriptorSet) CommandOutcome {
+    fn handleCommands(self: *Looper) CommandOutcome {
         self.lock.lock();
         var pending = self.commands.takeReady();
 
@@ -814,7 +823,7 @@ pub const Looper = struct {
                 },
                 .enable_write => |identity| {
                     if (!self.isOutdatedLocked(identity)) {
-                        self.handleEnableWriteLocked(identity.side, fd_set) catch |err| {
+                        self.handleEnableWriteLocked(identity.side) catch |err| {
                             outcome.failure = .{ .system = err };
                         };
                     }
@@ -835,14 +844,6 @@ pub const Looper = struct {
                     self.lock.unlock();
                     self.lock.lock();
                 },
-                .timed_task => |command| {
-                    self.unregisterTimerLocked(node);
-                    if (command.task) |task| {
-                        self.lock.unlock();
-                        task.call();
-                        self.lock.lock();
-                    }
-                },
                 .stop => {
                     log.writef(.info, "Stop looper", .{});
                     outcome.should_continue = false;
@@ -895,15 +896,25 @@ pub const Looper = struct {
             side,
             descriptor,
             self.readBufferSize(side),
+            self.batchController(),
+            self.writeLimits(side),
             arguments,
         ) catch |err| {
             _ = c.pp_mux_delete(self.mux, descriptor.fd);
             self.queueCompletionLocked(completion, err);
             return;
         };
+        _ = c.pp_mux_set_user_data(self.mux, descriptor.fd, side_io);
+        self.attachReceiveRing(side_io) catch |err| {
+            log.writef(.err, "Unable to attach {} receive ring", .{side});
+            _ = c.pp_mux_delete(self.mux, descriptor.fd);
+            side_io.destroyStorage(self.allocator);
+            self.queueCompletionLocked(completion, err);
+            return;
+        };
         side_io.syncEventMask() catch {
             log.writef(.err, "Unable to retain {}", .{side});
-            _ = c.pp_mux_delete(self.mux, descriptor.fd);
+            _ = side_io.detachFromMux(self.mux);
             side_io.destroyStorage(self.allocator);
             self.queueCompletionLocked(completion, error.MuxFailure);
             return;
@@ -913,6 +924,35 @@ pub const Looper = struct {
         self.queueCompletionLocked(completion, null);
     }
 
+    /// Moves reads to a receive ring where the native I/O supports it. The
+    /// ring descriptor is then watched for reads, and the original one for
+    /// writes only. Sides keep reading with copies otherwise.
+    fn attachReceiveRing(
+        self: *Looper,
+        side_io: *SideIO,
+    ) (std.mem.Allocator.Error || Errors.MuxFailure)!void {
+        if (self.options.receive_ring_slots == 0) return;
+        const ring_slots = std.math.floorPowerOfTwo(
+            usize,
+            @min(self.options.receive_ring_slots, max_ring_slots),
+        );
+        try side_io.allocateReceiveSlots(self.allocator, @min(ring_slots, self.options.max_read_count));
+        errdefer side_io.freeReceiveSlots(self.allocator);
+        const ring_fd = side_io.native_io.openReceiveRing(
+            self.readBufferSize(side_io.side),
+            ring_slots,
+        ) orelse {
+            side_io.freeReceiveSlots(self.allocator);
+            return;
+        };
+        errdefer side_io.native_io.closeReceiveRing();
+        if (!c.pp_mux_add(self.mux, ring_fd)) return error.MuxFailure;
+        _ = c.pp_mux_set_user_data(self.mux, ring_fd, side_io);
+        _ = c.pp_mux_set_read(self.mux, side_io.fd, false);
+        side_io.read_fd = ring_fd;
+        log.writef(.info, "Attach {} receive ring (fd={any})", .{ side_io.side, ring_fd });
+    }
+
     fn handleDetachLocked(
         self: *Looper,
         side: io.Side,
@@ -932,51 +972,47 @@ pub const Looper = struct {
         }
     }
 
-    fn handleEnableWriteLocked(
-        self: *const Looper,
-        side: io.Side,
-        fd_set: *DescriptorSet,
-    ) io.Error!void {
+    fn handleEnableWriteLocked(self: *const Looper, side: io.Side) io.Error!void {
         if (self.sideIO(side)) |side_io| {
             try side_io.setWrite(self.mux, true);
-            fd_set.insertWritable(side_io.fd);
+            side_io.writable = true;
         } else {
             log.writef(.err, "Ignoring enableWrite({}), not attached", .{side});
         }
     }
 
-    fn process(self: *Looper, fd_set: *DescriptorSet) ProcessOutcome {
+    fn process(self: *Looper) ProcessOutcome {
         if (self.link) |link| {
-            if (fd_set.isReadable(link.fd) or fd_set.isWritable(link.fd)) {
+            if (link.readable or link.writable) {
                 link.resetEvents() catch |err| return .{ .fatal = .{ .system = err } };
             }
         }
         if (self.tun) |tun| {
-            if (fd_set.isReadable(tun.fd) or fd_set.isWritable(tun.fd)) {
+            if (tun.readable or tun.writable) {
                 tun.resetEvents() catch |err| return .{ .fatal = .{ .system = err } };
             }
         }
 
         if (self.link) |link| {
-            if (fd_set.isWritable(link.fd)) {
-                const outcome = self.processWrite(link, self.tun, fd_set);
+            if (link.writable) {
+                const outcome = self.processWrite(link, self.tun);
                 if (outcome != .ok) return outcome;
             }
         }
         if (self.tun) |tun| {
-            if (fd_set.isWritable(tun.fd)) {
-                const outcome = self.processWrite(tun, self.link, fd_set);
+            if (tun.writable) {
+                const outcome = self.processWrite(tun, self.link);
                 if (outcome != .ok) return outcome;
             }
         }
         if (self.tun) |tun| {
-            if (fd_set.isReadable(tun.fd)) {
+            if (tun.readable) {
                 const outcome = self.processRead(tun);
                 if (outcome != .ok) return outcome;
             }
         }
         if (self.link) |link| {
-            if (fd_set.isReadable(link.fd)) return self.processRead(link);
+            if (link.readable) return self.processRead(link);
         }
         return .ok;
     }
@@ -985,37 +1021,33 @@ pub const Looper = struct {
         self: *Looper,
         side_io: *SideIO,
         opposite: ?*SideIO,
-        fd_set: *DescriptorSet,
     ) ProcessOutcome {
         var watch_writes = false;
+        var syscalls: u64 = 0;
+        defer if (syscalls > 0) {
+            self.countMetric(.write_syscalls, syscalls);
+            self.countMetric(.write_batches, 1);
+        };
         while (self.pendingWrite(side_io)) |pending| {
-            const written = side_io.native_io.write(pending.data, pending.offset) catch |err| {
+            syscalls += 1;
+            const written = self.writePending(side_io, pending) catch |err| {
                 switch (err) {
                     error.WouldBlock => {
                         watch_writes = true;
                         break;
                     },
                     error.Backpressure => {
+                        self.countMetric(.backpressure_events, 1);
                         if (opposite) |other| {
-                            self.suspendRead(other, fd_set) catch |suspend_err| {
+                            self.suspendRead(other) catch |suspend_err| {
                                 return .{ .fatal = .{ .system = suspend_err } };
                             };
-                            self.scheduleReadRetry(other) catch |schedule_err| {
-                                if (schedule_err == error.OutOfMemory)
-                                    return .{ .fatal = .{ .system = error.OutOfMemory } };
-                                log.writef(.fault, "Unable to schedule read retry: {s}", .{
-                                    @errorName(schedule_err),
-                                });
-                                @panic("Looper read-retry scheduling failed after start");
+                            self.scheduleReadRetry(other) catch {
+                                return .{ .fatal = .{ .system = error.OutOfMemory } };
                             };
                         }
-                        self.scheduleWriteRetry(side_io) catch |schedule_err| {
-                            if (schedule_err == error.OutOfMemory)
-                                return .{ .fatal = .{ .system = error.OutOfMemory } };
-                            log.writef(.fault, "Unable to schedule write retry: {s}", .{
-                                @errorName(schedule_err),
-                            });
-                            @panic("Looper write-retry scheduling failed after start");
+                        self.scheduleWriteRetry(side_io) catch {
+                            return .{ .fatal = .{ .system = error.OutOfMemory } };
                         };
                         watch_writes = false;
                         break;
@@ -1035,11 +1067,31 @@ pub const Looper = struct {
         side_io.setWrite(self.mux, watch_writes) catch |err| {
             return .{ .fatal = .{ .system = err } };
         };
-        if (!watch_writes) fd_set.removeWritable(side_io.fd);
+        if (!watch_writes) side_io.writable = false;
         return .ok;
     }
 
-    fn processRead(self: *const Looper, side_io: *SideIO) ProcessOutcome {
+    /// Writes the head packet, or as many queued packets as possible with a
+    /// single call when the side is a byte stream.
+    fn writePending(
+        self: *Looper,
+        side_io: *SideIO,
+        pending: queue_mod.PendingWrite,
+    ) io.Error!usize {
+        if (!side_io.native_io.gathersWrites())
+            return side_io.native_io.write(pending.data, pending.offset);
+
+        // Queued buffers are only released by this thread, so the views
+        // remain valid after unlocking.
+        var chunks: [max_gathered_writes][]const u8 = undefined;
+        self.lock.lock();
+        const count = side_io.write_queue.gather(&chunks);
+        self.lock.unlock();
+        return side_io.native_io.writeVectored(chunks[0..count], pending.offset);
+    }
+
+    fn processRead(self: *Looper, side_io: *SideIO) ProcessOutcome {
+        if (side_io.receive_slots.len > 0) return self.processReceive(side_io);
         var inbox: std.ArrayList(Packet) = .empty;
         defer {
             for (inbox.items) |packet| self.allocator.free(@constCast(packet));
@@ -1048,7 +1100,15 @@ pub const Looper = struct {
 
         var read_count: usize = 0;
         var read_size: usize = 0;
-        while (read_count < self.options.max_read_count and read_size < self.options.max_read_size) {
+        var syscalls: u64 = 0;
+        defer {
+            self.countMetric(.read_syscalls, syscalls);
+            self.countMetric(.read_batches, 1);
+        }
+        const read_limit = side_io.readLimit(self.options.max_read_count);
+        const start_ns = side_io.batchStartNs();
+        while (read_count < read_limit and read_size < self.options.max_read_size) {
+            syscalls += 1;
             const maybe_count = side_io.native_io.read(side_io.read_buf) catch |err| {
                 if (err == error.WouldBlock) break;
                 return .{ .side_failure = .{
@@ -1069,7 +1129,10 @@ pub const Looper = struct {
             read_count += 1;
         }
 
+        if (read_count > 0) self.adjustReadBatch(side_io, read_count, start_ns);
         if (inbox.items.len > 0) {
+            self.countPackets(side_io.side, .read, inbox.items);
+            self.countMetric(.allocations, inbox.items.len);
             const action = if (side_io.on_read) |callback|
                 callback.call(inbox.items) catch |err| {
                     return .{ .side_failure = .{
@@ -1088,13 +1151,112 @@ pub const Looper = struct {
         return .ok;
     }
 
-    fn suspendRead(
-        self: *Looper,
-        side_io: *SideIO,
-        fd_set: *DescriptorSet,
-    ) io.Error!void {
+    /// Hands packets to `on_read` straight from the receive ring, one batch
+    /// per readiness event, as the ring descriptor stays readable while
+    /// completions are pending.
+    fn processReceive(self: *Looper, side_io: *SideIO) ProcessOutcome {
+        const slots = side_io.receive_slots[0..side_io.readLimit(side_io.receive_slots.len)];
+        const start_ns = side_io.batchStartNs();
+        const count = side_io.native_io.receive(slots) catch |err| {
+            if (err == error.WouldBlock) return .ok;
+            return .{ .side_failure = .{
+                .side = side_io.side,
+                .failure = side_io.ioFailure(err),
+            } };
+        };
+        defer side_io.native_io.release(slots[0..count]);
+        self.countMetric(.read_batches, 1);
+        if (count == 0) return .ok;
+        self.adjustReadBatch(side_io, count, start_ns);
+
+        const packets = side_io.received_packets[0..count];
+        for (slots[0..count], packets) |slot, *packet| {
+            packet.* = slot.bytes[0..slot.length];
+        }
+        self.countPackets(side_io.side, .read, packets);
+        const action = if (side_io.on_read) |callback|
+            callback.call(packets) catch |err| {
+                return .{ .side_failure = .{
+                    .side = side_io.side,
+                    .failure = .{ .user = err },
+                } };
+            }
+        else
+            ReadAction.keep;
+        if (action == .pause) {
+            side_io.setRead(self.mux, false) catch |err| {
+                return .{ .fatal = .{ .system = err } };
+            };
+        }
+        return .ok;
+    }
+
+    fn batchController(self: *const Looper) ?BatchController {
+        if (self.options.read_latency_target_ns == 0) return null;
+        return BatchController.init(.{
+            .target_latency_ns = self.options.read_latency_target_ns,
+            .max_count = self.options.max_read_count,
+        });
+    }
+
+    /// Tunes the next read batch of the side after a batch of `count`
+    /// packets, read since `start_ns`.
+    fn adjustReadBatch(self: *Looper, side_io: *SideIO, count: usize, start_ns: u64) void {
+        const batch = if (side_io.batch) |*value| value else return;
+        const latency_ns = core.concurrency.monotonicNs() -| start_ns;
+        const opposite: io.Side = switch (side_io.side) {
+            .link => .tun,
+            .tun => .link,
+        };
+        const adjustment = batch.record(.{
+            .count = count,
+            .latency_ns = latency_ns,
+            .queue_depth = self.queuedWrites(opposite),
+        });
+        const metrics = self.options.metrics orelse return;
+        metrics.recordLatency(.read_batch, latency_ns);
+        switch (adjustment) {
+            .none => {},
+            .grow => metrics.increment(.read_batch_grows),
+            .shrink => metrics.increment(.read_batch_shrinks),
+        }
+        metrics.set(switch (side_io.side) {
+            .link => .link_read_batch_limit,
+            .tun => .tun_read_batch_limit,
+        }, batch.limit());
+    }
+
+    fn countMetric(self: *const Looper, counter: core.metrics.Counter, value: u64) void {
+        const metrics = self.options.metrics orelse return;
+        metrics.add(counter, value);
+    }
+
+    fn countPackets(
+        self: *const Looper,
+        side: io.Side,
+        comptime direction: enum { read, write },
+        packets: Packets,
+    ) void {
+        const metrics = self.options.metrics orelse return;
+        var bytes: u64 = 0;
+        for (packets) |packet| bytes += packet.len;
+        const counters: [2]core.metrics.Counter = switch (direction) {
+            .read => switch (side) {
+                .link => .{ .link_read_packets, .link_read_bytes },
+                .tun => .{ .tun_read_packets, .tun_read_bytes },
+            },
+            .write => switch (side) {
+                .link => .{ .link_write_packets, .link_write_bytes },
+                .tun => .{ .tun_write_packets, .tun_write_bytes },
+            },
+        };
+        metrics.add(counters[0], packets.len);
+        metrics.add(counters[1], bytes);
+    }
+
+    fn suspendRead(self: *Looper, side_io: *SideIO) io.Error!void {
         try side_io.setRead(self.mux, false);
-        fd_set.removeReadable(side_io.fd);
+        side_io.readable = false;
     }
 
     fn scheduleReadRetry(
@@ -1105,19 +1267,11 @@ pub const Looper = struct {
         defer self.lock.unlock();
         const index = sideIndex(side_io.side);
         if (self.state != .started or self.read_retries[index]) return;
-        const node = try self.createCommandNode(.{ .enable_read = .{
+        _ = try self.armTimer(no_buf_retry_delay_ms, .{ .enable_read = .{
             .side = side_io.side,
             .id = side_io.id,
         } });
-        errdefer self.allocator.destroy(node);
         self.read_retries[index] = true;
-        errdefer self.read_retries[index] = false;
-        try self.scheduler.scheduleAppending(
-            &node.timer,
-            no_buf_retry_delay_ms,
-            onScheduledCommand,
-            self,
-        );
     }
 
     fn scheduleWriteRetry(
@@ -1128,19 +1282,51 @@ pub const Looper = struct {
         defer self.lock.unlock();
         const index = sideIndex(side_io.side);
         if (self.state != .started or self.write_retries[index]) return;
-        const node = try self.createCommandNode(.{ .enable_write = .{
+        _ = try self.armTimer(no_buf_retry_delay_ms, .{ .enable_write = .{
             .side = side_io.side,
             .id = side_io.id,
         } });
-        errdefer self.allocator.destroy(node);
         self.write_retries[index] = true;
-        errdefer self.write_retries[index] = false;
-        try self.scheduler.scheduleAppending(
-            &node.timer,
-            no_buf_retry_delay_ms,
-            onScheduledCommand,
-            self,
-        );
+    }
+
+    /// Moves elapsed timers to the due list and dispatches them one at a
+    /// time, so that a callback may still cancel a sibling that is already
+    /// due. Nodes return to the pool before their task runs, which lets the
+    /// task re-arm its own token.
+    fn runDueTimers(self: *Looper) ?Failure {
+        self.timers.advance(core.concurrency.monotonicNs());
+        while (self.timers.popDue()) |entry| {
+            const node = TimerNode.fromEntry(entry);
+            const command = node.command;
+            self.timer_pool.release(node);
+            switch (command) {
+                .timed_task => |task| {
+                    self.lock.lock();
+                    const is_started = self.state == .started;
+                    self.lock.unlock();
+                    if (is_started) task.call();
+                },
+                .enable_read => |identity| {
+                    self.lock.lock();
+                    defer self.lock.unlock();
+                    self.read_retries[sideIndex(identity.side)] = false;
+                    if (self.state != .started or self.isOutdatedLocked(identity)) continue;
+                    self.handleEnableReadLocked(identity.side) catch |err| {
+                        return .{ .system = err };
+                    };
+                },
+                .enable_write => |identity| {
+                    self.lock.lock();
+                    defer self.lock.unlock();
+                    self.write_retries[sideIndex(identity.side)] = false;
+                    if (self.state != .started or self.isOutdatedLocked(identity)) continue;
+                    self.handleEnableWriteLocked(identity.side) catch |err| {
+                        return .{ .system = err };
+                    };
+                },
+            }
+        }
+        return null;
     }
 
     fn detachImmediately(self: *Looper, side: io.Side, failure: Failure) void {
@@ -1187,7 +1373,7 @@ pub const Looper = struct {
         self.condition.broadcast();
         self.lock.unlock();
 
-        self.scheduler.cancel();
+        self.cancelAllTimers();
 
         if (failure) |reason| switch (reason) {
             .wait => |code| log.writef(.err, "Finish looper with error: wait({d})", .{code}),
@@ -1270,10 +1456,6 @@ pub const Looper = struct {
         self.setSideIO(side, null);
         self.read_retries[sideIndex(side)] = false;
         self.write_retries[sideIndex(side)] = false;
-        if (self.fd_set) |*fd_set| {
-            fd_set.removeReadable(side_io.fd);
-            fd_set.removeWritable(side_io.fd);
-        }
         return side_io;
     }
 
@@ -1292,10 +1474,8 @@ pub const Looper = struct {
     /// must either be the caller or have been joined.
     fn cleanupResourcesLocked(self: *Looper) void {
         self.cleanupSidesLocked();
-        if (self.fd_set) |*fd_set| {
-            fd_set.deinit();
-            self.fd_set = null;
-        }
+        self.timers.clear();
+        self.timer_pool.deinit();
         c.pp_mux_free(self.mux);
     }
 
@@ -1333,6 +1513,13 @@ pub const Looper = struct {
         };
     }
 
+    fn writeLimits(self: Looper, side: io.Side) WriteLimits {
+        return switch (side) {
+            .link => self.options.link_write_limits,
+            .tun => self.options.tun_write_limits,
+        };
+    }
+
     fn isOutdatedLocked(self: *const Looper, identity: SideIdentity) bool {
         const id = identity.id orelse return false;
         const side_io = self.sideIO(identity.side) orelse return true;
@@ -1342,7 +1529,17 @@ pub const Looper = struct {
     fn pendingWrite(self: *Looper, side_io: *SideIO) ?queue_mod.PendingWrite {
         self.lock.lock();
         defer self.lock.unlock();
-        return side_io.write_queue.pending();
+        const pending = side_io.write_queue.peek();
+        const drops = side_io.write_queue.takeDrops();
+        if (drops > 0) self.countMetric(.write_drops, drops);
+        return pending;
+    }
+
+    fn queuedWrites(self: *Looper, side: io.Side) usize {
+        self.lock.lock();
+        defer self.lock.unlock();
+        const side_io = self.sideIO(side) orelse return 0;
+        return side_io.write_queue.len();
     }
 
     fn createCommandNode(self: *const Looper, command: Command) std.mem.Allocator.Error!*CommandNode {
@@ -1351,98 +1548,46 @@ pub const Looper = struct {
         return node;
     }
 
-    fn nextTimerIdLocked(self: *Looper) u64 {
+    fn nextTimerId(self: *Looper) u64 {
         const id = self.next_timer_id;
         self.next_timer_id +%= 1;
         if (self.next_timer_id == 0) self.next_timer_id = 1;
         return id;
     }
 
-    fn registerTimerLocked(self: *Looper, node: *CommandNode) void {
-        node.timer_next = self.timers_head;
-        self.timers_head = node;
-    }
-
-    fn unregisterTimerLocked(self: *Looper, node: *CommandNode) void {
-        var previous: ?*CommandNode = null;
-        var current = self.timers_head;
-        while (current) |candidate| {
-            if (candidate == node) {
-                if (previous) |before| {
-                    before.timer_next = candidate.timer_next;
-                } else {
-                    self.timers_head = candidate.timer_next;
-                }
-                candidate.timer_next = null;
-                return;
-            }
-            previous = candidate;
-            current = candidate.timer_next;
-        }
-    }
-
-    fn cancelTimerLocked(self: *Looper, id: u64) void {
-        var current = self.timers_head;
-        while (current) |node| : (current = node.timer_next) {
-            switch (node.command) {
-                .timed_task => |command| if (command.id == id) {
-                    // The scheduler may already be moving this command to the
-                    // ready queue. Clearing the task under the looper lock is
-                    // the cancellation barrier for its borrowed context.
-                    node.command.timed_task.task = null;
-                    return;
-                },
-                else => unreachable,
-            }
-        }
+    fn armTimer(
+        self: *Looper,
+        delay_ms: u64,
+        command: TimerCommand,
+    ) std.mem.Allocator.Error!*TimerNode {
+        const node = try self.timer_pool.acquire(self.nextTimerId(), command);
+        self.timers.schedule(&node.entry, deadlineAfterMs(delay_ms));
+        return node;
     }
 
-    fn isActiveTimerCommand(command: Command) bool {
-        return switch (command) {
-            .timed_task => |timer| timer.task != null,
-            else => true,
-        };
+    /// Resolves a token to its node only while the node still carries the
+    /// token's id, i.e. it has neither run nor been recycled.
+    fn pendingTimerNode(_: *const Looper, timer: *const Timer) ?*TimerNode {
+        const id = timer.id orelse return null;
+        const node = timer.node orelse return null;
+        if (node.id != id) return null;
+        return node;
     }
 
-    fn unregisterTimerCommandLocked(self: *Looper, node: *CommandNode) void {
-        switch (node.command) {
-            .timed_task => self.unregisterTimerLocked(node),
-            else => {},
-        }
+    /// Unlinks every pending timer. Stale tokens stop matching their nodes.
+    fn cancelAllTimers(self: *Looper) void {
+        self.timers.clear();
+        self.timer_pool.releaseAll();
     }
 
-    fn onScheduledCommand(
-        scheduled: *core.RunAfter.Scheduled,
-        outcome: core.RunAfter.Scheduled.Outcome,
-    ) void {
-        const node: *CommandNode = @fieldParentPtr("timer", scheduled);
-        const self: *Looper = @ptrCast(@alignCast(scheduled.context.?));
-        self.lock.lock();
-        defer self.lock.unlock();
-
-        self.clearRetryForCommand(node.command);
-        if (outcome == .elapsed and
-            self.state == .started and
-            isActiveTimerCommand(node.command))
-        {
-            self.commands.append(node);
-            self.wakeLocked();
-        } else {
-            self.unregisterTimerCommandLocked(node);
-            self.allocator.destroy(node);
-        }
+    /// Returns the mux deadline that wakes the loop at the next timer. The
+    /// mux clock is the same as `core.concurrency.monotonicNs`.
+    fn waitDeadlineNs(self: *const Looper) u64 {
+        return self.timers.nextDeadlineNs() orelse c.PPMuxNoDeadline;
     }
 
-    fn clearRetryForCommand(self: *Looper, command: Command) void {
-        switch (command) {
-            .enable_read => |identity| if (identity.id != null) {
-                self.read_retries[sideIndex(identity.side)] = false;
-            },
-            .enable_write => |identity| if (identity.id != null) {
-                self.write_retries[sideIndex(identity.side)] = false;
-            },
-            else => {},
-        }
+    fn deadlineAfterMs(delay_ms: u64) u64 {
+        return core.concurrency.deadlineAfterMs(core.concurrency.monotonicNs(), delay_ms);
     }
 
     fn cancelPendingLocked(self: *Looper, pending_head: ?*CommandNode) void {
@@ -1450,8 +1595,6 @@ pub const Looper = struct {
         while (pending) |node| {
             const next = node.next;
             const allocated = node.allocated;
-            self.clearRetryForCommand(node.command);
-            self.unregisterTimerCommandLocked(node);
             switch (node.command) {
                 .attach => |command| self.queueCompletionLocked(command.completion, error.LooperUnavailable),
                 .detach => |command| self.queueCompletionLocked(command.completion, error.LooperUnavailable),
@@ -1492,6 +1635,8 @@ pub const Looper = struct {
         id: u64,
         side: io.Side,
         fd: io.FileDescriptor,
+        /// Differs from `fd` when reading from a receive ring.
+        read_fd: io.FileDescriptor,
         native_io: io.IOInterface,
 
         // User callbacks.
@@ -1501,13 +1646,22 @@ pub const Looper = struct {
 
         // Buffered packet state.
         read_buf: []u8,
+        /// Null when reading up to the static limits.
+        batch: ?BatchController,
         write_queue: WriteQueue,
+        /// Empty unless reading from a receive ring.
+        receive_slots: []io.ReceiveSlot,
+        received_packets: []Packet,
 
         // Mux event and cleanup state.
         is_reading: bool,
         is_writing: bool,
         did_cleanup: bool,
 
+        // Readiness, where writes stay pending until the queue drains.
+        readable: bool,
+        writable: bool,
+
         // In-flight transform synchronization.
         transform_drainer: core.Drainer,
 
@@ -1517,6 +1671,8 @@ pub const Looper = struct {
             side: io.Side,
             descriptor: Descriptor,
             read_buf_size: usize,
+            batch: ?BatchController,
+            write_limits: WriteLimits,
             arguments: AttachArguments,
         ) std.mem.Allocator.Error!*SideIO {
             const self = try allocator.create(SideIO);
@@ -1526,33 +1682,67 @@ pub const Looper = struct {
                 .id = id,
                 .side = side,
                 .fd = descriptor.fd,
+                .read_fd = descriptor.fd,
                 .native_io = descriptor.io,
                 .transform_write = arguments.transform_write,
                 .on_read = arguments.on_read,
                 .on_failure = arguments.on_failure,
                 .read_buf = read_buf,
-                .write_queue = WriteQueue.init(allocator),
+                .batch = batch,
+                .write_queue = WriteQueue.initWithLimits(allocator, write_limits),
+                .receive_slots = &.{},
+                .received_packets = &.{},
                 .is_reading = true,
                 .is_writing = false,
                 .did_cleanup = false,
+                .readable = false,
+                .writable = false,
                 .transform_drainer = .{},
             };
             return self;
         }
 
+        fn allocateReceiveSlots(
+            self: *SideIO,
+            allocator: std.mem.Allocator,
+            count: usize,
+        ) std.mem.Allocator.Error!void {
+            const slots = try allocator.alloc(io.ReceiveSlot, count);
+            errdefer allocator.free(slots);
+            self.received_packets = try allocator.alloc(Packet, count);
+            self.receive_slots = slots;
+        }
+
+        fn freeReceiveSlots(self: *SideIO, allocator: std.mem.Allocator) void {
+            allocator.free(self.receive_slots);
+            allocator.free(self.received_packets);
+            self.receive_slots = &.{};
+            self.received_packets = &.{};
+        }
+
         fn destroyStorage(self: *SideIO, allocator: std.mem.Allocator) void {
             self.write_queue.deinit();
+            self.freeReceiveSlots(allocator);
             allocator.free(self.read_buf);
             self.transform_drainer.deinit();
             allocator.destroy(self);
         }
 
+        fn readLimit(self: *const SideIO, max_count: usize) usize {
+            const batch = self.batch orelse return max_count;
+            return @min(batch.limit(), max_count);
+        }
+
+        fn batchStartNs(self: *const SideIO) u64 {
+            return if (self.batch != null) core.concurrency.monotonicNs() else 0;
+        }
+
         fn resetEvents(self: *const SideIO) io.Error!void {
             return self.native_io.resetEvents();
         }
 
         fn setRead(self: *SideIO, mux: c.pp_mux, enabled: bool) io.Error!void {
-            _ = c.pp_mux_set_read(mux, self.fd, enabled);
+            _ = c.pp_mux_set_read(mux, self.read_fd, enabled);
             self.is_reading = enabled;
             try self.syncEventMask();
         }
@@ -1571,6 +1761,7 @@ pub const Looper = struct {
             if (self.did_cleanup) return false;
             self.did_cleanup = true;
             _ = c.pp_mux_delete(mux, self.fd);
+            if (self.read_fd != self.fd) _ = c.pp_mux_delete(mux, self.read_fd);
             return true;
         }
 
@@ -1589,88 +1780,4 @@ pub const Looper = struct {
             } };
         }
     };
-
-    const DescriptorSet = struct {
-        allocator: std.mem.Allocator,
-
-        readable: std.ArrayList(io.FileDescriptor),
-        writable: std.ArrayList(io.FileDescriptor),
-
-        allocation_failed: bool,
-
-        fn init(allocator: std.mem.Allocator) std.mem.Allocator.Error!DescriptorSet {
-            var self = DescriptorSet{
-                .allocator = allocator,
-                .readable = .empty,
-                .writable = .empty,
-                .allocation_failed = false,
-            };
-            errdefer self.deinit();
-            try self.readable.ensureTotalCapacity(allocator, number_of_descriptors);
-            try self.writable.ensureTotalCapacity(allocator, number_of_descriptors);
-            return self;
-        }
-
-        fn deinit(self: *DescriptorSet) void {
-            self.readable.deinit(self.allocator);
-            self.writable.deinit(self.allocator);
-        }
-
-        fn resetReadable(self: *DescriptorSet) void {
-            self.readable.clearRetainingCapacity();
-        }
-
-        fn insertReadable(self: *DescriptorSet, fd: io.FileDescriptor) void {
-            self.insert(&self.readable, fd) catch {
-                self.allocation_failed = true;
-            };
-        }
-
-        fn insertWritable(self: *DescriptorSet, fd: io.FileDescriptor) void {
-            self.insert(&self.writable, fd) catch {
-                self.allocation_failed = true;
-            };
-        }
-
-        fn insert(
-            self: *const DescriptorSet,
-            list: *std.ArrayList(io.FileDescriptor),
-            fd: io.FileDescriptor,
-        ) std.mem.Allocator.Error!void {
-            if (contains(list.items, fd)) return;
-            try list.append(self.allocator, fd);
-        }
-
-        fn removeReadable(self: *DescriptorSet, fd: io.FileDescriptor) void {
-            remove(&self.readable, fd);
-        }
-
-        fn removeWritable(self: *DescriptorSet, fd: io.FileDescriptor) void {
-            remove(&self.writable, fd);
-        }
-
-        fn isReadable(self: DescriptorSet, fd: io.FileDescriptor) bool {
-            return contains(self.readable.items, fd);
-        }
-
-        fn isWritable(self: DescriptorSet, fd: io.FileDescriptor) bool {
-            return contains(self.writable.items, fd);
-        }
-
-        fn contains(list: []const io.FileDescriptor, fd: io.FileDescriptor) bool {
-            for (list) |item| {
-                if (item == fd) return true;
-            }
-            return false;
-        }
-
-        fn remove(list: *std.ArrayList(io.FileDescriptor), fd: io.FileDescriptor) void {
-            for (list.items, 0..) |item, index| {
-                if (item == fd) {
-                    _ = list.orderedRemove(index);
-                    return;
-                }
-            }
-        }
-    };
 };
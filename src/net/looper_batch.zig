@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Adaptive sizing of the `Looper` read batches.
+//!
+//! A batch holds the packets read before `on_read` is called, so the first
+//! packet of a batch waits for the last one. Each side tunes its batch limit
+//! after every batch:
+//!
+//! - The per-packet read cost is averaged, and the limit never exceeds the
+//!   count that fits the added latency target.
+//! - Full batches (arrivals faster than reads) double the limit, up to that
+//!   budget. Partial batches mean sparse arrivals, and leave it unchanged.
+//! - Batches over the target, or a deep write queue on the opposite side,
+//!   halve the limit, since reading more would only queue more.
+
+const std = @import("std");
+
+pub const BatchController = struct {
+    /// Weight of a new sample in the cost average, as a power of 2.
+    const cost_shift = 3;
+
+    pub const Options = struct {
+        /// Added latency that a batch should not exceed.
+        target_latency_ns: u64 = 200 * std.time.ns_per_us,
+        min_count: usize = 1,
+        max_count: usize,
+        /// Write queue depth of the opposite side that halves batches.
+        queue_high_watermark: usize = 256,
+    };
+
+    /// An observed batch.
+    pub const Sample = struct {
+        count: usize,
+        /// From the first read to the `on_read` call.
+        latency_ns: u64,
+        /// Packets queued for write on the opposite side.
+        queue_depth: usize,
+    };
+
+    pub const Adjustment = enum {
+        none,
+        grow,
+        shrink,
+    };
+
+    options: Options,
+    current_limit: usize,
+    /// Average read cost per packet, in nanoseconds.
+    cost_ns: u64,
+
+    pub fn init(options: Options) BatchController {
+        std.debug.assert(options.min_count > 0);
+        std.debug.assert(options.min_count <= options.max_count);
+        return .{
+            .options = options,
+            .current_limit = options.min_count,
+            .cost_ns = 0,
+        };
+    }
+
+    pub fn limit(self: BatchController) usize {
+        return self.current_limit;
+    }
+
+    /// Returns the count of packets that fits the latency target.
+    pub fn budget(self: BatchController) usize {
+        if (self.cost_ns == 0) return self.options.max_count;
+        const count = @min(self.options.target_latency_ns / self.cost_ns, self.options.max_count);
+        return @max(count, self.options.min_count);
+    }
+
+    pub fn record(self: *BatchController, sample: Sample) Adjustment {
+        if (sample.count == 0) return .none;
+        const cost = sample.latency_ns / sample.count;
+        if (self.cost_ns == 0) {
+            self.cost_ns = cost;
+        } else if (cost >= self.cost_ns) {
+            self.cost_ns += (cost - self.cost_ns) >> cost_shift;
+        } else {
+            self.cost_ns -= (self.cost_ns - cost) >> cost_shift;
+        }
+
+        const previous = self.current_limit;
+        if (sample.queue_depth >= self.options.queue_high_watermark or
+            sample.latency_ns > self.options.target_latency_ns)
+        {
+            self.current_limit = @max(self.options.min_count, self.current_limit / 2);
+        } else if (sample.count >= self.current_limit) {
+            self.current_limit = @min(self.current_limit *| 2, self.budget());
+        }
+        self.current_limit = @max(self.current_limit, self.options.min_count);
+
+        if (self.current_limit > previous) return .grow;
+        if (self.current_limit < previous) return .shrink;
+        return .none;
+    }
+};
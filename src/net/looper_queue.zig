@@ -113,8 +113,11 @@ pub const TimedTask = struct {
 
 /// Identity of one replaceable delayed task. The looper never retains this
 /// value's address; callers may store it inline with their queue-owned state.
+/// `node` is a looper-owned hint that makes cancellation constant-time; it is
+/// only trusted while the node still carries `id`.
 pub const Timer = struct {
     id: ?u64 = null,
+    node: ?*TimerNode = null,
 };
 
 /// A descriptor includes:
@@ -223,18 +226,12 @@ pub const Command = union(enum) {
         task: Task,
         completion: *Completion,
     },
-    timed_task: struct {
-        id: u64,
-        task: ?TimedTask,
-    },
     stop,
 };
 
-/// A node in `CommandQueue`, with the payload and
-/// an optional one-shot timer for deferred scheduling.
+/// A node in `CommandQueue` with its payload.
 pub const CommandNode = struct {
     command: Command,
-    timer: core.RunAfter.Scheduled = .{},
 
     // Synchronous callers keep their node on the stack until completion.
     // Asynchronous commands set this when allocating a persistent node.
@@ -242,9 +239,93 @@ pub const CommandNode = struct {
 
     // Intrusive command queue linkage.
     next: ?*CommandNode = null,
+};
+
+/// Delayed work armed on the looper's timer wheel. Retries carry the side
+/// identity so that they are discarded if the side is replaced meanwhile.
+pub const TimerCommand = union(enum) {
+    timed_task: TimedTask,
+    enable_read: SideIdentity,
+    enable_write: SideIdentity,
+};
+
+/// A looper-owned timer wheel entry. Nodes are recycled through `TimerPool`
+/// and only released when the looper is deinitialized, so a stale `Timer`
+/// token may safely compare its id against a node that was reused.
+pub const TimerNode = struct {
+    entry: core.TimerWheel.Entry = .{},
+    // Zero while the node is idle in the pool.
+    id: u64 = 0,
+    command: TimerCommand = .{ .timed_task = undefined },
+
+    // Intrusive free-list and ownership linkage.
+    next_free: ?*TimerNode = null,
+    next_owned: ?*TimerNode = null,
+
+    pub fn fromEntry(entry: *core.TimerWheel.Entry) *TimerNode {
+        return @fieldParentPtr("entry", entry);
+    }
+};
+
+/// Recycling allocator for `TimerNode`. Steady-state scheduling does not
+/// allocate. Not thread-safe.
+pub const TimerPool = struct {
+    allocator: std.mem.Allocator,
+    free: ?*TimerNode = null,
+    owned: ?*TimerNode = null,
+
+    pub fn init(allocator: std.mem.Allocator) TimerPool {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *TimerPool) void {
+        var current = self.owned;
+        while (current) |node| {
+            current = node.next_owned;
+            self.allocator.destroy(node);
+        }
+        self.free = null;
+        self.owned = null;
+    }
+
+    pub fn acquire(
+        self: *TimerPool,
+        id: u64,
+        command: TimerCommand,
+    ) std.mem.Allocator.Error!*TimerNode {
+        const node = if (self.free) |free| free: {
+            self.free = free.next_free;
+            break :free free;
+        } else created: {
+            const created = try self.allocator.create(TimerNode);
+            created.* = .{ .next_owned = self.owned };
+            self.owned = created;
+            break :created created;
+        };
+        node.id = id;
+        node.command = command;
+        node.next_free = null;
+        return node;
+    }
+
+    /// Returns every node to the free list. The timer wheel must already have
+    /// been cleared.
+    pub fn releaseAll(self: *TimerPool) void {
+        self.free = null;
+        var current = self.owned;
+        while (current) |node| {
+            current = node.next_owned;
+            self.release(node);
+        }
+    }
 
-    // Intrusive linkage while a timed task is pending or ready.
-    timer_next: ?*CommandNode = null,
+    /// The node must already be unlinked from the timer wheel.
+    pub fn release(self: *TimerPool, node: *TimerNode) void {
+        node.id = 0;
+        node.command = .{ .timed_task = undefined };
+        node.next_free = self.free;
+        self.free = node;
+    }
 };
 
 /// A plain FIFO for the pending worker commands. Not thread-safe.
@@ -280,47 +361,124 @@ pub const PendingWrite = struct {
 /// A node in `WriteQueue`.
 const WriteNode = struct {
     data: []u8,
+    /// Only set with the `.codel` policy.
+    enqueued_ns: u64 = 0,
     next: ?*WriteNode = null,
 };
 
 /// Owned FIFO of packet buffers with partial consumption of the head packet.
 /// The queue is not thread-safe; callers must synchronize access.
+///
+/// The queue is bounded by `Limits`, and packets beyond the bounds are
+/// dropped by policy. Views returned by `peek` and `gather` stay borrowed
+/// until the next `advance` or `peek`, and are never dropped meanwhile.
 pub const WriteQueue = struct {
+    pub const DropPolicy = enum {
+        /// Drops the incoming packets that exceed the bounds.
+        tail,
+        /// Drops the oldest packets to make room for the incoming ones.
+        head,
+        /// Drops like `.tail`, and drops the head on dequeue while packets
+        /// stay queued longer than the CoDel target (RFC 8289).
+        codel,
+    };
+
+    pub const Limits = struct {
+        max_packets: usize = std.math.maxInt(usize),
+        max_bytes: usize = std.math.maxInt(usize),
+        policy: DropPolicy = .tail,
+        codel_target_ns: u64 = 5 * std.time.ns_per_ms,
+        codel_interval_ns: u64 = 100 * std.time.ns_per_ms,
+    };
+
+    /// CoDel state, see RFC 8289.
+    const CoDel = struct {
+        first_above_ns: u64 = 0,
+        drop_next_ns: u64 = 0,
+        drop_count: u64 = 0,
+        dropping: bool = false,
+    };
+
     allocator: std.mem.Allocator,
+    limits: Limits = .{},
 
     // Owned FIFO and partial head progress.
     head: ?*WriteNode = null,
     tail: ?*WriteNode = null,
     offset: usize = 0,
+    count: usize = 0,
+    bytes: usize = 0,
+
+    // Head packets in use by the writer, and drops not yet reported.
+    borrowed: usize = 0,
+    drops: usize = 0,
+    codel: CoDel = .{},
 
     pub fn init(allocator: std.mem.Allocator) WriteQueue {
         return .{ .allocator = allocator };
     }
 
+    pub fn initWithLimits(allocator: std.mem.Allocator, limits: Limits) WriteQueue {
+        return .{ .allocator = allocator, .limits = limits };
+    }
+
     pub fn deinit(self: *WriteQueue) void {
         destroyList(self.allocator, self.head);
         self.head = null;
         self.tail = null;
         self.offset = 0;
+        self.count = 0;
+        self.bytes = 0;
+        self.borrowed = 0;
+    }
+
+    /// Returns the number of queued packets.
+    pub fn len(self: *const WriteQueue) usize {
+        return self.count;
+    }
+
+    /// Returns the size of the queued packets in bytes.
+    pub fn size(self: *const WriteQueue) usize {
+        return self.bytes;
     }
 
-    /// Copies and appends the entire packet batch, or leaves the queue unchanged.
+    /// Returns and resets the number of packets dropped so far.
+    pub fn takeDrops(self: *WriteQueue) usize {
+        defer self.drops = 0;
+        return self.drops;
+    }
+
+    /// Copies and appends the packet batch within the bounds, or leaves the
+    /// queue unchanged.
     pub fn append(self: *WriteQueue, packets: Packets) std.mem.Allocator.Error!void {
+        return self.appendAt(packets, self.now());
+    }
+
+    pub fn appendAt(self: *WriteQueue, packets: Packets, now_ns: u64) std.mem.Allocator.Error!void {
         var new_head: ?*WriteNode = null;
         var new_tail: ?*WriteNode = null;
         errdefer destroyList(self.allocator, new_head);
 
+        var new_count: usize = 0;
+        var new_bytes: usize = 0;
+        var dropped: usize = 0;
         for (packets) |packet| {
+            if (!self.accepts(new_count, new_bytes, packet.len)) {
+                dropped += 1;
+                continue;
+            }
             const copy = try self.allocator.dupe(u8, packet);
             errdefer self.allocator.free(copy);
             const node = try self.allocator.create(WriteNode);
-            node.* = .{ .data = copy };
+            node.* = .{ .data = copy, .enqueued_ns = now_ns };
             if (new_tail) |tail| {
                 tail.next = node;
             } else {
                 new_head = node;
             }
             new_tail = node;
+            new_count += 1;
+            new_bytes += packet.len;
         }
 
         if (new_head) |head| {
@@ -330,7 +488,11 @@ pub const WriteQueue = struct {
                 self.head = head;
             }
             self.tail = new_tail;
+            self.count += new_count;
+            self.bytes += new_bytes;
         }
+        self.drops += dropped;
+        if (self.limits.policy == .head) self.evictOldest();
     }
 
     /// Returns a borrowed view of the head packet and its current offset.
@@ -342,26 +504,165 @@ pub const WriteQueue = struct {
         };
     }
 
-    /// Advances the head packet and returns whether it was fully consumed.
+    /// Like `pending`, but applies the dequeue policy first and marks the
+    /// head as borrowed. Only the writer may call this.
+    pub fn peek(self: *WriteQueue) ?PendingWrite {
+        return self.peekAt(self.now());
+    }
+
+    pub fn peekAt(self: *WriteQueue, now_ns: u64) ?PendingWrite {
+        self.borrowed = 0;
+        if (self.limits.policy == .codel) self.dropStale(now_ns);
+        const result = self.pending() orelse return null;
+        self.borrowed = 1;
+        return result;
+    }
+
+    /// Fills `chunks` with borrowed views of the queued packets, starting
+    /// from the head, and returns how many were filled. The head offset
+    /// still applies to the first chunk.
+    pub fn gather(self: *WriteQueue, chunks: [][]const u8) usize {
+        var count: usize = 0;
+        var current = self.head;
+        while (current) |node| : (current = node.next) {
+            if (count == chunks.len) break;
+            chunks[count] = node.data;
+            count += 1;
+        }
+        self.borrowed = @max(self.borrowed, count);
+        return count;
+    }
+
+    /// Advances by `written` bytes, possibly across gathered packets, and
+    /// returns whether the write ended on a packet boundary.
     pub fn advance(self: *WriteQueue, written: usize) bool {
-        const first = self.head orelse {
+        self.borrowed = 0;
+        if (self.head == null) {
             log.writeAndFailDebug("Ignoring advance on an empty WriteQueue");
             return true;
-        };
-        const remaining = first.data.len - self.offset;
-        if (written > remaining)
-            @panic("WriteQueue cannot advance past the pending packet");
-        if (written < remaining) {
-            self.offset += written;
+        }
+        var left = written;
+        while (self.head) |first| {
+            const remaining = first.data.len - self.offset;
+            if (left < remaining) {
+                self.offset += left;
+                return false;
+            }
+            left -= remaining;
+            self.offset = 0;
+            self.removeHead();
+            if (left == 0) return true;
+        }
+        @panic("WriteQueue cannot advance past the queued packets");
+    }
+
+    fn now(self: *const WriteQueue) u64 {
+        if (self.limits.policy != .codel) return 0;
+        return core.concurrency.monotonicNs();
+    }
+
+    fn accepts(self: *const WriteQueue, new_count: usize, new_bytes: usize, packet_len: usize) bool {
+        if (packet_len > self.limits.max_bytes) return false;
+        // Room is made afterwards
+        if (self.limits.policy == .head) return true;
+        return self.count + new_count < self.limits.max_packets and
+            self.bytes + new_bytes + packet_len <= self.limits.max_bytes;
+    }
+
+    fn isOverLimits(self: *const WriteQueue) bool {
+        return self.count > self.limits.max_packets or self.bytes > self.limits.max_bytes;
+    }
+
+    /// Drops the oldest packets until within bounds, except those in use.
+    fn evictOldest(self: *WriteQueue) void {
+        const protected = @max(self.borrowed, @intFromBool(self.offset > 0));
+        var previous: ?*WriteNode = null;
+        var current = self.head;
+        for (0..protected) |_| {
+            previous = current orelse return;
+            current = previous.?.next;
+        }
+        while (self.isOverLimits()) {
+            const node = current orelse return;
+            current = node.next;
+            if (previous) |value| {
+                value.next = current;
+            } else {
+                self.head = current;
+            }
+            if (self.tail == node) self.tail = previous;
+            self.destroyNode(node);
+            self.drops += 1;
+        }
+    }
+
+    /// Drops the head while it stays over the CoDel target, at the pace of
+    /// the control law. A partially written head is always kept.
+    fn dropStale(self: *WriteQueue, now_ns: u64) void {
+        const interval = self.limits.codel_interval_ns;
+        if (self.codel.dropping) {
+            while (self.offset == 0 and self.head != null) {
+                if (!self.isStale(now_ns)) {
+                    self.codel.dropping = false;
+                    return;
+                }
+                if (now_ns < self.codel.drop_next_ns) return;
+                self.dropHead();
+                self.codel.drop_count += 1;
+                self.codel.drop_next_ns = controlLaw(self.codel.drop_next_ns, interval, self.codel.drop_count);
+            }
+            return;
+        }
+        if (self.offset > 0 or self.head == null or !self.isStale(now_ns)) return;
+        self.dropHead();
+        self.codel.dropping = true;
+        // Resume near the previous rate if dropping stopped recently
+        const recently = now_ns -| self.codel.drop_next_ns < 16 * interval;
+        self.codel.drop_count = if (recently and self.codel.drop_count > 2)
+            self.codel.drop_count - 2
+        else
+            1;
+        self.codel.drop_next_ns = controlLaw(now_ns, interval, self.codel.drop_count);
+    }
+
+    /// Whether the head was queued longer than the target for an interval.
+    /// The last packet is never stale.
+    fn isStale(self: *WriteQueue, now_ns: u64) bool {
+        const first = self.head orelse return false;
+        const sojourn = now_ns -| first.enqueued_ns;
+        if (sojourn < self.limits.codel_target_ns or self.count <= 1) {
+            self.codel.first_above_ns = 0;
             return false;
         }
+        if (self.codel.first_above_ns == 0) {
+            self.codel.first_above_ns = now_ns + self.limits.codel_interval_ns;
+            return false;
+        }
+        return now_ns >= self.codel.first_above_ns;
+    }
+
+    fn controlLaw(t: u64, interval: u64, drop_count: u64) u64 {
+        return t + interval / std.math.sqrt(drop_count);
+    }
 
+    fn dropHead(self: *WriteQueue) void {
+        self.removeHead();
+        self.drops += 1;
+    }
+
+    fn removeHead(self: *WriteQueue) void {
+        const first = self.head orelse return;
         self.head = first.next;
         if (self.head == null) self.tail = null;
-        self.offset = 0;
-        self.allocator.free(first.data);
-        self.allocator.destroy(first);
-        return true;
+        self.destroyNode(first);
+    }
+
+    /// Releases an unlinked node and its accounting.
+    fn destroyNode(self: *WriteQueue, node: *WriteNode) void {
+        self.count -= 1;
+        self.bytes -= node.data.len;
+        self.allocator.free(node.data);
+        self.allocator.destroy(node);
     }
 
     fn destroyList(allocator: std.mem.Allocator, head: ?*WriteNode) void {
@@ -291,6 +291,7 @@ const Query = struct {
     }
 
     fn run(self: *Query) void {
+        defer log.releaseThread();
         var result: c.pp_dns_result = null;
         var reachability = self.reachability;
         const hostname = self.hostname orelse
@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Davide De Rosa
+ *
+ * SPDX-License-Identifier: GPL-3.0
+ */
+
+#include <string.h>
+#include "openvpn/decompress.h"
+
+// MARK: - LZO1X
+
+/*
+ Follows lzo1x_decompress_safe() of the LZO reference. Matches are
+ tracked by their distance from the output cursor, so that no pointer
+ ever leaves the output buffer.
+ */
+
+#define LZO_M2_MAX_OFFSET   0x0800
+#define LZO_M4_BASE_OFFSET  0x4000
+
+#define LZO_NEED_IP(x)      if ((size_t)(ip_end - ip) < (size_t)(x)) return false
+#define LZO_NEED_OP(x)      if ((size_t)(op_end - op) < (size_t)(x)) return false
+#define LZO_NEED_LB(d)      if ((d) > (size_t)(op - dst)) return false
+
+// Adds the zero-extended length that follows a zero length field
+#define LZO_EXTEND(t, base) \
+    do { \
+        while (*ip == 0) { \
+            t += 255; \
+            ++ip; \
+            LZO_NEED_IP(1); \
+        } \
+        t += base + *ip++; \
+    } while (0)
+
+static inline
+size_t lzo_load16(const uint8_t *src) {
+    return (size_t)src[0] | ((size_t)src[1] << 8);
+}
+
+bool openvpn_lzo1x_decompress(const uint8_t *src, size_t src_len,
+                              uint8_t *dst, size_t dst_capacity,
+                              size_t *dst_len) {
+    const uint8_t *ip = src;
+    const uint8_t *const ip_end = src + src_len;
+    uint8_t *op = dst;
+    uint8_t *const op_end = dst + dst_capacity;
+    size_t t;
+    size_t next;
+    size_t distance;
+    size_t state = 0;
+
+    // The shortest stream is the end marker
+    LZO_NEED_IP(3);
+    if (*ip > 17) {
+        t = *ip++ - 17;
+        if (t < 4) {
+            next = t;
+            goto match_next;
+        }
+        goto copy_literal_run;
+    }
+
+    for (;;) {
+        t = *ip++;
+        if (t < 16) {
+            if (state == 0) {
+                if (t == 0) {
+                    LZO_EXTEND(t, 15);
+                }
+                t += 3;
+copy_literal_run:
+                LZO_NEED_OP(t);
+                LZO_NEED_IP(t + 3);
+                memcpy(op, ip, t);
+                op += t;
+                ip += t;
+                state = 4;
+                continue;
+            }
+            next = t & 3;
+            if (state != 4) {
+                // M1, 2 bytes within 1 KiB
+                distance = 1 + (t >> 2) + ((size_t)*ip++ << 2);
+                t = 2;
+            } else {
+                // M1, 3 bytes just past the M2 range
+                distance = 1 + LZO_M2_MAX_OFFSET + (t >> 2) + ((size_t)*ip++ << 2);
+                t = 3;
+            }
+        } else if (t >= 64) {
+            // M2
+            next = t & 3;
+            distance = 1 + ((t >> 2) & 7) + ((size_t)*ip++ << 3);
+            t = (t >> 5) + 1;
+        } else if (t >= 32) {
+            // M3
+            t &= 31;
+            if (t == 0) {
+                LZO_EXTEND(t, 31);
+                LZO_NEED_IP(2);
+            }
+            t += 2;
+            next = lzo_load16(ip);
+            ip += 2;
+            distance = 1 + (next >> 2);
+            next &= 3;
+        } else {
+            // M4, or the end marker
+            const size_t high = (t & 8) << 11;
+            t &= 7;
+            if (t == 0) {
+                LZO_EXTEND(t, 7);
+                LZO_NEED_IP(2);
+            }
+            t += 2;
+            next = lzo_load16(ip);
+            ip += 2;
+            distance = high + (next >> 2);
+            next &= 3;
+            if (distance == 0) {
+                break;
+            }
+            distance += LZO_M4_BASE_OFFSET;
+        }
+
+        // Matches may overlap their own output
+        LZO_NEED_LB(distance);
+        LZO_NEED_OP(t);
+        const uint8_t *match = op - distance;
+        for (size_t i = 0; i < t; ++i) {
+            op[i] = match[i];
+        }
+        op += t;
+
+match_next:
+        state = next;
+        LZO_NEED_IP(next + 3);
+        LZO_NEED_OP(next);
+        memcpy(op, ip, next);
+        op += next;
+        ip += next;
+    }
+
+    if (t != 3 || ip != ip_end) {
+        return false;
+    }
+    *dst_len = (size_t)(op - dst);
+    return true;
+}
+
+// MARK: - LZ4
+
+/*
+ Decodes a single LZ4 block, i.e. what LZ4_decompress_safe() takes,
+ made of sequences of literals followed by a match. The last sequence
+ has literals only.
+ */
+
+#define LZ4_MIN_MATCH       4
+
+// Adds the 255-extended length that follows a 15 length field
+static inline
+bool lz4_extend(const uint8_t **ip, const uint8_t *ip_end, size_t *len) {
+    uint8_t byte;
+    do {
+        if (*ip == ip_end) {
+            return false;
+        }
+        byte = *(*ip)++;
+        *len += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool openvpn_lz4_decompress(const uint8_t *src, size_t src_len,
+                            uint8_t *dst, size_t dst_capacity,
+                            size_t *dst_len) {
+    const uint8_t *ip = src;
+    const uint8_t *const ip_end = src + src_len;
+    uint8_t *op = dst;
+    uint8_t *const op_end = dst + dst_capacity;
+
+    for (;;) {
+        // The last sequence has literals only, so it never ends on a match
+        if (ip == ip_end) {
+            return false;
+        }
+        const uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !lz4_extend(&ip, ip_end, &literals)) {
+            return false;
+        }
+        if ((size_t)(ip_end - ip) < literals || (size_t)(op_end - op) < literals) {
+            return false;
+        }
+        memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+        if (ip == ip_end) {
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        const size_t distance = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (distance == 0 || distance > (size_t)(op - dst)) {
+            return false;
+        }
+        size_t len = token & 15;
+        if (len == 15 && !lz4_extend(&ip, ip_end, &len)) {
+            return false;
+        }
+        len += LZ4_MIN_MATCH;
+        if ((size_t)(op_end - op) < len) {
+            return false;
+        }
+
+        // Matches may overlap their own output
+        const uint8_t *match = op - distance;
+        if (distance >= len) {
+            memcpy(op, match, len);
+        } else {
+            for (size_t i = 0; i < len; ++i) {
+                op[i] = match[i];
+            }
+        }
+        op += len;
+    }
+
+    *dst_len = (size_t)(op - dst);
+    return true;
+}
@@ -7,6 +7,7 @@
 #include "portable/common.h"
 #include "openvpn/dp_macros.h"
 #include "openvpn/dp_mode.h"
+#include "openvpn/mss_fix.h"
 #include "openvpn/packet.h"
 
 openvpn_dp_mode *openvpn_dp_mode_create_opt(pp_crypto_ctx crypto,
@@ -26,6 +27,11 @@ openvpn_dp_mode *openvpn_dp_mode_create_opt(pp_crypto_ctx crypto,
         mode->opt.peer_id = OpenVPNPacketPeerIdDisabled;
         mode->opt.mss_val = 0;
     }
+    // Inbound only, outbound packets are never compressed
+    mode->inflate_buf = NULL;
+    if (mode->opt.comp_f != OpenVPNCompressionFramingDisabled) {
+        mode->inflate_buf = pp_zd_create(OpenVPNDecompressionCapacity);
+    }
 
     // Extend with raw crypto functions
     mode->enc = *enc;
@@ -39,9 +45,22 @@ openvpn_dp_mode *openvpn_dp_mode_create_opt(pp_crypto_ctx crypto,
 void openvpn_dp_mode_free(openvpn_dp_mode *mode) {
     OPENVPN_DP_LOG("openvpn_dp_mode_free");
     mode->pp_crypto_free(mode->crypto);
+    if (mode->inflate_buf) {
+        pp_zd_free(mode->inflate_buf);
+    }
     pp_free(mode);
 }
 
+openvpn_dp_mode *openvpn_dp_mode_create_cursor(const openvpn_dp_mode *mode,
+                                               pp_crypto_ctx crypto,
+                                               pp_crypto_free_fn pp_crypto_free) {
+    OPENVPN_DP_LOG("openvpn_dp_mode_create_cursor");
+    openvpn_dp_mode *cursor = openvpn_dp_mode_create_opt(crypto, pp_crypto_free,
+                                                         &mode->enc, &mode->dec, &mode->opt);
+    openvpn_dp_mode_set_variants(cursor, mode->variants);
+    return cursor;
+}
+
 // MARK: - Encryption
 
 size_t openvpn_dp_mode_assemble(openvpn_dp_mode *mode,
@@ -103,6 +122,7 @@ size_t openvpn_dp_mode_parse(openvpn_dp_mode *mode,
     ctx->dst = dst;
     ctx->src = src;
     ctx->src_len = src_len;
+    ctx->dst_offset = NULL;
     ctx->error = error;
     return mode->dec.parse(mode);
 }
@@ -116,25 +136,31 @@ pp_zd *_Nullable openvpn_dp_mode_decrypt_and_parse(openvpn_dp_mode *mode,
                                                    size_t src_len,
                                                    openvpn_dp_error *_Nullable error) {
     pp_assert(buf->length >= src_len);
-    pp_zd *dst = NULL;
     const size_t dec_len = openvpn_dp_mode_decrypt(mode, buf, dst_packet_id,
                                                    src, src_len, error);
     if (dec_len == 0) {
-        goto failure;
+        return NULL;
     }
-    dst = pp_zd_create(dec_len);
-    const size_t dst_len = openvpn_dp_mode_parse(mode, dst, dst_header,
-                                                 buf->bytes, dec_len, error);
+
+    // Parse in place, so that the payload is classified before any copy
+    openvpn_dp_mode_parse_ctx *ctx = &mode->parse_ctx;
+    size_t dst_offset = 0;
+    ctx->dst_header = dst_header;
+    ctx->dst = buf;
+    ctx->src = buf->bytes;
+    ctx->src_len = dec_len;
+    ctx->dst_offset = &dst_offset;
+    ctx->error = error;
+    const size_t dst_len = mode->dec.parse(mode);
+    ctx->dst_offset = NULL;
     if (dst_len == 0) {
-        goto failure;
+        return NULL;
     }
-    pp_zd_resize(dst, dst_len);
-    if (openvpn_packet_is_ping(dst->bytes, dst->length)) {
+    uint8_t *payload = buf->bytes + dst_offset;
+    if (openvpn_packet_is_ping(payload, dst_len)) {
         *dst_keep_alive = true;
+    } else if (mode->opt.mss_val) {
+        openvpn_mss_fix(payload, dst_len, mode->opt.mss_val);
     }
-    return dst;
-
-failure:
-    if (dst) pp_zd_free(dst);
-    return NULL;
+    return pp_zd_create_from_data(payload, dst_len);
 }
@@ -5,62 +5,68 @@
  */
 
 #include "portable/endian.h"
+#include "openvpn/dp_framing_comp.h"
 #include "openvpn/dp_macros.h"
 #include "openvpn/dp_mode_ad.h"
 #include "openvpn/packet.h"
 
-static
-size_t dp_assemble(void *vmode) {
-    OPENVPN_DP_LOG("openvpn_dp_mode_ad_assemble");
-    const openvpn_dp_mode *mode = vmode;
-    const openvpn_dp_mode_assemble_ctx *ctx = &mode->assemble_ctx;
+// MARK: - Generic routines
 
-    const size_t dst_capacity = openvpn_dp_mode_assemble_capacity(mode, ctx->src_len);
-    pp_assert(ctx->dst->length >= dst_capacity);
+OPENVPN_DP_INLINE
+size_t ad_assemble(openvpn_dp_framing_assemble_fn _Nullable framing_assemble,
+                   const openvpn_dp_mode *mode,
+                   pp_zd *dst_buf,
+                   const uint8_t *src,
+                   size_t src_len) {
+    const size_t dst_capacity = openvpn_dp_mode_assemble_capacity(mode, src_len);
+    pp_assert(dst_buf->length >= dst_capacity);
 
-    uint8_t *dst = ctx->dst->bytes;
-    size_t dst_len = ctx->src_len;
-    if (!mode->enc.framing_assemble) {
-        memcpy(ctx->dst, ctx->src, ctx->src_len);
+    uint8_t *dst = dst_buf->bytes;
+    size_t dst_len = src_len;
+    if (!framing_assemble) {
+        memcpy(dst, src, src_len);
     } else {
         int packet_len_offset;
         openvpn_dp_framing_assemble_ctx assemble;
         assemble.dst = dst;
         assemble.dst_len_offset = &packet_len_offset;
-        assemble.src = ctx->src;
-        assemble.src_len = ctx->src_len;
+        assemble.src = src;
+        assemble.src_len = src_len;
         assemble.mss_val = mode->opt.mss_val;
-        mode->enc.framing_assemble(&assemble);
+        framing_assemble(&assemble);
         dst_len += packet_len_offset;
     }
     return dst_len;
 }
 
-static
-size_t dp_encrypt(void *vmode) {
-    OPENVPN_DP_LOG("openvpn_dp_mode_ad_encrypt");
-    const openvpn_dp_mode *mode = vmode;
-    const openvpn_dp_mode_encrypt_ctx *ctx = &mode->enc_ctx;
-
+OPENVPN_DP_INLINE
+size_t ad_encrypt(bool with_peer_id,
+                  const openvpn_dp_mode *mode,
+                  uint8_t key,
+                  uint32_t packet_id,
+                  pp_zd *dst_buf,
+                  const uint8_t *src,
+                  size_t src_len,
+                  openvpn_dp_error *_Nullable error) {
     pp_assert(mode->enc.raw_encrypt);
-    OPENVPN_DP_ENCRYPT_BEGIN(mode->opt.peer_id)
+    OPENVPN_DP_ENCRYPT_BEGIN(with_peer_id)
 
-    const size_t dst_capacity = openvpn_dp_mode_encrypt_capacity(mode, ctx->src_len);
-    pp_assert(ctx->dst->length >= dst_capacity);
-    uint8_t *dst = ctx->dst->bytes;
+    const size_t dst_capacity = openvpn_dp_mode_encrypt_capacity(mode, src_len);
+    pp_assert(dst_buf->length >= dst_capacity);
+    uint8_t *dst = dst_buf->bytes;
 
-    *(uint32_t *)(dst + dst_header_len) = pp_endian_htonl(ctx->packet_id);
+    *(uint32_t *)(dst + dst_header_len) = pp_endian_htonl(packet_id);
 
     pp_crypto_flags flags = { 0 };
     flags.iv = dst + dst_header_len;
     flags.iv_len = OpenVPNPacketIdLength;
     if (has_peer_id) {
-        openvpn_packet_header_v2_set(dst, ctx->key, mode->opt.peer_id);
+        openvpn_packet_header_v2_set(dst, key, mode->opt.peer_id);
         flags.ad = dst;
         flags.ad_len = dst_header_len + OpenVPNPacketIdLength;
     }
     else {
-        openvpn_packet_header_set(dst, OpenVPNPacketCodeDataV1, ctx->key, NULL);
+        openvpn_packet_header_set(dst, OpenVPNPacketCodeDataV1, key, NULL);
         flags.ad = dst + dst_header_len;
         flags.ad_len = OpenVPNPacketIdLength;
     }
@@ -69,56 +75,57 @@ size_t dp_encrypt(void *vmode) {
     pp_crypto_error_code enc_error;
     const size_t dst_packet_len = mode->enc.raw_encrypt(mode->crypto,
                                                         dst + dst_header_len + OpenVPNPacketIdLength,
-                                                        ctx->dst->length - (dst_header_len + OpenVPNPacketIdLength),
-                                                        ctx->src,
-                                                        ctx->src_len,
+                                                        dst_buf->length - (dst_header_len + OpenVPNPacketIdLength),
+                                                        src,
+                                                        src_len,
                                                         &flags,
                                                         &enc_error);
 
     pp_assert(dst_packet_len <= dst_capacity);//, "Did not allocate enough bytes for payload");
 
     if (!dst_packet_len) {
-        if (ctx->error) {
-            ctx->error->dp_code = OpenVPNDataPathErrorCrypto;
-            ctx->error->crypto_code = enc_error;
+        if (error) {
+            error->dp_code = OpenVPNDataPathErrorCrypto;
+            error->crypto_code = enc_error;
         }
         return 0;
     }
     return dst_header_len + OpenVPNPacketIdLength + dst_packet_len;
 }
 
-static
-size_t dp_decrypt(void *vmode) {
-    OPENVPN_DP_LOG("openvpn_dp_mode_ad_decrypt");
-    const openvpn_dp_mode *mode = vmode;
-    const openvpn_dp_mode_decrypt_ctx *ctx = &mode->dec_ctx;
-
+OPENVPN_DP_INLINE
+size_t ad_decrypt(const openvpn_dp_mode *mode,
+                  pp_zd *dst_buf,
+                  uint32_t *dst_packet_id,
+                  const uint8_t *src,
+                  size_t src_len,
+                  openvpn_dp_error *_Nullable error) {
     pp_assert(mode->dec.raw_decrypt);
-    pp_assert(ctx->src_len > 0);//, @"Decrypting an empty packet, how did it get this far?");
-    pp_assert(ctx->dst->length >= ctx->src_len);
-    uint8_t *dst = ctx->dst->bytes;
+    pp_assert(src_len > 0);//, @"Decrypting an empty packet, how did it get this far?");
+    pp_assert(dst_buf->length >= src_len);
+    uint8_t *dst = dst_buf->bytes;
 
-    OPENVPN_DP_DECRYPT_BEGIN(ctx)
-    if (ctx->src_len < src_header_len + OpenVPNPacketIdLength) {
+    OPENVPN_DP_DECRYPT_BEGIN(src, src_len)
+    if (src_len < src_header_len + OpenVPNPacketIdLength) {
         return 0;
     }
 
     pp_crypto_flags flags = { 0 };
-    flags.iv = ctx->src + src_header_len;
+    flags.iv = src + src_header_len;
     flags.iv_len = OpenVPNPacketIdLength;
     if (has_peer_id) {
         if (peer_id != mode->opt.peer_id) {
-            if (ctx->error) {
-                ctx->error->dp_code = OpenVPNDataPathErrorPeerIdMismatch;
-                ctx->error->crypto_code = PPCryptoErrorNone;
+            if (error) {
+                error->dp_code = OpenVPNDataPathErrorPeerIdMismatch;
+                error->crypto_code = PPCryptoErrorNone;
             }
             return 0;
         }
-        flags.ad = ctx->src;
+        flags.ad = src;
         flags.ad_len = src_header_len + OpenVPNPacketIdLength;
     }
     else {
-        flags.ad = ctx->src + src_header_len;
+        flags.ad = src + src_header_len;
         flags.ad_len = OpenVPNPacketIdLength;
     }
 
@@ -126,56 +133,177 @@ size_t dp_decrypt(void *vmode) {
     pp_crypto_error_code dec_error;
     const size_t dst_len = mode->dec.raw_decrypt(mode->crypto,
                                                  dst,
-                                                 ctx->dst->length,
-                                                 ctx->src + src_header_len + OpenVPNPacketIdLength,
-                                                 (int)(ctx->src_len - (src_header_len + OpenVPNPacketIdLength)),
+                                                 dst_buf->length,
+                                                 src + src_header_len + OpenVPNPacketIdLength,
+                                                 (int)(src_len - (src_header_len + OpenVPNPacketIdLength)),
                                                  &flags,
                                                  &dec_error);
     if (!dst_len) {
-        if (ctx->error) {
-            ctx->error->dp_code = OpenVPNDataPathErrorCrypto;
-            ctx->error->crypto_code = dec_error;
+        if (error) {
+            error->dp_code = OpenVPNDataPathErrorCrypto;
+            error->crypto_code = dec_error;
         }
         return 0;
     }
-    *ctx->dst_packet_id = pp_endian_ntohl(*(const uint32_t *)(flags.iv));
+    *dst_packet_id = pp_endian_ntohl(*(const uint32_t *)(flags.iv));
     return dst_len;
 }
 
-static
-size_t dp_parse(void *vmode) {
-    OPENVPN_DP_LOG("openvpn_dp_mode_ad_parse");
-    const openvpn_dp_mode *mode = vmode;
-    const openvpn_dp_mode_parse_ctx *ctx = &mode->parse_ctx;
-
-    pp_assert(ctx->dst->length >= ctx->src_len);
-
-    uint8_t *payload = ctx->src;
-    size_t dst_len = ctx->src_len;// - (int)(payload - ctx->src);
-    if (!mode->dec.framing_parse) {
-        *ctx->dst_header = 0x00;
-        memcpy(ctx->dst->bytes, payload, dst_len);
+// dst is only written when dst_offset is NULL, or to expand compressed
+// payloads from the inflate_buf scratch, at offset 0
+OPENVPN_DP_INLINE
+size_t ad_parse(openvpn_dp_framing_parse_fn _Nullable framing_parse,
+                pp_zd *_Nullable inflate_buf,
+                pp_zd *dst,
+                uint8_t *dst_header,
+                size_t *_Nullable dst_offset,
+                uint8_t *src,
+                size_t src_len,
+                openvpn_dp_error *_Nullable error) {
+    uint8_t *payload = src;
+    size_t dst_len = src_len;// - (int)(payload - src);
+    if (!framing_parse) {
+        *dst_header = 0x00;
+        if (dst_offset) {
+            *dst_offset = (size_t)(payload - src);
+            return dst_len;
+        }
+        memcpy(dst->bytes, payload, dst_len);
         return dst_len;
     }
 
     size_t payload_offset;
     size_t payload_header_len;
+    openvpn_decompression compression;
     openvpn_dp_framing_parse_ctx parse;
     parse.dst_payload = payload;
     parse.dst_payload_offset = &payload_offset;
-    parse.dst_header = ctx->dst_header;
+    parse.dst_header = dst_header;
     parse.dst_header_len = &payload_header_len;
-    parse.src = ctx->src;
-    parse.src_len = ctx->src_len;
-    parse.error = ctx->error;
-    if (!mode->dec.framing_parse(&parse)) {
+    parse.dst_compression = &compression;
+    parse.src = src;
+    parse.src_len = src_len;
+    parse.error = error;
+    if (!framing_parse(&parse)) {
         return 0;
     }
     dst_len -= payload_header_len;
-    memcpy(ctx->dst->bytes, payload + payload_offset, dst_len);
+    if (compression != OpenVPNDecompressionNone) {
+        if (dst_offset) {
+            *dst_offset = 0;
+        }
+        return openvpn_dp_framing_decompress(compression, inflate_buf, dst,
+                                             payload + payload_offset, dst_len, error);
+    }
+    if (dst_offset) {
+        *dst_offset = (size_t)(payload + payload_offset - src);
+        return dst_len;
+    }
+    memcpy(dst->bytes, payload + payload_offset, dst_len);
     return dst_len;
 }
 
+OPENVPN_DP_INLINE
+size_t dp_seal(openvpn_dp_framing_assemble_fn framing_assemble,
+               bool with_peer_id,
+               const openvpn_dp_mode *mode,
+               uint8_t key,
+               uint32_t packet_id,
+               pp_zd *buf,
+               pp_zd *dst,
+               const uint8_t *src,
+               size_t src_len,
+               openvpn_dp_error *_Nullable error) {
+    const size_t asm_len = ad_assemble(framing_assemble, mode, buf, src, src_len);
+    if (!asm_len) {
+        return 0;
+    }
+    return ad_encrypt(with_peer_id, mode, key, packet_id, dst, buf->bytes, asm_len, error);
+}
+
+OPENVPN_DP_INLINE
+size_t dp_open(openvpn_dp_framing_parse_fn framing_parse,
+               const openvpn_dp_mode *mode,
+               pp_zd *dst,
+               size_t *dst_offset,
+               uint32_t *dst_packet_id,
+               const uint8_t *src,
+               size_t src_len,
+               openvpn_dp_error *_Nullable error) {
+    const size_t dec_len = ad_decrypt(mode, dst, dst_packet_id, src, src_len, error);
+    if (!dec_len) {
+        return 0;
+    }
+    uint8_t header = 0;
+    return ad_parse(framing_parse, mode->inflate_buf, dst, &header, dst_offset,
+                    dst->bytes, dec_len, error);
+}
+
+// MARK: - Staged functions
+
+static
+size_t dp_assemble(void *vmode) {
+    OPENVPN_DP_LOG("openvpn_dp_mode_ad_assemble");
+    const openvpn_dp_mode *mode = vmode;
+    const openvpn_dp_mode_assemble_ctx *ctx = &mode->assemble_ctx;
+    return ad_assemble(mode->enc.framing_assemble, mode, ctx->dst, ctx->src, ctx->src_len);
+}
+
+static
+size_t dp_encrypt(void *vmode) {
+    OPENVPN_DP_LOG("openvpn_dp_mode_ad_encrypt");
+    const openvpn_dp_mode *mode = vmode;
+    const openvpn_dp_mode_encrypt_ctx *ctx = &mode->enc_ctx;
+    return ad_encrypt(mode->opt.peer_id != OpenVPNPacketPeerIdDisabled, mode,
+                      ctx->key, ctx->packet_id, ctx->dst, ctx->src, ctx->src_len, ctx->error);
+}
+
+static
+size_t dp_decrypt(void *vmode) {
+    OPENVPN_DP_LOG("openvpn_dp_mode_ad_decrypt");
+    const openvpn_dp_mode *mode = vmode;
+    const openvpn_dp_mode_decrypt_ctx *ctx = &mode->dec_ctx;
+    return ad_decrypt(mode, ctx->dst, ctx->dst_packet_id, ctx->src, ctx->src_len, ctx->error);
+}
+
+static
+size_t dp_parse(void *vmode) {
+    OPENVPN_DP_LOG("openvpn_dp_mode_ad_parse");
+    const openvpn_dp_mode *mode = vmode;
+    const openvpn_dp_mode_parse_ctx *ctx = &mode->parse_ctx;
+
+    pp_assert(ctx->dst->length >= ctx->src_len);
+    return ad_parse(mode->dec.framing_parse, mode->inflate_buf, ctx->dst, ctx->dst_header,
+                    ctx->dst_offset, ctx->src, ctx->src_len, ctx->error);
+}
+
+// MARK: - Specialized variants
+
+OPENVPN_DP_VARIANTS(disabled, openvpn_dp_framing_assemble_disabled, openvpn_dp_framing_parse_disabled)
+OPENVPN_DP_VARIANTS(lzo, openvpn_dp_framing_assemble_lzo, openvpn_dp_framing_parse_lzo)
+OPENVPN_DP_VARIANTS(compress, openvpn_dp_framing_assemble_compress, openvpn_dp_framing_parse_compress)
+OPENVPN_DP_VARIANTS(compress_v2, openvpn_dp_framing_assemble_compress_v2, openvpn_dp_framing_parse_compress_v2)
+
+static const openvpn_dp_mode_variants variants_disabled = OPENVPN_DP_VARIANTS_ENTRY(disabled);
+static const openvpn_dp_mode_variants variants_lzo = OPENVPN_DP_VARIANTS_ENTRY(lzo);
+static const openvpn_dp_mode_variants variants_compress = OPENVPN_DP_VARIANTS_ENTRY(compress);
+static const openvpn_dp_mode_variants variants_compress_v2 = OPENVPN_DP_VARIANTS_ENTRY(compress_v2);
+
+static
+const openvpn_dp_mode_variants *variants_of(openvpn_compression_framing comp_f) {
+    switch (comp_f) {
+    case OpenVPNCompressionFramingDisabled:
+        return &variants_disabled;
+    case OpenVPNCompressionFramingCompLZO:
+        return &variants_lzo;
+    case OpenVPNCompressionFramingCompress:
+        return &variants_compress;
+    case OpenVPNCompressionFramingCompressV2:
+        return &variants_compress_v2;
+    }
+    return NULL;
+}
+
 // MARK: -
 
 openvpn_dp_mode *openvpn_dp_mode_ad_create(pp_crypto_ctx crypto,
@@ -201,5 +329,7 @@ openvpn_dp_mode *openvpn_dp_mode_ad_create(pp_crypto_ctx crypto,
         OpenVPNPacketPeerIdDisabled,
         0
     };
-    return openvpn_dp_mode_create_opt(crypto, pp_crypto_free, &enc, &dec, &opt);
+    openvpn_dp_mode *mode = openvpn_dp_mode_create_opt(crypto, pp_crypto_free, &enc, &dec, &opt);
+    openvpn_dp_mode_set_variants(mode, variants_of(comp_f));
+    return mode;
 }
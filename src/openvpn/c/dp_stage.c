@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Davide De Rosa
+ *
+ * SPDX-License-Identifier: GPL-3.0
+ */
+
+#include "portable/common.h"
+#include "openvpn/dp_macros.h"
+#include "openvpn/dp_stage.h"
+#include "openvpn/mss_fix.h"
+#include "openvpn/packet.h"
+
+size_t openvpn_dp_stage_send(const openvpn_dp_stage *stage,
+                             uint8_t key,
+                             uint32_t packet_id,
+                             pp_zd *buf,
+                             pp_zd *dst,
+                             const uint8_t *src,
+                             size_t src_len,
+                             openvpn_dp_error *_Nullable error) {
+    OPENVPN_DP_LOG("openvpn_dp_stage_send");
+    pp_assert(dst->length >= openvpn_dp_stage_send_capacity(stage, src_len));
+
+    size_t dst_len;
+    if (stage->mode->seal) {
+        dst_len = stage->mode->seal(stage->mode, key, packet_id, buf, dst,
+                                    src, src_len, error);
+    } else {
+        const size_t asm_len = openvpn_dp_mode_assemble(stage->mode, packet_id, buf,
+                                                        src, src_len);
+        if (!asm_len) {
+            return 0;
+        }
+        dst_len = openvpn_dp_mode_encrypt(stage->mode, key, packet_id, dst,
+                                          buf->bytes, asm_len, error);
+    }
+    if (!dst_len) {
+        return 0;
+    }
+    if (stage->proc) {
+        openvpn_pkt_proc_send(stage->proc, dst->bytes, dst->bytes, dst_len);
+    }
+    return dst_len;
+}
+
+// Pings aside, inbound SYN-ACKs are clamped like outbound SYNs
+static inline
+void stage_recv_payload(const openvpn_dp_stage *stage,
+                        uint8_t *payload,
+                        size_t payload_len,
+                        bool *dst_keep_alive) {
+    *dst_keep_alive = openvpn_packet_is_ping(payload, payload_len);
+    if (stage->mode->opt.mss_val && !*dst_keep_alive) {
+        openvpn_mss_fix(payload, payload_len, stage->mode->opt.mss_val);
+    }
+}
+
+size_t openvpn_dp_stage_recv(const openvpn_dp_stage *stage,
+                             pp_zd *dst,
+                             size_t *dst_offset,
+                             uint32_t *dst_packet_id,
+                             bool *dst_keep_alive,
+                             const uint8_t *src,
+                             size_t src_len,
+                             openvpn_dp_error *_Nullable error) {
+    OPENVPN_DP_LOG("openvpn_dp_stage_recv");
+    pp_assert(dst->length >= src_len);
+
+    if (stage->mode->open) {
+        const size_t dst_len = stage->mode->open(stage->mode, dst, dst_offset, dst_packet_id,
+                                                 src, src_len, error);
+        if (!dst_len) {
+            return 0;
+        }
+        stage_recv_payload(stage, dst->bytes + *dst_offset, dst_len, dst_keep_alive);
+        return dst_len;
+    }
+
+    const size_t dec_len = openvpn_dp_mode_decrypt(stage->mode, dst, dst_packet_id,
+                                                   src, src_len, error);
+    if (!dec_len) {
+        return 0;
+    }
+
+    openvpn_dp_mode_parse_ctx *ctx = &stage->mode->parse_ctx;
+    uint8_t header = 0;
+    ctx->dst_header = &header;
+    ctx->dst = dst;
+    ctx->src = dst->bytes;
+    ctx->src_len = dec_len;
+    ctx->dst_offset = dst_offset;
+    ctx->error = error;
+    const size_t dst_len = stage->mode->dec.parse(stage->mode);
+    ctx->dst_offset = NULL;
+    if (!dst_len) {
+        return 0;
+    }
+    stage_recv_payload(stage, dst->bytes + *dst_offset, dst_len, dst_keep_alive);
+    return dst_len;
+}
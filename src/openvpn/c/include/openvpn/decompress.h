@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Davide De Rosa
+ *
+ * SPDX-License-Identifier: GPL-3.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#pragma clang assume_nonnull begin
+
+/*
+ Decompressors for the inbound packets of legacy servers that still
+ compress with --comp-lzo or --compress lz4(-v2). Outbound packets are
+ never compressed, see VORACLE.
+
+ Both decoders only write within dst_capacity and fail on anything
+ that would exceed it, so a packet can't expand past the MTU plus some
+ slack, however crafted its compressed stream.
+ */
+
+typedef enum {
+    OpenVPNDecompressionNone,
+    OpenVPNDecompressionLZO,
+    OpenVPNDecompressionLZ4
+} openvpn_decompression;
+
+// The largest advertised tun MTU (IV_MTU), plus slack
+#define OpenVPNDecompressionCapacity       ((size_t)(1600 + 448))
+
+bool openvpn_lzo1x_decompress(const uint8_t *src, size_t src_len,
+                              uint8_t *dst, size_t dst_capacity,
+                              size_t *dst_len);
+
+bool openvpn_lz4_decompress(const uint8_t *src, size_t src_len,
+                            uint8_t *dst, size_t dst_capacity,
+                            size_t *dst_len);
+
+static inline
+bool openvpn_decompress(openvpn_decompression algorithm,
+                        const uint8_t *src, size_t src_len,
+                        uint8_t *dst, size_t dst_capacity,
+                        size_t *dst_len) {
+    switch (algorithm) {
+        case OpenVPNDecompressionLZO:
+            return openvpn_lzo1x_decompress(src, src_len, dst, dst_capacity, dst_len);
+        case OpenVPNDecompressionLZ4:
+            return openvpn_lz4_decompress(src, src_len, dst, dst_capacity, dst_len);
+        default:
+            return false;
+    }
+}
+
+#pragma clang assume_nonnull end
@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "openvpn/comp.h"
+#include "openvpn/decompress.h"
 #include "openvpn/dp_error.h"
 
 #pragma clang assume_nonnull begin
@@ -26,6 +27,7 @@ typedef struct {
     size_t *dst_payload_offset;
     uint8_t *dst_header;
     size_t *dst_header_len;
+    openvpn_decompression *dst_compression; // how the payload must expand, if at all
     const uint8_t *src;
     size_t src_len;
     openvpn_dp_error *_Nullable error;
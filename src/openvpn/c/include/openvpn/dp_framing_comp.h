@@ -7,6 +7,8 @@
 #pragma once
 
 #include <string.h>
+#include "portable/zd.h"
+#include "openvpn/decompress.h"
 #include "openvpn/dp_framing.h"
 #include "openvpn/mss_fix.h"
 #include "openvpn/packet.h"
@@ -27,6 +29,7 @@ bool openvpn_dp_framing_parse_disabled(openvpn_dp_framing_parse_ctx *ctx) {
     *ctx->dst_payload_offset = 0;
     *ctx->dst_header = 0x00;
     *ctx->dst_header_len = 0;
+    *ctx->dst_compression = OpenVPNDecompressionNone;
     return true;
 }
 
@@ -37,6 +40,7 @@ bool openvpn_dp_framing_parse_v1(openvpn_dp_framing_parse_ctx *ctx) {
     *ctx->dst_header = ctx->dst_payload[0];
     *ctx->dst_payload_offset = 0;
     *ctx->dst_header_len = 0;
+    *ctx->dst_compression = OpenVPNDecompressionNone;
 
     switch (*ctx->dst_header) {
         case OpenVPNDataPacketNoCompress:
@@ -49,11 +53,17 @@ bool openvpn_dp_framing_parse_v1(openvpn_dp_framing_parse_ctx *ctx) {
             *ctx->dst_header_len = 1;
             break;
         case OpenVPNDataPacketLZOCompress:
-            if (ctx->error) {
-                ctx->error->dp_code = OpenVPNDataPathErrorCompression;
-                ctx->error->crypto_code = PPCryptoErrorNone;
-            }
-            return false;
+            *ctx->dst_payload_offset = 1;
+            *ctx->dst_header_len = 1;
+            *ctx->dst_compression = OpenVPNDecompressionLZO;
+            break;
+        case OpenVPNDataPacketLZ4Compress:
+            // swapped like uncompressed payloads
+            ctx->dst_payload[0] = ctx->src[ctx->src_len - 1];
+            *ctx->dst_payload_offset = 0;
+            *ctx->dst_header_len = 1;
+            *ctx->dst_compression = OpenVPNDecompressionLZ4;
+            break;
         default:
             break;
     }
@@ -65,15 +75,25 @@ bool openvpn_dp_framing_parse_v2(openvpn_dp_framing_parse_ctx *ctx) {
     *ctx->dst_header = ctx->dst_payload[0];
     *ctx->dst_payload_offset = 0;
     *ctx->dst_header_len = 0;
+    *ctx->dst_compression = OpenVPNDecompressionNone;
 
     switch (*ctx->dst_header) {
         case OpenVPNDataPacketV2Indicator:
-            if (ctx->dst_payload[1] != OpenVPNDataPacketV2Uncompressed) {
-                if (ctx->error) {
-                    ctx->error->dp_code = OpenVPNDataPathErrorCompression;
-                    ctx->error->crypto_code = PPCryptoErrorNone;
-                }
-                return false;
+            switch (ctx->dst_payload[1]) {
+                case OpenVPNDataPacketV2Uncompressed:
+                    break;
+                case OpenVPNDataPacketV2LZ4:
+                    *ctx->dst_compression = OpenVPNDecompressionLZ4;
+                    break;
+                case OpenVPNDataPacketV2LZO:
+                    *ctx->dst_compression = OpenVPNDecompressionLZO;
+                    break;
+                default:
+                    if (ctx->error) {
+                        ctx->error->dp_code = OpenVPNDataPathErrorCompression;
+                        ctx->error->crypto_code = PPCryptoErrorNone;
+                    }
+                    return false;
             }
             *ctx->dst_payload_offset = 2;
             *ctx->dst_header_len = 2;
@@ -85,6 +105,33 @@ bool openvpn_dp_framing_parse_v2(openvpn_dp_framing_parse_ctx *ctx) {
     return true;
 }
 
+/*
+ Expands a compressed payload to the start of dst, and returns its
+ length, or 0 on failure. The payload may be parsed in place within
+ dst, so it expands into scratch first.
+ */
+static inline
+size_t openvpn_dp_framing_decompress(openvpn_decompression compression,
+                                     pp_zd *_Nullable scratch,
+                                     pp_zd *dst,
+                                     const uint8_t *payload,
+                                     size_t payload_len,
+                                     openvpn_dp_error *_Nullable error) {
+    size_t dst_len = 0;
+    if (!scratch ||
+        !openvpn_decompress(compression, payload, payload_len,
+                            scratch->bytes, scratch->length, &dst_len) ||
+        !dst_len || dst_len > dst->length) {
+        if (error) {
+            error->dp_code = OpenVPNDataPathErrorCompression;
+            error->crypto_code = PPCryptoErrorNone;
+        }
+        return 0;
+    }
+    memcpy(dst->bytes, scratch->bytes, dst_len);
+    return dst_len;
+}
+
 static inline
 void openvpn_dp_framing_assemble_lzo(openvpn_dp_framing_assemble_ctx *ctx) {
     ctx->dst[0] = OpenVPNDataPacketNoCompress;
@@ -119,7 +166,7 @@ bool openvpn_dp_framing_parse_compress(openvpn_dp_framing_parse_ctx *ctx) {
 
 static inline
 void openvpn_dp_framing_assemble_compress_v2(openvpn_dp_framing_assemble_ctx *ctx) {
-    // assume no compression (v2 algorithms unsupported)
+    // never compress outbound (VORACLE), v2 algorithms are inbound only
 
     // prepend headers only in case of byte ambiguity
     const uint8_t first = *(uint8_t *)ctx->src;
@@ -11,15 +11,16 @@
 #include <stdio.h>
 #include "openvpn/packet.h"
 
-#define OPENVPN_DP_ENCRYPT_BEGIN(peerId) \
-    const bool has_peer_id = (peerId != OpenVPNPacketPeerIdDisabled); \
+// with_peer_id is a constant in the specialized variants
+#define OPENVPN_DP_ENCRYPT_BEGIN(with_peer_id) \
+    const bool has_peer_id = (with_peer_id); \
     size_t dst_header_len = OpenVPNPacketOpcodeLength; \
     if (has_peer_id) { \
         dst_header_len += OpenVPNPacketPeerIdLength; \
     }
 
-#define OPENVPN_DP_DECRYPT_BEGIN(ctx) \
-    const uint8_t *ptr = ctx->src; \
+#define OPENVPN_DP_DECRYPT_BEGIN(src, src_len) \
+    const uint8_t *ptr = src; \
     openvpn_packet_code code; \
     openvpn_packet_header_get(&code, NULL, ptr); \
     uint32_t peer_id = OpenVPNPacketPeerIdDisabled; \
@@ -27,12 +28,57 @@
     size_t src_header_len = OpenVPNPacketOpcodeLength; \
     if (has_peer_id) { \
         src_header_len += OpenVPNPacketPeerIdLength; \
-        if (ctx->src_len < src_header_len) { \
+        if (src_len < src_header_len) { \
             return false; \
         } \
         peer_id = openvpn_packet_header_v2_get_peer_id(ptr); \
     }
 
+// Forces the generic routines into their callers, so that constant
+// arguments fold into straight-line code
+#if defined(__GNUC__) || defined(__clang__)
+#define OPENVPN_DP_INLINE           static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define OPENVPN_DP_INLINE           static __forceinline
+#else
+#define OPENVPN_DP_INLINE           static inline
+#endif
+
+/*
+ Instantiates the monomorphic seal/open routines of a mode for one
+ compression framing. The mode source must provide the generic
+ dp_seal() and dp_open() routines, that take the framing functions
+ and the peer-id flag as their leading arguments.
+ */
+#define OPENVPN_DP_VARIANTS(name, framing_assemble, framing_parse) \
+    static size_t dp_seal_##name##_v1(const openvpn_dp_mode *mode, \
+                                      uint8_t key, uint32_t packet_id, \
+                                      pp_zd *buf, pp_zd *dst, \
+                                      const uint8_t *src, size_t src_len, \
+                                      openvpn_dp_error *error) { \
+        return dp_seal(framing_assemble, false, mode, key, packet_id, \
+                       buf, dst, src, src_len, error); \
+    } \
+    static size_t dp_seal_##name##_v2(const openvpn_dp_mode *mode, \
+                                      uint8_t key, uint32_t packet_id, \
+                                      pp_zd *buf, pp_zd *dst, \
+                                      const uint8_t *src, size_t src_len, \
+                                      openvpn_dp_error *error) { \
+        return dp_seal(framing_assemble, true, mode, key, packet_id, \
+                       buf, dst, src, src_len, error); \
+    } \
+    static size_t dp_open_##name(const openvpn_dp_mode *mode, \
+                                 pp_zd *dst, size_t *dst_offset, \
+                                 uint32_t *dst_packet_id, \
+                                 const uint8_t *src, size_t src_len, \
+                                 openvpn_dp_error *error) { \
+        return dp_open(framing_parse, mode, dst, dst_offset, dst_packet_id, \
+                       src, src_len, error); \
+    }
+
+#define OPENVPN_DP_VARIANTS_ENTRY(name) \
+    { { dp_seal_##name##_v1, dp_seal_##name##_v2 }, dp_open_##name }
+
 #ifdef OPENVPN_DP_DEBUG
 #define OPENVPN_DP_LOG(msg)         pp_clog_v(PPLogLevelInfo, "%s", msg)
 #define OPENVPN_DP_LOG_F(fmt, ...)  pp_clog_v(PPLogLevelInfo, fmt, __VA_ARGS__)
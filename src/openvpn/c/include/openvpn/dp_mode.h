@@ -56,6 +56,7 @@ typedef struct {
     uint8_t *dst_header;
     uint8_t *src; // allow parse in place
     size_t src_len;
+    size_t *_Nullable dst_offset; // when set, report payload offset in src instead of copying
     openvpn_dp_error *_Nullable error;
 } openvpn_dp_mode_parse_ctx;
 
@@ -108,18 +109,62 @@ typedef struct {
     uint16_t mss_val;
 } openvpn_dp_mode_options;
 
+/*
+ The staged functions above are generic over the framing and the
+ peer-id, and dispatch several indirect calls per packet. Modes may
+ additionally provide monomorphic routines, one per framing and
+ peer-id presence, that assemble+encrypt and decrypt+parse in a
+ single straight-line call:
+
+ - seal: assembles into buf, then encrypts into dst
+ - open: decrypts into dst, then parses in place by offset
+
+ Inbound packets carry their own opcode, so open is only specialized
+ by framing. The variant in use follows the peer-id, see
+ openvpn_dp_mode_set_peer_id().
+ */
+
+typedef struct openvpn_dp_mode openvpn_dp_mode;
+
+typedef size_t (*openvpn_dp_mode_seal_fn)(const openvpn_dp_mode *mode,
+                                          uint8_t key,
+                                          uint32_t packet_id,
+                                          pp_zd *buf,
+                                          pp_zd *dst,
+                                          const uint8_t *src,
+                                          size_t src_len,
+                                          openvpn_dp_error *_Nullable error);
+
+typedef size_t (*openvpn_dp_mode_open_fn)(const openvpn_dp_mode *mode,
+                                          pp_zd *dst,
+                                          size_t *dst_offset,
+                                          uint32_t *dst_packet_id,
+                                          const uint8_t *src,
+                                          size_t src_len,
+                                          openvpn_dp_error *_Nullable error);
+
 typedef struct {
+    openvpn_dp_mode_seal_fn seal[2]; // by has_peer_id
+    openvpn_dp_mode_open_fn open;
+} openvpn_dp_mode_variants;
+
+struct openvpn_dp_mode {
     void *crypto;
     pp_crypto_free_fn pp_crypto_free;
     openvpn_dp_mode_encrypter enc;
     openvpn_dp_mode_decrypter dec;
     openvpn_dp_mode_options opt;
+    pp_zd *_Nullable inflate_buf; // scratch of compressed framings, see openvpn_decompress()
+
+    const openvpn_dp_mode_variants *_Nullable variants;
+    openvpn_dp_mode_seal_fn _Nullable seal;
+    openvpn_dp_mode_open_fn _Nullable open;
 
     openvpn_dp_mode_assemble_ctx assemble_ctx;
     openvpn_dp_mode_encrypt_ctx enc_ctx;
     openvpn_dp_mode_decrypt_ctx dec_ctx;
     openvpn_dp_mode_parse_ctx parse_ctx;
-} openvpn_dp_mode;
+};
 
 // "crypto" is owned and released on free
 
@@ -139,6 +184,24 @@ openvpn_dp_mode *openvpn_dp_mode_create(pp_crypto_ctx crypto,
 
 void openvpn_dp_mode_free(openvpn_dp_mode * _Nonnull);
 
+// MARK: - Cursors
+
+/*
+ Once the peer-id is set, a mode only changes through its crypto
+ context and the *_ctx fields of the staged functions. A cursor is a
+ private copy of a mode with its own crypto context, configured with
+ the same keys, so that several threads may encrypt for the same key
+ at once, each with its own cursor and without locking.
+
+ Cursors are released with openvpn_dp_mode_free(), and don't follow
+ later changes to the mode they were created from.
+ */
+
+// "crypto" is owned and released on free
+openvpn_dp_mode *openvpn_dp_mode_create_cursor(const openvpn_dp_mode *mode,
+                                               pp_crypto_ctx crypto,
+                                               pp_crypto_free_fn pp_crypto_free);
+
 static inline
 uint32_t openvpn_dp_mode_peer_id(openvpn_dp_mode *mode) {
     return mode->opt.peer_id;
@@ -147,6 +210,20 @@ uint32_t openvpn_dp_mode_peer_id(openvpn_dp_mode *mode) {
 static inline
 void openvpn_dp_mode_set_peer_id(openvpn_dp_mode *mode, uint32_t peer_id) {
     mode->opt.peer_id = OPENVPN_PEER_ID_MASKED(peer_id);
+    if (mode->variants) {
+        const bool has_peer_id = (mode->opt.peer_id != OpenVPNPacketPeerIdDisabled);
+        mode->seal = mode->variants->seal[has_peer_id];
+    }
+}
+
+// variants is static and selected by framing, NULL for generic modes
+static inline
+void openvpn_dp_mode_set_variants(openvpn_dp_mode *mode,
+                                  const openvpn_dp_mode_variants *_Nullable variants) {
+    mode->variants = variants;
+    mode->seal = NULL;
+    mode->open = variants ? variants->open : NULL;
+    openvpn_dp_mode_set_peer_id(mode, mode->opt.peer_id);
 }
 
 static inline
@@ -225,6 +302,17 @@ pp_zd *_Nullable openvpn_dp_mode_assemble_and_encrypt(openvpn_dp_mode *mode,
 
 // MARK: - Decryption
 
+//
+// Compressed payloads may expand past len, up to OpenVPNDecompressionCapacity
+//
+static inline
+size_t openvpn_dp_mode_parse_capacity(const openvpn_dp_mode *mode, size_t len) {
+    if (!mode->inflate_buf || len >= OpenVPNDecompressionCapacity) {
+        return len;
+    }
+    return OpenVPNDecompressionCapacity;
+}
+
 size_t openvpn_dp_mode_decrypt(openvpn_dp_mode *mode,
                        pp_zd *dst,
                        uint32_t *dst_packet_id,
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Davide De Rosa
+ *
+ * SPDX-License-Identifier: GPL-3.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "openvpn/dp_mode.h"
+#include "openvpn/pkt_proc.h"
+
+#pragma clang assume_nonnull begin
+
+/*
+ A stage composes the link processor (obfuscation) with a data path
+ mode once, so that packets run through the whole chain without
+ intermediate allocations or copies:
+
+ - Outbound
+    - Assembles packet into the scratch buffer
+    - Encrypts payload into the caller slot
+    - Obfuscates the slot in place
+ - Inbound
+    - Decrypts payload into the caller slot
+    - Parses packet in place, by offset
+
+ Inbound de-obfuscation is not part of the stage because the opcode
+ must be in the clear to route packets to the control or data channel.
+
+ Both the mode and the processor are borrowed.
+ */
+
+typedef struct {
+    openvpn_dp_mode *mode;
+    const openvpn_pkt_proc *_Nullable proc;
+} openvpn_dp_stage;
+
+static inline
+openvpn_dp_stage openvpn_dp_stage_make(openvpn_dp_mode *mode,
+                                       const openvpn_pkt_proc *_Nullable proc) {
+    const openvpn_dp_stage stage = { mode, proc };
+    return stage;
+}
+
+// MARK: - Outbound
+
+static inline
+size_t openvpn_dp_stage_send_capacity(const openvpn_dp_stage *stage, size_t len) {
+    return openvpn_dp_mode_assemble_and_encrypt_capacity(stage->mode, len);
+}
+
+/* Returns the length of the packet in dst, ready to SEND, or 0 on failure.
+ * buf must fit openvpn_dp_mode_assemble_capacity(), and dst must fit
+ * openvpn_dp_stage_send_capacity(). */
+size_t openvpn_dp_stage_send(const openvpn_dp_stage *stage,
+                             uint8_t key,
+                             uint32_t packet_id,
+                             pp_zd *buf,
+                             pp_zd *dst,
+                             const uint8_t *src,
+                             size_t src_len,
+                             openvpn_dp_error *_Nullable error);
+
+// MARK: - Inbound
+
+static inline
+size_t openvpn_dp_stage_recv_capacity(const openvpn_dp_stage *stage, size_t len) {
+    return openvpn_dp_mode_parse_capacity(stage->mode, len);
+}
+
+/* Returns the length of the packet found at dst->bytes + *dst_offset, or
+ * 0 on failure. dst must fit src_len, and compressed packets only expand
+ * up to dst->length, see openvpn_dp_stage_recv_capacity(). */
+size_t openvpn_dp_stage_recv(const openvpn_dp_stage *stage,
+                             pp_zd *dst,
+                             size_t *dst_offset,
+                             uint32_t *dst_packet_id,
+                             bool *dst_keep_alive,
+                             const uint8_t *src,
+                             size_t src_len,
+                             openvpn_dp_error *_Nullable error);
+
+#pragma clang assume_nonnull end
@@ -6,11 +6,18 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #pragma clang assume_nonnull begin
 
-void openvpn_mss_fix(uint8_t *data, size_t data_len, uint16_t mtu);
+/*
+ Clamps the MSS option of a TCP SYN (or SYN-ACK) in an IPv4 or IPv6
+ packet to mss, and updates the TCP checksum incrementally. Returns
+ true if the packet was changed. Any malformed or truncated packet is
+ left untouched.
+ */
+bool openvpn_mss_fix(uint8_t *data, size_t data_len, uint16_t mss);
 
 #pragma clang assume_nonnull end
@@ -6,6 +6,7 @@
 
 #include "openvpn/comp.h"
 #include "openvpn/control.h"
+#include "openvpn/decompress.h"
 #include "openvpn/dp_error.h"
 #include "openvpn/dp_framing.h"
 #include "openvpn/dp_framing_comp.h"
@@ -14,6 +15,7 @@
 #include "openvpn/dp_mode_ad.h"
 #include "openvpn/dp_mode_hmac.h"
 #include "openvpn/dp_mode_shortcuts.h"
+#include "openvpn/dp_stage.h"
 #include "openvpn/mss_fix.h"
 #include "openvpn/obf.h"
 #include "openvpn/packet.h"
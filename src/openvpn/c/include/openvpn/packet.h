@@ -42,22 +42,33 @@ typedef enum {
 #define OpenVPNDataPacketNoCompress        0xfa
 #define OpenVPNDataPacketNoCompressSwap    0xfb
 #define OpenVPNDataPacketLZOCompress       0x66
+#define OpenVPNDataPacketLZ4Compress       0x69
 
 #define OpenVPNDataPacketV2Indicator       0x50
 #define OpenVPNDataPacketV2Uncompressed    0x00
+#define OpenVPNDataPacketV2LZ4             0x01
+#define OpenVPNDataPacketV2LZO             0x02
 #define OpenVPNPacketKeyMask               0x07u
 
 // MARK: - Macros
 
 #define OPENVPN_PEER_ID_MASKED(pid)        (pid & 0xffffff)
 
+#define OpenVPNPacketPingLength            ((size_t)16)
+
+static const uint8_t openvpn_packet_ping[OpenVPNPacketPingLength] = {
+    0x2a, 0x18, 0x7b, 0xf3, 0x64, 0x1e, 0xb4, 0xcb,
+    0x07, 0xed, 0x2d, 0x0a, 0x98, 0x1f, 0xc7, 0x48
+};
+
+// Data packets almost always fail on the length or the first byte, so the
+// full comparison only runs for pings
 static inline
 bool openvpn_packet_is_ping(const uint8_t *bytes, size_t len) {
-    static const uint8_t ping[] = {
-        0x2a, 0x18, 0x7b, 0xf3, 0x64, 0x1e, 0xb4, 0xcb,
-        0x07, 0xed, 0x2d, 0x0a, 0x98, 0x1f, 0xc7, 0x48
-    };
-    return len == sizeof(ping) && !memcmp(bytes, ping, len);
+    if (len != OpenVPNPacketPingLength || bytes[0] != openvpn_packet_ping[0]) {
+        return false;
+    }
+    return !memcmp(bytes, openvpn_packet_ping, OpenVPNPacketPingLength);
 }
 
 static inline
@@ -4,90 +4,183 @@
  * SPDX-License-Identifier: GPL-3.0
  */
 
-#include "portable/endian.h"
 #include "openvpn/mss_fix.h"
 
-static const int FLAG_SYN      = 2;
-static const int PROTO_TCP     = 6;
-static const int OPT_END       = 0;
-static const int OPT_NOP       = 1;
-static const int OPT_MSS       = 2;
+#define PROTO_TCP               6
+#define PROTO_IP6_HOP_BY_HOP    0
+#define PROTO_IP6_ROUTING       43
+#define PROTO_IP6_FRAGMENT      44
+#define PROTO_IP6_AUTH          51
+#define PROTO_IP6_DEST_OPTS     60
 
-typedef struct {
-    uint8_t hdr_len:4, ver:4, x[8], proto;
-} ip_hdr_t;
+#define IP4_HEADER_MIN_LEN      20
+#define IP4_PROTO_OFFSET        9
+#define IP4_FRAGMENT_OFFSET     6
+#define IP6_HEADER_LEN          40
+#define IP6_NEXT_HEADER_OFFSET  6
+#define IP6_EXT_MIN_LEN         8
+#define IP6_EXT_MAX_COUNT       8
 
-typedef struct {
-    uint8_t x1[12];
-    uint8_t x2:4, hdr_len:4, flags;
-    uint16_t x3, sum, x4;
-} tcp_hdr_t;
+#define TCP_HEADER_MIN_LEN      20
+#define TCP_DATA_OFFSET_OFFSET  12
+#define TCP_FLAGS_OFFSET        13
+#define TCP_CHECKSUM_OFFSET     16
+#define TCP_FLAG_SYN            0x02
+#define TCP_OPT_END             0
+#define TCP_OPT_NOP             1
+#define TCP_OPT_MSS             2
+#define TCP_OPT_MSS_LEN         4
 
-typedef struct {
-    uint8_t opt, size;
-    uint16_t mss;
-} tcp_opt_t;
+// Big-endian accessors, the fields are not aligned in general
+static inline
+uint16_t mss_load16(const uint8_t *src) {
+    return (uint16_t)((src[0] << 8) | src[1]);
+}
 
 static inline
-void mss_update_sum(uint16_t* sum_ptr, uint16_t* val_ptr, uint16_t new_val)
-{
-    uint32_t sum = (~pp_endian_ntohs(*sum_ptr) & 0xffff) + (~pp_endian_ntohs(*val_ptr) & 0xffff) + new_val;
-    sum = (sum >> 16) + (sum & 0xffff);
-    sum += (sum >> 16);
-    *sum_ptr = pp_endian_htons(~sum & 0xffff);
-    *val_ptr = pp_endian_htons(new_val);
+void mss_store16(uint8_t *dst, uint16_t value) {
+    dst[0] = (uint8_t)(value >> 8);
+    dst[1] = (uint8_t)value;
 }
 
-void openvpn_mss_fix(uint8_t *data, size_t data_len, uint16_t mtu)
-{
-    /* XXX Prevent buffer overread */
-    if (data_len < sizeof(ip_hdr_t)) {
-        return;
-    }
-    ip_hdr_t *iph = (ip_hdr_t *)data;
-    if (iph->proto != PROTO_TCP) {
-        return;
+// RFC 1624, HC' = ~(~HC + ~m + m')
+static inline
+void mss_update_sum(uint8_t *sum, uint16_t old_value, uint16_t new_value) {
+    uint32_t acc = (uint16_t)~mss_load16(sum);
+    acc += (uint16_t)~old_value;
+    acc += new_value;
+    acc = (acc >> 16) + (acc & 0xffff);
+    acc += acc >> 16;
+    mss_store16(sum, (uint16_t)~acc);
+}
+
+// Headers without options or extensions put the TCP flags at fixed
+// offsets, which settles most packets with a single test
+static inline
+bool mss_is_plain_non_syn(const uint8_t *data, size_t data_len) {
+    if (data[0] == 0x45 && data_len >= IP4_HEADER_MIN_LEN + TCP_HEADER_MIN_LEN) {
+        return data[IP4_PROTO_OFFSET] != PROTO_TCP ||
+               !(data[IP4_HEADER_MIN_LEN + TCP_FLAGS_OFFSET] & TCP_FLAG_SYN);
     }
-    uint32_t iph_size = iph->hdr_len * 4;
-    if (iph_size + sizeof(tcp_hdr_t) > data_len) {
-        return;
+    if ((data[0] >> 4) == 6 && data_len >= IP6_HEADER_LEN + TCP_HEADER_MIN_LEN &&
+        data[IP6_NEXT_HEADER_OFFSET] == PROTO_TCP) {
+        return !(data[IP6_HEADER_LEN + TCP_FLAGS_OFFSET] & TCP_FLAG_SYN);
     }
+    return false;
+}
 
-    tcp_hdr_t *tcph = (tcp_hdr_t *)(data + iph_size);
-    if (!(tcph->flags & FLAG_SYN)) {
-        return;
+// Returns the offset of the TCP header, or 0 if there is none to read
+static
+size_t mss_ip4_tcp_offset(const uint8_t *data, size_t data_len) {
+    if (data_len < IP4_HEADER_MIN_LEN || data[IP4_PROTO_OFFSET] != PROTO_TCP) {
+        return 0;
+    }
+    const size_t header_len = (size_t)(data[0] & 0x0f) * 4;
+    if (header_len < IP4_HEADER_MIN_LEN) {
+        return 0;
     }
-    uint8_t *opts = data + iph_size + sizeof(tcp_hdr_t);
+    // Only the first fragment carries the TCP header
+    if (mss_load16(data + IP4_FRAGMENT_OFFSET) & 0x1fff) {
+        return 0;
+    }
+    return header_len;
+}
 
-    uint32_t tcph_len = tcph->hdr_len * 4, optlen = tcph_len-sizeof(tcp_hdr_t);
-    if (iph_size + sizeof(tcp_hdr_t) + optlen > data_len) {
-        return;
+// Same as mss_ip4_tcp_offset(), skipping the extension headers
+static
+size_t mss_ip6_tcp_offset(const uint8_t *data, size_t data_len) {
+    if (data_len < IP6_HEADER_LEN) {
+        return 0;
+    }
+    uint8_t next = data[IP6_NEXT_HEADER_OFFSET];
+    size_t offset = IP6_HEADER_LEN;
+    for (int i = 0; next != PROTO_TCP; ++i) {
+        if (i == IP6_EXT_MAX_COUNT || offset + IP6_EXT_MIN_LEN > data_len) {
+            return 0;
+        }
+        const uint8_t *ext = data + offset;
+        switch (next) {
+            case PROTO_IP6_HOP_BY_HOP:
+            case PROTO_IP6_ROUTING:
+            case PROTO_IP6_DEST_OPTS:
+                offset += ((size_t)ext[1] + 1) * 8;
+                break;
+            case PROTO_IP6_FRAGMENT:
+                if (mss_load16(ext + 2) & 0xfff8) {
+                    return 0;
+                }
+                offset += IP6_EXT_MIN_LEN;
+                break;
+            case PROTO_IP6_AUTH:
+                offset += ((size_t)ext[1] + 2) * 4;
+                break;
+            default:
+                // ESP, no next header, or anything else
+                return 0;
+        }
+        next = ext[0];
     }
+    return offset;
+}
 
-    for (uint32_t i = 0; i < optlen;) {
-        tcp_opt_t *o = (tcp_opt_t *)&opts[i];
+bool openvpn_mss_fix(uint8_t *data, size_t data_len, uint16_t mss) {
+    if (!data_len || mss_is_plain_non_syn(data, data_len)) {
+        return false;
+    }
+    size_t tcp_offset;
+    switch (data[0] >> 4) {
+        case 4:
+            tcp_offset = mss_ip4_tcp_offset(data, data_len);
+            break;
+        case 6:
+            tcp_offset = mss_ip6_tcp_offset(data, data_len);
+            break;
+        default:
+            return false;
+    }
+    if (!tcp_offset || tcp_offset > data_len || data_len - tcp_offset < TCP_HEADER_MIN_LEN) {
+        return false;
+    }
+    uint8_t *tcp = data + tcp_offset;
+    if (!(tcp[TCP_FLAGS_OFFSET] & TCP_FLAG_SYN)) {
+        return false;
+    }
+    const size_t tcp_len = (size_t)(tcp[TCP_DATA_OFFSET_OFFSET] >> 4) * 4;
+    if (tcp_len < TCP_HEADER_MIN_LEN || tcp_len > data_len - tcp_offset) {
+        return false;
+    }
 
-        /* XXX Prevent buffer overread */
-        if ((void *)(o + sizeof(tcp_opt_t)) > (void *)(data + data_len)) {
-            return;
+    // Every option is bounded by the TCP header
+    size_t i = TCP_HEADER_MIN_LEN;
+    while (i < tcp_len) {
+        const uint8_t kind = tcp[i];
+        if (kind == TCP_OPT_END) {
+            return false;
         }
-
-        if (o->opt == OPT_END) {
-            return;
+        if (kind == TCP_OPT_NOP) {
+            ++i;
+            continue;
         }
-        if (o->opt == OPT_MSS) {
-            if (i + o->size > optlen) {
-                return;
+        if (tcp_len - i < 2) {
+            return false;
+        }
+        const uint8_t size = tcp[i + 1];
+        if (size < 2 || size > tcp_len - i) {
+            return false;
+        }
+        if (kind == TCP_OPT_MSS) {
+            if (size != TCP_OPT_MSS_LEN) {
+                return false;
             }
-            if (pp_endian_ntohs(o->mss) <= mtu) {
-                return;
+            const uint16_t current = mss_load16(tcp + i + 2);
+            if (current <= mss) {
+                return false;
             }
-            mss_update_sum(&tcph->sum, &o->mss, mtu);
-            return;
+            mss_update_sum(tcp + TCP_CHECKSUM_OFFSET, current, mss);
+            mss_store16(tcp + i + 2, mss);
+            return true;
         }
-
-        /* XXX Prevent infinite loop */
-        i += (o->opt == OPT_NOP) ? 1 : (o->size ? o->size : 1);
-//        i += (o->opt == OPT_NOP) ? 1 : o->size;
+        i += size;
     }
+    return false;
 }
@@ -15,7 +15,13 @@
 static inline
 void alg_plain(const openvpn_pkt_proc_alg_ctx *ctx) {
     pp_assert(ctx);
-    memcpy(ctx->dst + ctx->dst_offset, ctx->src + ctx->src_offset, ctx->src_len);
+    uint8_t *dst = ctx->dst + ctx->dst_offset;
+    const uint8_t *src = ctx->src + ctx->src_offset;
+    // In-place processing, e.g. of reassembled TCP frames
+    if (dst == src) {
+        return;
+    }
+    memcpy(dst, src, ctx->src_len);
 }
 
 static
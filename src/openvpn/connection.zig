@@ -7,7 +7,6 @@ const std = @import("std");
 const core = @import("../core/exports.zig");
 const net = @import("../net/exports.zig");
 const configuration_mod = @import("internal/configuration.zig");
-const constants_mod = @import("internal/constants.zig");
 const crypto_mod = @import("internal/crypto.zig");
 const endpoint_resolver_mod = @import("internal/endpoint_resolver.zig");
 const errors_mod = @import("internal/errors.zig");
@@ -21,11 +20,11 @@ const openvpn_log = logging_mod;
 const EndpointResolver = endpoint_resolver_mod.EndpointResolver;
 const SessionOptions = configuration_mod.SessionOptions;
 const NetworkSettingsBuilder = settings_mod.NetworkSettingsBuilder;
+const SettingsSummary = settings_mod.SettingsSummary;
 const PRNG = crypto_mod.PRNG;
 const Session = session_mod.Session;
 const SessionEvents = session_mod.SessionEvents;
 const SessionError = errors_mod.SessionError;
-const TLSConstants = constants_mod.TLS;
 
 const EnvironmentKeys = struct {
     const server_configuration = "OpenVPN.serverConfiguration";
@@ -67,13 +66,14 @@ const OpenVPNConnection = struct {
     credentials: ?api.OpenVPNCredentials,
     endpoints: []api.ExtendedEndpoint,
     endpoint_resolver: EndpointResolver,
-    cache_dir: []u8,
 
     status: api.ConnectionStatus,
     events: ?net.Connection.Events,
     current_session: ?*Session,
     current_endpoint: ?api.ExtendedEndpoint,
     tunnel: ?net.TunWrapper,
+    /// Settings built for the last session, kept across reconnections.
+    last_settings: ?SettingsSummary,
 
     // MARK: - Public API
 
@@ -124,9 +124,6 @@ const OpenVPNConnection = struct {
             null;
         errdefer if (credentials) |*value| value.deinit(allocator);
 
-        const cache_dir = try allocator.dupe(u8, sandbox.cache_dir);
-        errdefer allocator.free(cache_dir);
-
         const created = try allocator.create(OpenVPNConnection);
         var session_options = context.session_options;
         session_options.write_timeout_ms = sandbox.options.link_write_timeout;
@@ -147,12 +144,12 @@ const OpenVPNConnection = struct {
             .credentials = credentials,
             .endpoints = endpoints,
             .endpoint_resolver = EndpointResolver.init(endpoints),
-            .cache_dir = cache_dir,
             .status = .disconnected,
             .events = null,
             .current_session = null,
             .current_endpoint = null,
             .tunnel = null,
+            .last_settings = null,
         };
         log.write(.notice, "Using v3 connection");
         return created.asConnection();
@@ -166,7 +163,7 @@ const OpenVPNConnection = struct {
         core.util.freeSlice(api.ExtendedEndpoint, self.allocator, self.endpoints);
         self.configuration.deinit(self.allocator);
         if (self.credentials) |*credentials| credentials.deinit(self.allocator);
-        self.allocator.free(self.cache_dir);
+        if (self.last_settings) |*summary| summary.deinit(self.allocator);
         const allocator = self.allocator;
         allocator.destroy(self);
     }
@@ -192,16 +189,6 @@ const OpenVPNConnection = struct {
         self.destroyCurrentSession();
         self.clearLink();
 
-        const ca_filename = api.moduleCacheFilename(
-            self.allocator,
-            self.module_id,
-            TLSConstants.ca_filename,
-        ) catch |err| {
-            log.writef(.err, "Unable to create session: {s}", .{@errorName(err)});
-            return error.UnableToStart;
-        };
-        defer self.allocator.free(ca_filename);
-
         const session_events = SessionEvents{
             .context = self,
             .established = sessionEstablished,
@@ -214,8 +201,6 @@ const OpenVPNConnection = struct {
             .configuration = self.configuration,
             .credentials = self.credentials,
             .prng = PRNG.system(),
-            .caches_directory = self.cache_dir,
-            .ca_filename = ca_filename,
             .options = self.session_options,
         }) catch |err| {
             log.writef(.err, "Unable to create session: {s}", .{@errorName(err)});
@@ -364,6 +349,7 @@ const OpenVPNConnection = struct {
             return;
         };
         defer core.util.freeSlice(api.TaggedModule, self.allocator, modules);
+        self.summarizeSettings(modules);
 
         const info = api.TunnelRemoteInfoWrapper{
             .profile = self.profile.*,
@@ -397,6 +383,23 @@ const OpenVPNConnection = struct {
         }
     }
 
+    /// Logs the routes of a reconnection only as far as they differ from
+    /// those of the previous session, since servers usually push the same
+    /// settings again.
+    fn summarizeSettings(self: *OpenVPNConnection, modules: []const api.TaggedModule) void {
+        var summary = SettingsSummary.init(self.allocator, modules) catch |err| {
+            log.writef(.err, "Unable to summarize settings: {s}", .{@errorName(err)});
+            settings_mod.logSettingsChanges(null, null, modules);
+            if (self.last_settings) |*value| value.deinit(self.allocator);
+            self.last_settings = null;
+            return;
+        };
+        const previous = if (self.last_settings) |*value| value else null;
+        settings_mod.logSettingsChanges(previous, &summary, modules);
+        if (self.last_settings) |*value| value.deinit(self.allocator);
+        self.last_settings = summary;
+    }
+
     fn failTunnelSetup(
         self: *OpenVPNConnection,
         session: *Session,
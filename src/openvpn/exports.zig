@@ -27,10 +27,11 @@
 //! - Key renegotiation
 //! - Replay protection (hardcoded window)
 //!
-//! The library supports compression framing, just not compression. Match
-//! server-side compression framing, otherwise the client will shut down with an
-//! error. For example, if the server has `comp-lzo no`, the client must use
-//! `.compLZO` compression framing.
+//! The library supports compression framing, and decompresses LZO and LZ4
+//! packets from legacy servers, but never compresses outbound packets (see
+//! VORACLE). Match server-side compression framing, otherwise the client will
+//! shut down with an error. For example, if the server has `comp-lzo no`, the
+//! client must use `.compLZO` compression framing.
 //!
 //! ## Tunnelblick XOR Patch
 //!
@@ -50,7 +50,6 @@ pub const Keys = struct {
 };
 
 pub const TLS = struct {
-    pub const ca_filename = "ca.pem";
     pub const default_security_level: i32 = 0;
     pub const buffer_length: usize = 16 * 1024;
 };
@@ -25,6 +25,7 @@ const CryptoKeys = crypto_mod.CryptoKeys;
 const CryptoKeysBridge = crypto_mod.CryptoKeysBridge;
 const DataConstants = constants_mod.Data;
 const LinkProcessor = processing_mod.LinkProcessor;
+const PacketProcessor = processing_mod.PacketProcessor;
 const PRF = auth_mod.PRF;
 const PRNG = crypto_mod.PRNG;
 const ZeroingData = crypto_mod.ZeroingData;
@@ -35,6 +36,16 @@ const ZeroingData = crypto_mod.ZeroingData;
 /// released by `destroy`. Cryptographic/framing transforms, replay-window
 /// bookkeeping, and ping recognition delegate to the existing C routines;
 /// this type only owns buffers and orchestrates packet batches.
+///
+/// The mode and the optional link obfuscation are composed once into an
+/// `openvpn_dp_stage`, through which `sendBatch` and `receiveBatch` process
+/// whole batches in a reusable buffer without per-packet allocations.
+///
+/// Outbound packet ids are reserved atomically, so that the owner and any
+/// number of `Sender` may encrypt for the same key concurrently.
+///
+/// Pings are sealed by `sendPing` into a buffer of their own, sized once at
+/// creation, so that keepalives never touch the batch storage.
 pub const DataPath = struct {
     pub const Parameters = struct {
         backend: CryptoBackend,
@@ -42,6 +53,11 @@ pub const DataPath = struct {
         digest: ?api.OpenVPNDigest,
         compression_framing: api.OpenVPNCompressionFraming,
         peer_id: ?u32,
+        obfuscation: ?api.OpenVPNObfuscationMethod = null,
+        /// Borrowed, must outlive the data path.
+        metrics: ?*core_mod.Metrics = null,
+        /// Number of `Sender` to create for threads other than the owner.
+        senders: usize = 0,
     };
 
     pub const DecryptedPacket = struct {
@@ -63,6 +79,55 @@ pub const DataPath = struct {
         }
     };
 
+    /// Packets borrowed from the data path until the next batch.
+    pub const Batch = struct {
+        packets: []const []const u8,
+        keep_alive: bool,
+    };
+
+    /// Encrypts batches for the key of a data path on behalf of one extra
+    /// thread. Each sender owns a cursor of the data path mode, i.e. its own
+    /// crypto context and buffers, and only shares the packet id counter.
+    /// A sender must not be used by more than one thread at a time.
+    pub const Sender = struct {
+        data_path: *DataPath,
+        cursor: *c.openvpn_dp_mode,
+        stage: c.openvpn_dp_stage,
+        enc_buffer: *c_common.pp_zd,
+        batch_buffer: *c_common.pp_zd,
+        batch_packets: std.ArrayList([]const u8) = .empty,
+
+        fn deinit(self: *Sender, allocator: std.mem.Allocator) void {
+            c.openvpn_dp_mode_free(self.cursor);
+            c_common.pp_zd_free(self.enc_buffer);
+            c_common.pp_zd_free(self.batch_buffer);
+            self.batch_packets.deinit(allocator);
+        }
+
+        /// Same as `DataPath.sendBatch`, the result is only valid until the
+        /// next batch of this sender.
+        pub fn sendBatch(
+            self: *Sender,
+            packets: []const []const u8,
+            key: u8,
+        ) Error![]const []const u8 {
+            const data_path = self.data_path;
+            const first_packet_id = try data_path.reservePacketIds(packets.len);
+            const result = try sealBatch(
+                data_path.allocator,
+                &self.stage,
+                self.enc_buffer,
+                self.batch_buffer,
+                &self.batch_packets,
+                packets,
+                key,
+                first_packet_id,
+            );
+            data_path.countEncrypted(packets);
+            return result;
+        }
+    };
+
     pub const Error = std.mem.Allocator.Error || error{
         CompressionMismatch,
         CryptoFailure,
@@ -76,7 +141,17 @@ pub const DataPath = struct {
     enc_buffer: *c_common.pp_zd,
     dec_buffer: *c_common.pp_zd,
     replay: *c.openvpn_replay,
-    out_packet_id: u32 = 0,
+    /// The last reserved outbound packet id.
+    out_packet_id: std.atomic.Value(u32) = .init(0),
+
+    // Fused stage and the storage of the last batch.
+    obfuscator: ?PacketProcessor,
+    stage: c.openvpn_dp_stage,
+    batch_buffer: *c_common.pp_zd,
+    batch_packets: std.ArrayList([]const u8) = .empty,
+    ping_buffer: *c_common.pp_zd,
+    metrics: ?*core_mod.Metrics = null,
+    senders: std.ArrayList(Sender) = .empty,
 
     const resize_step: usize = 1024;
     const initial_buffer_size: usize = 64 * 1024;
@@ -86,15 +161,32 @@ pub const DataPath = struct {
         allocator: std.mem.Allocator,
         mode: *c.openvpn_dp_mode,
         peer_id: u32,
+        obfuscation: ?api.OpenVPNObfuscationMethod,
     ) !*DataPath {
         const self = try allocator.create(DataPath);
+        errdefer allocator.destroy(self);
+        var obfuscator: ?PacketProcessor = if (obfuscation) |method|
+            try PacketProcessor.init(allocator, method)
+        else
+            null;
+        errdefer if (obfuscator) |*processor| processor.deinit();
         c.openvpn_dp_mode_set_peer_id(mode, peer_id);
+        const stage = c.openvpn_dp_stage_make(
+            mode,
+            if (obfuscator) |processor| processor.ptr else null,
+        );
         self.* = .{
             .allocator = allocator,
             .mode = mode,
             .enc_buffer = c_common.pp_zd_create(initial_buffer_size),
             .dec_buffer = c_common.pp_zd_create(initial_buffer_size),
             .replay = c.openvpn_replay_create(),
+            .obfuscator = obfuscator,
+            .stage = stage,
+            .batch_buffer = c_common.pp_zd_create(initial_buffer_size),
+            .ping_buffer = c_common.pp_zd_create(
+                c.openvpn_dp_stage_send_capacity(&stage, DataConstants.ping_string.len),
+            ),
         };
         return self;
     }
@@ -134,49 +226,311 @@ pub const DataPath = struct {
         var bridge = CryptoKeysBridge.init(keys);
         defer bridge.deinit();
 
+        const fnt: *const c.pp_crypto_enc_fnt = @ptrCast(&functions);
+        const native_keys: *const c.pp_crypto_keys = @ptrCast(bridge.native());
         const framing = nativeFraming(parameters.compression_framing);
-        const cipher_name = if (parameters.cipher) |cipher| cipher.raw() else null;
         const is_aead = if (parameters.cipher) |cipher|
             configuration_mod.cipherEmbedsDigest(cipher)
         else
             false;
-        const mode: *c.openvpn_dp_mode = if (is_aead) blk: {
+        const crypto_free = if (is_aead) fnt.aead_free else fnt.cbc_free;
+        const mode: *c.openvpn_dp_mode = blk: {
+            const crypto = try createNativeCrypto(fnt, parameters, is_aead, native_keys);
+            break :blk if (is_aead)
+                c.openvpn_dp_mode_ad_create(crypto, crypto_free, framing)
+            else
+                c.openvpn_dp_mode_hmac_create(crypto, crypto_free, framing);
+        };
+        const self = blk: {
+            errdefer c.openvpn_dp_mode_free(mode);
+            break :blk try createWithMode(
+                allocator,
+                mode,
+                parameters.peer_id orelse c.OpenVPNPacketPeerIdDisabled,
+                parameters.obfuscation,
+            );
+        };
+        errdefer self.destroy();
+        self.metrics = parameters.metrics;
+
+        // Cursors get their own crypto contexts from the same keys.
+        try self.senders.ensureTotalCapacityPrecise(allocator, parameters.senders);
+        for (0..parameters.senders) |_| {
+            const crypto = try createNativeCrypto(fnt, parameters, is_aead, native_keys);
+            self.addSender(crypto, crypto_free);
+        }
+        return self;
+    }
+
+    fn createNativeCrypto(
+        fnt: *const c.pp_crypto_enc_fnt,
+        parameters: Parameters,
+        is_aead: bool,
+        keys: *const c.pp_crypto_keys,
+    ) Error!c.pp_crypto_ctx {
+        const cipher_name = if (parameters.cipher) |cipher| cipher.raw() else null;
+        if (is_aead) {
             const name = cipher_name orelse return error.UnsupportedAlgorithm;
-            break :blk c.openvpn_dp_mode_ad_create_aead(
-                @ptrCast(&functions),
+            return fnt.aead_create.?(
                 name.ptr,
                 DataConstants.aead_tag_length,
                 DataConstants.aead_id_length,
-                @ptrCast(bridge.native()),
-                framing,
-            ) orelse return error.UnsupportedAlgorithm;
-        } else blk: {
-            const digest = parameters.digest orelse return error.UnsupportedAlgorithm;
-            break :blk c.openvpn_dp_mode_hmac_create_cbc(
-                @ptrCast(&functions),
-                if (cipher_name) |value| value.ptr else null,
-                digest.raw().ptr,
-                @ptrCast(bridge.native()),
-                framing,
+                keys,
             ) orelse return error.UnsupportedAlgorithm;
-        };
-        errdefer c.openvpn_dp_mode_free(mode);
-        return createWithMode(
-            allocator,
-            mode,
-            parameters.peer_id orelse c.OpenVPNPacketPeerIdDisabled,
-        );
+        }
+        const digest = parameters.digest orelse return error.UnsupportedAlgorithm;
+        return fnt.cbc_create.?(
+            if (cipher_name) |value| value.ptr else null,
+            digest.raw().ptr,
+            keys,
+        ) orelse return error.UnsupportedAlgorithm;
     }
 
-    pub fn destroy(self: *const DataPath) void {
+    /// `crypto` must be configured with the keys of the data path mode, and
+    /// is owned by the sender. Capacity must be reserved in `senders`, so
+    /// that senders never move.
+    fn addSender(
+        self: *DataPath,
+        crypto: c.pp_crypto_ctx,
+        crypto_free: c.pp_crypto_free_fn,
+    ) void {
+        std.debug.assert(self.senders.items.len < self.senders.capacity);
+        const cursor = c.openvpn_dp_mode_create_cursor(self.mode, crypto, crypto_free);
+        self.senders.appendAssumeCapacity(.{
+            .data_path = self,
+            .cursor = cursor,
+            .stage = c.openvpn_dp_stage_make(cursor, self.stage.proc),
+            .enc_buffer = c_common.pp_zd_create(initial_buffer_size),
+            .batch_buffer = c_common.pp_zd_create(initial_buffer_size),
+        });
+    }
+
+    /// The senders requested by `Parameters.senders`, each to be used by at
+    /// most one thread at a time.
+    pub fn sender(self: *DataPath, index: usize) *Sender {
+        return &self.senders.items[index];
+    }
+
+    pub fn destroy(self: *DataPath) void {
         const allocator = self.allocator;
         c.openvpn_replay_free(self.replay);
         c.openvpn_dp_mode_free(self.mode);
         c_common.pp_zd_free(self.enc_buffer);
         c_common.pp_zd_free(self.dec_buffer);
+        c_common.pp_zd_free(self.batch_buffer);
+        c_common.pp_zd_free(self.ping_buffer);
+        self.batch_packets.deinit(allocator);
+        for (self.senders.items) |*item| item.deinit(allocator);
+        self.senders.deinit(allocator);
+        if (self.obfuscator) |*processor| processor.deinit();
         allocator.destroy(self);
     }
 
+    /// Encrypts and obfuscates `packets` straight into the batch buffer.
+    /// The result is ready to frame and send, and is only valid until the
+    /// next batch.
+    pub fn sendBatch(
+        self: *DataPath,
+        packets: []const []const u8,
+        key: u8,
+    ) Error![]const []const u8 {
+        const first_packet_id = try self.reservePacketIds(packets.len);
+        const result = try sealBatch(
+            self.allocator,
+            &self.stage,
+            self.enc_buffer,
+            self.batch_buffer,
+            &self.batch_packets,
+            packets,
+            key,
+            first_packet_id,
+        );
+        self.countEncrypted(packets);
+        return result;
+    }
+
+    /// Encrypts and obfuscates a ping into the ping buffer, with no
+    /// allocations. The result is only valid until the next ping.
+    pub fn sendPing(self: *DataPath, key: u8) Error![]const u8 {
+        const ping: []const u8 = &DataConstants.ping_string;
+        const packet_id = try self.reservePacketIds(1);
+        ensureCapacity(self.enc_buffer, c.openvpn_dp_mode_assemble_capacity(self.stage.mode, ping.len));
+        var slot = c.pp_zd{
+            .bytes = self.ping_buffer.*.bytes,
+            .length = self.ping_buffer.*.length,
+        };
+        var native_error = emptyNativeError();
+        const length = c.openvpn_dp_stage_send(
+            &self.stage,
+            key,
+            packet_id,
+            @ptrCast(self.enc_buffer),
+            &slot,
+            ping.ptr,
+            ping.len,
+            &native_error,
+        );
+        if (length == 0) return nativeError(native_error);
+        self.countEncrypted(&.{ping});
+        return slot.bytes[0..length];
+    }
+
+    /// Reserves `count` consecutive outbound packet ids and returns the
+    /// first one. Safe to call from any thread. Fails without reserving
+    /// anything when the ids would exceed the 32-bit space.
+    pub fn reservePacketIds(self: *DataPath, count: usize) Error!u32 {
+        const requested = std.math.cast(u32, count) orelse return packetIdsExhausted();
+        var last = self.out_packet_id.load(.monotonic);
+        while (true) {
+            const next_last = std.math.add(u32, last, requested) catch return packetIdsExhausted();
+            last = self.out_packet_id.cmpxchgWeak(
+                last,
+                next_last,
+                .monotonic,
+                .monotonic,
+            ) orelse return last +% 1;
+        }
+    }
+
+    fn packetIdsExhausted() Error {
+        log.write(.notice, "OpenVPN data packet counter exhausted; reconnecting");
+        return error.Reconnect;
+    }
+
+    /// Seals `packets` with the consecutive ids starting at `first_packet_id`
+    /// into `buffer`, and returns their views collected in `views`.
+    fn sealBatch(
+        allocator: std.mem.Allocator,
+        stage: *const c.openvpn_dp_stage,
+        scratch: *c_common.pp_zd,
+        buffer: *c_common.pp_zd,
+        views: *std.ArrayList([]const u8),
+        packets: []const []const u8,
+        key: u8,
+        first_packet_id: u32,
+    ) Error![]const []const u8 {
+        var capacity: usize = 0;
+        for (packets) |packet| {
+            const packet_capacity = c.openvpn_dp_stage_send_capacity(stage, packet.len);
+            capacity = std.math.add(usize, capacity, packet_capacity) catch return error.OutOfMemory;
+        }
+        ensureCapacity(buffer, capacity);
+        views.clearRetainingCapacity();
+        try views.ensureTotalCapacity(allocator, packets.len);
+
+        var offset: usize = 0;
+        var packet_id = first_packet_id;
+        for (packets) |packet| {
+            ensureCapacity(scratch, c.openvpn_dp_mode_assemble_capacity(stage.mode, packet.len));
+            const slot_length = c.openvpn_dp_stage_send_capacity(stage, packet.len);
+            var slot = c.pp_zd{
+                .bytes = buffer.*.bytes + offset,
+                .length = slot_length,
+            };
+            var native_error = emptyNativeError();
+            const length = c.openvpn_dp_stage_send(
+                stage,
+                key,
+                packet_id,
+                @ptrCast(scratch),
+                &slot,
+                packet.ptr,
+                packet.len,
+                &native_error,
+            );
+            if (length == 0) return nativeError(native_error);
+            views.appendAssumeCapacity(slot.bytes[0..length]);
+            offset += slot_length;
+            packet_id +%= 1;
+        }
+        return views.items;
+    }
+
+    fn countEncrypted(self: *const DataPath, packets: []const []const u8) void {
+        const metrics = self.metrics orelse return;
+        var bytes: u64 = 0;
+        for (packets) |packet| bytes += packet.len;
+        metrics.add(.encrypt_packets, packets.len);
+        metrics.add(.encrypt_bytes, bytes);
+    }
+
+    /// Decrypts `packets`, already de-obfuscated by the link, into the batch
+    /// buffer and parses them in place. Replayed packets and pings are
+    /// dropped. The result is only valid until the next batch.
+    pub fn receiveBatch(
+        self: *DataPath,
+        packets: []const []const u8,
+    ) Error!Batch {
+        // Compressed packets expand within their slot
+        var capacity: usize = 0;
+        var bytes: usize = 0;
+        for (packets) |packet| {
+            const slot_length = c.openvpn_dp_stage_recv_capacity(&self.stage, packet.len);
+            capacity = std.math.add(usize, capacity, slot_length) catch return error.OutOfMemory;
+            bytes += packet.len;
+        }
+        ensureCapacity(self.batch_buffer, capacity);
+        self.batch_packets.clearRetainingCapacity();
+        try self.batch_packets.ensureTotalCapacity(self.allocator, packets.len);
+
+        var keep_alive = false;
+        var offset: usize = 0;
+        var replayed: u64 = 0;
+        var keep_alives: u64 = 0;
+        defer if (self.metrics) |metrics| {
+            metrics.add(.replay_rejects, replayed);
+            metrics.add(.keep_alives, keep_alives);
+        };
+        for (packets) |packet| {
+            const slot_length = c.openvpn_dp_stage_recv_capacity(&self.stage, packet.len);
+            var slot = c.pp_zd{
+                .bytes = self.batch_buffer.*.bytes + offset,
+                .length = slot_length,
+            };
+            offset += slot_length;
+            var payload_offset: usize = 0;
+            var packet_id: u32 = 0;
+            var is_keep_alive = false;
+            var native_error = emptyNativeError();
+            const length = c.openvpn_dp_stage_recv(
+                &self.stage,
+                &slot,
+                &payload_offset,
+                &packet_id,
+                &is_keep_alive,
+                packet.ptr,
+                packet.len,
+                &native_error,
+            );
+            if (length == 0) {
+                self.countFailure(native_error);
+                return nativeError(native_error);
+            }
+            if (packet_id > max_packet_id) {
+                log.write(.notice, "OpenVPN peer data packet counter exhausted; reconnecting");
+                return error.Reconnect;
+            }
+            if (c.openvpn_replay_is_replayed(self.replay, packet_id)) {
+                replayed += 1;
+                continue;
+            }
+            if (is_keep_alive) {
+                keep_alive = true;
+                keep_alives += 1;
+                continue;
+            }
+            self.batch_packets.appendAssumeCapacity(slot.bytes[payload_offset..][0..length]);
+        }
+        if (self.metrics) |metrics| {
+            metrics.add(.decrypt_packets, packets.len);
+            metrics.add(.decrypt_bytes, bytes);
+        }
+        return .{
+            .packets = self.batch_packets.items,
+            .keep_alive = keep_alive,
+        };
+    }
+
     pub fn encryptPackets(
         self: *DataPath,
         allocator: std.mem.Allocator,
@@ -186,18 +540,16 @@ pub const DataPath = struct {
         var result: std.ArrayList([]u8) = .empty;
         errdefer core_mod.util.deinitListOfStrings(allocator, &result);
         try result.ensureTotalCapacity(allocator, packets.len);
+        var packet_id = try self.reservePacketIds(packets.len);
         for (packets) |packet| {
-            self.out_packet_id = std.math.add(u32, self.out_packet_id, 1) catch {
-                log.write(.notice, "OpenVPN data packet counter exhausted; reconnecting");
-                return error.Reconnect;
-            };
             const encrypted = try self.assembleAndEncrypt(
                 allocator,
                 packet,
                 key,
-                self.out_packet_id,
+                packet_id,
             );
             result.appendAssumeCapacity(encrypted);
+            packet_id +%= 1;
         }
         return result.toOwnedSlice(allocator);
     }
@@ -263,7 +615,7 @@ pub const DataPath = struct {
         allocator: std.mem.Allocator,
         packet: []const u8,
     ) !DecryptedPacket {
-        ensureCapacity(self.dec_buffer, packet.len);
+        ensureCapacity(self.dec_buffer, c.openvpn_dp_mode_parse_capacity(self.mode, packet.len));
         var packet_id: u32 = 0;
         var ignored_header: u8 = 0;
         var keep_alive = false;
@@ -299,6 +651,16 @@ pub const DataPath = struct {
         };
     }
 
+    fn countFailure(self: *const DataPath, native: c.openvpn_dp_error) void {
+        const metrics = self.metrics orelse return;
+        metrics.increment(switch (native.dp_code) {
+            c.OpenVPNDataPathErrorPeerIdMismatch => .decrypt_failures_peer_id,
+            c.OpenVPNDataPathErrorCompression => .decrypt_failures_compression,
+            c.OpenVPNDataPathErrorCrypto => .decrypt_failures_crypto,
+            else => .decrypt_failures_other,
+        });
+    }
+
     fn nativeError(native: c.openvpn_dp_error) error{
         CompressionMismatch,
         CryptoFailure,
@@ -349,22 +711,28 @@ pub const DataChannel = struct {
         allocator.destroy(self);
     }
 
-    /// The caller owns the returned packet rows and outer slice.
+    /// The returned packets are borrowed from the data path until the next
+    /// `encrypt` or `decrypt`.
     pub fn encrypt(
         self: *const DataChannel,
-        allocator: std.mem.Allocator,
         packets: []const []const u8,
-    ) ![][]u8 {
-        return self.data_path.encryptPackets(allocator, packets, self.key);
+    ) ![]const []const u8 {
+        return self.data_path.sendBatch(packets, self.key);
     }
 
-    /// The caller owns the returned packet rows and outer slice.
+    /// The returned packet is borrowed from the data path until the next
+    /// `encryptPing`.
+    pub fn encryptPing(self: *const DataChannel) ![]const u8 {
+        return self.data_path.sendPing(self.key);
+    }
+
+    /// The returned packets are borrowed from the data path until the next
+    /// `encrypt` or `decrypt`.
     pub fn decrypt(
         self: *const DataChannel,
-        allocator: std.mem.Allocator,
         packets: []const []const u8,
-    ) ![][]u8 {
-        const result = try self.data_path.decryptPackets(allocator, packets);
+    ) ![]const []const u8 {
+        const result = try self.data_path.receiveBatch(packets);
         if (result.keep_alive)
             log.write(.debug, "Data: Received ping, do nothing");
         return result.packets;
@@ -411,18 +779,19 @@ pub const DataLink = struct {
         key: u8,
     ) !void {
         const channel = self.callbacks.data_channel(self.context, key) orelse return;
-        const decrypted = channel.decrypt(self.allocator, packets) catch |err| {
+        const batch_start = core_mod.concurrency.monotonicNs();
+        const decrypted = channel.decrypt(packets) catch |err| {
             log.write(.err, "Unable to decrypt packets, is DataChannel properly configured?");
             return err;
         };
-        defer core_mod.util.freeSliceOfStrings(self.allocator, decrypted);
         if (decrypted.len == 0) return;
 
         self.callbacks.report_inbound_data_count(
             self.context,
             flatCount(decrypted),
         );
-        try self.looper.writeQueued(asConstPackets(decrypted), .tun);
+        try self.looper.writeQueued(decrypted, .tun);
+        self.recordLatency(.link_to_tun, batch_start);
     }
 
     pub fn send(
@@ -432,11 +801,11 @@ pub const DataLink = struct {
         timeout_ms: ?u64,
     ) !void {
         const channel = self.callbacks.data_channel(self.context, key) orelse return;
-        const encrypted = channel.encrypt(self.allocator, packets) catch |err| {
+        const batch_start = core_mod.concurrency.monotonicNs();
+        const encrypted = channel.encrypt(packets) catch |err| {
             log.write(.err, "Unable to encrypt packets, is DataChannel properly configured?");
             return err;
         };
-        defer core_mod.util.freeSliceOfStrings(self.allocator, encrypted);
         if (encrypted.len == 0) return;
 
         self.callbacks.report_outbound_data_count(
@@ -444,7 +813,8 @@ pub const DataLink = struct {
             flatCount(encrypted),
         );
 
-        var processed = try self.link_processor.processOutbound(asConstPackets(encrypted));
+        // Already obfuscated by the data path stage.
+        var processed = try self.link_processor.frameOutbound(encrypted);
         defer processed.deinit();
 
         if (timeout_ms) |timeout| {
@@ -469,23 +839,45 @@ pub const DataLink = struct {
                 });
                 return err;
             };
+            self.recordLatency(.tun_to_link, batch_start);
         }
     }
 
-    fn flatCount(packets: []const []u8) usize {
+    /// Same as `send` for a single ping, with no allocations: the data path
+    /// seals it into a dedicated buffer, and TCP framing goes on the stack.
+    pub fn sendPing(self: *const DataLink, key: u8) !void {
+        const channel = self.callbacks.data_channel(self.context, key) orelse return;
+        const encrypted = channel.encryptPing() catch |err| {
+            log.write(.err, "Unable to encrypt ping, is DataChannel properly configured?");
+            return err;
+        };
+        self.callbacks.report_outbound_data_count(self.context, encrypted.len);
+
+        var frame_buffer: [ping_frame_capacity]u8 = undefined;
+        const frame = try self.link_processor.frameOutboundInto(&frame_buffer, encrypted);
+        self.looper.writeQueued(&.{frame}, .link) catch |err| {
+            log.writef(.err, "Data: Failed LINK write during send ping: {s}", .{
+                @errorName(err),
+            });
+            return err;
+        };
+    }
+
+    /// Room for a framed ping with the largest IV, padding and digest.
+    const ping_frame_capacity = 512;
+
+    fn recordLatency(self: *const DataLink, latency: core_mod.metrics.Latency, start_ns: u64) void {
+        const metrics = self.looper.options.metrics orelse return;
+        metrics.recordLatency(latency, core_mod.concurrency.monotonicNs() -| start_ns);
+    }
+
+    fn flatCount(packets: []const []const u8) usize {
         var result: usize = 0;
         for (packets) |packet| {
             result = std.math.add(usize, result, packet.len) catch std.math.maxInt(usize);
         }
         return result;
     }
-
-    fn asConstPackets(packets: []const []u8) []const []const u8 {
-        // Slice mutability is not part of the packet identity. The returned
-        // view borrows the exact same rows and is used only for synchronous
-        // processing/copying by PacketProcessor and Looper.
-        return @ptrCast(packets);
-    }
 };
 
 /// A data-link view bound to the currently selected three-bit key.
@@ -502,6 +894,10 @@ pub const DataLinkPair = struct {
         return self.link.send(packets, key orelse self.key, timeout_ms);
     }
 
+    pub fn sendPing(self: DataLinkPair, key: ?u8) !void {
+        return self.link.sendPing(key orelse self.key);
+    }
+
     pub fn receive(
         self: DataLinkPair,
         packets: []const []const u8,
@@ -524,6 +920,34 @@ pub const testing = struct {
         );
     }
 
+    pub fn createMockDataPathWithSenders(
+        allocator: std.mem.Allocator,
+        peer_id: u32,
+        senders: usize,
+    ) !*DataPath {
+        const mode = c.openvpn_dp_mode_ad_create_mock(c.OpenVPNCompressionFramingDisabled);
+        const data_path = blk: {
+            errdefer c.openvpn_dp_mode_free(mode);
+            break :blk try DataPath.createWithMode(allocator, mode, peer_id, null);
+        };
+        errdefer data_path.destroy();
+        try data_path.senders.ensureTotalCapacityPrecise(allocator, senders);
+        for (0..senders) |_| {
+            data_path.addSender(c.openvpn_crypto_mock_create(), c.openvpn_crypto_mock_free);
+        }
+        return data_path;
+    }
+
+    pub fn createMockDataPathWithObfuscation(
+        allocator: std.mem.Allocator,
+        peer_id: u32,
+        obfuscation: ?api.OpenVPNObfuscationMethod,
+    ) !*DataPath {
+        const mode = c.openvpn_dp_mode_ad_create_mock(c.OpenVPNCompressionFramingDisabled);
+        errdefer c.openvpn_dp_mode_free(mode);
+        return DataPath.createWithMode(allocator, mode, peer_id, obfuscation);
+    }
+
     pub fn createMockDataPathWithFraming(
         allocator: std.mem.Allocator,
         peer_id: u32,
@@ -535,6 +959,6 @@ pub const testing = struct {
             c.openvpn_dp_mode_hmac_create_mock(native_framing)
         else
             c.openvpn_dp_mode_ad_create_mock(native_framing);
-        return DataPath.createWithMode(allocator, mode, peer_id);
+        return DataPath.createWithMode(allocator, mode, peer_id, null);
     }
 };
@@ -16,6 +16,9 @@ pub const PacketDirection = enum {
     inbound,
 };
 
+/// Length prefix of TCP frames, matches `OpenVPNPktProcStreamHeaderLength`.
+const stream_header_length = @sizeOf(u16);
+
 pub const PacketProcessor = struct {
     ptr: *c.openvpn_pkt_proc,
 
@@ -66,6 +69,18 @@ pub const PacketProcessor = struct {
         return destination;
     }
 
+    /// Processes `packet` without copying it to a separate destination.
+    pub fn processPacketInPlace(
+        self: *const PacketProcessor,
+        packet: []u8,
+        direction: PacketDirection,
+    ) void {
+        switch (direction) {
+            .inbound => c.openvpn_pkt_proc_recv(self.ptr, packet.ptr, packet.ptr, packet.len),
+            .outbound => c.openvpn_pkt_proc_send(self.ptr, packet.ptr, packet.ptr, packet.len),
+        }
+    }
+
     pub fn processPackets(
         self: *const PacketProcessor,
         allocator: std.mem.Allocator,
@@ -118,27 +133,135 @@ pub const PacketProcessor = struct {
         allocator: std.mem.Allocator,
         packets: []const []const u8,
     ) ![]u8 {
-        var payload_length: usize = 0;
+        const stream = try allocator.alloc(u8, try streamLength(packets));
+        self.writeStream(stream, packets);
+        return stream;
+    }
+
+    /// Returns the length of `packets` once framed as a TCP stream.
+    pub fn streamLength(packets: []const []const u8) error{PacketTooLarge}!usize {
+        var length: usize = 0;
         for (packets) |packet| {
             if (packet.len > std.math.maxInt(u16)) return error.PacketTooLarge;
-            payload_length = std.math.add(usize, payload_length, packet.len) catch return error.PacketTooLarge;
+            length = std.math.add(usize, length, stream_header_length + packet.len) catch
+                return error.PacketTooLarge;
         }
-        const capacity = c.openvpn_pkt_proc_stream_send_bufsize(@intCast(packets.len), payload_length);
-        const zeroing = c_common.pp_zd_create(capacity);
-        defer c_common.pp_zd_free(zeroing);
+        return length;
+    }
+
+    /// Frames and processes `packets` straight into `stream`, which must be
+    /// exactly `streamLength(packets)` bytes long.
+    pub fn writeStream(
+        self: *const PacketProcessor,
+        stream: []u8,
+        packets: []const []const u8,
+    ) void {
         var offset: usize = 0;
         for (packets) |packet| {
-            offset = c.openvpn_pkt_proc_stream_send(
-                self.ptr,
-                @ptrCast(zeroing),
-                offset,
-                packet.ptr,
-                packet.len,
-            );
+            std.mem.writeInt(u16, stream[offset..][0..stream_header_length], @intCast(packet.len), .big);
+            offset += stream_header_length;
+            c.openvpn_pkt_proc_send(self.ptr, stream[offset..].ptr, packet.ptr, packet.len);
+            offset += packet.len;
         }
-        if (offset != capacity)
+        if (offset != stream.len)
             @panic("OpenVPN stream serializer wrote a length different from its advertised capacity");
-        return allocator.dupe(u8, zeroing.*.bytes[0..offset]);
+    }
+};
+
+/// Length-prefixes `packets` into `stream` without processing them. `stream`
+/// must be exactly `PacketProcessor.streamLength(packets)` bytes long.
+fn writeFrames(stream: []u8, packets: []const []const u8) void {
+    var offset: usize = 0;
+    for (packets) |packet| {
+        std.mem.writeInt(u16, stream[offset..][0..stream_header_length], @intCast(packet.len), .big);
+        offset += stream_header_length;
+        @memcpy(stream[offset..][0..packet.len], packet);
+        offset += packet.len;
+    }
+    if (offset != stream.len)
+        @panic("OpenVPN stream serializer wrote a length different from its advertised capacity");
+}
+
+/// Reassembles TCP frames (`[length(2 bytes)][packet(length)]`) from
+/// arbitrary stream reads, and yields them as views into its buffer.
+///
+/// Unconsumed bytes live between `start` and `end`. The buffer rewinds for
+/// free whenever it is drained, and the trailing partial frame is only moved
+/// to the front when new input does not fit past `end`. Unlike compacting
+/// after every read, each byte is therefore moved at most once per buffer
+/// length of input.
+pub const StreamReassembler = struct {
+    const initial_capacity = 64 * 1024;
+
+    buffer: []u8 = &.{},
+    start: usize = 0,
+    end: usize = 0,
+
+    pub fn deinit(self: *StreamReassembler, allocator: std.mem.Allocator) void {
+        allocator.free(self.buffer);
+        self.* = .{};
+    }
+
+    /// Appends `chunks` after the unconsumed bytes. Frames previously
+    /// returned by `next` are invalidated.
+    pub fn push(
+        self: *StreamReassembler,
+        allocator: std.mem.Allocator,
+        chunks: []const []const u8,
+    ) error{OutOfMemory}!void {
+        var additional: usize = 0;
+        for (chunks) |chunk| additional = std.math.add(usize, additional, chunk.len) catch return error.OutOfMemory;
+        if (self.start == self.end) {
+            self.start = 0;
+            self.end = 0;
+        }
+        if (additional > self.buffer.len - self.end) {
+            const pending = self.end - self.start;
+            const required = std.math.add(usize, pending, additional) catch return error.OutOfMemory;
+            if (required > self.buffer.len) {
+                const capacity = @max(required, self.buffer.len * 2, initial_capacity);
+                const grown = try allocator.alloc(u8, capacity);
+                @memcpy(grown[0..pending], self.buffer[self.start..self.end]);
+                allocator.free(self.buffer);
+                self.buffer = grown;
+            } else {
+                std.mem.copyForwards(u8, self.buffer[0..pending], self.buffer[self.start..self.end]);
+            }
+            self.start = 0;
+            self.end = pending;
+        }
+        for (chunks) |chunk| {
+            @memcpy(self.buffer[self.end..][0..chunk.len], chunk);
+            self.end += chunk.len;
+        }
+    }
+
+    /// Consumes and returns the payload of the next complete frame.
+    pub fn next(self: *StreamReassembler) ?[]u8 {
+        const available = self.buffer[self.start..self.end];
+        if (available.len < stream_header_length) return null;
+        const length = std.mem.readInt(u16, available[0..stream_header_length], .big);
+        if (available.len - stream_header_length < length) return null;
+        self.start += stream_header_length + length;
+        return available[stream_header_length..][0..length];
+    }
+
+    /// Returns the number of complete frames that `next` would return.
+    pub fn frameCount(self: *const StreamReassembler) usize {
+        var count: usize = 0;
+        var available = self.buffer[self.start..self.end];
+        while (available.len >= stream_header_length) {
+            const length = std.mem.readInt(u16, available[0..stream_header_length], .big);
+            if (available.len - stream_header_length < length) break;
+            available = available[stream_header_length + length ..];
+            count += 1;
+        }
+        return count;
+    }
+
+    /// Returns the number of buffered bytes not yet returned as frames.
+    pub fn pendingLength(self: *const StreamReassembler) usize {
+        return self.end - self.start;
     }
 };
 
@@ -150,12 +273,14 @@ pub const PacketProcessor = struct {
 ///
 /// Unlike the Swift closure pair, the Zig API returns explicit ownership so
 /// callers can retain output through a synchronous `Looper.write()` call.
+/// Inbound TCP packets are the exception, they are processed in place and
+/// borrowed from the stream reassembler until the next `processInbound`.
 pub const LinkProcessor = struct {
     const Self = @This();
     const BeforeRead = *const fn (
         self: *Self,
         packets: []const []const u8,
-    ) error{OutOfMemory}![][]u8;
+    ) error{OutOfMemory}!Output;
     const BeforeWrite = *const fn (
         self: *const Self,
         packets: []const []const u8,
@@ -163,20 +288,23 @@ pub const LinkProcessor = struct {
 
     allocator: std.mem.Allocator,
     processor: PacketProcessor,
-    read_buffer: std.ArrayList(u8),
+    reassembler: StreamReassembler,
+    is_tcp: bool,
     before_read: BeforeRead,
     before_write: BeforeWrite,
 
     pub const Output = struct {
         allocator: std.mem.Allocator,
-        owned_packets: [][]u8,
+        owned_packets: [][]u8 = &.{},
+        borrowed_packets: ?[][]const u8 = null,
 
         pub fn packets(self: Output) []const []const u8 {
-            return @ptrCast(self.owned_packets);
+            return self.borrowed_packets orelse @ptrCast(self.owned_packets);
         }
 
         pub fn deinit(self: *Output) void {
             core_mod.util.freeSliceOfStrings(self.allocator, self.owned_packets);
+            if (self.borrowed_packets) |borrowed| self.allocator.free(borrowed);
         }
     };
 
@@ -192,7 +320,8 @@ pub const LinkProcessor = struct {
         self.* = .{
             .allocator = allocator,
             .processor = processor,
-            .read_buffer = .empty,
+            .reassembler = .{},
+            .is_tcp = is_tcp,
             .before_read = if (is_tcp) processTCPInbound else processUDPInbound,
             .before_write = if (is_tcp) processTCPOutbound else processUDPOutbound,
         };
@@ -200,7 +329,7 @@ pub const LinkProcessor = struct {
     }
 
     pub fn destroy(self: *LinkProcessor) void {
-        self.read_buffer.deinit(self.allocator);
+        self.reassembler.deinit(self.allocator);
         self.processor.deinit();
         const allocator = self.allocator;
         allocator.destroy(self);
@@ -209,32 +338,72 @@ pub const LinkProcessor = struct {
     pub fn processInbound(
         self: *LinkProcessor,
         packets: []const []const u8,
+    ) !Output {
+        return self.before_read(self, packets);
+    }
+
+    pub fn processOutbound(
+        self: *const LinkProcessor,
+        packets: []const []const u8,
     ) !Output {
         return .{
             .allocator = self.allocator,
-            .owned_packets = try self.before_read(self, packets),
+            .owned_packets = try self.before_write(self, packets),
         };
     }
 
-    pub fn processOutbound(
+    /// Frames `packets` that were already obfuscated upstream, e.g. by the
+    /// data path stage. UDP packets are borrowed as they are, TCP packets
+    /// are length-prefixed into a single owned stream.
+    pub fn frameOutbound(
         self: *const LinkProcessor,
         packets: []const []const u8,
     ) !Output {
+        if (!self.is_tcp) {
+            return .{
+                .allocator = self.allocator,
+                .borrowed_packets = try self.allocator.dupe([]const u8, packets),
+            };
+        }
+        if (packets.len == 0) return .{ .allocator = self.allocator };
+        const stream = try self.allocator.alloc(u8, try PacketProcessor.streamLength(packets));
+        errdefer self.allocator.free(stream);
+        writeFrames(stream, packets);
+        const result = try self.allocator.alloc([]u8, 1);
+        result[0] = stream;
         return .{
             .allocator = self.allocator,
-            .owned_packets = try self.before_write(self, packets),
+            .owned_packets = result,
         };
     }
 
+    /// Same as `frameOutbound` for a single packet, framed into `buffer`
+    /// rather than allocated. UDP packets are returned as they are.
+    pub fn frameOutboundInto(
+        self: *const LinkProcessor,
+        buffer: []u8,
+        packet: []const u8,
+    ) error{PacketTooLarge}![]const u8 {
+        if (!self.is_tcp) return packet;
+        const packets = [_][]const u8{packet};
+        const length = try PacketProcessor.streamLength(&packets);
+        if (length > buffer.len) return error.PacketTooLarge;
+        writeFrames(buffer[0..length], &packets);
+        return buffer[0..length];
+    }
+
     fn processUDPInbound(
         self: *LinkProcessor,
         packets: []const []const u8,
-    ) error{OutOfMemory}![][]u8 {
-        return self.processor.processPackets(
-            self.allocator,
-            packets,
-            PacketDirection.inbound,
-        );
+    ) error{OutOfMemory}!Output {
+        return .{
+            .allocator = self.allocator,
+            .owned_packets = try self.processor.processPackets(
+                self.allocator,
+                packets,
+                PacketDirection.inbound,
+            ),
+        };
     }
 
     fn processUDPOutbound(
@@ -263,25 +432,18 @@ pub const LinkProcessor = struct {
     fn processTCPInbound(
         self: *LinkProcessor,
         packets: []const []const u8,
-    ) ![][]u8 {
-        var additional: usize = 0;
-        for (packets) |packet| additional = std.math.add(usize, additional, packet.len) catch return error.OutOfMemory;
-        try self.read_buffer.ensureUnusedCapacity(self.allocator, additional);
-        for (packets) |packet| self.read_buffer.appendSliceAssumeCapacity(packet);
-
-        var consumed: usize = 0;
-        const result = try self.processor.packetsFromStream(
-            self.allocator,
-            self.read_buffer.items,
-            &consumed,
-        );
-        if (consumed > self.read_buffer.items.len)
-            @panic("OpenVPN stream parser consumed beyond its input buffer");
-        if (consumed > 0) {
-            const remaining = self.read_buffer.items[consumed..];
-            std.mem.copyForwards(u8, self.read_buffer.items[0..remaining.len], remaining);
-            self.read_buffer.shrinkRetainingCapacity(remaining.len);
+    ) error{OutOfMemory}!Output {
+        try self.reassembler.push(self.allocator, packets);
+        // Reserved before taking any frame, that would be lost on failure
+        const borrowed = try self.allocator.alloc([]const u8, self.reassembler.frameCount());
+        for (borrowed) |*slot| {
+            const packet = self.reassembler.next().?;
+            self.processor.processPacketInPlace(packet, PacketDirection.inbound);
+            slot.* = packet;
         }
-        return result;
+        return .{
+            .allocator = self.allocator,
+            .borrowed_packets = borrowed,
+        };
     }
 };
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+//! Compact route sets to compare the settings of consecutive sessions.
+//!
+//! Servers may push thousands of routes, and push them again on every
+//! reconnection, usually unchanged. A `RouteSet` packs each route into a
+//! fixed-size key, sorted and deduplicated, so that two sets compare with a
+//! single merge pass over plain bytes.
+
+const std = @import("std");
+const core_mod = @import("../../core/exports.zig");
+
+const api = core_mod.api;
+const prefix_trie = core_mod.prefix_trie;
+const Prefix = prefix_trie.Prefix;
+
+pub const Route = extern struct {
+    family: Family,
+    kind: Kind,
+    /// Unset for a route without destination, which is not the default
+    /// route even though both pack to a zero prefix.
+    has_destination: bool,
+    /// The network address, with host bits cleared.
+    destination: [16]u8,
+    prefix_length: u8,
+    has_gateway: bool,
+    gateway: [16]u8,
+
+    pub const Family = enum(u8) {
+        v4,
+        v6,
+    };
+
+    pub const Kind = enum(u8) {
+        included,
+        excluded,
+    };
+
+    /// Returns null when an address is not in `family`.
+    pub fn init(family: Family, kind: Kind, route: api.Route) ?Route {
+        const trie_family = trieFamily(family);
+        var result: Route = .{
+            .family = family,
+            .kind = kind,
+            .has_destination = false,
+            .destination = @splat(0),
+            .prefix_length = 0,
+            .has_gateway = false,
+            .gateway = @splat(0),
+        };
+        if (route.destination) |destination| {
+            const prefix = Prefix.parse(
+                trie_family,
+                destination.address.raw,
+                destination.prefix_length,
+            ) orelse return null;
+            result.has_destination = true;
+            result.destination = prefix.bytes;
+            result.prefix_length = prefix.len;
+        }
+        if (route.gateway) |gateway| {
+            const prefix = Prefix.parse(trie_family, gateway.raw, trie_family.bitCount()) orelse return null;
+            result.gateway = prefix.bytes;
+            result.has_gateway = true;
+        }
+        return result;
+    }
+
+    fn order(lhs: Route, rhs: Route) std.math.Order {
+        return std.mem.order(u8, std.mem.asBytes(&lhs), std.mem.asBytes(&rhs));
+    }
+
+    fn lessThan(_: void, lhs: Route, rhs: Route) bool {
+        return order(lhs, rhs) == .lt;
+    }
+
+    fn trieFamily(family: Family) prefix_trie.Family {
+        return switch (family) {
+            .v4 => .v4,
+            .v6 => .v6,
+        };
+    }
+};
+
+pub const RouteSet = struct {
+    /// Sorted and unique.
+    routes: []const Route = &.{},
+
+    pub const Diff = struct {
+        added: usize = 0,
+        removed: usize = 0,
+        unchanged: usize = 0,
+
+        pub fn isEmpty(self: Diff) bool {
+            return self.added == 0 and self.removed == 0;
+        }
+    };
+
+    /// Collects the routes of the IP settings. Returns null when any route
+    /// can't be packed, e.g. for a hostname gateway.
+    pub fn init(
+        allocator: std.mem.Allocator,
+        ipv4: ?*const api.IPSettings,
+        ipv6: ?*const api.IPSettings,
+    ) std.mem.Allocator.Error!?RouteSet {
+        var routes: std.ArrayList(Route) = .empty;
+        errdefer routes.deinit(allocator);
+        if (ipv4) |settings| {
+            if (!try appendSettings(allocator, &routes, .v4, settings)) {
+                routes.deinit(allocator);
+                return null;
+            }
+        }
+        if (ipv6) |settings| {
+            if (!try appendSettings(allocator, &routes, .v6, settings)) {
+                routes.deinit(allocator);
+                return null;
+            }
+        }
+
+        std.mem.sort(Route, routes.items, {}, Route.lessThan);
+        var unique: usize = 0;
+        for (routes.items) |route| {
+            if (unique > 0 and Route.order(routes.items[unique - 1], route) == .eq) continue;
+            routes.items[unique] = route;
+            unique += 1;
+        }
+        routes.shrinkRetainingCapacity(unique);
+        return .{ .routes = try routes.toOwnedSlice(allocator) };
+    }
+
+    pub fn deinit(self: *RouteSet, allocator: std.mem.Allocator) void {
+        allocator.free(self.routes);
+        self.routes = &.{};
+    }
+
+    pub fn contains(self: RouteSet, route: Route) bool {
+        var low: usize = 0;
+        var high: usize = self.routes.len;
+        while (low < high) {
+            const mid = low + (high - low) / 2;
+            switch (Route.order(self.routes[mid], route)) {
+                .eq => return true,
+                .lt => low = mid + 1,
+                .gt => high = mid,
+            }
+        }
+        return false;
+    }
+
+    pub fn eql(self: RouteSet, other: RouteSet) bool {
+        return std.mem.eql(u8, std.mem.sliceAsBytes(self.routes), std.mem.sliceAsBytes(other.routes));
+    }
+
+    /// Counts the routes that `next` adds, removes and keeps.
+    pub fn diff(self: RouteSet, next: RouteSet) Diff {
+        var result: Diff = .{};
+        var old_index: usize = 0;
+        var new_index: usize = 0;
+        while (old_index < self.routes.len and new_index < next.routes.len) {
+            switch (Route.order(self.routes[old_index], next.routes[new_index])) {
+                .eq => {
+                    result.unchanged += 1;
+                    old_index += 1;
+                    new_index += 1;
+                },
+                .lt => {
+                    result.removed += 1;
+                    old_index += 1;
+                },
+                .gt => {
+                    result.added += 1;
+                    new_index += 1;
+                },
+            }
+        }
+        result.removed += self.routes.len - old_index;
+        result.added += next.routes.len - new_index;
+        return result;
+    }
+
+    fn appendSettings(
+        allocator: std.mem.Allocator,
+        routes: *std.ArrayList(Route),
+        family: Route.Family,
+        settings: *const api.IPSettings,
+    ) std.mem.Allocator.Error!bool {
+        try routes.ensureUnusedCapacity(allocator, settings.included_routes.len + settings.excluded_routes.len);
+        for (settings.included_routes) |route| {
+            routes.appendAssumeCapacity(Route.init(family, .included, route) orelse return false);
+        }
+        for (settings.excluded_routes) |route| {
+            routes.appendAssumeCapacity(Route.init(family, .excluded, route) orelse return false);
+        }
+        return true;
+    }
+};
@@ -42,6 +42,7 @@ const RenegotiationType = session_negotiator_mod.RenegotiationType;
 const Serializer = control_serializers_mod.Serializer;
 const SessionState = session_context_mod.SessionState;
 const SessionError = errors_mod.SessionError;
+const HandshakeStats = tls_mod.HandshakeStats;
 const TLSWrapper = tls_mod.TLSWrapper;
 
 /// Immutable event sink for facts produced by the protocol engine.
@@ -68,16 +69,21 @@ pub const SessionEvents = struct {
 /// looper attachment or timer is cancelled. Its `Looper` is borrowed for the
 /// same lifetime. Mutable protocol state is confined to `on_queue`; its owner
 /// retains lifecycle policy.
+///
+/// Every object owned by the session allocates through `memory`, which also
+/// counts the C objects allocated while the session runs, and mirrors the
+/// usage into the looper metrics.
 pub const Session = struct {
     pub const Error = errors_mod.SessionError;
 
+    parent_allocator: std.mem.Allocator,
+    memory: core.AccountingAllocator,
     allocator: std.mem.Allocator,
     configuration: api.OpenVPNConfiguration,
     credentials: ?api.OpenVPNCredentials,
     prng: PRNG,
-    caches_directory: []u8,
-    ca_filename: []u8,
     options: SessionOptions,
+    handshakes: HandshakeStats = .{},
 
     looper: *net.Looper,
     events: SessionEvents,
@@ -89,8 +95,6 @@ pub const Session = struct {
         configuration: api.OpenVPNConfiguration,
         credentials: ?api.OpenVPNCredentials,
         prng: PRNG,
-        caches_directory: []const u8,
-        ca_filename: []const u8,
         options: SessionOptions,
     };
 
@@ -100,7 +104,14 @@ pub const Session = struct {
         return createFallible(allocator, init) catch |err| errors_mod.sessionError(err);
     }
 
-    fn createFallible(allocator: std.mem.Allocator, init: Init) !*Session {
+    fn createFallible(parent_allocator: std.mem.Allocator, init: Init) !*Session {
+        const self = try parent_allocator.create(Session);
+        errdefer parent_allocator.destroy(self);
+        self.memory = .init(parent_allocator, init.looper.options.metrics);
+        const allocator = self.memory.allocator();
+        const native = self.memory.enterNative();
+        defer native.leave();
+
         var owned_configuration = try init.configuration.clone(allocator);
         errdefer owned_configuration.deinit(allocator);
         var owned_credentials = if (init.credentials) |value|
@@ -108,12 +119,6 @@ pub const Session = struct {
         else
             null;
         errdefer if (owned_credentials) |*value| value.deinit(allocator);
-        const owned_caches_directory = try allocator.dupe(u8, init.caches_directory);
-        errdefer allocator.free(owned_caches_directory);
-        const owned_ca_filename = try allocator.dupe(u8, init.ca_filename);
-        errdefer allocator.free(owned_ca_filename);
-        const self = try allocator.create(Session);
-        errdefer allocator.destroy(self);
         const serializer = try Serializer.forConfiguration(
             allocator,
             init.options.backend,
@@ -121,12 +126,12 @@ pub const Session = struct {
         );
         const control_channel = try ControlChannel.create(allocator, init.prng, serializer);
         self.* = .{
+            .parent_allocator = parent_allocator,
+            .memory = self.memory,
             .allocator = allocator,
             .configuration = owned_configuration,
             .credentials = owned_credentials,
             .prng = init.prng,
-            .caches_directory = owned_caches_directory,
-            .ca_filename = owned_ca_filename,
             .options = init.options,
             .looper = init.looper,
             .events = init.events,
@@ -150,13 +155,19 @@ pub const Session = struct {
             });
             @panic("Session.destroy() cannot release an attached session");
         };
+        const native = self.memory.enterNative();
         self.on_queue.deinit();
         self.configuration.deinit(self.allocator);
         if (self.credentials) |*credentials| credentials.deinit(self.allocator);
-        self.allocator.free(self.caches_directory);
-        self.allocator.free(self.ca_filename);
-        const allocator = self.allocator;
-        allocator.destroy(self);
+        native.leave();
+
+        const usage = self.memory.usage();
+        log.writef(.debug, "Session memory: {d} bytes at peak, {d} bytes left", .{
+            usage.peak_bytes,
+            usage.bytes,
+        });
+        const parent_allocator = self.parent_allocator;
+        parent_allocator.destroy(self);
     }
 
     pub fn setLink(
@@ -172,6 +183,8 @@ pub const Session = struct {
             log.write(.err, "Link interface already set");
             return;
         }
+        const native = self.memory.enterNative();
+        defer native.leave();
 
         const processor = LinkProcessor.create(
             self.allocator,
@@ -244,6 +257,25 @@ pub const Session = struct {
         descriptor_transferred = true;
     }
 
+    /// Returns the memory owned by the session. Safe from any thread.
+    pub fn memoryUsage(self: *const Session) core.memory.Usage {
+        return self.memory.usage();
+    }
+
+    pub const HandshakeCounts = struct {
+        full: u64,
+        resumed: u64,
+    };
+
+    /// Returns how many TLS handshakes resumed a previous session. Safe from
+    /// any thread.
+    pub fn tlsHandshakes(self: *const Session) HandshakeCounts {
+        return .{
+            .full = self.handshakes.full.load(.monotonic),
+            .resumed = self.handshakes.resumed.load(.monotonic),
+        };
+    }
+
     /// Prepares state on the looper, detaches from this external thread, then
     /// finishes state on the looper.
     pub fn shutdown(
@@ -296,6 +328,8 @@ pub const Session = struct {
     /// session. The owner must call this synchronously from `Looper.OnFinish`
     /// while the Session is alive, and must stop forwarding before `destroy`.
     pub fn looperTerminated(self: *Session, failure: ?net.Looper.Failure) void {
+        const native = self.memory.enterNative();
+        defer native.leave();
         if (failure) |value| switch (value) {
             .user => |cause| log.writef(.err, "Session looper finished with error: {s}", .{
                 @errorName(cause),
@@ -342,6 +376,8 @@ pub const Session = struct {
         packets: net.Looper.Packets,
     ) !net.Looper.ReadAction {
         const self: *Session = @ptrCast(@alignCast(raw.?));
+        const native = self.memory.enterNative();
+        defer native.leave();
         try self.onQueue().receiveLink(packets);
         return .keep;
     }
@@ -351,6 +387,8 @@ pub const Session = struct {
         packets: net.Looper.Packets,
     ) !net.Looper.ReadAction {
         const self: *Session = @ptrCast(@alignCast(raw.?));
+        const native = self.memory.enterNative();
+        defer native.leave();
         try self.onQueue().receiveTunnel(packets);
         return .keep;
     }
@@ -413,6 +451,8 @@ pub const Session = struct {
 
             fn run(raw: ?*anyopaque) anyerror!Result {
                 const request: *@This() = @ptrCast(@alignCast(raw.?));
+                const native = request.session.memory.enterNative();
+                defer native.leave();
                 return callback(request.session.onQueue(), request.arguments);
             }
         };
@@ -733,9 +773,9 @@ const SessionOnQueue = struct {
             @panic("Cannot start negotiation while the session is stopped");
         const tls = try TLSWrapper.create(self.session.allocator, .{
             .backend = self.session.options.backend,
-            .caches_directory = self.session.caches_directory,
-            .ca_filename = self.session.ca_filename,
             .configuration = &self.session.configuration,
+            .remote = &context.remote_endpoint,
+            .handshakes = &self.session.handshakes,
             .verification = .{
                 .context = self.session,
                 .callback = Session.onTLSVerificationFailure,
@@ -848,6 +888,10 @@ const SessionOnQueue = struct {
     ) !void {
         const delay_ms = self.keepAliveIntervalMs(context) orelse
             self.session.options.ping_timeout_check_interval_ms;
+        try self.schedulePingAfter(delay_ms);
+    }
+
+    fn schedulePingAfter(self: *SessionOnQueue, delay_ms: u64) !void {
         log.logTimeMs(.debug, "Schedule ping check after ", delay_ms);
         try self.session.looper.scheduleReplacing(
             &self.ping_timer,
@@ -858,6 +902,8 @@ const SessionOnQueue = struct {
 
     fn onNegotiationTimer(raw: ?*anyopaque) void {
         const self: *SessionOnQueue = @ptrCast(@alignCast(raw.?));
+        const native = self.session.memory.enterNative();
+        defer native.leave();
         self.checkNegotiation() catch |err| {
             self.session.reportFailure(errors_mod.sessionError(err));
         };
@@ -874,6 +920,8 @@ const SessionOnQueue = struct {
 
     fn onPingTimer(raw: ?*anyopaque) void {
         const self: *SessionOnQueue = @ptrCast(@alignCast(raw.?));
+        const native = self.session.memory.enterNative();
+        defer native.leave();
         self.ping() catch |err| {
             self.session.reportFailure(errors_mod.sessionError(err));
         };
@@ -890,10 +938,14 @@ const SessionOnQueue = struct {
         };
         log.write(.debug, "Run ping check");
         try self.checkPingTimeout(context);
-        if (self.keepAliveIntervalMs(context) != null) {
+        if (self.keepAliveIntervalMs(context)) |interval_ms| {
+            // Outbound data keeps the peer alive as well as a ping
+            if (pingDeferralMs(context.last_sent_ns, core.concurrency.monotonicNs(), interval_ms)) |delay_ms| {
+                log.write(.debug, "Skip ping, data sent within interval");
+                return self.schedulePingAfter(delay_ms);
+            }
             log.write(.debug, "Send ping");
-            const ping_packet: []const u8 = &constants_mod.Data.ping_string;
-            try pair.send(&.{ping_packet}, null, null);
+            try pair.sendPing(null);
         }
         try self.scheduleNextPing(context);
     }
@@ -947,6 +999,7 @@ const SessionOnQueue = struct {
 
     fn reportOutboundDataCount(self: *SessionOnQueue, count: usize) void {
         const context = self.state.activeContext() orelse return;
+        context.last_sent_ns = core.concurrency.monotonicNs();
         self.addDataCount(context, &context.data_count.outbound, count);
     }
 
@@ -977,6 +1030,16 @@ const SessionOnQueue = struct {
     }
 };
 
+/// Returns how long to defer a ping due at `now_ns` when data went out at
+/// `last_sent_ns`, or null when the ping must be sent now. The delay rounds
+/// up, so that the deferred check never fires early.
+fn pingDeferralMs(last_sent_ns: ?u64, now_ns: u64, interval_ms: u64) ?u64 {
+    const last_sent = last_sent_ns orelse return null;
+    const due = core.concurrency.deadlineAfterMs(last_sent, interval_ms);
+    if (now_ns >= due) return null;
+    return std.math.divCeil(u64, due - now_ns, std.time.ns_per_ms) catch unreachable;
+}
+
 fn shouldSendExitNotification(cause: ?SessionError) bool {
     // Mirror Swift's `error == nil || error == networkChanged` choice: notify
     // only for an orderly stop or path change; other failures tear down at once.
@@ -985,6 +1048,7 @@ fn shouldSendExitNotification(cause: ?SessionError) bool {
 
 pub const testing = struct {
     pub const shouldSendExitNotification = session_mod.shouldSendExitNotification;
+    pub const pingDeferralMs = session_mod.pingDeferralMs;
 
     pub fn reportFailure(session: *Session, cause: SessionError) void {
         session.reportFailure(cause);
@@ -56,6 +56,8 @@ pub const ActiveContext = struct {
     current_data_pair: ?DataLinkPair,
     push_reply: ?PushReply,
     last_received_ns: ?u64,
+    /// Any outbound data, pings included, defers the next ping.
+    last_sent_ns: ?u64,
     last_data_count_ns: ?u64,
     data_count: BidirectionalState(u64),
 
@@ -84,6 +86,7 @@ pub const ActiveContext = struct {
             .current_data_pair = null,
             .push_reply = null,
             .last_received_ns = null,
+            .last_sent_ns = null,
             .last_data_count_ns = null,
             .data_count = .init(0),
         };
@@ -175,6 +178,7 @@ pub const ActiveContext = struct {
         self.current_negotiator_key = null;
         self.current_data_pair = null;
         self.last_received_ns = null;
+        self.last_sent_ns = null;
         self.last_data_count_ns = null;
         self.data_count.reset();
     }
@@ -81,8 +81,13 @@ pub const NegotiatorOptions = struct {
 };
 
 /// V3 control-channel state machine. All mutable methods run on `looper`.
+///
+/// Control messages and the parsed push reply only live until the
+/// negotiation completes, so they are allocated in `scratch` and released
+/// at once after `on_connected`.
 pub const Negotiator = struct {
     allocator: std.mem.Allocator,
+    scratch: std.heap.ArenaAllocator,
     key: u8,
     history: ?PushReply,
     renegotiation: ?RenegotiationType,
@@ -128,6 +133,7 @@ pub const Negotiator = struct {
         const self = try allocator.create(Negotiator);
         self.* = .{
             .allocator = allocator,
+            .scratch = .init(allocator),
             .key = init.key,
             .history = init.history,
             .renegotiation = init.renegotiation,
@@ -155,6 +161,7 @@ pub const Negotiator = struct {
         if (self.history) |*history| history.deinit(self.allocator);
         if (self.continued_push_reply_message) |message| self.allocator.free(message);
         if (self.tls) |tls| tls.destroy();
+        self.scratch.deinit();
         const allocator = self.allocator;
         allocator.destroy(self);
     }
@@ -449,7 +456,10 @@ pub const Negotiator = struct {
                 _ = try self.sendAvailableCipherText(tls);
 
                 if (self.state.before(.auth) and tls.isConnected()) {
-                    log.write(.info, "TLS.connect: Handshake is complete");
+                    log.write(.info, if (tls.recordHandshake())
+                        "TLS.connect: Handshake is complete (resumed)"
+                    else
+                        "TLS.connect: Handshake is complete");
                     self.setState(.auth);
                     try self.onTLSConnect();
                 }
@@ -490,6 +500,10 @@ pub const Negotiator = struct {
     }
 
     fn handleControlData(self: *Negotiator, data: []const u8) !void {
+        // After didNegotiate, nothing refers to the scratch allocations
+        defer if (self.state == .connected) {
+            _ = self.scratch.reset(.free_all);
+        };
         const authenticator = if (self.authenticator) |*value| value else return;
         log.write(.info, "Pulled plain control data");
         authenticator.appendControlData(data);
@@ -510,8 +524,7 @@ pub const Negotiator = struct {
             );
         }
 
-        const messages = try authenticator.parseMessages(self.allocator);
-        defer core_mod.util.freeSliceOfStrings(self.allocator, messages);
+        const messages = try authenticator.parseMessages(self.scratch.allocator());
         for (messages) |message| {
             log.write(.info, "Parsed control message");
             self.handleControlMessage(message) catch |err| {
@@ -548,7 +561,7 @@ pub const Negotiator = struct {
             try self.allocator.dupe(u8, message);
         defer self.allocator.free(complete_message);
 
-        var reply = PushReply.parse(self.allocator, complete_message) catch |err| {
+        const reply = PushReply.parse(self.scratch.allocator(), complete_message) catch |err| {
             if (err != error.ContinuationPushReply) return err;
             const stripped = try std.mem.replaceOwned(
                 u8,
@@ -561,7 +574,6 @@ pub const Negotiator = struct {
             self.continued_push_reply_message = stripped;
             return;
         } orelse return;
-        defer reply.deinit(self.allocator);
         if (self.continued_push_reply_message) |old| self.allocator.free(old);
         self.continued_push_reply_message = null;
 
@@ -570,17 +582,10 @@ pub const Negotiator = struct {
         if (reply.options.compression_framing) |framing| {
             const algorithm = reply.options.compression_algorithm orelse .disabled;
             if (algorithm != .disabled) {
-                if (algorithm == .LZO) {
-                    log.writef(.fault, "Server has LZO compression enabled and this was not built into the library (framing={s}): CompressionMismatch", .{
-                        @tagName(framing),
-                    });
-                } else {
-                    log.writef(.fault, "Server has compression enabled ({s}) and this is not supported (framing={s}): CompressionMismatch", .{
-                        @tagName(algorithm),
-                        @tagName(framing),
-                    });
-                }
-                return error.CompressionMismatch;
+                log.writef(.notice, "Server has compression enabled ({s}, framing={s}); inbound packets will be decompressed, outbound packets are never compressed", .{
+                    @tagName(algorithm),
+                    @tagName(framing),
+                });
             }
         }
         if (reply.options.ipv4 == null and reply.options.ipv6 == null)
@@ -642,6 +647,8 @@ pub const Negotiator = struct {
             .compression_framing = push_reply.options.compression_framing orelse
                 configuration_mod.fallbackCompressionFraming(self.options.configuration),
             .peer_id = push_reply.options.peer_id,
+            .obfuscation = self.options.configuration.xor_method,
+            .metrics = self.looper.options.metrics,
         };
         var prf = try PRF.init(
             self.allocator,
@@ -703,4 +710,18 @@ pub const Negotiator = struct {
 
 pub const testing = struct {
     pub const requestsWrappedKeyResend = Negotiator.requestsWrappedKeyResend;
+    pub const handleControlData = Negotiator.handleControlData;
+
+    /// Skips the TLS handshake, as if the auth had just been put.
+    pub fn startAuthentication(negotiator: *Negotiator) !void {
+        if (negotiator.authenticator) |*old| old.deinit();
+        negotiator.authenticator = null;
+        negotiator.authenticator = try Authenticator.init(
+            negotiator.allocator,
+            negotiator.prng,
+            null,
+            null,
+        );
+        negotiator.setState(.auth);
+    }
 };
@@ -6,15 +6,24 @@ const std = @import("std");
 const core_mod = @import("../../core/exports.zig");
 const configuration_mod = @import("configuration.zig");
 const logging_mod = @import("logging.zig");
+const routes_mod = @import("routes.zig");
 
 const api = core_mod.api;
 const log = core_mod.logging;
 const openvpn_log = logging_mod;
+const Prefix = core_mod.prefix_trie.Prefix;
+const PrefixTrie = core_mod.PrefixTrie;
+const RouteSet = routes_mod.RouteSet;
 
 /// Merges local and pushed OpenVPN settings into owned core modules.
 pub const NetworkSettingsBuilder = struct {
     local_options: *const api.OpenVPNConfiguration,
     remote_options: *const api.OpenVPNConfiguration,
+    /// Merges sibling routes and drops routes covered by an equal route,
+    /// rather than exact duplicates only. Either may change which interface
+    /// wins against a system route more specific than the merged or
+    /// covering one, hence opt-in.
+    aggregates_routes: bool = false,
 
     pub fn init(
         local_options: *const api.OpenVPNConfiguration,
@@ -83,7 +92,7 @@ pub const NetworkSettingsBuilder = struct {
                 self.remote_options.routes4,
                 self.remote_options.route_gateway4,
                 self.isGateway(.IPv4),
-                "IPv4",
+                .v4,
             )
         else
             null;
@@ -97,7 +106,7 @@ pub const NetworkSettingsBuilder = struct {
                 self.remote_options.routes6,
                 self.remote_options.route_gateway6,
                 self.isGateway(.IPv6),
-                "IPv6",
+                .v6,
             )
         else
             null;
@@ -128,7 +137,7 @@ pub const NetworkSettingsBuilder = struct {
         remote_routes: ?[]const api.Route,
         default_gateway: ?api.Address,
         add_default: bool,
-        comptime family: []const u8,
+        comptime family: core_mod.prefix_trie.Family,
     ) !api.IPSettings {
         var collected: std.ArrayList(api.Route) = .empty;
         defer collected.deinit(allocator);
@@ -141,36 +150,39 @@ pub const NetworkSettingsBuilder = struct {
 
         var effective: std.ArrayList(api.Route) = .empty;
         defer effective.deinit(allocator);
+        try effective.ensureTotalCapacity(allocator, collected.items.len);
         for (collected.items) |route| {
-            const resolved = api.Route{
+            effective.appendAssumeCapacity(.{
                 .destination = route.destination,
                 .gateway = route.gateway orelse default_gateway,
+            });
+        }
+
+        var arena = std.heap.ArenaAllocator.init(allocator);
+        defer arena.deinit();
+        const routes = if (self.aggregates_routes)
+            try aggregateRoutes(
+                arena.allocator(),
+                family,
+                effective.items,
+                server.excluded_routes,
+            )
+        else
+            try dedupeRoutes(arena.allocator(), family, effective.items);
+        if (routes.len < effective.items.len) {
+            const label = switch (family) {
+                .v4 => "IPv4",
+                .v6 => "IPv6",
             };
-            if (resolved.destination) |destination| {
-                if (resolved.gateway) |gateway| {
-                    log.writef(.info, "\t" ++ family ++ ": Add route {s} -> {s}", .{
-                        destination,
-                        gateway,
-                    });
-                } else {
-                    log.writef(.info, "\t" ++ family ++ ": Add route {s} -> *", .{
-                        destination,
-                    });
-                }
-            } else {
-                if (resolved.gateway) |gateway| {
-                    log.writef(.info, "\t" ++ family ++ ": Set default gateway -> {s}", .{
-                        gateway,
-                    });
-                } else {
-                    log.write(.info, "\t" ++ family ++ ": Set default gateway -> *");
-                }
-            }
-            try effective.append(allocator, resolved);
+            log.writef(.info, "\t" ++ label ++ ": {s} {d} routes into {d}", .{
+                if (self.aggregates_routes) "Aggregate" else "Deduplicate",
+                effective.items.len,
+                routes.len,
+            });
         }
         return (api.IPSettings{
             .subnets = server.subnets,
-            .included_routes = effective.items,
+            .included_routes = routes,
             .excluded_routes = server.excluded_routes,
         }).clone(allocator);
     }
@@ -303,6 +315,270 @@ pub const NetworkSettingsBuilder = struct {
     }
 };
 
+/// Drops the included routes equal to a previous one in destination and
+/// gateway, and keeps the others in order. Routes without a destination
+/// follow the others unchanged. Returns routes borrowing from `included`
+/// and from `arena`.
+fn dedupeRoutes(
+    arena: std.mem.Allocator,
+    family: core_mod.prefix_trie.Family,
+    included: []const api.Route,
+) std.mem.Allocator.Error![]const api.Route {
+    var seen: std.StringHashMapUnmanaged(void) = .empty;
+    var result: std.ArrayList(api.Route) = .empty;
+    try result.ensureTotalCapacity(arena, included.len);
+    var unindexed: std.ArrayList(api.Route) = .empty;
+    for (included) |route| {
+        const prefix = routePrefix(family, route) orelse {
+            try unindexed.append(arena, route);
+            continue;
+        };
+        // Normalized destination, then the gateway
+        const gateway = if (route.gateway) |address| address.raw else "";
+        const key = try std.mem.concat(arena, u8, &.{
+            &prefix.bytes,
+            &.{ prefix.len, @intFromBool(route.gateway != null) },
+            gateway,
+        });
+        const entry = try seen.getOrPut(arena, key);
+        if (entry.found_existing) continue;
+        result.appendAssumeCapacity(route);
+    }
+    try result.appendSlice(arena, unindexed.items);
+    return result.items;
+}
+
+/// Deduplicates and aggregates the included routes through a prefix trie,
+/// so that the platform installs fewer routes with the same effect. Routes
+/// that overlap an excluded route are kept as they are, and routes without
+/// a destination follow the others unchanged. Returns routes borrowing from
+/// `included` and from `arena`.
+fn aggregateRoutes(
+    arena: std.mem.Allocator,
+    family: core_mod.prefix_trie.Family,
+    included: []const api.Route,
+    excluded: []const api.Route,
+) std.mem.Allocator.Error![]const api.Route {
+    var exclusions = PrefixTrie(void).init(family);
+    for (excluded) |route| {
+        const prefix = routePrefix(family, route) orelse continue;
+        _ = try exclusions.insert(arena, prefix, {});
+    }
+
+    const Trie = PrefixTrie(RouteSource);
+    var trie = Trie.init(family);
+    var unindexed: std.ArrayList(api.Route) = .empty;
+    for (included, 0..) |route, index| {
+        if (routePrefix(family, route)) |prefix| {
+            _ = try trie.insert(arena, prefix, .{ .index = index });
+        } else {
+            try unindexed.append(arena, route);
+        }
+    }
+    trie.aggregate(AggregationContext{
+        .routes = included,
+        .exclusions = &exclusions,
+    });
+
+    var entries: std.ArrayList(Trie.Entry) = .empty;
+    try trie.collect(arena, &entries);
+    const result = try arena.alloc(api.Route, entries.items.len + unindexed.items.len);
+    for (entries.items, result[0..entries.items.len]) |entry, *route| {
+        const source = included[entry.value.index];
+        if (entry.prefix.len == source.destination.?.prefix_length) {
+            route.* = source;
+            continue;
+        }
+        // Merged halves
+        route.* = .{
+            .destination = .{
+                .address = .{
+                    .raw = try prefixAddressAlloc(arena, family, entry.prefix),
+                    .family = switch (family) {
+                        .v4 => .v4,
+                        .v6 => .v6,
+                    },
+                },
+                .prefix_length = entry.prefix.len,
+            },
+            .gateway = source.gateway,
+        };
+    }
+    @memcpy(result[entries.items.len..], unindexed.items);
+    return result;
+}
+
+const RouteSource = struct {
+    index: usize,
+};
+
+const AggregationContext = struct {
+    routes: []const api.Route,
+    exclusions: *const PrefixTrie(void),
+
+    pub fn eql(self: AggregationContext, lhs: RouteSource, rhs: RouteSource) bool {
+        const lhs_gateway = self.routes[lhs.index].gateway orelse
+            return self.routes[rhs.index].gateway == null;
+        const rhs_gateway = self.routes[rhs.index].gateway orelse return false;
+        return std.mem.eql(u8, lhs_gateway.raw, rhs_gateway.raw);
+    }
+
+    pub fn isPinned(self: AggregationContext, prefix: Prefix) bool {
+        return self.exclusions.overlaps(prefix);
+    }
+};
+
+fn routePrefix(family: core_mod.prefix_trie.Family, route: api.Route) ?Prefix {
+    const destination = route.destination orelse return null;
+    return Prefix.parse(family, destination.address.raw, destination.prefix_length);
+}
+
+fn prefixAddressAlloc(
+    allocator: std.mem.Allocator,
+    family: core_mod.prefix_trie.Family,
+    prefix: Prefix,
+) std.mem.Allocator.Error![]u8 {
+    return switch (family) {
+        .v4 => std.fmt.allocPrint(allocator, "{d}.{d}.{d}.{d}", .{
+            prefix.bytes[0],
+            prefix.bytes[1],
+            prefix.bytes[2],
+            prefix.bytes[3],
+        }),
+        .v6 => std.fmt.allocPrint(allocator, "{f}", .{std.Io.net.Ip6Address.Unresolved{
+            .bytes = prefix.bytes,
+            .interface_name = null,
+        }}),
+    };
+}
+
+/// Summarizes the settings built for a session, so that the next session
+/// logs only what it changes.
+pub const SettingsSummary = struct {
+    /// Null when a route can't be packed.
+    routes: ?RouteSet,
+    /// Digest of the modules without ids and routes.
+    digest: u64,
+
+    pub fn init(
+        allocator: std.mem.Allocator,
+        modules: []const api.TaggedModule,
+    ) std.mem.Allocator.Error!SettingsSummary {
+        var hasher = std.hash.Wyhash.init(0);
+        var routes: ?RouteSet = .{};
+        errdefer if (routes) |*value| value.deinit(allocator);
+        for (modules) |module| {
+            var stripped = module;
+            switch (stripped) {
+                .IP => |*ip| {
+                    if (routes) |*value| value.deinit(allocator);
+                    routes = null;
+                    routes = try RouteSet.init(
+                        allocator,
+                        if (ip.ipv4) |*settings| settings else null,
+                        if (ip.ipv6) |*settings| settings else null,
+                    );
+                    if (ip.ipv4) |*settings| stripRoutes(settings);
+                    if (ip.ipv6) |*settings| stripRoutes(settings);
+                },
+                else => {},
+            }
+            switch (stripped) {
+                inline else => |*value| value.id = @splat('0'),
+            }
+            const encoded = try core_mod.util.encodeJsonValue(allocator, &stripped);
+            defer allocator.free(encoded);
+            hasher.update(encoded);
+        }
+        return .{
+            .routes = routes,
+            .digest = hasher.final(),
+        };
+    }
+
+    pub fn deinit(self: *SettingsSummary, allocator: std.mem.Allocator) void {
+        if (self.routes) |*routes| routes.deinit(allocator);
+    }
+
+    fn stripRoutes(settings: *api.IPSettings) void {
+        settings.included_routes = &.{};
+        settings.excluded_routes = &.{};
+    }
+};
+
+/// Logs the included routes of `modules`, or only the routes added since
+/// `previous` when the previous session pushed comparable settings.
+pub fn logSettingsChanges(
+    previous: ?*const SettingsSummary,
+    current: ?*const SettingsSummary,
+    modules: []const api.TaggedModule,
+) void {
+    const previous_routes = blk: {
+        const summary = previous orelse break :blk null;
+        const next = current orelse break :blk null;
+        log.write(.info, if (summary.digest == next.digest)
+            "\tSettings other than routes unchanged since last session"
+        else
+            "\tSettings other than routes changed since last session");
+        const old_routes = summary.routes orelse break :blk null;
+        const new_routes = next.routes orelse break :blk null;
+        const diff = old_routes.diff(new_routes);
+        if (diff.isEmpty()) {
+            log.writef(.info, "\tRoutes unchanged since last session ({d})", .{diff.unchanged});
+            return;
+        }
+        log.writef(.info, "\tRoutes changed since last session: {d} added, {d} removed, {d} unchanged", .{
+            diff.added,
+            diff.removed,
+            diff.unchanged,
+        });
+        break :blk old_routes;
+    };
+    for (modules) |module| {
+        const ip = switch (module) {
+            .IP => |value| value,
+            else => continue,
+        };
+        if (ip.ipv4) |settings| logAddedRoutes(previous_routes, .v4, "IPv4", settings.included_routes);
+        if (ip.ipv6) |settings| logAddedRoutes(previous_routes, .v6, "IPv6", settings.included_routes);
+    }
+}
+
+fn logAddedRoutes(
+    previous: ?RouteSet,
+    family: routes_mod.Route.Family,
+    comptime label: []const u8,
+    routes: []const api.Route,
+) void {
+    for (routes) |route| {
+        if (previous) |old_routes| {
+            if (routes_mod.Route.init(family, .included, route)) |key| {
+                if (old_routes.contains(key)) continue;
+            }
+        }
+        if (route.destination) |destination| {
+            if (route.gateway) |gateway| {
+                log.writef(.info, "\t" ++ label ++ ": Add route {s} -> {s}", .{
+                    destination,
+                    gateway,
+                });
+            } else {
+                log.writef(.info, "\t" ++ label ++ ": Add route {s} -> *", .{
+                    destination,
+                });
+            }
+        } else {
+            if (route.gateway) |gateway| {
+                log.writef(.info, "\t" ++ label ++ ": Set default gateway -> {s}", .{
+                    gateway,
+                });
+            } else {
+                log.write(.info, "\t" ++ label ++ ": Set default gateway -> *");
+            }
+        }
+    }
+}
+
 fn addressesAlloc(
     allocator: std.mem.Allocator,
     values: []const []const u8,
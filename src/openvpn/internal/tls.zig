@@ -10,16 +10,20 @@ const constants_mod = @import("constants.zig");
 const api = core_mod.api;
 const c_common = c_exports_mod.common;
 const c_crypto = c_exports_mod.crypto;
+const log = core_mod.logging;
 
 const CryptoBackend = c_exports_mod.CryptoBackend;
+const Sha256 = std.crypto.hash.sha2.Sha256;
 const TLSConstants = constants_mod.TLS;
 
 /// Borrowed arguments used to create a TLS engine.
 pub const TLSParameters = struct {
     backend: CryptoBackend,
-    caches_directory: []const u8,
-    ca_filename: []const u8,
     configuration: *const api.OpenVPNConfiguration,
+    contexts: *TLSContextCache = &TLSContextCache.shared,
+    /// Remote whose previous session is offered for resumption, if any.
+    remote: ?*const api.ExtendedEndpoint = null,
+    handshakes: ?*HandshakeStats = null,
     verification: Verification = .{},
 
     pub const Verification = struct {
@@ -34,20 +38,238 @@ pub const TLSParameters = struct {
     };
 };
 
+/// Completed TLS handshakes by kind, updated on the session looper.
+pub const HandshakeStats = struct {
+    full: std.atomic.Value(u64) = .init(0),
+    resumed: std.atomic.Value(u64) = .init(0),
+};
+
+/// Reference-counted cache of ready C TLS contexts.
+///
+/// A context owns the parsed CA chain, client certificate, and private key,
+/// whose parsing dominates the cost of a new TLS engine. Contexts are keyed by
+/// a digest of the backend and every option they are built from, so that
+/// reconnections and concurrent sessions with the same profile share one.
+/// EKU and SAN checks run per engine on the peer certificate, therefore they
+/// are not part of the key. Up to `max_idle` unreferenced contexts are kept
+/// for the next connection attempt, least recently released first out.
+///
+/// When the backend supports resumption, each context also keeps the last
+/// session negotiated with up to `max_sessions` remotes.
+pub const TLSContextCache = struct {
+    pub const max_idle = 4;
+    pub const max_sessions = 8;
+
+    /// Cache shared by all sessions of the process.
+    pub var shared: TLSContextCache = .{ .allocator = std.heap.c_allocator };
+
+    pub const Key = [Sha256.digest_length]u8;
+
+    pub const Entry = struct {
+        key: Key,
+        ctx: c_crypto.pp_tls_ctx,
+        free: *const fn (c_crypto.pp_tls_ctx) callconv(.c) void,
+        free_session: c_crypto.pp_tls_session_free_fn,
+        refs: usize,
+        released_at: u64 = 0,
+        sessions: [max_sessions]StoredSession = @splat(.{}),
+    };
+
+    const StoredSession = struct {
+        remote: u64 = 0,
+        session: c_crypto.pp_tls_session = null,
+        stored_at: u64 = 0,
+    };
+
+    allocator: std.mem.Allocator,
+    mutex: core_mod.Mutex = .{},
+    entries: std.ArrayList(*Entry) = .empty,
+    releases: u64 = 0,
+    stores: u64 = 0,
+
+    /// Frees every context. Entries must not be referenced anymore.
+    pub fn deinit(self: *TLSContextCache) void {
+        for (self.entries.items) |entry| {
+            std.debug.assert(entry.refs == 0);
+            self.destroyEntry(entry);
+        }
+        self.entries.deinit(self.allocator);
+        self.mutex.deinit();
+    }
+
+    /// Returns a context matching `options`, creating it on a miss. Balance
+    /// with `release` once the engines built on it are freed.
+    pub fn acquire(
+        self: *TLSContextCache,
+        functions: c_crypto.pp_crypto_tls_fnt,
+        options: *const c_crypto.pp_tls_options,
+    ) !*Entry {
+        const create_ctx = functions.ctx_create orelse return error.TLSFailure;
+        const free_ctx = functions.ctx_free orelse return error.TLSFailure;
+        const key = makeKey(@intFromPtr(create_ctx), options);
+
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        for (self.entries.items) |entry| {
+            if (!std.mem.eql(u8, &entry.key, &key)) continue;
+            entry.refs += 1;
+            return entry;
+        }
+
+        // Build under the lock so that racing sessions share one context.
+        try self.entries.ensureUnusedCapacity(self.allocator, 1);
+        const entry = try self.allocator.create(Entry);
+        errdefer self.allocator.destroy(entry);
+        var code: c_crypto.pp_tls_error_code = c_crypto.PPTLSErrorNone;
+        const ctx = create_ctx(options, &code) orelse return error.TLSFailure;
+        entry.* = .{
+            .key = key,
+            .ctx = ctx,
+            .free = free_ctx,
+            .free_session = functions.session_free,
+            .refs = 1,
+        };
+        self.entries.appendAssumeCapacity(entry);
+        return entry;
+    }
+
+    pub fn release(self: *TLSContextCache, entry: *Entry) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        std.debug.assert(entry.refs > 0);
+        entry.refs -= 1;
+        if (entry.refs > 0) return;
+        self.releases += 1;
+        entry.released_at = self.releases;
+        self.trimIdle(max_idle);
+    }
+
+    /// Offers the last session stored for `remote` to a new TLS object.
+    pub fn offerSession(
+        self: *TLSContextCache,
+        entry: *Entry,
+        remote: u64,
+        tls: c_crypto.pp_tls,
+        set_session: *const fn (c_crypto.pp_tls, c_crypto.pp_tls_session) callconv(.c) void,
+    ) bool {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        for (&entry.sessions) |*stored| {
+            if (stored.session == null or stored.remote != remote) continue;
+            set_session(tls, stored.session);
+            return true;
+        }
+        return false;
+    }
+
+    /// Takes ownership of `session` as the last one negotiated with `remote`,
+    /// replacing the previous one or the least recently stored.
+    pub fn storeSession(
+        self: *TLSContextCache,
+        entry: *Entry,
+        remote: u64,
+        session: c_crypto.pp_tls_session,
+    ) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        var slot = &entry.sessions[0];
+        for (&entry.sessions) |*stored| {
+            if (stored.session != null and stored.remote == remote) {
+                slot = stored;
+                break;
+            }
+            if (stored.stored_at < slot.stored_at) slot = stored;
+        }
+        if (slot.session != null) entry.free_session.?(slot.session);
+        self.stores += 1;
+        slot.* = .{
+            .remote = remote,
+            .session = session,
+            .stored_at = self.stores,
+        };
+    }
+
+    /// Frees every unreferenced context.
+    pub fn purge(self: *TLSContextCache) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        self.trimIdle(0);
+    }
+
+    /// Returns the number of cached contexts, referenced or not.
+    pub fn count(self: *TLSContextCache) usize {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        return self.entries.items.len;
+    }
+
+    fn trimIdle(self: *TLSContextCache, limit: usize) void {
+        while (true) {
+            var idle: usize = 0;
+            var oldest: ?usize = null;
+            for (self.entries.items, 0..) |entry, i| {
+                if (entry.refs > 0) continue;
+                idle += 1;
+                if (oldest == null or entry.released_at < self.entries.items[oldest.?].released_at) {
+                    oldest = i;
+                }
+            }
+            if (idle <= limit) return;
+            self.destroyEntry(self.entries.swapRemove(oldest.?));
+        }
+    }
+
+    fn destroyEntry(self: *TLSContextCache, entry: *Entry) void {
+        for (entry.sessions) |stored| {
+            if (stored.session != null) entry.free_session.?(stored.session);
+        }
+        entry.free(entry.ctx);
+        self.allocator.destroy(entry);
+    }
+
+    fn makeKey(backend: usize, options: *const c_crypto.pp_tls_options) Key {
+        var hasher = Sha256.init(.{});
+        hasher.update(std.mem.asBytes(&backend));
+        hasher.update(std.mem.asBytes(&options.sec_level));
+        inline for (.{ "ca_pem", "cert_pem", "key_pem" }) |field| {
+            const value: [*c]const u8 = @field(options, field);
+            // Length prefixes keep missing values and field boundaries apart.
+            var prefix: u64 = 0;
+            if (value != null) {
+                const bytes = std.mem.span(@as([*:0]const u8, @ptrCast(value)));
+                prefix = bytes.len + 1;
+                hasher.update(std.mem.asBytes(&prefix));
+                hasher.update(bytes);
+            } else {
+                hasher.update(std.mem.asBytes(&prefix));
+            }
+        }
+        var key: Key = undefined;
+        hasher.final(&key);
+        return key;
+    }
+};
+
 /// C-backed TLS implementation.
 ///
 /// The C TLS object takes ownership of `pp_tls_options` after a successful
-/// `create`. The Zig wrapper owns its verification context, CA file path, and
-/// the TLS object itself.
+/// `create`. The Zig wrapper owns its verification context, its reference to
+/// the shared TLS context, and the TLS object itself.
 pub const TLSWrapper = struct {
     allocator: std.mem.Allocator,
     functions: c_crypto.pp_crypto_tls_fnt,
     tls: c_crypto.pp_tls,
-    ca_path: [:0]u8,
+    contexts: *TLSContextCache,
+    context: *TLSContextCache.Entry,
+    remote: ?u64,
+    handshakes: ?*HandshakeStats,
     verification_context: *VerificationContext,
 
     const VerificationContext = struct {
         verification: TLSParameters.Verification,
+        /// Set when the current handshake failed verification or any other
+        /// operation, its session is never stored for resumption then.
+        failed: bool = false,
     };
 
     pub fn create(
@@ -72,20 +294,8 @@ pub const TLSWrapper = struct {
         const create_tls = functions.create orelse return error.TLSFailure;
         const free_tls = functions.free orelse return error.TLSFailure;
 
-        const ca_path = try std.fmt.allocPrintSentinel(
-            allocator,
-            "{s}{s}{s}",
-            .{
-                parameters.caches_directory,
-                if (std.mem.endsWith(u8, parameters.caches_directory, "/")) "" else "/",
-                parameters.ca_filename,
-            },
-            0,
-        );
-        errdefer allocator.free(ca_path);
-        try writeCA(ca_path, ca.pem);
-        errdefer _ = c_common.remove(ca_path.ptr);
-
+        const ca_pem = try allocator.dupeZ(u8, ca.pem);
+        defer allocator.free(ca_pem);
         const cert_pem = if (configuration.client_certificate) |value|
             try allocator.dupeZ(u8, value.pem)
         else
@@ -111,27 +321,42 @@ pub const TLSWrapper = struct {
             TLSConstants.buffer_length,
             configuration.checks_eku orelse false,
             configuration.checks_san_host orelse false,
-            ca_path.ptr,
+            ca_pem.ptr,
             if (cert_pem) |value| value.ptr else null,
             if (key_pem) |value| value.ptr else null,
             if (hostname) |value| value.ptr else null,
             verificationFailed,
             verification_context,
         );
+        var options_transferred = false;
+        defer if (!options_transferred) c_crypto.pp_tls_options_free(options);
+
+        const context = try parameters.contexts.acquire(functions, options);
+        errdefer parameters.contexts.release(context);
+
         var code: c_crypto.pp_tls_error_code = c_crypto.PPTLSErrorNone;
-        const tls = create_tls(options, &code) orelse {
-            c_crypto.pp_tls_options_free(options);
-            if (code == c_crypto.PPTLSErrorNone) return error.TLSFailure;
-            return error.TLSFailure;
-        };
+        const tls = create_tls(options, context.ctx, &code) orelse return error.TLSFailure;
+        options_transferred = true;
         errdefer free_tls(tls);
 
+        const remote = if (parameters.remote) |endpoint| remoteKey(endpoint) else null;
+        if (remote) |key| {
+            if (functions.set_session) |set_session| {
+                if (parameters.contexts.offerSession(context, key, tls, set_session)) {
+                    log.write(.info, "TLS: Offer previous session for resumption");
+                }
+            }
+        }
+
         const self = try allocator.create(TLSWrapper);
         self.* = .{
             .allocator = allocator,
             .functions = functions,
             .tls = tls,
-            .ca_path = ca_path,
+            .contexts = parameters.contexts,
+            .context = context,
+            .remote = remote,
+            .handshakes = parameters.handshakes,
             .verification_context = verification_context,
         };
         return self;
@@ -139,16 +364,19 @@ pub const TLSWrapper = struct {
 
     pub fn destroy(self: *const TLSWrapper) void {
         const allocator = self.allocator;
+        self.storeSession();
         self.functions.free.?(self.tls);
+        self.contexts.release(self.context);
         allocator.destroy(self.verification_context);
-        _ = c_common.remove(self.ca_path.ptr);
-        allocator.free(self.ca_path);
         allocator.destroy(self);
     }
 
     pub fn start(self: *const TLSWrapper) !void {
         const start_tls = self.functions.start orelse return error.TLSFailure;
-        if (!start_tls(self.tls)) return error.TLSFailure;
+        // The C object offers its previous session on restart by itself.
+        self.storeSession();
+        self.verification_context.failed = false;
+        if (!start_tls(self.tls)) return self.operationError(c_crypto.PPTLSErrorNone);
     }
 
     pub fn isConnected(self: *const TLSWrapper) bool {
@@ -168,7 +396,7 @@ pub const TLSWrapper = struct {
         var code: c_crypto.pp_tls_error_code = c_crypto.PPTLSErrorNone;
         const put_cipher = self.functions.put_cipher orelse return error.TLSFailure;
         if (!put_cipher(self.tls, data.ptr, data.len, &code))
-            return tlsOperationError(code);
+            return self.operationError(code);
     }
 
     pub fn pullPlainText(
@@ -179,7 +407,7 @@ pub const TLSWrapper = struct {
         const pull_plain = self.functions.pull_plain orelse return error.TLSFailure;
         const data = pull_plain(self.tls, &code) orelse {
             if (code == c_crypto.PPTLSErrorNone) return error.TLSNoData;
-            return tlsOperationError(code);
+            return self.operationError(code);
         };
         defer c_crypto.pp_zd_free(data);
         return allocator.dupe(u8, data.*.bytes[0..data.*.length]);
@@ -193,12 +421,25 @@ pub const TLSWrapper = struct {
         const pull_cipher = self.functions.pull_cipher orelse return error.TLSFailure;
         const data = pull_cipher(self.tls, &code) orelse {
             if (code == c_crypto.PPTLSErrorNone) return error.TLSNoData;
-            return tlsOperationError(code);
+            return self.operationError(code);
         };
         defer c_crypto.pp_zd_free(data);
         return allocator.dupe(u8, data.*.bytes[0..data.*.length]);
     }
 
+    /// Records a completed handshake and returns whether it resumed a session.
+    pub fn recordHandshake(self: *const TLSWrapper) bool {
+        const resumed = if (self.functions.is_resumed) |is_resumed|
+            is_resumed(self.tls)
+        else
+            false;
+        if (self.handshakes) |stats| {
+            const counter = if (resumed) &stats.resumed else &stats.full;
+            _ = counter.fetchAdd(1, .monotonic);
+        }
+        return resumed;
+    }
+
     pub fn caMD5(
         self: *const TLSWrapper,
         allocator: std.mem.Allocator,
@@ -213,22 +454,36 @@ pub const TLSWrapper = struct {
         var code: c_crypto.pp_tls_error_code = c_crypto.PPTLSErrorNone;
         const put_plain = self.functions.put_plain orelse return error.TLSFailure;
         if (!put_plain(self.tls, data.ptr, data.len, &code))
-            return tlsOperationError(code);
+            return self.operationError(code);
+    }
+
+    /// Only stores sessions of handshakes that completed and passed all the
+    /// peer checks.
+    fn storeSession(self: *const TLSWrapper) void {
+        if (self.verification_context.failed or !self.isConnected()) return;
+        const remote = self.remote orelse return;
+        const get_session = self.functions.get_session orelse return;
+        if (self.functions.session_free == null) return;
+        const session = get_session(self.tls) orelse return;
+        self.contexts.storeSession(self.context, remote, session);
+    }
+
+    fn remoteKey(endpoint: *const api.ExtendedEndpoint) u64 {
+        var hasher = std.hash.Wyhash.init(0);
+        hasher.update(endpoint.address);
+        hasher.update(std.mem.asBytes(&endpoint.proto.port));
+        hasher.update(@tagName(endpoint.proto.socket_type));
+        return hasher.final();
     }
 
     fn verificationFailed(context: ?*anyopaque) callconv(.c) void {
         const typed: *VerificationContext = @ptrCast(@alignCast(context orelse return));
+        typed.failed = true;
         typed.verification.failed();
     }
 
-    fn writeCA(path: [:0]const u8, pem: []const u8) !void {
-        const file = c_common.fopen(path.ptr, "wb") orelse return error.TLSFailure;
-        defer _ = c_common.fclose(file);
-        if (pem.len == 0) return;
-        if (c_common.fwrite(pem.ptr, 1, pem.len, file) != pem.len) return error.TLSFailure;
-    }
-
-    fn tlsOperationError(_: c_crypto.pp_tls_error_code) error{TLSFailure} {
+    fn operationError(self: *const TLSWrapper, _: c_crypto.pp_tls_error_code) error{TLSFailure} {
+        self.verification_context.failed = true;
         return error.TLSFailure;
     }
 
@@ -128,20 +128,42 @@ pub const Parser = struct {
         context: Context,
     ) ParseError!api.OpenVPNConfiguration {
         var builder = Builder.init(
+            allocator,
             context,
             self.decrypt_key_ctx,
             self.decrypt_key,
+            true,
         );
         defer builder.deinit(allocator);
 
         var lines = std.mem.splitScalar(u8, contents, '\n');
         while (lines.next()) |raw_line| {
-            const line = util.trim(raw_line);
-            if (line.len == 0 or line[0] == '#' or line[0] == ';') continue;
-            builder.putLine(allocator, line) catch |err| {
-                builder.context.setLineParseErrorInfo(allocator, line, err);
-                return err;
-            };
+            try builder.putRawLine(allocator, raw_line);
+        }
+
+        return try builder.build(allocator);
+    }
+
+    /// Parses a profile incrementally, e.g. from a file reader, so that the
+    /// whole text never needs to be in memory. The reader buffer must fit the
+    /// longest line, and only the lines retained until `build` are copied.
+    pub fn parseReader(
+        self: Parser,
+        allocator: std.mem.Allocator,
+        reader: *std.Io.Reader,
+        context: Context,
+    ) StreamError!api.OpenVPNConfiguration {
+        var builder = Builder.init(
+            allocator,
+            context,
+            self.decrypt_key_ctx,
+            self.decrypt_key,
+            false,
+        );
+        defer builder.deinit(allocator);
+
+        while (try reader.takeDelimiter('\n')) |raw_line| {
+            try builder.putRawLine(allocator, raw_line);
         }
 
         return try builder.build(allocator);
@@ -159,6 +181,11 @@ pub const ParseError = std.mem.Allocator.Error || error{
     UnsupportedConfiguration,
 };
 
+pub const StreamError = ParseError || error{
+    ReadFailed,
+    StreamTooLong,
+};
+
 fn decryptKey(backend: CryptoBackend) Parser.DecryptKey {
     return switch (backend) {
         .openssl => decryptKeyWithBackend(.openssl),
@@ -206,7 +233,15 @@ fn decryptKeyWithBackend(comptime backend: CryptoBackend) Parser.DecryptKey {
     }.decrypt;
 }
 
+/// Accumulates options into a configuration owned by the caller allocator.
+///
+/// Transient state (tokens, remotes, block lines) lives in `scratch`, which
+/// is released at once by `deinit`. Token slices borrow the input, unless the
+/// input is transient and `retain` copies them to `scratch`.
 const Builder = struct {
+    scratch: std.heap.ArenaAllocator,
+    borrows_input: bool,
+    components: std.ArrayList([]const u8),
     configuration: api.OpenVPNConfiguration,
     legacy_cipher: ?api.OpenVPNCipher,
     data_ciphers_fallback: ?api.OpenVPNCipher,
@@ -222,7 +257,7 @@ const Builder = struct {
     current_block_name: ?[]const u8,
     current_block_lines: std.ArrayList([]const u8),
     tls_strategy: ?api.OpenVPNTLSWrapStrategy,
-    tls_key_lines: ?[][]const u8,
+    tls_key_lines: ?std.ArrayList([]const u8),
     tls_key_direction: ?api.OpenVPNStaticKeyDirection,
     default_protocol: api.IPSocketType,
     default_port: u16,
@@ -236,11 +271,16 @@ const Builder = struct {
     decrypt_key: ?Parser.DecryptKey,
 
     fn init(
+        allocator: std.mem.Allocator,
         context: Parser.Context,
         decrypt_key_ctx: ?*anyopaque,
         decrypt_key: ?Parser.DecryptKey,
+        borrows_input: bool,
     ) Builder {
         return .{
+            .scratch = std.heap.ArenaAllocator.init(allocator),
+            .borrows_input = borrows_input,
+            .components = .empty,
             .configuration = .{},
             .legacy_cipher = null,
             .data_ciphers_fallback = null,
@@ -274,7 +314,6 @@ const Builder = struct {
     fn deinit(self: *Builder, allocator: std.mem.Allocator) void {
         self.configuration.deinit(allocator);
         self.data_ciphers.deinit(allocator);
-        self.remotes.deinit(allocator);
         util.deinitList(api.Route, allocator, &self.routes4);
         util.deinitList(api.Route, allocator, &self.routes6);
         util.deinitListOfStrings(allocator, &self.dns_servers);
@@ -282,8 +321,26 @@ const Builder = struct {
         util.deinitListOfStrings(allocator, &self.proxy_bypass_domains);
         self.routing_policies.deinit(allocator);
         self.no_pull_mask.deinit(allocator);
-        self.current_block_lines.deinit(allocator);
-        if (self.tls_key_lines) |lines| allocator.free(lines);
+        self.scratch.deinit();
+    }
+
+    fn putRawLine(
+        self: *Builder,
+        allocator: std.mem.Allocator,
+        raw_line: []const u8,
+    ) ParseError!void {
+        const line = util.trim(raw_line);
+        if (line.len == 0 or line[0] == '#' or line[0] == ';') return;
+        self.putLine(allocator, line) catch |err| {
+            self.context.setLineParseErrorInfo(allocator, line, err);
+            return err;
+        };
+    }
+
+    /// Returns a slice that outlives the current line.
+    fn retain(self: *Builder, value: []const u8) error{OutOfMemory}![]const u8 {
+        if (self.borrows_input) return value;
+        return self.scratch.allocator().dupe(u8, value);
     }
 
     fn putLine(
@@ -291,6 +348,7 @@ const Builder = struct {
         allocator: std.mem.Allocator,
         line: []const u8,
     ) ParseError!void {
+        const scratch = self.scratch.allocator();
         if (self.current_block_name) |block_name| {
             if (blockEndName(line)) |name| {
                 if (std.ascii.eqlIgnoreCase(block_name, name)) {
@@ -299,7 +357,7 @@ const Builder = struct {
                     return;
                 }
             }
-            try self.current_block_lines.append(allocator, line);
+            try self.current_block_lines.append(scratch, try self.retain(line));
             return;
         }
 
@@ -310,15 +368,16 @@ const Builder = struct {
                 self.context.setParseErrorInfo(allocator, name, line);
                 return error.UnsupportedConfiguration;
             }
-            self.current_block_name = name;
+            self.current_block_name = try self.retain(name);
             return;
         }
 
-        var components: std.ArrayList([]const u8) = .empty;
-        defer components.deinit(allocator);
+        // Tokens are slices of the line, in a list reused across lines.
+        const components = &self.components;
+        components.clearRetainingCapacity();
         var words = std.mem.tokenizeAny(u8, line, " \t");
         while (words.next()) |word| {
-            try components.append(allocator, word);
+            try components.append(scratch, word);
         }
         if (components.items.len == 0) return;
 
@@ -391,10 +450,18 @@ const Builder = struct {
             self.configuration.digest = util.parseRawIgnoreCase(api.OpenVPNDigest, components.items[1]) orelse return error.UnsupportedConfiguration;
             return;
         }
+        // Compressed inbound packets are decompressed, outbound packets are
+        // never compressed
         if (std.ascii.eqlIgnoreCase(option, "comp-lzo")) {
             self.configuration.compression_framing = .compLZO;
-            if (components.items.len > 1 and std.ascii.eqlIgnoreCase(components.items[1], "no")) {
+            if (components.items.len == 1) {
+                self.configuration.compression_algorithm = .LZO;
+            } else if (std.ascii.eqlIgnoreCase(components.items[1], "no")) {
                 self.configuration.compression_algorithm = .disabled;
+            } else if (std.ascii.eqlIgnoreCase(components.items[1], "yes") or
+                std.ascii.eqlIgnoreCase(components.items[1], "adaptive"))
+            {
+                self.configuration.compression_algorithm = .LZO;
             } else {
                 return error.UnsupportedCompression;
             }
@@ -410,7 +477,12 @@ const Builder = struct {
                 self.configuration.compression_framing = .compressV2;
                 self.configuration.compression_algorithm = .disabled;
             } else if (std.ascii.eqlIgnoreCase(components.items[1], "lzo")) {
-                return error.UnsupportedCompression;
+                self.configuration.compression_algorithm = .LZO;
+            } else if (std.ascii.eqlIgnoreCase(components.items[1], "lz4")) {
+                self.configuration.compression_algorithm = .other;
+            } else if (std.ascii.eqlIgnoreCase(components.items[1], "lz4-v2")) {
+                self.configuration.compression_framing = .compressV2;
+                self.configuration.compression_algorithm = .other;
             } else {
                 return error.UnsupportedCompression;
             }
@@ -453,14 +525,14 @@ const Builder = struct {
         if (std.ascii.eqlIgnoreCase(option, "remote")) {
             if (components.items.len < 2) return error.MalformedOption;
             const remote = RemoteBuilder{
-                .address = components.items[1],
+                .address = try self.retain(components.items[1]),
                 .port = if (components.items.len > 2)
                     std.fmt.parseInt(u16, components.items[2], 10) catch null
                 else
                     null,
                 .protocol = if (components.items.len > 3) parseIPSocketType(components.items[3]) else null,
             };
-            try self.remotes.append(allocator, remote);
+            try self.remotes.append(scratch, remote);
             return;
         }
         if (std.ascii.eqlIgnoreCase(option, "remote-cert-tls")) {
@@ -502,12 +574,12 @@ const Builder = struct {
         }
         if (std.ascii.eqlIgnoreCase(option, "ifconfig")) {
             if (components.items.len < 3) return;
-            self.ifconfig4 = IfconfigArguments.init(components.items[1..]);
+            self.ifconfig4 = try self.ifconfigArguments(components.items[1..]);
             return;
         }
         if (std.ascii.eqlIgnoreCase(option, "ifconfig-ipv6")) {
             if (components.items.len < 3) return;
-            self.ifconfig6 = IfconfigArguments.init(components.items[1..]);
+            self.ifconfig6 = try self.ifconfigArguments(components.items[1..]);
             return;
         }
         if (std.ascii.eqlIgnoreCase(option, "route")) {
@@ -550,6 +622,16 @@ const Builder = struct {
         }
     }
 
+    fn ifconfigArguments(
+        self: *Builder,
+        arguments: []const []const u8,
+    ) error{OutOfMemory}!IfconfigArguments {
+        var result = IfconfigArguments.init(arguments);
+        if (result.first) |value| result.first = try self.retain(value);
+        if (result.second) |value| result.second = try self.retain(value);
+        return result;
+    }
+
     fn putTLSDirective(
         self: *Builder,
         strategy: api.OpenVPNTLSWrapStrategy,
@@ -581,26 +663,28 @@ const Builder = struct {
         } else if (std.ascii.eqlIgnoreCase(block_name, "cert")) {
             replaceOpenVPNCryptoContainer(allocator, &self.configuration.client_certificate, try std.mem.join(allocator, "\n", self.current_block_lines.items));
         } else if (std.ascii.eqlIgnoreCase(block_name, "key")) {
-            try normalizeEncryptedPEMBlock(allocator, &self.current_block_lines);
+            try normalizeEncryptedPEMBlock(self.scratch.allocator(), &self.current_block_lines);
             replaceOpenVPNCryptoContainer(allocator, &self.configuration.client_key, try std.mem.join(allocator, "\n", self.current_block_lines.items));
         } else if (std.ascii.eqlIgnoreCase(block_name, "tls-auth")) {
-            try self.replaceTLSKeyLines(allocator);
+            self.replaceTLSKeyLines();
             self.tls_strategy = .auth;
         } else if (std.ascii.eqlIgnoreCase(block_name, "tls-crypt")) {
-            try self.replaceTLSKeyLines(allocator);
+            self.replaceTLSKeyLines();
             self.tls_strategy = .crypt;
         } else if (std.ascii.eqlIgnoreCase(block_name, "tls-crypt-v2")) {
-            try self.replaceTLSKeyLines(allocator);
+            self.replaceTLSKeyLines();
             self.tls_strategy = .cryptV2;
         }
 
         self.current_block_lines.clearRetainingCapacity();
     }
 
-    fn replaceTLSKeyLines(self: *Builder, allocator: std.mem.Allocator) error{OutOfMemory}!void {
-        const new_lines = try allocator.dupe([]const u8, self.current_block_lines.items);
-        if (self.tls_key_lines) |lines| allocator.free(lines);
-        self.tls_key_lines = new_lines;
+    /// Moves the block lines without copying them. The previous key lines
+    /// become the next block buffer.
+    fn replaceTLSKeyLines(self: *Builder) void {
+        const previous = self.tls_key_lines orelse std.ArrayList([]const u8).empty;
+        self.tls_key_lines = self.current_block_lines;
+        self.current_block_lines = previous;
     }
 
     fn putRoute4(
@@ -611,8 +695,9 @@ const Builder = struct {
         if (components.len < 2) return;
         const mask = if (components.len > 2) components[2] else "255.255.255.255";
         const prefix = ipv4MaskPrefix(mask) orelse return error.MalformedOption;
-        const destination = try std.fmt.allocPrint(allocator, "{s}/{d}", .{ components[1], prefix });
-        defer allocator.free(destination);
+        var destination_buffer: [64]u8 = undefined;
+        const destination = std.fmt.bufPrint(&destination_buffer, "{s}/{d}", .{ components[1], prefix }) catch
+            return error.MalformedOption;
         var parsed_destination = (try api.Subnet.parseRawAlloc(allocator, destination)) orelse return error.MalformedOption;
         errdefer parsed_destination.deinit(allocator);
         var gateway = if (components.len > 3 and !std.ascii.eqlIgnoreCase(components[3], "vpn_gateway"))
@@ -764,7 +849,7 @@ const Builder = struct {
         self.configuration.no_pull_mask = try takeOwnedSliceOrNull(allocator, &self.no_pull_mask);
 
         if (self.tls_strategy) |strategy| {
-            const lines = self.tls_key_lines orelse {
+            const lines = if (self.tls_key_lines) |list| list.items else {
                 const name = tlsStrategyOptionName(strategy);
                 self.context.setParseErrorInfo(allocator, name, name);
                 return error.MalformedOption;
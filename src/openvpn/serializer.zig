@@ -187,9 +187,13 @@ const ConfigurationWriter = struct {
             .compress => if (algorithm) |inner| switch (inner) {
                 .LZO => try self.line("compress lzo", .{}),
                 .disabled => try self.line("compress stub", .{}),
-                .other => {},
+                .other => try self.line("compress lz4", .{}),
+            },
+            .compressV2 => if (algorithm == .other) {
+                try self.line("compress lz4-v2", .{});
+            } else {
+                try self.line("compress stub-v2", .{});
             },
-            .compressV2 => try self.line("compress stub-v2", .{}),
             .disabled => {},
         }
     }
@@ -32,6 +32,9 @@ typedef struct {
     partout_logger_cb logger;
 } partout_init_args;
 void partout_init(const partout_init_args *args);
+/* Messages less severe than level are dropped before formatting. The
+ * default is PartoutLogLevelDebug. */
+void partout_set_log_level(partout_log_level level);
 
 /* Common functions. */
 char *partout_readfile(const char *rel_path, const char *parent);
@@ -88,6 +91,12 @@ int partout_daemon_start(const partout_daemon_start_args *args);
 void partout_daemon_hold(void);
 void partout_daemon_stop(void);
 
+/* Snapshot of the counters and latency histograms of the current
+ * connection, as a JSON object. NULL if the daemon is not running,
+ * otherwise the caller must free() the result. May be called from any
+ * thread, also while the daemon stops. */
+char *partout_get_metrics(void);
+
 #ifdef __cplusplus
 }
 #endif
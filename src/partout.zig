@@ -29,6 +29,9 @@ const allocator = std.heap.c_allocator;
 // const DaemonRuntime = if (builtin.is_test) @import("testing/mock.zig").MockRuntime else abi.DaemonRuntime;
 // var daemon_runtime = DaemonRuntime{};
 var daemon_runtime: ?*abi.DaemonRuntime = null;
+/// Guards `daemon_runtime` against readers on other threads, e.g. metrics,
+/// so that stop never destroys the runtime while they use it.
+var daemon_runtime_mutex: core.Mutex = .{};
 var daemon_process_lock: DaemonProcessLock = .{};
 
 const DaemonProcessLock = struct {
@@ -75,6 +78,15 @@ pub export fn partout_version() callconv(.c) [*:0]const u8 {
 pub export fn partout_init(args_pointer: ?*const c.partout_init_args) callconv(.c) void {
     const args = args_pointer orelse return;
     log.init(args.logs_private_data, args.logger);
+    // Keep the caller threads off the host logger
+    log.startAsync(.{}) catch |err| {
+        log.writef(.err, "Unable to start asynchronous logging: {s}", .{@errorName(err)});
+    };
+}
+
+pub export fn partout_set_log_level(level: c.partout_log_level) callconv(.c) void {
+    if (level < 0 or level > @intFromEnum(log.Level.debug)) return;
+    log.setLevel(@enumFromInt(level));
 }
 
 pub export fn partout_readfile(
@@ -150,7 +162,11 @@ pub export fn partout_daemon_start(
     };
     const is_daemon = runtime.options.is_daemon;
     if (is_daemon) daemon_process_lock.prepare();
-    daemon_runtime = runtime;
+    {
+        daemon_runtime_mutex.lock();
+        defer daemon_runtime_mutex.unlock();
+        daemon_runtime = runtime;
+    }
     if (is_daemon) daemon_process_lock.wait();
     return c.PartoutCompletionCodeOK;
 }
@@ -170,11 +186,25 @@ pub export fn partout_daemon_stop() callconv(.c) void {
     const runtime = daemon_runtime orelse return;
     const is_daemon = runtime.options.is_daemon;
     runtime.stop();
+    {
+        // Waits for readers still using the runtime
+        daemon_runtime_mutex.lock();
+        defer daemon_runtime_mutex.unlock();
+        daemon_runtime = null;
+    }
     runtime.destroy(allocator);
-    daemon_runtime = null;
+    log.flush();
     if (is_daemon) daemon_process_lock.release();
 }
 
+pub export fn partout_get_metrics() callconv(.c) ?[*:0]u8 {
+    daemon_runtime_mutex.lock();
+    defer daemon_runtime_mutex.unlock();
+    const runtime = daemon_runtime orelse return null;
+    const json = runtime.metricsJsonAlloc(allocator) catch return null;
+    return json.ptr;
+}
+
 fn mapErrorToCode(err: abi.RuntimeError) c_int {
     log.writef(.err, "Unable to start daemon: {s}", .{@errorName(err)});
     return switch (err) {
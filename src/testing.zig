@@ -13,8 +13,10 @@ pub const c_common = c_mod.common;
 pub const c_crypto = c_mod.crypto;
 pub const core = @import("core/exports.zig");
 pub const core_logging = @import("core/logging.zig");
+pub const core_logging_queue = @import("core/logging_queue.zig");
 pub const core_api = @import("core/api.zig");
 pub const core_actor = @import("core/actor.zig");
+pub const core_profile_cache = @import("core/profile_cache.zig");
 pub const core_registry = @import("core/registry.zig");
 pub const core_uuid = @import("core/uuid.zig");
 pub const mock = @import("testing/mock.zig");
@@ -24,6 +26,7 @@ pub const net_daemon = @import("net/daemon.zig");
 pub const net_daemon_helpers = @import("net/daemon_helpers.zig");
 pub const net_io = @import("net/io.zig");
 pub const net_looper = @import("net/looper.zig");
+pub const net_looper_batch = @import("net/looper_batch.zig");
 pub const net_looper_queue = @import("net/looper_queue.zig");
 pub const net_sandbox = @import("net/sandbox.zig");
 pub const net_platform = @import("net/platform.zig");
@@ -48,6 +51,7 @@ pub const openvpn_internal = if (openvpn_enabled) struct {
     pub const packet = @import("openvpn/internal/packet.zig");
     pub const processing = @import("openvpn/internal/processing.zig");
     pub const push = @import("openvpn/internal/push.zig");
+    pub const routes = @import("openvpn/internal/routes.zig");
     pub const session = @import("openvpn/internal/session.zig");
     pub const session_context = @import("openvpn/internal/session_context.zig");
     pub const session_negotiator = @import("openvpn/internal/session_negotiator.zig");
@@ -5,10 +5,85 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "portable/common.h"
 #include "portable/lib.h"
 #include "wireguard/backend.h"
 
+static bool pp_wg_stats_key_is(const char *key, size_t key_len, const char *expected) {
+    const size_t expected_len = strlen(expected);
+    return key_len == expected_len && !memcmp(key, expected, expected_len);
+}
+
+static void pp_wg_stats_merge_handshake(pp_wg_stats *stats, int64_t sec, int64_t nsec) {
+    if (sec > stats->last_handshake_sec ||
+        (sec == stats->last_handshake_sec && nsec > stats->last_handshake_nsec)) {
+        stats->last_handshake_sec = sec;
+        stats->last_handshake_nsec = nsec;
+    }
+}
+
+/* Scans the UAPI "get" output in place, without copying lines. */
+int pp_wg_parse_stats(const char *uapi, pp_wg_stats *stats, pp_wg_peer_stats *peers, size_t max_peers) {
+    if (!uapi || !stats) return -1;
+    pp_zero(stats, sizeof(*stats));
+    pp_wg_peer_stats peer = { 0 };
+    bool in_peer = false;
+
+    const char *line = uapi;
+    while (*line) {
+        const char *end = strchr(line, '\n');
+        if (!end) end = line + strlen(line);
+        const char *separator = memchr(line, '=', (size_t)(end - line));
+        if (separator) {
+            const char *key = line;
+            const size_t key_len = (size_t)(separator - line);
+            const char *value = separator + 1;
+            const size_t value_len = (size_t)(end - value);
+            if (pp_wg_stats_key_is(key, key_len, "public_key")) {
+                if (in_peer) {
+                    pp_wg_stats_merge_handshake(stats, peer.last_handshake_sec, peer.last_handshake_nsec);
+                    if (peers && stats->peers_count <= max_peers) {
+                        peers[stats->peers_count - 1] = peer;
+                    }
+                }
+                pp_zero(&peer, sizeof(peer));
+                in_peer = true;
+                ++stats->peers_count;
+                char hex[WG_KEY_LEN_HEX];
+                if (value_len == WG_KEY_LEN_HEX - 1) {
+                    memcpy(hex, value, WG_KEY_LEN_HEX - 1);
+                    hex[WG_KEY_LEN_HEX - 1] = '\0';
+                    key_from_hex(peer.public_key, hex);
+                }
+            } else if (in_peer) {
+                /* Values stop at the line break, which is not a digit. */
+                if (pp_wg_stats_key_is(key, key_len, "rx_bytes")) {
+                    peer.rx_bytes = strtoull(value, NULL, 10);
+                    stats->rx_bytes += peer.rx_bytes;
+                } else if (pp_wg_stats_key_is(key, key_len, "tx_bytes")) {
+                    peer.tx_bytes = strtoull(value, NULL, 10);
+                    stats->tx_bytes += peer.tx_bytes;
+                } else if (pp_wg_stats_key_is(key, key_len, "last_handshake_time_sec")) {
+                    peer.last_handshake_sec = strtoll(value, NULL, 10);
+                } else if (pp_wg_stats_key_is(key, key_len, "last_handshake_time_nsec")) {
+                    peer.last_handshake_nsec = strtoll(value, NULL, 10);
+                }
+            }
+        }
+        if (!*end) break;
+        line = end + 1;
+    }
+    if (in_peer) {
+        pp_wg_stats_merge_handshake(stats, peer.last_handshake_sec, peer.last_handshake_nsec);
+        if (peers && stats->peers_count <= max_peers) {
+            peers[stats->peers_count - 1] = peer;
+        }
+    }
+    return 0;
+}
+
 #if PARTOUT_HAS_WIREGUARD_BACKEND
 
 /* The Apple library is statically linked as a Swift package, except
@@ -52,6 +127,16 @@ char *pp_wg_get_config(int handle) {
     return wgGetConfig(handle);
 }
 
+int pp_wg_get_stats(int handle, pp_wg_stats *stats, pp_wg_peer_stats *peers, size_t max_peers) {
+    /* wg-go only exports the UAPI text, parse it here so that callers
+     * neither copy nor re-scan the whole configuration. */
+    char *config = wgGetConfig(handle);
+    if (!config) return -1;
+    const int ret = pp_wg_parse_stats(config, stats, peers, max_peers);
+    pp_free(config);
+    return ret;
+}
+
 void pp_wg_bump_sockets(int handle, bool sync) {
     if (sync) {
         wgBumpSocketsAndWait(handle);
@@ -118,6 +203,14 @@ char *pp_wg_get_config(int handle) {
     return NULL;
 }
 
+int pp_wg_get_stats(int handle, pp_wg_stats *stats, pp_wg_peer_stats *peers, size_t max_peers) {
+    (void)handle;
+    (void)stats;
+    (void)peers;
+    (void)max_peers;
+    return -1;
+}
+
 void pp_wg_bump_sockets(int handle, bool sync) {
     (void)handle;
     (void)sync;
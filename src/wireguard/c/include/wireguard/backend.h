@@ -8,7 +8,27 @@
 #include "portable/conditionals.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "wireguard/key.h"
+
+/* Runtime counters of a single peer. */
+typedef struct {
+    uint8_t public_key[WG_KEY_LEN];
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    int64_t last_handshake_sec;
+    int64_t last_handshake_nsec;
+} pp_wg_peer_stats;
+
+/* Runtime counters summed over all peers, with the most recent handshake. */
+typedef struct {
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    int64_t last_handshake_sec;
+    int64_t last_handshake_nsec;
+    size_t peers_count;
+} pp_wg_stats;
 
 int pp_wg_init(void);
 typedef void (*pp_wg_logger_fn)(void *context, int level, const char *msg);
@@ -23,6 +43,13 @@ int pp_wg_turn_on(const char *settings, int32_t tun_fd);
 void pp_wg_turn_off(int handle);
 int64_t pp_wg_set_config(int handle, const char *settings);
 char *pp_wg_get_config(int handle);
+/*
+ * Fills the totals and up to max_peers entries of peers (may be NULL), in
+ * the order of the device configuration. stats->peers_count reports every
+ * peer, even beyond max_peers. Returns 0 on success.
+ */
+int pp_wg_get_stats(int handle, pp_wg_stats *stats, pp_wg_peer_stats *peers, size_t max_peers);
+int pp_wg_parse_stats(const char *uapi, pp_wg_stats *stats, pp_wg_peer_stats *peers, size_t max_peers);
 void pp_wg_bump_sockets(int handle, bool sync);
 void pp_wg_tweak_mobile_roaming(int handle);
 #if PARTOUT_ANDROID
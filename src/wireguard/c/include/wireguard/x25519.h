@@ -5,5 +5,10 @@
 
 #pragma once
 
+#include <stddef.h>
+
 void curve25519_derive_public_key(unsigned char public_key[32], const unsigned char private_key[32]);
+void curve25519_shared_secret(unsigned char shared_secret[32], const unsigned char private_key[32], const unsigned char public_key[32]);
 void curve25519_generate_private_key(unsigned char private_key[32]);
+/* Generates count key pairs, sharing the PRNG call and field inversions. */
+void curve25519_generate_keypairs(unsigned char (*private_keys)[32], unsigned char (*public_keys)[32], size_t count);
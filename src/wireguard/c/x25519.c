@@ -2,7 +2,8 @@
  *
  * Copyright (C) 2015-2019 Jason A. Donenfeld <Jason@zx2c4.com>. All Rights Reserved.
  *
- * Curve25519 ECDH functions, based on TweetNaCl but cleaned up.
+ * Curve25519 ECDH functions, based on TweetNaCl but cleaned up. The 64-bit
+ * backend follows the 51-bit limb arithmetic of ref10 and fiat-crypto.
  */
 
 #include <stdint.h>
@@ -12,6 +13,20 @@
 #include "portable/prng.h"
 #include "wireguard/x25519.h"
 
+/* The 64-bit backend needs 128-bit products, TweetNaCl is the fallback. */
+#ifndef PARTOUT_X25519_PORTABLE
+#if defined(__SIZEOF_INT128__)
+#define PARTOUT_X25519_PORTABLE 0
+#else
+#define PARTOUT_X25519_PORTABLE 1
+#endif
+#endif
+
+/* Keys generated per shared inversion in curve25519_generate_keypairs(). */
+#define CURVE25519_BATCH 16
+
+#if PARTOUT_X25519_PORTABLE
+
 typedef int64_t fe[16];
 
 static inline void carry(fe o)
@@ -117,7 +132,7 @@ static inline void invert(fe o, const fe i)
     memcpy(o, c, sizeof(fe));
 }
 
-static void curve25519_shared_secret(uint8_t shared_secret[32], const uint8_t private_key[32], const uint8_t public_key[32])
+static void curve25519_ladder(uint8_t shared_secret[32], const uint8_t private_key[32], const uint8_t public_key[32])
 {
     static const fe a24 = { 0xdb41, 1 };
     uint8_t z[32];
@@ -163,11 +178,318 @@ static void curve25519_shared_secret(uint8_t shared_secret[32], const uint8_t pr
     pack(shared_secret, a);
 }
 
+#else
+
+typedef uint64_t fe51[5];
+__extension__ typedef unsigned __int128 uint128_t;
+
+#define FE51_MASK 0x7ffffffffffffULL
+
+static inline uint64_t load64_le(const uint8_t *src)
+{
+    uint64_t w = 0;
+    int i;
+
+    for (i = 7; i >= 0; --i)
+        w = (w << 8) | src[i];
+    return w;
+}
+
+static inline void store64_le(uint8_t *dst, uint64_t w)
+{
+    int i;
+
+    for (i = 0; i < 8; ++i, w >>= 8)
+        dst[i] = (uint8_t)w;
+}
+
+static inline void fe51_frombytes(fe51 h, const uint8_t s[32])
+{
+    h[0] = load64_le(s) & FE51_MASK;
+    h[1] = (load64_le(s + 6) >> 3) & FE51_MASK;
+    h[2] = (load64_le(s + 12) >> 6) & FE51_MASK;
+    h[3] = (load64_le(s + 19) >> 1) & FE51_MASK;
+    h[4] = (load64_le(s + 24) >> 12) & FE51_MASK;
+}
+
+static inline void fe51_carry(uint64_t t[5])
+{
+    t[1] += t[0] >> 51;
+    t[0] &= FE51_MASK;
+    t[2] += t[1] >> 51;
+    t[1] &= FE51_MASK;
+    t[3] += t[2] >> 51;
+    t[2] &= FE51_MASK;
+    t[4] += t[3] >> 51;
+    t[3] &= FE51_MASK;
+    t[0] += 19 * (t[4] >> 51);
+    t[4] &= FE51_MASK;
+}
+
+static inline void fe51_tobytes(uint8_t s[32], const fe51 f)
+{
+    uint64_t t[5];
+
+    memcpy(t, f, sizeof(t));
+    fe51_carry(t);
+    fe51_carry(t);
+
+    /* Now below 2^255, add 19 to detect values of at least p. */
+    t[0] += 19;
+    fe51_carry(t);
+
+    /* Subtract the 19 back while offsetting by 2^255, then drop 2^255. */
+    t[0] += 0x8000000000000ULL - 19;
+    t[1] += 0x8000000000000ULL - 1;
+    t[2] += 0x8000000000000ULL - 1;
+    t[3] += 0x8000000000000ULL - 1;
+    t[4] += 0x8000000000000ULL - 1;
+    t[1] += t[0] >> 51;
+    t[0] &= FE51_MASK;
+    t[2] += t[1] >> 51;
+    t[1] &= FE51_MASK;
+    t[3] += t[2] >> 51;
+    t[2] &= FE51_MASK;
+    t[4] += t[3] >> 51;
+    t[3] &= FE51_MASK;
+    t[4] &= FE51_MASK;
+
+    store64_le(s, t[0] | (t[1] << 51));
+    store64_le(s + 8, (t[1] >> 13) | (t[2] << 38));
+    store64_le(s + 16, (t[2] >> 26) | (t[3] << 25));
+    store64_le(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+static inline void fe51_add(fe51 h, const fe51 f, const fe51 g)
+{
+    int i;
+
+    for (i = 0; i < 5; ++i)
+        h[i] = f[i] + g[i];
+}
+
+/* Adds 2p before subtracting, so that limbs never underflow. */
+static inline void fe51_sub(fe51 h, const fe51 f, const fe51 g)
+{
+    uint64_t t[5];
+
+    memcpy(t, g, sizeof(t));
+    fe51_carry(t);
+    h[0] = (f[0] + 0xfffffffffffdaULL) - t[0];
+    h[1] = (f[1] + 0xffffffffffffeULL) - t[1];
+    h[2] = (f[2] + 0xffffffffffffeULL) - t[2];
+    h[3] = (f[3] + 0xffffffffffffeULL) - t[3];
+    h[4] = (f[4] + 0xffffffffffffeULL) - t[4];
+}
+
+static inline void fe51_reduce(fe51 h, uint128_t r0, uint128_t r1, uint128_t r2, uint128_t r3, uint128_t r4)
+{
+    uint64_t carry;
+
+    r1 += (uint64_t)(r0 >> 51);
+    h[0] = (uint64_t)r0 & FE51_MASK;
+    r2 += (uint64_t)(r1 >> 51);
+    h[1] = (uint64_t)r1 & FE51_MASK;
+    r3 += (uint64_t)(r2 >> 51);
+    h[2] = (uint64_t)r2 & FE51_MASK;
+    r4 += (uint64_t)(r3 >> 51);
+    h[3] = (uint64_t)r3 & FE51_MASK;
+    carry = (uint64_t)(r4 >> 51);
+    h[4] = (uint64_t)r4 & FE51_MASK;
+    h[0] += 19 * carry;
+    h[1] += h[0] >> 51;
+    h[0] &= FE51_MASK;
+}
+
+static inline void fe51_mul(fe51 h, const fe51 f, const fe51 g)
+{
+    const uint64_t f1_19 = 19 * f[1], f2_19 = 19 * f[2], f3_19 = 19 * f[3], f4_19 = 19 * f[4];
+    const uint128_t r0 = (uint128_t)f[0] * g[0] + (uint128_t)f1_19 * g[4] + (uint128_t)f2_19 * g[3] +
+                         (uint128_t)f3_19 * g[2] + (uint128_t)f4_19 * g[1];
+    const uint128_t r1 = (uint128_t)f[0] * g[1] + (uint128_t)f[1] * g[0] + (uint128_t)f2_19 * g[4] +
+                         (uint128_t)f3_19 * g[3] + (uint128_t)f4_19 * g[2];
+    const uint128_t r2 = (uint128_t)f[0] * g[2] + (uint128_t)f[1] * g[1] + (uint128_t)f[2] * g[0] +
+                         (uint128_t)f3_19 * g[4] + (uint128_t)f4_19 * g[3];
+    const uint128_t r3 = (uint128_t)f[0] * g[3] + (uint128_t)f[1] * g[2] + (uint128_t)f[2] * g[1] +
+                         (uint128_t)f[3] * g[0] + (uint128_t)f4_19 * g[4];
+    const uint128_t r4 = (uint128_t)f[0] * g[4] + (uint128_t)f[1] * g[3] + (uint128_t)f[2] * g[2] +
+                         (uint128_t)f[3] * g[1] + (uint128_t)f[4] * g[0];
+
+    fe51_reduce(h, r0, r1, r2, r3, r4);
+}
+
+static inline void fe51_sq(fe51 h, const fe51 f)
+{
+    const uint64_t f0_2 = 2 * f[0], f1_2 = 2 * f[1];
+    const uint64_t f1_38 = 38 * f[1], f2_38 = 38 * f[2], f3_38 = 38 * f[3];
+    const uint64_t f3_19 = 19 * f[3], f4_19 = 19 * f[4];
+    const uint128_t r0 = (uint128_t)f[0] * f[0] + (uint128_t)f1_38 * f[4] + (uint128_t)f2_38 * f[3];
+    const uint128_t r1 = (uint128_t)f0_2 * f[1] + (uint128_t)f2_38 * f[4] + (uint128_t)f3_19 * f[3];
+    const uint128_t r2 = (uint128_t)f0_2 * f[2] + (uint128_t)f[1] * f[1] + (uint128_t)f3_38 * f[4];
+    const uint128_t r3 = (uint128_t)f0_2 * f[3] + (uint128_t)f1_2 * f[2] + (uint128_t)f4_19 * f[4];
+    const uint128_t r4 = (uint128_t)f0_2 * f[4] + (uint128_t)f1_2 * f[3] + (uint128_t)f[2] * f[2];
+
+    fe51_reduce(h, r0, r1, r2, r3, r4);
+}
+
+static inline void fe51_sqn(fe51 h, const fe51 f, int n)
+{
+    fe51_sq(h, f);
+    while (--n > 0)
+        fe51_sq(h, h);
+}
+
+static inline void fe51_mul_a24(fe51 h, const fe51 f)
+{
+    const uint64_t a24 = 121665;
+
+    fe51_reduce(h, (uint128_t)f[0] * a24, (uint128_t)f[1] * a24, (uint128_t)f[2] * a24,
+                (uint128_t)f[3] * a24, (uint128_t)f[4] * a24);
+}
+
+static inline void fe51_cswap(fe51 p, fe51 q, uint64_t b)
+{
+    const uint64_t mask = 0 - b;
+    uint64_t t;
+    int i;
+
+    for (i = 0; i < 5; ++i) {
+        t = mask & (p[i] ^ q[i]);
+        p[i] ^= t;
+        q[i] ^= t;
+    }
+}
+
+/* Computes z^(p - 2) with the ref10 addition chain. */
+static void fe51_invert(fe51 out, const fe51 z)
+{
+    fe51 t0, t1, t2, t3;
+
+    fe51_sq(t0, z);
+    fe51_sqn(t1, t0, 2);
+    fe51_mul(t1, z, t1);
+    fe51_mul(t0, t0, t1);
+    fe51_sq(t2, t0);
+    fe51_mul(t1, t1, t2);
+    fe51_sqn(t2, t1, 5);
+    fe51_mul(t1, t2, t1);
+    fe51_sqn(t2, t1, 10);
+    fe51_mul(t2, t2, t1);
+    fe51_sqn(t3, t2, 20);
+    fe51_mul(t2, t3, t2);
+    fe51_sqn(t2, t2, 10);
+    fe51_mul(t1, t2, t1);
+    fe51_sqn(t2, t1, 50);
+    fe51_mul(t2, t2, t1);
+    fe51_sqn(t3, t2, 100);
+    fe51_mul(t2, t3, t2);
+    fe51_sqn(t2, t2, 50);
+    fe51_mul(t1, t2, t1);
+    fe51_sqn(t1, t1, 5);
+    fe51_mul(out, t1, t0);
+}
+
+/* RFC 7748 Montgomery ladder, leaving the result in projective (x, z). */
+static void fe51_ladder(fe51 x2, fe51 z2, const uint8_t private_key[32], const uint8_t public_key[32])
+{
+    uint8_t k[32];
+    fe51 x1, x3, z3, a, aa, b, bb, e, c, d, da, cb;
+    uint64_t swap = 0, bit;
+    int i;
+
+    memcpy(k, private_key, sizeof(k));
+    k[31] = (k[31] & 127) | 64;
+    k[0] &= 248;
+
+    fe51_frombytes(x1, public_key);
+    memset(x2, 0, sizeof(fe51));
+    x2[0] = 1;
+    memset(z2, 0, sizeof(fe51));
+    memcpy(x3, x1, sizeof(x3));
+    memset(z3, 0, sizeof(z3));
+    z3[0] = 1;
+
+    for (i = 254; i >= 0; --i) {
+        bit = (k[i >> 3] >> (i & 7)) & 1;
+        swap ^= bit;
+        fe51_cswap(x2, x3, swap);
+        fe51_cswap(z2, z3, swap);
+        swap = bit;
+
+        fe51_add(a, x2, z2);
+        fe51_sq(aa, a);
+        fe51_sub(b, x2, z2);
+        fe51_sq(bb, b);
+        fe51_sub(e, aa, bb);
+        fe51_add(c, x3, z3);
+        fe51_sub(d, x3, z3);
+        fe51_mul(da, d, a);
+        fe51_mul(cb, c, b);
+        fe51_add(x3, da, cb);
+        fe51_sq(x3, x3);
+        fe51_sub(z3, da, cb);
+        fe51_sq(z3, z3);
+        fe51_mul(z3, x1, z3);
+        fe51_mul(x2, aa, bb);
+        fe51_mul_a24(z2, e);
+        fe51_add(z2, z2, aa);
+        fe51_mul(z2, e, z2);
+    }
+    fe51_cswap(x2, x3, swap);
+    fe51_cswap(z2, z3, swap);
+    memset(k, 0, sizeof(k));
+}
+
+static void curve25519_ladder(uint8_t out[32], const uint8_t private_key[32], const uint8_t public_key[32])
+{
+    fe51 x, z;
+
+    fe51_ladder(x, z, private_key, public_key);
+    fe51_invert(z, z);
+    fe51_mul(x, x, z);
+    fe51_tobytes(out, x);
+}
+
+/* Shares one inversion across the batch with Montgomery's trick. */
+static void curve25519_derive_public_keys(uint8_t (*public_keys)[32], const uint8_t (*private_keys)[32], size_t count)
+{
+    static const uint8_t basepoint[32] = { 9 };
+    fe51 x[CURVE25519_BATCH], z[CURVE25519_BATCH], prefix[CURVE25519_BATCH], inverse, t;
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        fe51_ladder(x[i], z[i], private_keys[i], basepoint);
+        if (i == 0) {
+            memcpy(prefix[0], z[0], sizeof(fe51));
+        } else {
+            fe51_mul(prefix[i], prefix[i - 1], z[i]);
+        }
+    }
+    fe51_invert(inverse, prefix[count - 1]);
+    for (i = count; i-- > 0;) {
+        if (i > 0) {
+            fe51_mul(t, inverse, prefix[i - 1]);
+            fe51_mul(inverse, inverse, z[i]);
+        } else {
+            memcpy(t, inverse, sizeof(fe51));
+        }
+        fe51_mul(x[i], x[i], t);
+        fe51_tobytes(public_keys[i], x[i]);
+    }
+}
+
+#endif
+
 void curve25519_derive_public_key(uint8_t public_key[32], const uint8_t private_key[32])
 {
     static const uint8_t basepoint[32] = { 9 };
 
-    curve25519_shared_secret(public_key, private_key, basepoint);
+    curve25519_ladder(public_key, private_key, basepoint);
+}
+
+void curve25519_shared_secret(uint8_t shared_secret[32], const uint8_t private_key[32], const uint8_t public_key[32])
+{
+    curve25519_ladder(shared_secret, private_key, public_key);
 }
 
 void curve25519_generate_private_key(uint8_t private_key[32])
@@ -176,3 +498,28 @@ void curve25519_generate_private_key(uint8_t private_key[32])
     private_key[31] = (private_key[31] & 127) | 64;
     private_key[0] &= 248;
 }
+
+void curve25519_generate_keypairs(uint8_t (*private_keys)[32], uint8_t (*public_keys)[32], size_t count)
+{
+    size_t i, chunk;
+
+    if (count == 0)
+        return;
+    /* One PRNG call for the whole batch. */
+    pp_assert(pp_prng_do((uint8_t *)private_keys, count * 32));
+    for (i = 0; i < count; ++i) {
+        private_keys[i][31] = (private_keys[i][31] & 127) | 64;
+        private_keys[i][0] &= 248;
+    }
+    for (i = 0; i < count; i += chunk) {
+        chunk = count - i < CURVE25519_BATCH ? count - i : CURVE25519_BATCH;
+#if PARTOUT_X25519_PORTABLE
+        size_t j;
+
+        for (j = 0; j < chunk; ++j)
+            curve25519_derive_public_key(public_keys[i + j], private_keys[i + j]);
+#else
+        curve25519_derive_public_keys(public_keys + i, (const uint8_t (*)[32])(private_keys + i), chunk);
+#endif
+    }
+}
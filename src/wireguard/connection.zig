@@ -240,8 +240,8 @@ const WireGuardConnection = struct {
     }
 
     fn readDataCount(self: *const WireGuardConnection) ?api.DataCount {
-        return self.adapter.dataCountFromRuntimeConfig(self.allocator) catch |err| {
-            log.writef(.debug, "Unable to fetch runtime configuration: {s}", .{@errorName(err)});
+        return self.adapter.dataCount() orelse {
+            log.write(.debug, "Unable to fetch runtime stats");
             return null;
         };
     }
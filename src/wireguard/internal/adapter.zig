@@ -390,17 +390,16 @@ pub const WireGuardAdapter = struct {
         self.controller.clearTunnelSettings(false);
     }
 
-    pub fn dataCountFromRuntimeConfig(
-        self: *const WireGuardAdapter,
-        allocator: std.mem.Allocator,
-    ) impl.Error!?api.DataCount {
+    pub fn dataCount(self: *const WireGuardAdapter) ?api.DataCount {
         const handle = switch (self.state) {
             .started => |value| value,
             .stopped, .temporary_shutdown => return null,
         };
-        const text = (try self.backend.getConfig(allocator, handle)) orelse return null;
-        defer allocator.free(text);
-        return uapi.parseRuntimeDataCount(text);
+        const stats = self.backend.getStats(handle) orelse return null;
+        return .{
+            .received = stats.received,
+            .sent = stats.sent,
+        };
     }
 };
 
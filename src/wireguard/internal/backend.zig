@@ -30,6 +30,14 @@ pub const StartTunnel = struct {
     }
 };
 
+/// Runtime counters summed over all peers.
+pub const Stats = struct {
+    received: u64 = 0,
+    sent: u64 = 0,
+    last_handshake_sec: i64 = 0,
+    peers_count: usize = 0,
+};
+
 pub const Backend = struct {
     ptr: ?*anyopaque = null,
     vtable: *const VTable,
@@ -38,6 +46,7 @@ pub const Backend = struct {
         turn_on: *const fn (?*anyopaque, std.mem.Allocator, [:0]const u8, StartTunnel) Error!i32,
         turn_off: *const fn (?*anyopaque, i32) void,
         get_config: *const fn (?*anyopaque, std.mem.Allocator, i32) Error!?[]u8,
+        get_stats: *const fn (?*anyopaque, i32) ?Stats,
         set_config: *const fn (?*anyopaque, std.mem.Allocator, i32, [:0]const u8) Error!i64,
         socket_descriptors: *const fn (?*anyopaque, std.mem.Allocator, i32) Error![]net.SocketDescriptor,
         bump_sockets: *const fn (?*anyopaque, i32, bool) void,
@@ -65,6 +74,12 @@ pub const Backend = struct {
         return self.vtable.get_config(self.ptr, allocator, handle);
     }
 
+    /// Reads the runtime counters without exposing the UAPI text, which
+    /// `getConfig` should only return for debugging.
+    pub fn getStats(self: Backend, handle: i32) ?Stats {
+        return self.vtable.get_stats(self.ptr, handle);
+    }
+
     pub fn setConfig(
         self: Backend,
         allocator: std.mem.Allocator,
@@ -99,6 +114,7 @@ const go_backend_vtable = Backend.VTable{
     .turn_on = cTurnOn,
     .turn_off = cTurnOff,
     .get_config = cGetConfig,
+    .get_stats = cGetStats,
     .set_config = cSetConfig,
     .socket_descriptors = cSocketDescriptors,
     .bump_sockets = cBumpSockets,
@@ -152,6 +168,17 @@ fn cGetConfig(
     return try allocator.dupe(u8, std.mem.span(c_config));
 }
 
+fn cGetStats(_: ?*anyopaque, handle: i32) ?Stats {
+    var stats: c.pp_wg_stats = undefined;
+    if (c.pp_wg_get_stats(handle, &stats, null, 0) != 0) return null;
+    return .{
+        .received = stats.rx_bytes,
+        .sent = stats.tx_bytes,
+        .last_handshake_sec = stats.last_handshake_sec,
+        .peers_count = stats.peers_count,
+    };
+}
+
 fn cSetConfig(
     _: ?*anyopaque,
     _: std.mem.Allocator,
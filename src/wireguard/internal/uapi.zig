@@ -89,24 +89,6 @@ pub fn buildEndpointConfiguration(
     return aw.toOwnedSliceSentinel(0);
 }
 
-pub fn parseRuntimeDataCount(text: []const u8) ?api.DataCount {
-    var received: ?u64 = null;
-    var sent: ?u64 = null;
-    var lines = std.mem.splitScalar(u8, text, '\n');
-    while (lines.next()) |line| {
-        if (received == null and std.mem.startsWith(u8, line, "rx_bytes=")) {
-            received = std.fmt.parseInt(u64, line["rx_bytes=".len..], 10) catch null;
-        } else if (sent == null and std.mem.startsWith(u8, line, "tx_bytes=")) {
-            sent = std.fmt.parseInt(u64, line["tx_bytes=".len..], 10) catch null;
-        }
-        if (received != null and sent != null) break;
-    }
-    return .{
-        .received = received orelse return null,
-        .sent = sent orelse return null,
-    };
-}
-
 fn resolvedEndpoint(
     map: []const resolver.ResolvedEndpoint,
     source: api.Endpoint,
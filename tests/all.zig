@@ -19,20 +19,29 @@ comptime {
     _ = @import("core/actor.zig");
     _ = @import("core/concurrency.zig");
     _ = @import("core/logging.zig");
+    _ = @import("core/logging_queue.zig");
+    _ = @import("core/memory.zig");
+    _ = @import("core/metrics.zig");
+    _ = @import("core/prefix_trie.zig");
+    _ = @import("core/profile_cache.zig");
     _ = @import("core/api.zig");
     _ = @import("core/api_extensions.zig");
     _ = @import("core/registry.zig");
+    _ = @import("core/timer_wheel.zig");
     _ = @import("core/util.zig");
     _ = @import("core/uuid.zig");
     _ = @import("net/connection.zig");
     _ = @import("net/daemon.zig");
     _ = @import("net/io.zig");
     _ = @import("net/looper.zig");
+    _ = @import("net/looper_batch.zig");
     _ = @import("net/looper_queue.zig");
     _ = @import("net/mux.zig");
     _ = @import("net/platform.zig");
     _ = @import("net/platform_dns.zig");
     if (source.openvpn_enabled) {
+        _ = @import("openvpn/c/decompress.zig");
+        _ = @import("openvpn/c/mss_fix.zig");
         _ = @import("openvpn/configuration.zig");
         _ = @import("openvpn/connection.zig");
         _ = @import("openvpn/exports.zig");
@@ -49,6 +58,7 @@ comptime {
         _ = @import("openvpn/internal/packet.zig");
         _ = @import("openvpn/internal/processing.zig");
         _ = @import("openvpn/internal/push.zig");
+        _ = @import("openvpn/internal/routes.zig");
         _ = @import("openvpn/internal/serialization.zig");
         _ = @import("openvpn/internal/session.zig");
         _ = @import("openvpn/internal/session_context.zig");
@@ -59,6 +69,7 @@ comptime {
         _ = @import("openvpn/serializer.zig");
     }
     if (source.wireguard_enabled) {
+        _ = @import("wireguard/c/x25519.zig");
         _ = @import("wireguard/connection.zig");
         _ = @import("wireguard/exports.zig");
         _ = @import("wireguard/parser.zig");
@@ -474,6 +474,87 @@ test "round-trips tunnel remote info wrappers" {
     try expectRoundTrip(api.TunnelRemoteInfoWrapper, tunnel_remote_info_json);
 }
 
+test "streams large profiles like the tree parser with fewer allocations" {
+    const allocator = std.testing.allocator;
+    const json = try largeProfileJson(allocator, 64, 32);
+    defer allocator.free(json);
+
+    var streamed_counter = std.testing.FailingAllocator.init(allocator, .{});
+    var streamed = try api.Profile.parse(streamed_counter.allocator(), json);
+    defer streamed.deinit(streamed_counter.allocator());
+
+    var tree_counter = std.testing.FailingAllocator.init(allocator, .{});
+    var parsed = try util.parseJsonValue(tree_counter.allocator(), json);
+    var tree = api.Profile.parseValue(tree_counter.allocator(), parsed.value) catch |err| {
+        parsed.deinit();
+        return err;
+    };
+    parsed.deinit();
+    defer tree.deinit(tree_counter.allocator());
+
+    try std.testing.expectEqual(@as(usize, 64), streamed.modules.len);
+    const streamed_json = try util.encodeJsonValue(allocator, &streamed);
+    defer allocator.free(streamed_json);
+    const tree_json = try util.encodeJsonValue(allocator, &tree);
+    defer allocator.free(tree_json);
+    try std.testing.expectEqualStrings(tree_json, streamed_json);
+
+    // The tree holds every key and value before the model is built
+    try std.testing.expect(streamed_counter.allocations < tree_counter.allocations);
+    try std.testing.expect(streamed_counter.allocated_bytes < tree_counter.allocated_bytes);
+}
+
+test "streams tagged modules whose value precedes the discriminator" {
+    const allocator = std.testing.allocator;
+    var module = try api.TaggedModule.parse(allocator,
+        \{"value":{"id":"00000000-0000-0000-0000-000000000104","mtu":1380},"extra":[1,{"a":null}],"type":"IP"}
+    );
+    defer module.deinit(allocator);
+    try std.testing.expectEqual(@as(i32, 1380), module.IP.mtu.?);
+
+    var info: api.JsonErrorInfo = .{};
+    try std.testing.expectError(
+        error.InvalidModel,
+        api.TaggedModule.parseWithErrorInfo(allocator,
+            \{"type":"IP"}
+        , &info),
+    );
+    try std.testing.expectEqualStrings("value", info.key orelse return error.TestUnexpectedResult);
+}
+
+test "rejects malformed streamed JSON" {
+    const allocator = std.testing.allocator;
+    const inputs = [_][]const u8{
+        \{"name":"Trailing","id":"00000000-0000-0000-0000-000000000100","modules":[],"activeModulesIds":[]} x
+        ,
+        \{"name":"Duplicate","name":"Key","id":"00000000-0000-0000-0000-000000000100","modules":[],"activeModulesIds":[]}
+        ,
+        \{"name":"Truncated","id":"00000000-0000-0000-0000-000000000100","modules":[
+        ,
+    };
+    for (inputs) |input| {
+        try std.testing.expectError(error.InvalidJson, api.Profile.parse(allocator, input));
+    }
+    try std.testing.expectError(error.InvalidModel, api.Profile.parse(allocator, "[]"));
+}
+
+test "frees partially streamed profiles on allocation failures" {
+    try std.testing.checkAllAllocationFailures(std.testing.allocator, parseAndFreeProfile, .{tagged_profile_json});
+}
+
+test "encodes into caller-owned writers" {
+    const allocator = std.testing.allocator;
+    var profile = try api.Profile.parse(allocator, tagged_profile_json);
+    defer profile.deinit(allocator);
+
+    const expected = try util.encodeJsonValue(allocator, &profile);
+    defer allocator.free(expected);
+    var buffer: [8192]u8 = undefined;
+    var writer: std.Io.Writer = .fixed(&buffer);
+    try api.encodeJsonWriter(&writer, &profile);
+    try std.testing.expectEqualStrings(expected, writer.buffered());
+}
+
 fn expectAddress(raw: []const u8, family: api.Address.Family) !void {
     const parsed = api.Address.parseRaw(raw) orelse return error.TestUnexpectedResult;
     try std.testing.expectEqual(family, parsed.family);
@@ -562,6 +643,50 @@ fn encodedFromJson(comptime T: type, json: []const u8) ![]u8 {
     return util.encodeJsonValue(allocator, &value);
 }
 
+fn parseAndFreeProfile(allocator: std.mem.Allocator, json: []const u8) !void {
+    var profile = try api.Profile.parse(allocator, json);
+    profile.deinit(allocator);
+}
+
+/// Builds a profile of `module_count` IP modules with `route_count` routes
+/// per family, like a provider profile with large route lists.
+fn largeProfileJson(allocator: std.mem.Allocator, module_count: usize, route_count: usize) ![]u8 {
+    var out: std.Io.Writer.Allocating = .init(allocator);
+    errdefer out.deinit();
+    const w = &out.writer;
+    try w.writeAll(
+        \{"version":1,"id":"00000000-0000-0000-0000-000000000100","name":"Large","modules":[
+    );
+    for (0..module_count) |module_index| {
+        if (module_index > 0) try w.writeAll(",");
+        try w.print(
+            \{{"type":"IP","value":{{"id":"00000000-0000-0000-0000-{d:0>12}","ipv4":{{"subnets":["10.8.0.2/24"],"includedRoutes":[
+        , .{module_index + 1});
+        for (0..route_count) |route_index| {
+            if (route_index > 0) try w.writeAll(",");
+            try w.print(
+                \{{"destination":"10.{d}.{d}.0/24","gateway":"10.8.0.1"}}
+            , .{ module_index, route_index });
+        }
+        try w.writeAll(
+            \],"excludedRoutes":[]},"ipv6":{"subnets":["2001:db8:1::2/64"],"includedRoutes":[
+        );
+        for (0..route_count) |route_index| {
+            if (route_index > 0) try w.writeAll(",");
+            try w.print(
+                \{{"destination":"2001:db8:{x}:{x}::/64"}}
+            , .{ module_index, route_index });
+        }
+        try w.writeAll(
+            \],"excludedRoutes":[]},"mtu":1380}}
+        );
+    }
+    try w.writeAll(
+        \],"activeModulesIds":["00000000-0000-0000-0000-000000000001"]}
+    );
+    return out.toOwnedSlice();
+}
+
 fn parseFromJson(comptime T: type, allocator: std.mem.Allocator, json: []const u8) !T {
     if (comptime std.meta.hasFn(T, "parse")) {
         return T.parse(allocator, json);
@@ -91,6 +91,35 @@ test "private data flag round-trips" {
     try std.testing.expect(logging.logsPrivateData());
 }
 
+test "disabled levels are dropped before formatting" {
+    const FormattedValue = struct {
+        var formatted = false;
+
+        pub fn logging_formatter(
+            allocator: std.mem.Allocator,
+            _: @This(),
+        ) ![]const u8 {
+            formatted = true;
+            return allocator.dupe(u8, "value");
+        }
+    };
+
+    CapturingLogger.reset();
+    logging.init(true, CapturingLogger.log);
+    defer logging.deinit();
+    logging.setLevel(.notice);
+    try std.testing.expect(!logging.isEnabled(.info));
+
+    logging.writef(.debug, "{s}", .{FormattedValue{}});
+    logging.write(.info, "ignored");
+    try std.testing.expect(!FormattedValue.formatted);
+    try std.testing.expectEqualStrings("", CapturingLogger.lastMessage());
+
+    logging.writef(.notice, "{s}", .{FormattedValue{}});
+    try std.testing.expect(FormattedValue.formatted);
+    try std.testing.expectEqualStrings("value", CapturingLogger.lastMessage());
+}
+
 test "logging is disabled without callback" {
     logging.init(false, null);
     defer logging.deinit();
@@ -194,6 +223,20 @@ test "C log messages are forwarded without scanning or copying" {
     try std.testing.expectEqual(@intFromPtr(message.ptr), TestLogger.message_address);
 }
 
+test "C callers skip the disabled levels before formatting" {
+    const C = struct {
+        extern "c" fn partout_log_enabled(level: c_int) bool;
+    };
+
+    try std.testing.expect(!C.partout_log_enabled(@intFromEnum(logging.Level.fault)));
+    logging.init(false, CapturingLogger.log);
+    defer logging.deinit();
+    logging.setLevel(.notice);
+    try std.testing.expect(C.partout_log_enabled(@intFromEnum(logging.Level.fault)));
+    try std.testing.expect(C.partout_log_enabled(@intFromEnum(logging.Level.notice)));
+    try std.testing.expect(!C.partout_log_enabled(@intFromEnum(logging.Level.info)));
+}
+
 test "duration helpers log compact time representations" {
     CapturingLogger.reset();
     logging.init(false, CapturingLogger.log);
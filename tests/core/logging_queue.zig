@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const source = @import("source");
+const core = source.core;
+const queue = source.core_logging_queue;
+
+const Pipeline = queue.Pipeline;
+const Ring = queue.Ring;
+
+/// Collects the delivered messages, and blocks while `blocked` is set.
+const CollectingSink = struct {
+    mutex: core.Mutex = .{},
+    messages: std.ArrayList([]u8) = .empty,
+    blocked: std.atomic.Value(bool) = .init(false),
+
+    fn deinit(self: *CollectingSink) void {
+        self.mutex.deinit();
+        for (self.messages.items) |message| std.testing.allocator.free(message);
+        self.messages.deinit(std.testing.allocator);
+    }
+
+    fn sink(self: *CollectingSink) queue.Sink {
+        return .{ .context = self, .callback = collect };
+    }
+
+    fn collect(raw: ?*anyopaque, _: c_int, message: [:0]const u8) void {
+        const self: *CollectingSink = @ptrCast(@alignCast(raw.?));
+        while (self.blocked.load(.acquire)) {
+            std.Thread.yield() catch {};
+        }
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        const copy = std.testing.allocator.dupe(u8, message) catch @panic("OOM");
+        self.messages.append(std.testing.allocator, copy) catch @panic("OOM");
+    }
+
+    fn count(self: *CollectingSink) usize {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        return self.messages.items.len;
+    }
+};
+
+test "log ring wraps records in FIFO order until full" {
+    var ring = try Ring.init(std.testing.allocator, 256);
+    defer ring.deinit(std.testing.allocator);
+    try std.testing.expect(ring.peek() == null);
+
+    // Short records take 32 bytes, the long one 48.
+    for (0..7) |index| {
+        var buffer: [8]u8 = undefined;
+        const message = try std.fmt.bufPrint(&buffer, "m{d}", .{index});
+        try std.testing.expect(ring.push(3, index, message));
+    }
+    const long = "a message across the end";
+    try std.testing.expect(!ring.push(1, 100, long));
+
+    // Padding skips the tail of the storage.
+    for (0..3) |index| {
+        const record = ring.peek().?;
+        try std.testing.expectEqual(@as(u64, index), record.timestamp_ns);
+        ring.pop(record);
+    }
+    try std.testing.expect(ring.push(1, 100, long));
+    for (3..7) |index| {
+        const record = ring.peek().?;
+        try std.testing.expectEqual(@as(u64, index), record.timestamp_ns);
+        try std.testing.expectEqual(@as(c_int, 3), record.level);
+        ring.pop(record);
+    }
+    const record = ring.peek().?;
+    try std.testing.expectEqual(@as(c_int, 1), record.level);
+    try std.testing.expectEqualStrings(long, record.message);
+    ring.pop(record);
+    try std.testing.expect(ring.isEmpty());
+}
+
+test "log pipeline delivers the messages of every thread in order" {
+    var collector = CollectingSink{};
+    defer collector.deinit();
+    const pipeline = try Pipeline.create(std.testing.allocator, collector.sink(), .{
+        .ring_size = 64 * 1024,
+        .max_rings = 2,
+    });
+    defer pipeline.destroy();
+    try pipeline.start();
+
+    // One thread more than the rings, sharing the fallback ring.
+    const Producer = struct {
+        fn run(target: *Pipeline, id: usize) void {
+            defer target.releaseThread();
+            for (0..200) |index| {
+                var buffer: [32]u8 = undefined;
+                const message = std.fmt.bufPrint(&buffer, "{d}:{d}", .{ id, index }) catch unreachable;
+                std.debug.assert(target.push(3, message));
+            }
+        }
+    };
+    var threads: [3]std.Thread = undefined;
+    for (&threads, 0..) |*thread, id| thread.* = try std.Thread.spawn(.{}, Producer.run, .{ pipeline, id });
+    for (threads) |thread| thread.join();
+    pipeline.flush();
+
+    try std.testing.expectEqual(@as(usize, 600), collector.count());
+    var next = [_]usize{0} ** threads.len;
+    for (collector.messages.items) |message| {
+        var parts = std.mem.splitScalar(u8, message, ':');
+        const id = try std.fmt.parseInt(usize, parts.next().?, 10);
+        const index = try std.fmt.parseInt(usize, parts.next().?, 10);
+        try std.testing.expectEqual(next[id], index);
+        next[id] += 1;
+    }
+}
+
+test "log pipeline reuses the rings of exited threads" {
+    var collector = CollectingSink{};
+    defer collector.deinit();
+    const pipeline = try Pipeline.create(std.testing.allocator, collector.sink(), .{});
+    defer pipeline.destroy();
+    try pipeline.start();
+
+    const Producer = struct {
+        fn run(target: *Pipeline) void {
+            defer target.releaseThread();
+            std.debug.assert(target.push(3, "hello"));
+        }
+    };
+    for (0..4) |_| {
+        const thread = try std.Thread.spawn(.{}, Producer.run, .{pipeline});
+        thread.join();
+    }
+    pipeline.flush();
+
+    try std.testing.expectEqual(@as(usize, 4), collector.count());
+    try std.testing.expectEqual(@as(usize, 1), pipeline.ring_count.load(.acquire));
+}
+
+test "log pipeline applies the overflow policy to full rings" {
+    inline for (.{ queue.OverflowPolicy.drop, queue.OverflowPolicy.dispatch }) |policy| {
+        var collector = CollectingSink{};
+        defer collector.deinit();
+        const pipeline = try Pipeline.create(std.testing.allocator, collector.sink(), .{
+            .ring_size = 256,
+            .overflow = policy,
+        });
+        defer pipeline.destroy();
+
+        // Not draining yet, 8 records fit.
+        var queued: usize = 0;
+        for (0..10) |_| {
+            if (pipeline.push(3, "message")) queued += 1;
+        }
+        try pipeline.start();
+        pipeline.flush();
+        pipeline.releaseThread();
+
+        switch (policy) {
+            .drop => {
+                try std.testing.expectEqual(@as(usize, 10), queued);
+                try std.testing.expectEqual(@as(usize, 9), collector.count());
+                try std.testing.expectEqualStrings("Dropped 2 log messages", collector.messages.items[0]);
+            },
+            .dispatch => {
+                try std.testing.expectEqual(@as(usize, 8), queued);
+                try std.testing.expectEqual(@as(usize, 8), collector.count());
+            },
+        }
+    }
+}
+
+test "log pipeline rejects messages longer than half a ring" {
+    var collector = CollectingSink{};
+    defer collector.deinit();
+    const pipeline = try Pipeline.create(std.testing.allocator, collector.sink(), .{
+        .ring_size = 256,
+    });
+    defer pipeline.destroy();
+    defer pipeline.releaseThread();
+
+    const long = [_]u8{'a'} ** 200;
+    try std.testing.expect(!pipeline.push(3, &long));
+}
+
+test "log pipeline flush returns without a drainer" {
+    var collector = CollectingSink{};
+    defer collector.deinit();
+    const pipeline = try Pipeline.create(std.testing.allocator, collector.sink(), .{
+        .ring_size = 256,
+    });
+    defer pipeline.destroy();
+    defer pipeline.releaseThread();
+
+    try std.testing.expect(pipeline.push(3, "queued"));
+    pipeline.flush();
+    try std.testing.expectEqual(@as(usize, 0), collector.count());
+}
+
+// Handshake-like load
+//
+// A TLS handshake logs a few lines per control packet. Here the host logger
+// stays blocked while several threads log, and the threads complete without
+// waiting for it, which a synchronous logger would not allow.
+
+test "log-heavy handshakes do not wait for a blocked host logger" {
+    var collector = CollectingSink{};
+    defer collector.deinit();
+    collector.blocked.store(true, .release);
+    const pipeline = try Pipeline.create(std.testing.allocator, collector.sink(), .{
+        .ring_size = 64 * 1024,
+    });
+    defer pipeline.destroy();
+    try pipeline.start();
+
+    const Handshake = struct {
+        fn run(target: *Pipeline, id: usize) void {
+            defer target.releaseThread();
+            for (0..100) |packet| {
+                var buffer: [64]u8 = undefined;
+                for ([_][]const u8{ "Control: Read packet", "Write control packet", "Send ack" }) |event| {
+                    const message = std.fmt.bufPrint(&buffer, "[{d}] {s} #{d}", .{ id, event, packet }) catch unreachable;
+                    std.debug.assert(target.push(3, message));
+                }
+            }
+        }
+    };
+    var threads: [4]std.Thread = undefined;
+    for (&threads, 0..) |*thread, id| thread.* = try std.Thread.spawn(.{}, Handshake.run, .{ pipeline, id });
+    for (threads) |thread| thread.join();
+
+    // The drainer is stuck on the first message.
+    try std.testing.expectEqual(@as(usize, 0), collector.count());
+    collector.blocked.store(false, .release);
+    pipeline.flush();
+    try std.testing.expectEqual(@as(usize, 1200), collector.count());
+}
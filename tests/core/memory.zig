@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const source = @import("source");
+const core = source.core;
+const c_common = source.c_common;
+
+const AccountingAllocator = core.AccountingAllocator;
+const Metrics = core.Metrics;
+
+test "accounting allocator counts live and peak bytes" {
+    var accounting: AccountingAllocator = .init(std.testing.allocator, null);
+    const allocator = accounting.allocator();
+
+    const first = try allocator.alloc(u8, 100);
+    const second = try allocator.alloc(u32, 50);
+    try std.testing.expectEqual(@as(u64, 300), accounting.usage().bytes);
+
+    allocator.free(first);
+    try std.testing.expectEqual(@as(u64, 200), accounting.usage().bytes);
+    try std.testing.expectEqual(@as(u64, 300), accounting.usage().peak_bytes);
+
+    var list: std.ArrayList(u8) = .empty;
+    try list.appendNTimes(allocator, 0, 1000);
+    try std.testing.expectEqual(@as(u64, 200 + list.capacity), accounting.usage().bytes);
+    list.deinit(allocator);
+    allocator.free(second);
+    try std.testing.expectEqual(core.memory.Usage{
+        .bytes = 0,
+        .peak_bytes = accounting.usage().peak_bytes,
+        .native_bytes = 0,
+    }, accounting.usage());
+    try std.testing.expect(accounting.usage().peak_bytes >= 1200);
+}
+
+test "accounting allocator counts native allocations within its scope" {
+    var accounting: AccountingAllocator = .init(std.testing.allocator, null);
+
+    const outside = c_common.pp_alloc(64);
+    const native = accounting.enterNative();
+    const inside = c_common.pp_alloc(256);
+    const duplicate = c_common.pp_dup("native");
+    const usage = accounting.usage();
+    try std.testing.expect(usage.native_bytes >= 256 + 7);
+    try std.testing.expectEqual(usage.native_bytes, usage.bytes);
+
+    // Nested scopes restore the previous one
+    var other: AccountingAllocator = .init(std.testing.allocator, null);
+    const nested = other.enterNative();
+    c_common.pp_free(c_common.pp_alloc(32));
+    nested.leave();
+    try std.testing.expectEqual(@as(u64, 0), other.usage().bytes);
+    try std.testing.expect(other.usage().peak_bytes >= 32);
+
+    c_common.pp_free(inside);
+    c_common.pp_free(@ptrCast(duplicate));
+    // Freed in scope but allocated outside, never below zero
+    c_common.pp_free(outside);
+    native.leave();
+    try std.testing.expectEqual(@as(u64, 0), accounting.usage().bytes);
+    try std.testing.expectEqual(@as(u64, 0), accounting.usage().native_bytes);
+
+    c_common.pp_free(c_common.pp_alloc(1024));
+    try std.testing.expectEqual(@as(u64, 0), accounting.usage().bytes);
+    try std.testing.expectEqual(usage.peak_bytes, accounting.usage().peak_bytes);
+}
+
+test "accounting allocator mirrors the usage into the memory gauges" {
+    const metrics = try std.testing.allocator.create(Metrics);
+    defer std.testing.allocator.destroy(metrics);
+    metrics.* = .{};
+
+    var accounting: AccountingAllocator = .init(std.testing.allocator, metrics);
+    const allocator = accounting.allocator();
+    const buffer = try allocator.alloc(u8, 4096);
+    const native = accounting.enterNative();
+    const block = c_common.pp_alloc(128);
+
+    // Published on crossing a granule, not on every allocation
+    const granularity = AccountingAllocator.gauge_granularity;
+    var snapshot = metrics.snapshot();
+    try std.testing.expectEqual(@as(u64, 4096), snapshot.gauge(.memory_bytes));
+    try std.testing.expect(accounting.usage().bytes - snapshot.gauge(.memory_bytes) < granularity);
+    try std.testing.expect(snapshot.gauge(.native_memory_bytes) <= accounting.usage().native_bytes);
+    const more = try allocator.alloc(u8, granularity);
+    snapshot = metrics.snapshot();
+    try std.testing.expectEqual(accounting.usage().bytes, snapshot.gauge(.memory_bytes));
+    try std.testing.expectEqual(accounting.usage().native_bytes, snapshot.gauge(.native_memory_bytes));
+    try std.testing.expect(snapshot.gauge(.native_memory_bytes) >= 128);
+    allocator.free(more);
+
+    c_common.pp_free(block);
+    native.leave();
+    allocator.free(buffer);
+    snapshot = metrics.snapshot();
+    try std.testing.expectEqual(@as(u64, 0), snapshot.gauge(.memory_bytes));
+    try std.testing.expectEqual(@as(u64, 0), snapshot.gauge(.native_memory_bytes));
+    try std.testing.expectEqual(accounting.usage().peak_bytes, snapshot.gauge(.memory_peak_bytes));
+
+    // The peak gauge holds the highest of several sessions
+    var next: AccountingAllocator = .init(std.testing.allocator, metrics);
+    const next_allocator = next.allocator();
+    next_allocator.free(try next_allocator.alloc(u8, 16));
+    try std.testing.expectEqual(accounting.usage().peak_bytes, metrics.snapshot().gauge(.memory_peak_bytes));
+}
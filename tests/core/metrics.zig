@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const core = @import("source").core;
+
+const Metrics = core.Metrics;
+const Histogram = core.metrics.Histogram;
+
+test "metrics aggregate counters recorded from several threads" {
+    const metrics = try std.testing.allocator.create(Metrics);
+    defer std.testing.allocator.destroy(metrics);
+    metrics.* = .{};
+
+    const Worker = struct {
+        fn run(target: *Metrics) void {
+            for (0..1000) |_| {
+                target.increment(.link_read_packets);
+                target.add(.link_read_bytes, 100);
+            }
+        }
+    };
+    var threads: [4]std.Thread = undefined;
+    for (&threads) |*thread| thread.* = try std.Thread.spawn(.{}, Worker.run, .{metrics});
+    for (threads) |thread| thread.join();
+
+    const snapshot = metrics.snapshot();
+    try std.testing.expectEqual(@as(u64, 4000), snapshot.get(.link_read_packets));
+    try std.testing.expectEqual(@as(u64, 400_000), snapshot.get(.link_read_bytes));
+    try std.testing.expectEqual(@as(u64, 0), snapshot.get(.replay_rejects));
+
+    metrics.reset();
+    try std.testing.expectEqual(@as(u64, 0), metrics.snapshot().get(.link_read_packets));
+}
+
+test "histogram percentiles stay within the bucket resolution" {
+    var histogram: Histogram = .{};
+    try std.testing.expectEqual(@as(u64, 0), histogram.summarize().count);
+
+    for (1..1001) |value| histogram.record(value * 1000);
+    const summary = histogram.summarize();
+    try std.testing.expectEqual(@as(u64, 1000), summary.count);
+    try std.testing.expectEqual(@as(u64, 500_500), summary.mean);
+    try std.testing.expectEqual(@as(u64, 1_000_000), summary.max);
+
+    const expected = [_][2]u64{
+        .{ summary.p50, 500_000 },
+        .{ summary.p90, 900_000 },
+        .{ summary.p99, 990_000 },
+        .{ summary.p999, 999_000 },
+    };
+    for (expected) |pair| {
+        try std.testing.expect(pair[0] >= pair[1]);
+        try std.testing.expect(pair[0] <= pair[1] + pair[1] / 8);
+    }
+    try std.testing.expect(summary.p50 <= summary.p90);
+    try std.testing.expect(summary.p99 <= summary.p999);
+}
+
+test "metrics snapshot serializes counters and latencies by name" {
+    var metrics: Metrics = .{};
+    metrics.add(.backpressure_events, 3);
+    metrics.recordLatency(.tun_to_link, 7);
+    metrics.set(.link_read_batch_limit, 64);
+    try std.testing.expectEqual(@as(u64, 64), metrics.snapshot().gauge(.link_read_batch_limit));
+
+    const json = try core.util.encodeJsonValue(std.testing.allocator, metrics.snapshot());
+    defer std.testing.allocator.free(json);
+
+    var parsed = try std.json.parseFromSlice(std.json.Value, std.testing.allocator, json, .{});
+    defer parsed.deinit();
+    const root = parsed.value.object;
+    try std.testing.expectEqual(@as(i64, 3), root.get("backpressure_events").?.integer);
+    try std.testing.expectEqual(@as(i64, 0), root.get("decrypt_failures_crypto").?.integer);
+    try std.testing.expectEqual(@as(i64, 64), root.get("link_read_batch_limit").?.integer);
+    try std.testing.expectEqual(@as(i64, 0), root.get("tun_read_batch_limit").?.integer);
+    const latency = root.get("latency_ns").?.object;
+    const tun_to_link = latency.get("tun_to_link").?.object;
+    try std.testing.expectEqual(@as(i64, 1), tun_to_link.get("count").?.integer);
+    try std.testing.expectEqual(@as(i64, 7), tun_to_link.get("max").?.integer);
+    try std.testing.expectEqual(@as(i64, 0), latency.get("link_to_tun").?.object.get("count").?.integer);
+}
@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const source = @import("source");
+const prefix_trie = source.core.prefix_trie;
+const Prefix = prefix_trie.Prefix;
+const PrefixTrie = source.core.PrefixTrie;
+
+const Trie = PrefixTrie(u32);
+
+fn v4(raw: []const u8, len: u8) Prefix {
+    return Prefix.parse(.v4, raw, len).?;
+}
+
+fn v6(raw: []const u8, len: u8) Prefix {
+    return Prefix.parse(.v6, raw, len).?;
+}
+
+const EqualValues = struct {
+    pinned: ?Prefix = null,
+
+    pub fn eql(_: EqualValues, lhs: u32, rhs: u32) bool {
+        return lhs == rhs;
+    }
+
+    pub fn isPinned(self: EqualValues, prefix: Prefix) bool {
+        const pinned = self.pinned orelse return false;
+        return pinned.contains(prefix) or prefix.contains(pinned);
+    }
+};
+
+test "prefixes clear host bits and parse by family" {
+    try std.testing.expect(v4("10.1.2.3", 8).eql(v4("10.0.0.0", 8)));
+    try std.testing.expect(!v4("10.1.2.3", 16).eql(v4("10.0.0.0", 16)));
+    try std.testing.expect(v4("10.0.0.0", 8).contains(v4("10.200.0.0", 16)));
+    try std.testing.expect(!v4("10.200.0.0", 16).contains(v4("10.0.0.0", 8)));
+    try std.testing.expect(Prefix.parse(.v4, "10.0.0.0", 33) == null);
+    try std.testing.expect(Prefix.parse(.v4, "2001:db8::", 32) == null);
+    try std.testing.expect(v6("2001:db8:ffff::", 32).eql(v6("2001:db8::", 32)));
+}
+
+test "prefix trie inserts, deduplicates and matches the longest prefix" {
+    const allocator = std.testing.allocator;
+    var trie = Trie.init(.v4);
+    defer trie.deinit(allocator);
+
+    try std.testing.expect(try trie.insert(allocator, v4("10.0.0.0", 8), 1));
+    try std.testing.expect(try trie.insert(allocator, v4("10.1.0.0", 16), 2));
+    try std.testing.expect(try trie.insert(allocator, v4("10.1.128.0", 17), 3));
+    try std.testing.expect(try trie.insert(allocator, v4("0.0.0.0", 0), 4));
+    try std.testing.expect(try trie.insert(allocator, v4("192.168.0.0", 16), 5));
+    try std.testing.expect(!try trie.insert(allocator, v4("10.1.2.3", 16), 6));
+    try std.testing.expectEqual(@as(usize, 5), trie.count);
+
+    try std.testing.expectEqual(@as(?u32, 2), trie.get(v4("10.1.0.0", 16)));
+    try std.testing.expectEqual(@as(?u32, null), trie.get(v4("10.1.0.0", 24)));
+
+    try std.testing.expectEqual(@as(u32, 3), trie.longestMatch(v4("10.1.200.1", 32)).?.value);
+    try std.testing.expectEqual(@as(u32, 2), trie.longestMatch(v4("10.1.1.1", 32)).?.value);
+    try std.testing.expectEqual(@as(u32, 1), trie.longestMatch(v4("10.2.0.1", 32)).?.value);
+    try std.testing.expectEqual(@as(u32, 4), trie.longestMatch(v4("8.8.8.8", 32)).?.value);
+    try std.testing.expect(trie.longestMatch(v4("10.1.200.1", 32)).?.prefix.eql(v4("10.1.128.0", 17)));
+
+    var empty = Trie.init(.v4);
+    defer empty.deinit(allocator);
+    try std.testing.expect(empty.longestMatch(v4("8.8.8.8", 32)) == null);
+}
+
+test "prefix trie enumerates overlapping prefixes" {
+    const allocator = std.testing.allocator;
+    var trie = Trie.init(.v6);
+    defer trie.deinit(allocator);
+    _ = try trie.insert(allocator, v6("2001:db8::", 32), 1);
+    _ = try trie.insert(allocator, v6("2001:db8:1::", 48), 2);
+    _ = try trie.insert(allocator, v6("2001:db8:1:1::", 64), 3);
+    _ = try trie.insert(allocator, v6("2001:db8:2::", 48), 4);
+    _ = try trie.insert(allocator, v6("fd00::", 8), 5);
+
+    var overlaps: std.ArrayList(Trie.Entry) = .empty;
+    defer overlaps.deinit(allocator);
+    try trie.collectOverlaps(allocator, v6("2001:db8:1::", 47), &overlaps);
+    try std.testing.expectEqual(@as(usize, 3), overlaps.items.len);
+    try std.testing.expectEqual(@as(u32, 1), overlaps.items[0].value);
+    try std.testing.expectEqual(@as(u32, 2), overlaps.items[1].value);
+    try std.testing.expectEqual(@as(u32, 3), overlaps.items[2].value);
+
+    try std.testing.expect(trie.overlaps(v6("2001:db8:2:3::", 64)));
+    try std.testing.expect(trie.overlaps(v6("2000::", 4)));
+    try std.testing.expect(!trie.overlaps(v6("2001:db9::", 32)));
+    try std.testing.expect(!trie.overlaps(v6("fe80::", 10)));
+}
+
+test "prefix trie aggregates adjacent halves and redundant prefixes" {
+    const allocator = std.testing.allocator;
+    var trie = Trie.init(.v4);
+    defer trie.deinit(allocator);
+
+    // Four /26 with equal values make a /24
+    _ = try trie.insert(allocator, v4("10.0.0.0", 26), 1);
+    _ = try trie.insert(allocator, v4("10.0.0.64", 26), 1);
+    _ = try trie.insert(allocator, v4("10.0.0.128", 26), 1);
+    _ = try trie.insert(allocator, v4("10.0.0.192", 26), 1);
+    // Redundant within 10.1.0.0/16
+    _ = try trie.insert(allocator, v4("10.1.0.0", 16), 2);
+    _ = try trie.insert(allocator, v4("10.1.5.0", 24), 2);
+    // Differs from the containing prefix
+    _ = try trie.insert(allocator, v4("10.1.6.0", 24), 3);
+    // Adjacent, but not halves of the same prefix
+    _ = try trie.insert(allocator, v4("10.2.1.0", 24), 1);
+    _ = try trie.insert(allocator, v4("10.2.2.0", 24), 1);
+
+    trie.aggregate(EqualValues{});
+    var entries: std.ArrayList(Trie.Entry) = .empty;
+    defer entries.deinit(allocator);
+    try trie.collect(allocator, &entries);
+    try std.testing.expectEqual(trie.count, entries.items.len);
+
+    const expected = [_]struct { Prefix, u32 }{
+        .{ v4("10.0.0.0", 24), 1 },
+        .{ v4("10.1.0.0", 16), 2 },
+        .{ v4("10.1.6.0", 24), 3 },
+        .{ v4("10.2.1.0", 24), 1 },
+        .{ v4("10.2.2.0", 24), 1 },
+    };
+    try std.testing.expectEqual(expected.len, entries.items.len);
+    for (expected, entries.items) |item, entry| {
+        try std.testing.expect(item[0].eql(entry.prefix));
+        try std.testing.expectEqual(item[1], entry.value);
+    }
+}
+
+test "prefix trie never aggregates the halves of the whole space" {
+    const allocator = std.testing.allocator;
+    var trie = Trie.init(.v4);
+    defer trie.deinit(allocator);
+    _ = try trie.insert(allocator, v4("0.0.0.0", 1), 1);
+    _ = try trie.insert(allocator, v4("128.0.0.0", 1), 1);
+
+    trie.aggregate(EqualValues{});
+    try std.testing.expectEqual(@as(usize, 2), trie.count);
+    try std.testing.expectEqual(@as(?u32, null), trie.get(v4("0.0.0.0", 0)));
+}
+
+test "prefix trie leaves pinned prefixes alone" {
+    const allocator = std.testing.allocator;
+    var trie = Trie.init(.v4);
+    defer trie.deinit(allocator);
+    _ = try trie.insert(allocator, v4("10.0.0.0", 25), 1);
+    _ = try trie.insert(allocator, v4("10.0.0.128", 25), 1);
+    _ = try trie.insert(allocator, v4("10.1.0.0", 16), 2);
+    _ = try trie.insert(allocator, v4("10.1.5.0", 24), 2);
+
+    trie.aggregate(EqualValues{ .pinned = v4("10.0.0.128", 26) });
+    try std.testing.expectEqual(@as(usize, 3), trie.count);
+    try std.testing.expectEqual(@as(?u32, 1), trie.get(v4("10.0.0.128", 25)));
+    try std.testing.expectEqual(@as(?u32, null), trie.get(v4("10.0.0.0", 24)));
+    try std.testing.expectEqual(@as(?u32, null), trie.get(v4("10.1.5.0", 24)));
+}
+
+test "prefix trie matches a linear scan over 50k routes and keeps matches when aggregated" {
+    const allocator = std.testing.allocator;
+    const route_count = 50_000;
+    var prng = std.Random.DefaultPrng.init(0x7e1e_0045);
+    const random = prng.random();
+
+    const prefixes = try allocator.alloc(Prefix, route_count);
+    defer allocator.free(prefixes);
+    const values = try allocator.alloc(u32, route_count);
+    defer allocator.free(values);
+    var trie = Trie.init(.v4);
+    defer trie.deinit(allocator);
+    var inserted: usize = 0;
+    for (0..route_count) |_| {
+        var bytes: [16]u8 = @splat(0);
+        // A dense 10.0.0.0/12 block, so that prefixes nest and touch
+        bytes[0] = 10;
+        bytes[1] = random.uintLessThan(u8, 16);
+        bytes[2] = random.int(u8);
+        bytes[3] = random.int(u8);
+        const prefix = Prefix.init(bytes, random.intRangeAtMost(u8, 12, 28));
+        const value = random.uintLessThan(u32, 4);
+        if (try trie.insert(allocator, prefix, value)) {
+            prefixes[inserted] = prefix;
+            values[inserted] = value;
+            inserted += 1;
+        }
+    }
+    try std.testing.expectEqual(inserted, trie.count);
+
+    var probes: [256]Prefix = undefined;
+    var expected: [probes.len]?u32 = undefined;
+    for (&probes, &expected) |*probe, *match| {
+        var bytes: [16]u8 = @splat(0);
+        bytes[0] = 10;
+        bytes[1] = random.uintLessThan(u8, 20);
+        bytes[2] = random.int(u8);
+        bytes[3] = random.int(u8);
+        probe.* = Prefix.init(bytes, 32);
+        match.* = linearMatch(prefixes[0..inserted], values[0..inserted], probe.*);
+        try std.testing.expectEqual(match.*, if (trie.longestMatch(probe.*)) |entry| entry.value else null);
+    }
+
+    trie.aggregate(EqualValues{});
+    try std.testing.expect(trie.count < inserted);
+    for (probes, expected) |probe, match| {
+        try std.testing.expectEqual(match, if (trie.longestMatch(probe)) |entry| entry.value else null);
+    }
+}
+
+fn linearMatch(prefixes: []const Prefix, values: []const u32, address: Prefix) ?u32 {
+    var best: ?usize = null;
+    for (prefixes, 0..) |prefix, index| {
+        if (!prefix.contains(address)) continue;
+        if (best == null or prefixes[best.?].len < prefix.len) best = index;
+    }
+    return if (best) |index| values[index] else null;
+}
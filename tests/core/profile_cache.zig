@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const source = @import("source");
+const api = source.core_api;
+const profile_cache = source.core_profile_cache;
+const util = source.core.util;
+
+test "round-trips profiles through the binary cache" {
+    const allocator = std.testing.allocator;
+    var profile = try api.Profile.parse(allocator, profile_json);
+    defer profile.deinit(allocator);
+
+    const key = profile_cache.contentKey(profile_json);
+    const encoded = try profile_cache.encodeAlloc(allocator, &profile, key);
+    defer allocator.free(encoded);
+    var decoded = try profile_cache.decode(allocator, encoded, key);
+    defer decoded.deinit(allocator);
+
+    const expected = try util.encodeJsonValue(allocator, &profile);
+    defer allocator.free(expected);
+    const actual = try util.encodeJsonValue(allocator, &decoded);
+    defer allocator.free(actual);
+    try std.testing.expectEqualStrings(expected, actual);
+}
+
+test "rejects stale and corrupt cache files" {
+    const allocator = std.testing.allocator;
+    var profile = try api.Profile.parse(allocator, profile_json);
+    defer profile.deinit(allocator);
+
+    const key = profile_cache.contentKey(profile_json);
+    const encoded = try profile_cache.encodeAlloc(allocator, &profile, key);
+    defer allocator.free(encoded);
+
+    // Other contents
+    try std.testing.expectError(
+        error.Stale,
+        profile_cache.decode(allocator, encoded, profile_cache.contentKey("{}")),
+    );
+
+    const damaged = try allocator.dupe(u8, encoded);
+    defer allocator.free(damaged);
+
+    // Other format version
+    damaged[4] +%= 1;
+    try std.testing.expectError(error.Stale, profile_cache.decode(allocator, damaged, key));
+    damaged[4] = encoded[4];
+
+    // Damaged payload
+    damaged[damaged.len - 1] ^= 0xff;
+    try std.testing.expectError(error.Corrupt, profile_cache.decode(allocator, damaged, key));
+    damaged[damaged.len - 1] = encoded[encoded.len - 1];
+
+    // Truncated file and header
+    try std.testing.expectError(error.Corrupt, profile_cache.decode(allocator, damaged[0 .. damaged.len - 1], key));
+    try std.testing.expectError(error.Corrupt, profile_cache.decode(allocator, damaged[0..16], key));
+
+    var restored = try profile_cache.decode(allocator, damaged, key);
+    restored.deinit(allocator);
+}
+
+test "cache files are sealed with a key that is never stored" {
+    const allocator = std.testing.allocator;
+    var profile = try api.Profile.parse(allocator, profile_json);
+    defer profile.deinit(allocator);
+
+    const key = profile_cache.contentKey(profile_json);
+    const encoded = try profile_cache.encodeAlloc(allocator, &profile, key);
+    defer allocator.free(encoded);
+
+    // No private key or secret in the clear, nor the sealing key
+    const private_key = [_]u8{0x01} ** 32;
+    try std.testing.expect(std.mem.indexOf(u8, encoded, &private_key) == null);
+    try std.testing.expect(std.mem.indexOf(u8, encoded, "AQEBAQEBAQEBAQEB") == null);
+    try std.testing.expect(std.mem.indexOf(u8, encoded, "BAUG") == null);
+    try std.testing.expect(std.mem.indexOf(u8, encoded, &key.secret) == null);
+
+    // Written for the same contents, but not sealed by who holds them
+    var forged = key;
+    forged.secret[0] ^= 0xff;
+    try std.testing.expectError(error.Corrupt, profile_cache.decode(allocator, encoded, forged));
+}
+
+test "decodes cached profiles with fewer allocations than JSON" {
+    const allocator = std.testing.allocator;
+    const key = profile_cache.contentKey(profile_json);
+
+    var json_counter = std.testing.FailingAllocator.init(allocator, .{});
+    var parsed = try api.Profile.parse(json_counter.allocator(), profile_json);
+    defer parsed.deinit(json_counter.allocator());
+
+    const encoded = try profile_cache.encodeAlloc(allocator, &parsed, key);
+    defer allocator.free(encoded);
+    var cache_counter = std.testing.FailingAllocator.init(allocator, .{});
+    var decoded = try profile_cache.decode(cache_counter.allocator(), encoded, key);
+    defer decoded.deinit(cache_counter.allocator());
+
+    // Decoding allocates the model only, with no scanner or token buffers
+    try std.testing.expect(cache_counter.allocations <= json_counter.allocations);
+    try std.testing.expect(cache_counter.allocated_bytes < json_counter.allocated_bytes);
+}
+
+test "stores and loads profiles in cache slots" {
+    const allocator = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const cache_root = try std.fmt.allocPrint(allocator, ".zig-cache/tmp/{s}/profiles", .{tmp.sub_path});
+    defer allocator.free(cache_root);
+
+    var profile = try api.Profile.parse(allocator, profile_json);
+    defer profile.deinit(allocator);
+    const key = profile_cache.contentKey(profile_json);
+    try std.testing.expect(try profile_cache.load(allocator, cache_root, key) == null);
+
+    profile_cache.store(allocator, cache_root, key, &profile);
+    var loaded = (try profile_cache.load(allocator, cache_root, key)) orelse
+        return error.TestUnexpectedResult;
+    defer loaded.deinit(allocator);
+    try std.testing.expectEqualStrings(profile.name, loaded.name);
+    try std.testing.expectEqual(profile.modules.len, loaded.modules.len);
+
+    // An edited profile misses, whatever slot it maps to
+    var edited = key;
+    edited.hash[1] +%= 1;
+    try std.testing.expect(try profile_cache.load(allocator, cache_root, edited) == null);
+}
+
+test "starts from a cache hit with less work than from a cold parse" {
+    const allocator = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const cache_root = try std.fmt.allocPrint(allocator, ".zig-cache/tmp/{s}/profiles", .{tmp.sub_path});
+    defer allocator.free(cache_root);
+    const key = profile_cache.contentKey(profile_json);
+
+    // As the daemon loads a profile: parse and store on a miss, load on a hit
+    var cold = std.testing.FailingAllocator.init(allocator, .{});
+    try std.testing.expect(try profile_cache.load(cold.allocator(), cache_root, key) == null);
+    var parsed = try api.Profile.parse(cold.allocator(), profile_json);
+    defer parsed.deinit(cold.allocator());
+    profile_cache.store(cold.allocator(), cache_root, key, &parsed);
+
+    var hit = std.testing.FailingAllocator.init(allocator, .{});
+    var loaded = (try profile_cache.load(hit.allocator(), cache_root, key)) orelse
+        return error.TestUnexpectedResult;
+    defer loaded.deinit(hit.allocator());
+
+    const expected = try util.encodeJsonValue(allocator, &parsed);
+    defer allocator.free(expected);
+    const actual = try util.encodeJsonValue(allocator, &loaded);
+    defer allocator.free(actual);
+    try std.testing.expectEqualStrings(expected, actual);
+    try std.testing.expect(hit.allocations < cold.allocations);
+    try std.testing.expect(hit.allocated_bytes < cold.allocated_bytes);
+}
+
+test "frees partially decoded profiles on allocation failures" {
+    const allocator = std.testing.allocator;
+    var profile = try api.Profile.parse(allocator, profile_json);
+    defer profile.deinit(allocator);
+    const key = profile_cache.contentKey(profile_json);
+    const encoded = try profile_cache.encodeAlloc(allocator, &profile, key);
+    defer allocator.free(encoded);
+
+    try std.testing.checkAllAllocationFailures(allocator, decodeAndFree, .{ encoded, key });
+}
+
+fn decodeAndFree(
+    allocator: std.mem.Allocator,
+    encoded: []const u8,
+    key: profile_cache.ContentKey,
+) !void {
+    var profile = try profile_cache.decode(allocator, encoded, key);
+    profile.deinit(allocator);
+}
+
+const profile_json =
+    \\{"version":7,"id":"00000000-0000-0000-0000-000000000100","name":"Cache Fixture","modules":[
+    \\{"type":"DNS","value":{"id":"00000000-0000-0000-0000-000000000102","protocolType":{"type":"https","url":"https://dns.example.com/query"},"servers":["1.1.1.1","2606:4700:4700::1111"],"domainName":"primary.example.com","searchDomains":["primary.example.com"],"domainPolicy":"matchAndSearch"}},
+    \\{"type":"IP","value":{"id":"00000000-0000-0000-0000-000000000104","ipv4":{"subnets":["10.8.0.2/24"],"includedRoutes":[{"destination":"172.16.0.0/12","gateway":"10.8.0.1"}]},"ipv6":{"subnets":["2001:db8:1::2/64"],"excludedRoutes":[{"destination":"fd00:dead:beef::/48"}]},"mtu":1380}},
+    \\{"type":"OnDemand","value":{"id":"00000000-0000-0000-0000-000000000105","policy":"including","withSSIDs":{"Office WiFi":true},"withOtherNetworks":["mobile"]}},
+    \\{"type":"OpenVPN","value":{"id":"00000000-0000-0000-0000-000000000106","configuration":{"cipher":"AES-256-CBC","keepAliveInterval":10.5,"remotes":["vpn.example.com:UDP4:1194"],"xorMethod":{"type":"obfuscate","mask":"BAUG"}}}},
+    \\{"type":"WireGuard","value":{"id":"00000000-0000-0000-0000-000000000107","configuration":{"interface":{"privateKey":"AQEBAQEBAQEBAQEBAQEBAQEBAQEBAQEBAQEBAQEBAQE=","addresses":["10.14.0.2/32"]},"peers":[{"publicKey":"AgICAgICAgICAgICAgICAgICAgICAgICAgICAgICAgI=","endpoint":"wg.example.com:51820","allowedIPs":["0.0.0.0/0","::/0"],"keepAlive":25}]}}}
+    \\],"activeModulesIds":["00000000-0000-0000-0000-000000000102","00000000-0000-0000-0000-000000000107"],"behavior":{"disconnectsOnSleep":true},"userInfo":{"owner":"PartoutCoreTests"}}
+;
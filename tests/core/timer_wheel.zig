@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const core = @import("source").core;
+
+const TimerWheel = core.TimerWheel;
+const ms = std.time.ns_per_ms;
+
+fn expectDue(wheel: *TimerWheel, expected: []const *TimerWheel.Entry) !void {
+    for (expected) |entry| {
+        try std.testing.expectEqual(entry, wheel.popDue().?);
+    }
+    try std.testing.expectEqual(@as(?*TimerWheel.Entry, null), wheel.popDue());
+}
+
+test "timer wheel reports nothing when empty" {
+    var wheel = TimerWheel.init(0);
+    try std.testing.expectEqual(@as(?u64, null), wheel.nextDeadlineNs());
+    wheel.advance(10 * ms);
+    try expectDue(&wheel, &.{});
+}
+
+test "timer wheel expires entries in deadline order and never early" {
+    var wheel = TimerWheel.init(0);
+    var late = TimerWheel.Entry{};
+    var early = TimerWheel.Entry{};
+    wheel.schedule(&late, 20 * ms);
+    wheel.schedule(&early, 5 * ms);
+    try std.testing.expectEqual(@as(?u64, 5 * ms), wheel.nextDeadlineNs());
+
+    wheel.advance(5 * ms - 1);
+    try expectDue(&wheel, &.{});
+    wheel.advance(5 * ms);
+    try expectDue(&wheel, &.{&early});
+    try std.testing.expectEqual(@as(?u64, 20 * ms), wheel.nextDeadlineNs());
+    wheel.advance(30 * ms);
+    try expectDue(&wheel, &.{&late});
+    try std.testing.expectEqual(@as(usize, 0), wheel.count);
+}
+
+test "timer wheel cascades far deadlines without firing them early" {
+    var wheel = TimerWheel.init(0);
+    var entries: [4]TimerWheel.Entry = @splat(.{});
+    const deadlines = [_]u64{ 100, 5_000, 300_000, 20_000_000 };
+    for (&entries, deadlines) |*entry, deadline| wheel.schedule(entry, deadline * ms);
+
+    for (&entries, deadlines) |*entry, deadline| {
+        const next = wheel.nextDeadlineNs().?;
+        try std.testing.expect(next <= deadline * ms);
+        wheel.advance(deadline * ms - 1);
+        try expectDue(&wheel, &.{});
+        wheel.advance(deadline * ms);
+        try expectDue(&wheel, &.{entry});
+    }
+}
+
+test "timer wheel reports an inner entry armed after an outer one" {
+    var wheel = TimerWheel.init(0);
+    var outer = TimerWheel.Entry{};
+    var inner = TimerWheel.Entry{};
+    wheel.schedule(&outer, 100 * ms);
+    wheel.advance(63 * ms);
+    wheel.schedule(&inner, 120 * ms);
+    try std.testing.expect(wheel.nextDeadlineNs().? <= 100 * ms);
+    wheel.advance(100 * ms);
+    try expectDue(&wheel, &.{&outer});
+}
+
+test "timer wheel cancels pending and due entries" {
+    var wheel = TimerWheel.init(0);
+    var pending = TimerWheel.Entry{};
+    var due = TimerWheel.Entry{};
+    var kept = TimerWheel.Entry{};
+    wheel.schedule(&pending, 50 * ms);
+    wheel.schedule(&due, 1 * ms);
+    wheel.schedule(&kept, 1 * ms);
+    wheel.cancel(&pending);
+    try std.testing.expect(!pending.isLinked());
+
+    wheel.advance(1 * ms);
+    wheel.cancel(&due);
+    try expectDue(&wheel, &.{&kept});
+    wheel.advance(100 * ms);
+    try expectDue(&wheel, &.{});
+}
+
+test "timer wheel rescheduling replaces the previous deadline" {
+    var wheel = TimerWheel.init(0);
+    var entry = TimerWheel.Entry{};
+    wheel.schedule(&entry, 1 * ms);
+    wheel.schedule(&entry, 40 * ms);
+    try std.testing.expectEqual(@as(usize, 1), wheel.count);
+    wheel.advance(10 * ms);
+    try expectDue(&wheel, &.{});
+    wheel.advance(40 * ms);
+    try expectDue(&wheel, &.{&entry});
+}
+
+test "timer wheel clamps elapsed deadlines to the next tick" {
+    var wheel = TimerWheel.init(0);
+    wheel.advance(10 * ms);
+    var entry = TimerWheel.Entry{};
+    wheel.schedule(&entry, 0);
+    wheel.advance(11 * ms);
+    try expectDue(&wheel, &.{&entry});
+}
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0
 
 const std = @import("std");
+const builtin = @import("builtin");
 
 const api = @import("source").core.api;
 const io = @import("source").net_io;
@@ -12,6 +13,12 @@ const mapReadResult = io.testing.mapReadResult;
 const mapWriteResult = io.testing.mapWriteResult;
 const reachabilityNone = io.testing.reachabilityNone;
 
+const libc = struct {
+    extern "c" fn close(fd: std.c.fd_t) c_int;
+    extern "c" fn socketpair(domain: c_int, kind: c_int, protocol: c_int, fds: *[2]std.c.fd_t) c_int;
+    extern "c" fn send(fd: std.c.fd_t, buf: [*]const u8, len: usize, flags: c_int) isize;
+};
+
 test "maps native socket read results" {
     try std.testing.expectError(error.WouldBlock, mapReadResult(.link, c.PPIOErrorWouldBlock, false));
     try std.testing.expectEqual(@as(?usize, null), try mapReadResult(.link, 0, false));
@@ -48,3 +55,83 @@ test "socket wrapper reports an invalid remote address" {
 
     try std.testing.expect(wrapper.remoteAddress() == null);
 }
+
+fn receiveWhenReady(ring: c.pp_uring_rx, slots: []io.ReceiveSlot) !usize {
+    while (true) {
+        const result = c.pp_uring_rx_read(ring, slots.ptr, slots.len);
+        if (result == c.PPIOErrorWouldBlock) {
+            std.Thread.yield() catch {};
+            continue;
+        }
+        if (result < 0) return error.ReceiveFailed;
+        return @intCast(result);
+    }
+}
+
+test "receive ring borrows packets in place until released" {
+    if (builtin.os.tag != .linux or builtin.abi.isAndroid()) return error.SkipZigTest;
+
+    var fds: [2]std.c.fd_t = undefined;
+    if (std.c.pipe(&fds) != 0) return error.PipeFailed;
+    defer _ = libc.close(fds[0]);
+    var is_writer_open = true;
+    defer if (is_writer_open) {
+        _ = libc.close(fds[1]);
+    };
+    // Unavailable on older kernels or when io_uring is disabled
+    const ring = c.pp_uring_rx_create(fds[0], false, true, 64, 2) orelse return error.SkipZigTest;
+    defer c.pp_uring_rx_free(ring);
+
+    var slots: [2]io.ReceiveSlot = undefined;
+    try std.testing.expectEqual(c.PPIOErrorWouldBlock, c.pp_uring_rx_read(ring, &slots, slots.len));
+
+    // Both slots stay borrowed, the third packet waits for a release
+    for ([_][]const u8{ "first", "second", "third" }, 0..) |payload, i| {
+        try std.testing.expectEqual(@as(isize, @intCast(payload.len)), std.c.write(fds[1], payload.ptr, payload.len));
+        if (i == 2) break;
+        const count = try receiveWhenReady(ring, slots[i .. i + 1]);
+        try std.testing.expectEqual(@as(usize, 1), count);
+        try std.testing.expectEqualStrings(payload, slots[i].bytes[0..slots[i].length]);
+    }
+    try std.testing.expectEqual(c.PPIOErrorWouldBlock, c.pp_uring_rx_read(ring, &slots, slots.len));
+    c.pp_uring_rx_release(ring, &slots, slots.len);
+
+    try std.testing.expectEqual(@as(usize, 1), try receiveWhenReady(ring, &slots));
+    try std.testing.expectEqualStrings("third", slots[0].bytes[0..slots[0].length]);
+    c.pp_uring_rx_release(ring, &slots, 1);
+
+    // Packets before the end of the stream come first, then the end
+    try std.testing.expectEqual(@as(isize, 4), std.c.write(fds[1], "last", 4));
+    _ = libc.close(fds[1]);
+    is_writer_open = false;
+    try std.testing.expectEqual(@as(usize, 1), try receiveWhenReady(ring, &slots));
+    try std.testing.expectEqualStrings("last", slots[0].bytes[0..slots[0].length]);
+    c.pp_uring_rx_release(ring, &slots, 1);
+    try std.testing.expectEqual(@as(usize, 0), try receiveWhenReady(ring, &slots));
+    try std.testing.expectEqual(@as(c_int, 0), c.pp_uring_rx_read(ring, &slots, slots.len));
+}
+
+test "receive ring keeps receiving after an empty datagram" {
+    if (builtin.os.tag != .linux or builtin.abi.isAndroid()) return error.SkipZigTest;
+
+    var fds: [2]std.c.fd_t = undefined;
+    if (libc.socketpair(std.c.AF.UNIX, std.c.SOCK.DGRAM, 0, &fds) != 0) return error.SocketPairFailed;
+    defer _ = libc.close(fds[0]);
+    defer _ = libc.close(fds[1]);
+    // Unavailable on older kernels or when io_uring is disabled
+    const ring = c.pp_uring_rx_create(fds[0], true, false, 64, 2) orelse return error.SkipZigTest;
+    defer c.pp_uring_rx_free(ring);
+
+    var slots: [2]io.ReceiveSlot = undefined;
+    try std.testing.expectEqual(@as(isize, 0), libc.send(fds[1], "", 0, 0));
+    try std.testing.expectEqual(@as(isize, 5), libc.send(fds[1], "after", 5, 0));
+    try std.testing.expectEqual(@as(usize, 1), try receiveWhenReady(ring, &slots));
+    try std.testing.expectEqualStrings("after", slots[0].bytes[0..slots[0].length]);
+    c.pp_uring_rx_release(ring, &slots, 1);
+
+    // Still armed
+    try std.testing.expectEqual(@as(isize, 4), libc.send(fds[1], "more", 4, 0));
+    try std.testing.expectEqual(@as(usize, 1), try receiveWhenReady(ring, &slots));
+    try std.testing.expectEqualStrings("more", slots[0].bytes[0..slots[0].length]);
+    c.pp_uring_rx_release(ring, &slots, 1);
+}
@@ -6,6 +6,7 @@ const std = @import("std");
 const builtin = @import("builtin");
 
 const source = @import("source");
+const core = source.core;
 const io = source.net_io;
 
 const Looper = source.net_looper.Looper;
@@ -93,6 +94,131 @@ const MockIO = struct {
     };
 };
 
+/// Never writable, like a TUN device that stopped draining.
+const ThrottledIO = struct {
+    cleaned: AtomicBool = AtomicBool.init(false),
+
+    fn interface(self: *ThrottledIO) io.IOInterface {
+        return .{ .ptr = self, .vtable = &vtable };
+    }
+
+    fn setEventMask(_: *anyopaque, _: bool, _: bool) io.Error!void {}
+
+    fn resetEvents(_: *anyopaque) io.Error!void {}
+
+    fn read(_: *anyopaque, _: []u8) io.Error!?usize {
+        return null;
+    }
+
+    fn write(_: *anyopaque, _: []const u8, _: usize) io.Error!usize {
+        return error.WouldBlock;
+    }
+
+    fn cleanup(raw: *anyopaque) void {
+        const self: *ThrottledIO = @ptrCast(@alignCast(raw));
+        self.cleaned.store(true, .release);
+    }
+
+    fn lastErrorCode(_: *anyopaque) c_int {
+        return 0;
+    }
+
+    const vtable = io.IOInterface.VTable{
+        .set_event_mask = setEventMask,
+        .reset_events = resetEvents,
+        .read = read,
+        .write = write,
+        .cleanup = cleanup,
+        .last_error_code = lastErrorCode,
+    };
+};
+
+/// Reads from the pipe through a receive ring, never with copies.
+const RingIO = struct {
+    fd: std.c.fd_t,
+    ring: io.c.pp_uring_rx = null,
+    cleaned: AtomicBool = AtomicBool.init(false),
+
+    fn interface(self: *RingIO) io.IOInterface {
+        return .{ .ptr = self, .vtable = &vtable };
+    }
+
+    fn setEventMask(_: *anyopaque, _: bool, _: bool) io.Error!void {}
+
+    fn resetEvents(_: *anyopaque) io.Error!void {}
+
+    fn read(_: *anyopaque, _: []u8) io.Error!?usize {
+        return error.LibcFailure;
+    }
+
+    fn write(_: *anyopaque, data: []const u8, offset: usize) io.Error!usize {
+        return data.len - offset;
+    }
+
+    fn openReceiveRing(raw: *anyopaque, slot_len: usize, slot_count: usize) ?io.FileDescriptor {
+        const self: *RingIO = @ptrCast(@alignCast(raw));
+        self.ring = io.c.pp_uring_rx_create(self.fd, false, true, slot_len, slot_count);
+        return io.c.pp_uring_rx_get_watch_fd(self.ring orelse return null);
+    }
+
+    fn closeReceiveRing(raw: *anyopaque) void {
+        const self: *RingIO = @ptrCast(@alignCast(raw));
+        if (self.ring) |ring| io.c.pp_uring_rx_free(ring);
+        self.ring = null;
+    }
+
+    fn receive(raw: *anyopaque, slots: []io.ReceiveSlot) io.Error!usize {
+        const self: *RingIO = @ptrCast(@alignCast(raw));
+        const result = io.c.pp_uring_rx_read(self.ring, slots.ptr, slots.len);
+        if (result == io.c.PPIOErrorWouldBlock) return error.WouldBlock;
+        if (result < 0) return error.LibcFailure;
+        return @intCast(result);
+    }
+
+    fn release(raw: *anyopaque, slots: []const io.ReceiveSlot) void {
+        const self: *RingIO = @ptrCast(@alignCast(raw));
+        io.c.pp_uring_rx_release(self.ring, slots.ptr, slots.len);
+    }
+
+    fn cleanup(raw: *anyopaque) void {
+        const self: *RingIO = @ptrCast(@alignCast(raw));
+        closeReceiveRing(raw);
+        self.cleaned.store(true, .release);
+    }
+
+    fn lastErrorCode(_: *anyopaque) c_int {
+        return 0;
+    }
+
+    const vtable = io.IOInterface.VTable{
+        .set_event_mask = setEventMask,
+        .reset_events = resetEvents,
+        .read = read,
+        .write = write,
+        .open_receive_ring = openReceiveRing,
+        .close_receive_ring = closeReceiveRing,
+        .receive = receive,
+        .release = release,
+        .cleanup = cleanup,
+        .last_error_code = lastErrorCode,
+    };
+};
+
+const ReceiveProbe = struct {
+    packet: [16]u8 = undefined,
+    packet_len: usize = 0,
+    did_read: AtomicBool = AtomicBool.init(false),
+
+    fn onRead(raw: ?*anyopaque, packets: Looper.Packets) anyerror!Looper.ReadAction {
+        const self: *ReceiveProbe = @ptrCast(@alignCast(raw.?));
+        const packet = packets[0];
+        @memcpy(self.packet[0..packet.len], packet);
+        self.packet_len = packet.len;
+        self.did_read.store(true, .release);
+        return .keep;
+    }
+};
+
 fn noopFinish(_: ?*anyopaque, _: ?Looper.Failure) void {}
 
 fn noopTask(_: ?*anyopaque) anyerror!void {}
@@ -437,6 +563,67 @@ test "out-of-band write returns the underlying I/O error" {
     try looper.stop();
 }
 
+test "throttled side drops writes beyond its queue bounds" {
+    if (builtin.os.tag == .windows) return error.SkipZigTest;
+
+    var pipe = try Pipe.init();
+    defer pipe.deinit();
+    var throttled = ThrottledIO{};
+    const metrics = try std.testing.allocator.create(core.Metrics);
+    defer std.testing.allocator.destroy(metrics);
+    metrics.* = .{};
+    var looper = try Looper.init(std.testing.allocator, .{
+        .on_finish = .{ .callback = noopFinish },
+        .tun_write_limits = .{ .max_packets = 16, .max_bytes = 16 * 100 },
+        .metrics = metrics,
+    });
+    defer looper.deinit();
+    try looper.start();
+    try looper.attach(.{
+        .pair = .{ .tun = .{ .fd = pipe.fds[0], .io = throttled.interface() } },
+    });
+
+    // Nothing is ever written, so the queue stays full.
+    const packet = [_]u8{0} ** 100;
+    for (0..1000) |_| try looper.writeQueued(&.{&packet}, .tun);
+    try std.testing.expectEqual(@as(u64, 1000 - 16), metrics.snapshot().get(.write_drops));
+
+    try looper.detach(.tun);
+    try std.testing.expect(throttled.cleaned.load(.acquire));
+    try looper.stop();
+}
+
+test "attached side reads packets in place from a receive ring" {
+    if (builtin.os.tag != .linux or builtin.abi.isAndroid()) return error.SkipZigTest;
+
+    var pipe = try Pipe.init();
+    defer pipe.deinit();
+    // Unavailable on older kernels or when io_uring is disabled
+    const probe_ring = io.c.pp_uring_rx_create(pipe.fds[0], false, true, 64, 1) orelse
+        return error.SkipZigTest;
+    io.c.pp_uring_rx_free(probe_ring);
+
+    var ring_io = RingIO{ .fd = pipe.fds[0] };
+    var probe = ReceiveProbe{};
+    var looper = try initLooper(.{ .callback = noopFinish });
+    defer looper.deinit();
+    try looper.start();
+    try looper.attach(.{
+        .pair = .{ .tun = .{ .fd = pipe.fds[0], .io = ring_io.interface() } },
+        .on_read = .{ .context = &probe, .callback = ReceiveProbe.onRead },
+    });
+
+    const payload = "packet";
+    try std.testing.expectEqual(@as(isize, payload.len), std.c.write(pipe.fds[1], payload, payload.len));
+    waitUntil(&probe.did_read);
+    try std.testing.expectEqualStrings(payload, probe.packet[0..probe.packet_len]);
+
+    try looper.detach(.tun);
+    try std.testing.expect(ring_io.cleaned.load(.acquire));
+    try std.testing.expect(ring_io.ring == null);
+    try looper.stop();
+}
+
 test "synchronous lifecycle commands do not allocate" {
     if (builtin.os.tag == .windows) return error.SkipZigTest;
 
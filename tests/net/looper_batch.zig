@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const BatchController = @import("source").net_looper_batch.BatchController;
+
+const target_ns = 200 * std.time.ns_per_us;
+
+fn initController(max_count: usize) BatchController {
+    return BatchController.init(.{
+        .target_latency_ns = target_ns,
+        .max_count = max_count,
+        .queue_high_watermark = 16,
+    });
+}
+
+test "batch controller doubles full batches up to the latency budget" {
+    var controller = initController(128);
+    try std.testing.expectEqual(@as(usize, 1), controller.limit());
+
+    // 4us per packet fits 50 packets in the target.
+    var expected: usize = 1;
+    while (expected < 32) {
+        try std.testing.expectEqual(BatchController.Adjustment.grow, controller.record(.{
+            .count = expected,
+            .latency_ns = expected * 4 * std.time.ns_per_us,
+            .queue_depth = 0,
+        }));
+        expected *= 2;
+        try std.testing.expectEqual(expected, controller.limit());
+    }
+    _ = controller.record(.{ .count = 32, .latency_ns = 128 * std.time.ns_per_us, .queue_depth = 0 });
+    try std.testing.expectEqual(@as(usize, 50), controller.limit());
+    try std.testing.expectEqual(@as(usize, 50), controller.budget());
+
+    // Partial batches are sparse arrivals.
+    try std.testing.expectEqual(BatchController.Adjustment.none, controller.record(.{
+        .count = 3,
+        .latency_ns = 12 * std.time.ns_per_us,
+        .queue_depth = 0,
+    }));
+    try std.testing.expectEqual(@as(usize, 50), controller.limit());
+}
+
+test "batch controller halves batches over the target or behind a deep queue" {
+    var controller = initController(128);
+    controller.current_limit = 64;
+
+    try std.testing.expectEqual(BatchController.Adjustment.shrink, controller.record(.{
+        .count = 64,
+        .latency_ns = 2 * target_ns,
+        .queue_depth = 0,
+    }));
+    try std.testing.expectEqual(@as(usize, 32), controller.limit());
+
+    try std.testing.expectEqual(BatchController.Adjustment.shrink, controller.record(.{
+        .count = 1,
+        .latency_ns = 1,
+        .queue_depth = 16,
+    }));
+    try std.testing.expectEqual(@as(usize, 16), controller.limit());
+
+    for (0..10) |_| {
+        _ = controller.record(.{ .count = 1, .latency_ns = 10 * target_ns, .queue_depth = 0 });
+    }
+    try std.testing.expectEqual(@as(usize, 1), controller.limit());
+}
+
+// Trace replay
+//
+// Timings replace a pcap: each trace is a list of arrival times, generated
+// from a fixed seed so that runs are reproducible. The model reads queued
+// packets one by one at `read_cost_ns` each, up to the batch limit, then
+// spends `deliver_cost_ns` per `on_read` call plus `process_cost_ns` per
+// packet before reading again.
+
+const read_cost_ns = 2 * std.time.ns_per_us;
+const process_cost_ns = 3 * std.time.ns_per_us;
+const deliver_cost_ns = 20 * std.time.ns_per_us;
+
+const ReplayResult = struct {
+    batches: usize = 0,
+    /// From the first read of a batch to its delivery.
+    max_batch_latency_ns: u64 = 0,
+    /// From the arrival of a packet to its delivery.
+    max_sojourn_ns: u64 = 0,
+};
+
+fn replay(arrivals: []const u64, controller: ?*BatchController, static_limit: usize) ReplayResult {
+    var result: ReplayResult = .{};
+    var now: u64 = 0;
+    var next: usize = 0;
+    while (next < arrivals.len) {
+        // Idle until readable
+        now = @max(now, arrivals[next]);
+        const limit = if (controller) |value| value.limit() else static_limit;
+        const start_ns = now;
+        const first = next;
+        while (next - first < limit and next < arrivals.len and arrivals[next] <= now) {
+            now += read_cost_ns;
+            next += 1;
+        }
+        const count = next - first;
+        const latency_ns = now - start_ns;
+        if (controller) |value| {
+            _ = value.record(.{ .count = count, .latency_ns = latency_ns, .queue_depth = 0 });
+        }
+        result.batches += 1;
+        result.max_batch_latency_ns = @max(result.max_batch_latency_ns, latency_ns);
+        result.max_sojourn_ns = @max(result.max_sojourn_ns, now - arrivals[first]);
+        now += deliver_cost_ns + count * process_cost_ns;
+    }
+    return result;
+}
+
+/// Keystroke-like traffic, one packet every 5-20ms.
+fn interactiveTrace(allocator: std.mem.Allocator, count: usize) ![]u64 {
+    var prng = std.Random.DefaultPrng.init(0x1a7e_0001);
+    const random = prng.random();
+    const arrivals = try allocator.alloc(u64, count);
+    var now: u64 = 0;
+    for (arrivals) |*arrival| {
+        now += random.intRangeAtMost(u64, 5, 20) * std.time.ns_per_ms;
+        arrival.* = now;
+    }
+    return arrivals;
+}
+
+/// Transfer-like traffic, bursts of 200-1000 packets queued at once and
+/// spaced by 10-50ms.
+fn bulkTrace(allocator: std.mem.Allocator, bursts: usize) ![]u64 {
+    var prng = std.Random.DefaultPrng.init(0x1a7e_0002);
+    const random = prng.random();
+    var arrivals: std.ArrayList(u64) = .empty;
+    errdefer arrivals.deinit(allocator);
+    var now: u64 = 0;
+    for (0..bursts) |_| {
+        now += random.intRangeAtMost(u64, 10, 50) * std.time.ns_per_ms;
+        const burst = random.intRangeAtMost(usize, 200, 1000);
+        try arrivals.appendNTimes(allocator, now, burst);
+    }
+    return arrivals.toOwnedSlice(allocator);
+}
+
+test "adaptive batches bound the latency of bulk traces unlike static limits" {
+    const arrivals = try bulkTrace(std.testing.allocator, 20);
+    defer std.testing.allocator.free(arrivals);
+
+    const static = replay(arrivals, null, 128);
+    var controller = initController(128);
+    const adaptive = replay(arrivals, &controller, 128);
+
+    try std.testing.expect(static.max_batch_latency_ns > target_ns);
+    try std.testing.expect(adaptive.max_batch_latency_ns <= target_ns);
+    try std.testing.expectEqual(controller.budget(), controller.limit());
+    // Batches are not chopped far below the budget.
+    try std.testing.expect(adaptive.batches <= 2 * static.batches);
+}
+
+test "adaptive batches add no latency to interactive traces" {
+    const arrivals = try interactiveTrace(std.testing.allocator, 500);
+    defer std.testing.allocator.free(arrivals);
+
+    const static = replay(arrivals, null, 128);
+    var controller = initController(128);
+    const adaptive = replay(arrivals, &controller, 128);
+
+    try std.testing.expectEqual(arrivals.len, static.batches);
+    try std.testing.expectEqual(arrivals.len, adaptive.batches);
+    try std.testing.expectEqual(static.max_sojourn_ns, adaptive.max_sojourn_ns);
+    try std.testing.expectEqual(@as(u64, read_cost_ns), adaptive.max_sojourn_ns);
+}
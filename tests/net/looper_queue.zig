@@ -9,6 +9,7 @@ const Completion = queue_mod.Completion;
 const CompletionQueue = queue_mod.CompletionQueue;
 const CommandNode = queue_mod.CommandNode;
 const CommandQueue = queue_mod.CommandQueue;
+const TimerPool = queue_mod.TimerPool;
 const WriteQueue = queue_mod.WriteQueue;
 
 test "completion queue releases completions in FIFO order" {
@@ -54,6 +55,26 @@ test "command queue detaches ready commands in FIFO order" {
     try std.testing.expect(queue.takeReady() == null);
 }
 
+test "timer pool recycles released nodes and invalidates their ids" {
+    var pool = TimerPool.init(std.testing.allocator);
+    defer pool.deinit();
+
+    const first = try pool.acquire(1, .{ .enable_read = .{ .side = .link, .id = 1 } });
+    try std.testing.expectEqual(@as(u64, 1), first.id);
+    pool.release(first);
+    try std.testing.expectEqual(@as(u64, 0), first.id);
+
+    const second = try pool.acquire(2, .{ .enable_write = .{ .side = .tun, .id = null } });
+    try std.testing.expect(second == first);
+    try std.testing.expectEqual(@as(u64, 2), second.id);
+
+    const third = try pool.acquire(3, .{ .enable_read = .{ .side = .tun, .id = null } });
+    try std.testing.expect(third != second);
+    pool.releaseAll();
+    try std.testing.expectEqual(@as(u64, 0), second.id);
+    try std.testing.expectEqual(@as(u64, 0), third.id);
+}
+
 test "write queue preserves FIFO order and partial progress" {
     var queue = WriteQueue.init(std.testing.allocator);
     defer queue.deinit();
@@ -73,6 +94,29 @@ test "write queue preserves FIFO order and partial progress" {
     try std.testing.expect(queue.pending() == null);
 }
 
+test "write queue gathers packets and advances across them" {
+    var queue = WriteQueue.init(std.testing.allocator);
+    defer queue.deinit();
+
+    try queue.append(&.{ "abcd", "ef", "ghi" });
+    try std.testing.expectEqual(@as(usize, 3), queue.len());
+    try std.testing.expect(!queue.advance(1));
+
+    var chunks: [2][]const u8 = undefined;
+    try std.testing.expectEqual(@as(usize, 2), queue.gather(&chunks));
+    try std.testing.expectEqualStrings("abcd", chunks[0]);
+    try std.testing.expectEqualStrings("ef", chunks[1]);
+
+    // Remainder of the head, the whole second packet and part of the third.
+    try std.testing.expect(!queue.advance(6));
+    try expectPending(&queue, "ghi", 1);
+    try std.testing.expectEqual(@as(usize, 1), queue.len());
+    try std.testing.expect(queue.advance(2));
+    try std.testing.expect(queue.pending() == null);
+    try std.testing.expectEqual(@as(usize, 0), queue.gather(&chunks));
+    try std.testing.expectEqual(@as(usize, 0), queue.len());
+}
+
 test "write queue owns packet copies" {
     var queue = WriteQueue.init(std.testing.allocator);
     defer queue.deinit();
@@ -94,6 +138,7 @@ test "write queue rolls back a failed batch" {
 
         try std.testing.expectError(error.OutOfMemory, queue.append(&.{ "one", "two" }));
         try std.testing.expect(queue.pending() == null);
+        try std.testing.expectEqual(@as(usize, 0), queue.len());
     }
 }
 
@@ -125,6 +170,147 @@ test "write queue accepts empty batches and packets" {
     try std.testing.expect(queue.pending() == null);
 }
 
+test "write queue drops the tail beyond its bounds" {
+    var queue = WriteQueue.initWithLimits(std.testing.allocator, .{
+        .max_packets = 3,
+        .max_bytes = 8,
+    });
+    defer queue.deinit();
+
+    try queue.append(&.{ "abc", "defgh", "i" });
+    try std.testing.expectEqual(@as(usize, 2), queue.len());
+    try std.testing.expectEqual(@as(usize, 8), queue.size());
+    try std.testing.expectEqual(@as(usize, 1), queue.takeDrops());
+    try std.testing.expectEqual(@as(usize, 0), queue.takeDrops());
+
+    try std.testing.expect(queue.advance(3));
+    try queue.append(&.{ "jk", "l", "m" });
+    try std.testing.expectEqual(@as(usize, 3), queue.len());
+    try std.testing.expectEqual(@as(usize, 1), queue.takeDrops());
+    try expectPending(&queue, "defgh", 0);
+}
+
+test "write queue drops the head but keeps the packets in use" {
+    var queue = WriteQueue.initWithLimits(std.testing.allocator, .{
+        .max_packets = 2,
+        .policy = .head,
+    });
+    defer queue.deinit();
+
+    // A partially written head is kept.
+    try queue.append(&.{ "ab", "cd" });
+    try std.testing.expect(!queue.advance(1));
+    try queue.append(&.{ "ef", "gh" });
+    try std.testing.expectEqual(@as(usize, 2), queue.len());
+    try std.testing.expectEqual(@as(usize, 2), queue.takeDrops());
+    try std.testing.expect(queue.advance(1));
+    try expectPending(&queue, "gh", 0);
+
+    // Gathered views are kept until advanced.
+    try queue.append(&.{"ij"});
+    var chunks: [2][]const u8 = undefined;
+    try std.testing.expectEqual(@as(usize, 2), queue.gather(&chunks));
+    try queue.append(&.{ "kl", "mn" });
+    try std.testing.expectEqual(@as(usize, 2), queue.takeDrops());
+    try std.testing.expectEqualStrings("gh", chunks[0]);
+    try std.testing.expectEqualStrings("ij", chunks[1]);
+    try std.testing.expect(queue.advance(4));
+    try std.testing.expect(queue.pending() == null);
+
+    // Otherwise the newest packets win.
+    try queue.append(&.{ "op", "qr", "st" });
+    try std.testing.expectEqual(@as(usize, 1), queue.takeDrops());
+    try expectPending(&queue, "qr", 0);
+}
+
+test "write queue drops packets larger than the byte bound" {
+    inline for (.{ .tail, .head, .codel }) |policy| {
+        var queue = WriteQueue.initWithLimits(std.testing.allocator, .{
+            .max_bytes = 4,
+            .policy = policy,
+        });
+        defer queue.deinit();
+
+        try queue.append(&.{ "abcdef", "gh" });
+        try std.testing.expectEqual(@as(usize, 1), queue.len());
+        try std.testing.expectEqual(@as(usize, 1), queue.takeDrops());
+        try expectPending(&queue, "gh", 0);
+    }
+}
+
+// Throttled consumer
+//
+// A producer queues a packet every millisecond, and a consumer slower by
+// 25% writes one at a time, in virtual time. Only the second half of the
+// run is measured, once the queue reached its steady state.
+
+const ThrottleResult = struct {
+    max_len: usize = 0,
+    max_bytes: usize = 0,
+    /// From the append of a packet to its write.
+    max_sojourn_ns: u64 = 0,
+    drops: usize = 0,
+};
+
+fn throttle(limits: WriteQueue.Limits) !ThrottleResult {
+    const ms = std.time.ns_per_ms;
+    const duration_ns = 20 * std.time.ns_per_s;
+    const produce_ns = 1 * ms;
+    const consume_ns = 1250 * std.time.ns_per_us;
+
+    var queue = WriteQueue.initWithLimits(std.testing.allocator, limits);
+    defer queue.deinit();
+    var result: ThrottleResult = .{};
+
+    const packet = [_]u8{0} ** 100;
+    var next_produce: u64 = 0;
+    var next_consume: u64 = 0;
+    while (@min(next_produce, next_consume) < duration_ns) {
+        const now = @min(next_produce, next_consume);
+        if (next_produce <= next_consume) {
+            try queue.appendAt(&.{&packet}, now);
+            next_produce += produce_ns;
+        } else {
+            if (queue.peekAt(now)) |pending| {
+                const first = queue.head.?;
+                if (now > duration_ns / 2) {
+                    result.max_sojourn_ns = @max(result.max_sojourn_ns, now - first.enqueued_ns);
+                }
+                try std.testing.expect(queue.advance(pending.data.len));
+            }
+            next_consume += consume_ns;
+        }
+        if (now > duration_ns / 2) {
+            result.max_len = @max(result.max_len, queue.len());
+            result.max_bytes = @max(result.max_bytes, queue.size());
+        }
+        result.drops += queue.takeDrops();
+    }
+    return result;
+}
+
+test "write queue bounds memory and delay behind a throttled consumer" {
+    const ms = std.time.ns_per_ms;
+    const limits: WriteQueue.Limits = .{ .max_packets = 1024 };
+
+    // Memory stays flat, but packets wait for the whole queue.
+    var tail_limits = limits;
+    tail_limits.policy = .tail;
+    const tail = try throttle(tail_limits);
+    try std.testing.expectEqual(@as(usize, 1024), tail.max_len);
+    try std.testing.expectEqual(@as(usize, 1024 * 100), tail.max_bytes);
+    try std.testing.expect(tail.max_sojourn_ns > 1000 * ms);
+
+    // Sojourn-time drops also keep the delay near the target.
+    var codel_limits = limits;
+    codel_limits.policy = .codel;
+    const codel = try throttle(codel_limits);
+    try std.testing.expect(codel.max_len < 64);
+    try std.testing.expect(codel.max_sojourn_ns < 50 * ms);
+    // Drops match the excess arrivals, about a fifth of them.
+    try std.testing.expect(codel.drops > 3000 and codel.drops < 5000);
+}
+
 fn expectPending(queue: *const WriteQueue, data: []const u8, offset: usize) !void {
     const pending = queue.pending() orelse return error.MissingPendingWrite;
     try std.testing.expectEqualSlices(u8, data, pending.data);
@@ -3,23 +3,103 @@
 // SPDX-License-Identifier: GPL-3.0
 
 const std = @import("std");
+const builtin = @import("builtin");
 
 const c = @cImport({
     @cInclude("portable/mux.h");
 });
 
+const libc = struct {
+    extern "c" fn close(fd: std.c.fd_t) c_int;
+};
+
 test "mux wait observes explicit wake" {
     const mux = c.pp_mux_create(1) orelse return error.MuxCreationFailed;
     defer c.pp_mux_free(mux);
 
     // Queue the wake first so the test is deterministic without thread timing.
     try std.testing.expect(c.pp_mux_wake(mux));
-    try std.testing.expectEqual(@as(c_int, 1), c.pp_mux_wait(mux, null));
+    try std.testing.expectEqual(@as(c_int, 1), c.pp_mux_wait(mux, -1, null));
+}
+
+test "mux wait returns zero when the timeout elapses" {
+    const mux = c.pp_mux_create(1) orelse return error.MuxCreationFailed;
+    defer c.pp_mux_free(mux);
+
+    try std.testing.expectEqual(@as(c_int, 0), c.pp_mux_wait(mux, 0, null));
+    try std.testing.expectEqual(@as(c_int, 0), c.pp_mux_wait(mux, 1, null));
 }
 
 test "mux wait preserves the null-mux error" {
     try std.testing.expectEqual(
         c.PPMuxErrorNull,
-        c.pp_mux_wait(null, null),
+        c.pp_mux_wait(null, -1, null),
+    );
+}
+
+test "mux wait until returns zero once the deadline elapses" {
+    const mux = c.pp_mux_create(1) orelse return error.MuxCreationFailed;
+    defer c.pp_mux_free(mux);
+
+    var events: [1]c.pp_mux_event = undefined;
+    const start_ns = c.pp_mux_now_ns();
+    const deadline_ns = start_ns + std.time.ns_per_ms;
+    try std.testing.expectEqual(
+        @as(c_int, 0),
+        c.pp_mux_wait_until(mux, deadline_ns, &events, events.len, null),
+    );
+    try std.testing.expect(c.pp_mux_now_ns() >= deadline_ns);
+    try std.testing.expectEqual(
+        @as(c_int, 0),
+        c.pp_mux_wait_until(mux, start_ns, &events, events.len, null),
+    );
+}
+
+test "mux wait until batches ready descriptors with their user data" {
+    if (builtin.os.tag == .windows) return error.SkipZigTest;
+
+    const mux = c.pp_mux_create(2) orelse return error.MuxCreationFailed;
+    defer c.pp_mux_free(mux);
+
+    var first: [2]std.c.fd_t = undefined;
+    var second: [2]std.c.fd_t = undefined;
+    if (std.c.pipe(&first) != 0) return error.PipeFailed;
+    defer for (first) |fd| {
+        _ = libc.close(fd);
+    };
+    if (std.c.pipe(&second) != 0) return error.PipeFailed;
+    defer for (second) |fd| {
+        _ = libc.close(fd);
+    };
+
+    var first_tag: u8 = 1;
+    var second_tag: u8 = 2;
+    try std.testing.expect(c.pp_mux_add(mux, first[0]));
+    try std.testing.expect(c.pp_mux_set_user_data(mux, first[0], &first_tag));
+    try std.testing.expect(c.pp_mux_add(mux, second[0]));
+    try std.testing.expect(c.pp_mux_set_user_data(mux, second[0], &second_tag));
+    try std.testing.expect(!c.pp_mux_set_user_data(mux, first[1], &first_tag));
+
+    const byte = [_]u8{1};
+    try std.testing.expectEqual(@as(isize, 1), std.c.write(first[1], &byte, byte.len));
+    try std.testing.expectEqual(@as(isize, 1), std.c.write(second[1], &byte, byte.len));
+
+    var events: [2]c.pp_mux_event = undefined;
+    try std.testing.expectEqual(
+        @as(c_int, 2),
+        c.pp_mux_wait_until(mux, c.PPMuxNoDeadline, &events, events.len, null),
+    );
+    var seen: u8 = 0;
+    for (events) |event| {
+        try std.testing.expectEqual(@as(c_int, c.PPMuxEventReadable), event.flags);
+        const tag: *u8 = @ptrCast(event.user_data.?);
+        seen |= tag.*;
+    }
+    try std.testing.expectEqual(@as(u8, 3), seen);
+
+    // Events beyond the buffer are left for the next wait.
+    try std.testing.expectEqual(
+        @as(c_int, 1),
+        c.pp_mux_wait_until(mux, c.PPMuxNoDeadline, &events, 1, null),
     );
 }
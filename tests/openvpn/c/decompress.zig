@@ -0,0 +1,370 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const c = @cImport({
+    @cInclude("openvpn/decompress.h");
+});
+
+const capacity = c.OpenVPNDecompressionCapacity;
+
+const Algorithm = enum { lzo, lz4 };
+
+fn decompress(algorithm: Algorithm, src: []const u8, dst: []u8) ?[]u8 {
+    var dst_len: usize = 0;
+    const native: c.openvpn_decompression = switch (algorithm) {
+        .lzo => c.OpenVPNDecompressionLZO,
+        .lz4 => c.OpenVPNDecompressionLZ4,
+    };
+    if (!c.openvpn_decompress(native, src.ptr, src.len, dst.ptr, dst.len, &dst_len)) return null;
+    std.debug.assert(dst_len <= dst.len);
+    return dst[0..dst_len];
+}
+
+const http_request = "GET /index.html HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\n";
+
+/// 16 requests, then the bytes 0 to 63.
+fn httpInput() [1024]u8 {
+    var bytes: [1024]u8 = undefined;
+    for (0..16) |index| @memcpy(bytes[index * http_request.len ..][0..http_request.len], http_request);
+    for (bytes[16 * http_request.len ..], 0..) |*byte, index| byte.* = @intCast(index);
+    return bytes;
+}
+
+/// The LZ4 block of `httpInput()`, as produced by the reference lz4 tool.
+const http_lz4 = hexBytes("ff2d474554202f696e6465782e68746d6c20485454502f312e310d0a486f73743a206578616d706c652e636f6d0d0a4163636570743a202a2f2a0d0a0d0a3c00ffffff74f031000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f");
+
+fn hexBytes(comptime hex: []const u8) [hex.len / 2]u8 {
+    var bytes: [hex.len / 2]u8 = undefined;
+    _ = std.fmt.hexToBytes(&bytes, hex) catch unreachable;
+    return bytes;
+}
+
+test "LZ4 decodes a reference block within the exact capacity only" {
+    const expected = httpInput();
+    var out: [expected.len]u8 = undefined;
+    try std.testing.expectEqualSlices(u8, &expected, decompress(.lz4, &http_lz4, &out).?);
+    try std.testing.expect(decompress(.lz4, &http_lz4, out[0 .. out.len - 1]) == null);
+}
+
+test "LZO decodes every instruction kind" {
+    // Literals, M2, short literal run, M3 with 2 trailing literals, M1, end
+    const stream = [_]u8{
+        0x15, 'a', 'b', 'c', 'd',
+        0xec, 0x00,
+        0x01, 'w', 'x', 'y', 'z',
+        0x23, 0x3e, 0x00, '!', '!',
+        0x04, 0x00,
+        0x11, 0x00, 0x00,
+    };
+    var out: [64]u8 = undefined;
+    try std.testing.expectEqualStrings("abcdabcdabcdwxyzabcda!!!!", decompress(.lzo, &stream, &out).?);
+    try std.testing.expectEqual(@as(usize, 0), decompress(.lzo, &.{ 0x11, 0x00, 0x00 }, &out).?.len);
+    try std.testing.expect(decompress(.lzo, &stream, out[0..24]) == null);
+    // Trailing garbage after the end marker
+    try std.testing.expect(decompress(.lzo, &(stream ++ [_]u8{0x00}), &out) == null);
+}
+
+test "decoders round-trip seeded payloads of reference encoders" {
+    var prng = std.Random.DefaultPrng.init(0x7e1e_0048);
+    const random = prng.random();
+    var input: [1400]u8 = undefined;
+    var compressed: [2048]u8 = undefined;
+    var out: [capacity]u8 = undefined;
+    for (0..200) |round| {
+        const len = random.intRangeAtMost(usize, 1, input.len);
+        fillPayload(random, input[0..len], round % 4);
+        for ([_]Algorithm{ .lzo, .lz4 }) |algorithm| {
+            const compressed_len = switch (algorithm) {
+                .lzo => lzoCompress(&compressed, input[0..len]),
+                .lz4 => lz4Compress(&compressed, input[0..len]),
+            };
+            const stream = compressed[0..compressed_len];
+            try std.testing.expectEqualSlices(u8, input[0..len], decompress(algorithm, stream, &out).?);
+            // Short of one byte in either buffer
+            try std.testing.expect(decompress(algorithm, stream, out[0 .. len - 1]) == null);
+            try std.testing.expect(decompress(algorithm, stream[0 .. stream.len - 1], &out) == null);
+        }
+    }
+}
+
+test "decoders refuse decompression bombs past the capacity" {
+    // One literal repeated by a ~75 KiB match, then the final literals
+    var bomb: [1 + 1 + 2 + 300 + 1 + 1 + 5]u8 = undefined;
+    var len: usize = 0;
+    for ([_]u8{ 0x1f, 'A', 0x01, 0x00 }) |byte| {
+        bomb[len] = byte;
+        len += 1;
+    }
+    @memset(bomb[len..][0..300], 0xff);
+    len += 300;
+    for ([_]u8{ 0x00, 0x50, 'h', 'e', 'l', 'l', 'o' }) |byte| {
+        bomb[len] = byte;
+        len += 1;
+    }
+    const expanded_len = 1 + (4 + 15 + 300 * 255) + 5;
+
+    var out: [capacity]u8 = undefined;
+    try std.testing.expect(decompress(.lz4, bomb[0..len], &out) == null);
+
+    const allocator = std.testing.allocator;
+    const large = try allocator.alloc(u8, expanded_len);
+    defer allocator.free(large);
+    try std.testing.expectEqual(@as(usize, expanded_len), decompress(.lz4, bomb[0..len], large).?.len);
+
+    // Same for LZO, with a long M3 run of a single literal
+    var lzo_bomb: [3 + 300 + 6]u8 = undefined;
+    len = 0;
+    for ([_]u8{ 0x12, 'A', 0x20 }) |byte| {
+        lzo_bomb[len] = byte;
+        len += 1;
+    }
+    @memset(lzo_bomb[len..][0..300], 0x00);
+    len += 300;
+    for ([_]u8{ 0x01, 0x00, 0x00, 0x11, 0x00, 0x00 }) |byte| {
+        lzo_bomb[len] = byte;
+        len += 1;
+    }
+    try std.testing.expect(decompress(.lzo, lzo_bomb[0..len], &out) == null);
+    const lzo_large = try allocator.alloc(u8, 1 + 300 * 255 + 34);
+    defer allocator.free(lzo_large);
+    try std.testing.expectEqual(lzo_large.len, decompress(.lzo, lzo_bomb[0..len], lzo_large).?.len);
+}
+
+test "decoders stay within bounds on truncated and random streams" {
+    var prng = std.Random.DefaultPrng.init(0x7e1e_1048);
+    const random = prng.random();
+    var stream: [96]u8 = undefined;
+    var out: [256]u8 = undefined;
+    for (0..100_000) |_| {
+        const len = random.uintAtMost(usize, stream.len);
+        random.bytes(stream[0..len]);
+        // Small length fields reach deeper into the decoders
+        for (stream[0..len], 0..) |*byte, index| {
+            if (index % 3 == 0) byte.* &= 0x1f;
+        }
+        const out_len = random.uintAtMost(usize, out.len);
+        for ([_]Algorithm{ .lzo, .lz4 }) |algorithm| {
+            if (decompress(algorithm, stream[0..len], out[0..out_len])) |result| {
+                try std.testing.expect(result.len <= out_len);
+            }
+        }
+    }
+
+    // LZO streams have an end marker, so truncation is always detected.
+    // LZ4 blocks don't, and may only stop short on a sequence boundary.
+    const input = httpInput();
+    var compressed: [2048]u8 = undefined;
+    var whole: [input.len]u8 = undefined;
+    const lzo_len = lzoCompress(&compressed, &input);
+    for (0..lzo_len) |prefix| {
+        try std.testing.expect(decompress(.lzo, compressed[0..prefix], &whole) == null);
+    }
+    for (0..http_lz4.len) |prefix| {
+        if (decompress(.lz4, http_lz4[0..prefix], &whole)) |result| {
+            try std.testing.expect(result.len < input.len);
+            try std.testing.expectEqualSlices(u8, input[0..result.len], result);
+        }
+    }
+}
+
+test "decoders expand a 4 MiB downlink of MTU-sized packets" {
+    // Stands in for a throughput benchmark: the same corpus and packet
+    // count on every run, so that regressions show in the test timings
+    var prng = std.Random.DefaultPrng.init(0x7e1e_2048);
+    const random = prng.random();
+    const packet_count = 3000;
+    const packet_len = 1400;
+    var corpus: [8][packet_len]u8 = undefined;
+    var streams: [corpus.len][2][2048]u8 = undefined;
+    var stream_lens: [corpus.len][2]usize = undefined;
+    for (&corpus, &streams, &stream_lens, 0..) |*packet, *packet_streams, *lens, index| {
+        fillPayload(random, packet, index % 4);
+        lens[0] = lzoCompress(&packet_streams[0], packet);
+        lens[1] = lz4Compress(&packet_streams[1], packet);
+    }
+
+    var out: [capacity]u8 = undefined;
+    for ([_]Algorithm{ .lzo, .lz4 }, 0..) |algorithm, which| {
+        var total: usize = 0;
+        var checksum: u32 = 0;
+        for (0..packet_count) |index| {
+            const slot = index % corpus.len;
+            const stream = streams[slot][which][0..stream_lens[slot][which]];
+            const result = decompress(algorithm, stream, &out).?;
+            total += result.len;
+            checksum = std.hash.Crc32.hash(result) ^ checksum;
+        }
+        try std.testing.expectEqual(@as(usize, packet_count * packet_len), total);
+        var expected: u32 = 0;
+        for (0..packet_count) |index| expected = std.hash.Crc32.hash(&corpus[index % corpus.len]) ^ expected;
+        try std.testing.expectEqual(expected, checksum);
+    }
+}
+
+/// Text, runs, repeated records or noise, by `kind`.
+fn fillPayload(random: std.Random, bytes: []u8, kind: usize) void {
+    switch (kind) {
+        0 => {
+            for (bytes, 0..) |*byte, index| byte.* = http_request[index % http_request.len];
+        },
+        1 => {
+            var index: usize = 0;
+            while (index < bytes.len) {
+                const run = @min(bytes.len - index, random.intRangeAtMost(usize, 1, 300));
+                @memset(bytes[index..][0..run], random.int(u8));
+                index += run;
+            }
+        },
+        2 => {
+            var record: [24]u8 = undefined;
+            random.bytes(&record);
+            for (bytes, 0..) |*byte, index| {
+                byte.* = record[index % record.len];
+                if (random.uintLessThan(u8, 16) == 0) byte.* = random.int(u8);
+            }
+        },
+        else => random.bytes(bytes),
+    }
+}
+
+// MARK: - Reference encoders
+
+const no_position = std.math.maxInt(u32);
+
+fn hash(bytes: []const u8) usize {
+    var value: u32 = 0;
+    for (bytes) |byte| value = (value << 8) | byte;
+    return (value *% 2654435761) >> 20;
+}
+
+/// Greedy LZO1X encoder using literal runs and M3 matches only, which
+/// the decoder must accept as any other valid stream.
+fn lzoCompress(dst: []u8, src: []const u8) usize {
+    var table: [4096]u32 = @splat(no_position);
+    var out: usize = 0;
+    var anchor: usize = 0;
+    var last_match: usize = 0;
+    var index: usize = 0;
+    while (index + 3 <= src.len) {
+        const key = src[index..][0..3];
+        const slot = hash(key);
+        const candidate = table[slot];
+        table[slot] = @intCast(index);
+        if (candidate == no_position or
+            index - candidate > 16384 or
+            !std.mem.eql(u8, src[candidate..][0..3], key))
+        {
+            index += 1;
+            continue;
+        }
+        var len: usize = 3;
+        while (index + len < src.len and src[candidate + len] == src[index + len]) len += 1;
+
+        out = lzoLiterals(dst, out, src[anchor..index], last_match);
+        if (len <= 33) {
+            dst[out] = 32 | @as(u8, @intCast(len - 2));
+            out += 1;
+        } else {
+            dst[out] = 32;
+            out = lzoExtend(dst, out + 1, len - 33);
+        }
+        // The low 2 bits count the literals that follow, up to 3
+        const distance = index - candidate - 1;
+        last_match = out;
+        dst[out] = @truncate(distance << 2);
+        dst[out + 1] = @intCast(distance >> 6);
+        out += 2;
+        index += len;
+        anchor = index;
+    }
+    out = lzoLiterals(dst, out, src[anchor..], last_match);
+    @memcpy(dst[out..][0..3], &[_]u8{ 0x11, 0x00, 0x00 });
+    return out + 3;
+}
+
+fn lzoLiterals(dst: []u8, start: usize, literals: []const u8, last_match: usize) usize {
+    if (literals.len == 0) return start;
+    var out = start;
+    if (out == 0 and literals.len <= 238) {
+        dst[0] = @intCast(17 + literals.len);
+        out = 1;
+    } else if (literals.len <= 3) {
+        dst[last_match] |= @as(u8, @intCast(literals.len));
+    } else if (literals.len <= 18) {
+        dst[out] = @intCast(literals.len - 3);
+        out += 1;
+    } else {
+        dst[out] = 0;
+        out = lzoExtend(dst, out + 1, literals.len - 18);
+    }
+    @memcpy(dst[out..][0..literals.len], literals);
+    return out + literals.len;
+}
+
+fn lzoExtend(dst: []u8, start: usize, remainder: usize) usize {
+    var out = start;
+    var rest = remainder;
+    while (rest > 255) : (rest -= 255) {
+        dst[out] = 0;
+        out += 1;
+    }
+    dst[out] = @intCast(rest);
+    return out + 1;
+}
+
+/// Greedy LZ4 block encoder, following the end of block rules: the last
+/// 5 bytes are literals, and no match starts in the last 12 bytes.
+fn lz4Compress(dst: []u8, src: []const u8) usize {
+    var table: [4096]u32 = @splat(no_position);
+    var out: usize = 0;
+    var anchor: usize = 0;
+    var index: usize = 0;
+    const match_limit = if (src.len > 12) src.len - 12 else 0;
+    while (index < match_limit) {
+        const key = src[index..][0..4];
+        const slot = hash(key);
+        const candidate = table[slot];
+        table[slot] = @intCast(index);
+        if (candidate == no_position or
+            index - candidate > 65535 or
+            !std.mem.eql(u8, src[candidate..][0..4], key))
+        {
+            index += 1;
+            continue;
+        }
+        var len: usize = 4;
+        while (index + len < src.len - 5 and src[candidate + len] == src[index + len]) len += 1;
+
+        const literals = src[anchor..index];
+        dst[out] = (@as(u8, @intCast(@min(literals.len, 15))) << 4) | @as(u8, @intCast(@min(len - 4, 15)));
+        out += 1;
+        if (literals.len >= 15) out = lz4Extend(dst, out, literals.len - 15);
+        @memcpy(dst[out..][0..literals.len], literals);
+        out += literals.len;
+        std.mem.writeInt(u16, dst[out..][0..2], @intCast(index - candidate), .little);
+        out += 2;
+        if (len - 4 >= 15) out = lz4Extend(dst, out, len - 4 - 15);
+        index += len;
+        anchor = index;
+    }
+    const literals = src[anchor..];
+    dst[out] = @as(u8, @intCast(@min(literals.len, 15))) << 4;
+    out += 1;
+    if (literals.len >= 15) out = lz4Extend(dst, out, literals.len - 15);
+    @memcpy(dst[out..][0..literals.len], literals);
+    return out + literals.len;
+}
+
+fn lz4Extend(dst: []u8, start: usize, remainder: usize) usize {
+    var out = start;
+    var rest = remainder;
+    while (rest >= 255) : (rest -= 255) {
+        dst[out] = 255;
+        out += 1;
+    }
+    dst[out] = @intCast(rest);
+    return out + 1;
+}
@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const c = @cImport({
+    @cInclude("openvpn/mss_fix.h");
+});
+
+const Family = enum { v4, v6 };
+
+const Packet = struct {
+    bytes: [160]u8 = @splat(0),
+    len: usize = 0,
+    tcp_offset: usize = 0,
+    family: Family,
+
+    fn slice(self: *Packet) []u8 {
+        return self.bytes[0..self.len];
+    }
+
+    fn tcp(self: *Packet) []u8 {
+        return self.bytes[self.tcp_offset..self.len];
+    }
+};
+
+const syn: u8 = 0x02;
+const syn_ack: u8 = 0x12;
+const ack: u8 = 0x10;
+
+/// Builds a TCP segment with `options` (padded to 32 bits) and a valid
+/// checksum, after the IPv6 `extensions` if any.
+fn tcpPacket(family: Family, flags: u8, options: []const u8, extensions: []const u8) Packet {
+    var packet: Packet = .{ .family = family };
+    const options_len = std.mem.alignForward(usize, options.len, 4);
+    const tcp_len = 20 + options_len;
+    switch (family) {
+        .v4 => {
+            packet.tcp_offset = 20;
+            packet.len = 20 + tcp_len;
+            const ip = packet.bytes[0..20];
+            ip[0] = 0x45;
+            std.mem.writeInt(u16, ip[2..4], @intCast(packet.len), .big);
+            ip[8] = 64;
+            ip[9] = 6;
+            @memcpy(ip[12..16], &[_]u8{ 10, 8, 0, 2 });
+            @memcpy(ip[16..20], &[_]u8{ 93, 184, 216, 34 });
+        },
+        .v6 => {
+            packet.tcp_offset = 40 + extensions.len;
+            packet.len = packet.tcp_offset + tcp_len;
+            const ip = packet.bytes[0..40];
+            ip[0] = 0x60;
+            std.mem.writeInt(u16, ip[4..6], @intCast(packet.len - 40), .big);
+            ip[6] = if (extensions.len > 0) 0 else 6;
+            ip[7] = 64;
+            ip[8] = 0xfd;
+            ip[23] = 0x02;
+            ip[24] = 0x20;
+            ip[25] = 0x01;
+            ip[39] = 0x01;
+            @memcpy(packet.bytes[40..][0..extensions.len], extensions);
+        },
+    }
+    const segment = packet.tcp();
+    std.mem.writeInt(u16, segment[0..2], 49152, .big);
+    std.mem.writeInt(u16, segment[2..4], 443, .big);
+    std.mem.writeInt(u32, segment[4..8], 0x01020304, .big);
+    segment[12] = @intCast((tcp_len / 4) << 4);
+    segment[13] = flags;
+    std.mem.writeInt(u16, segment[14..16], 64240, .big);
+    @memcpy(segment[20..][0..options.len], options);
+    std.mem.writeInt(u16, segment[16..18], ~checksumSum(&packet), .big);
+    return packet;
+}
+
+/// The ones' complement sum of the pseudo-header and the segment, which
+/// is 0xffff for a valid checksum.
+fn checksumSum(packet: *Packet) u16 {
+    var sum: u32 = 0;
+    const segment = packet.tcp();
+    switch (packet.family) {
+        .v4 => sum += sumWords(packet.bytes[12..20]),
+        .v6 => sum += sumWords(packet.bytes[8..40]),
+    }
+    sum += 6 + @as(u32, @intCast(segment.len));
+    sum += sumWords(segment);
+    while (sum > 0xffff) sum = (sum >> 16) + (sum & 0xffff);
+    return @intCast(sum);
+}
+
+fn sumWords(bytes: []const u8) u32 {
+    var sum: u32 = 0;
+    var index: usize = 0;
+    while (index + 1 < bytes.len) : (index += 2) {
+        sum += std.mem.readInt(u16, bytes[index..][0..2], .big);
+    }
+    if (index < bytes.len) sum += @as(u32, bytes[index]) << 8;
+    return sum;
+}
+
+fn mssOption(value: u16) [4]u8 {
+    var option = [_]u8{ 2, 4, 0, 0 };
+    std.mem.writeInt(u16, option[2..4], value, .big);
+    return option;
+}
+
+fn optionMss(packet: *Packet, offset: usize) u16 {
+    return std.mem.readInt(u16, packet.tcp()[20 + offset ..][0..2], .big);
+}
+
+fn fix(packet: *Packet, mss: u16) bool {
+    const bytes = packet.slice();
+    return c.openvpn_mss_fix(bytes.ptr, bytes.len, mss);
+}
+
+// NOP, NOP, SACK permitted, then MSS
+const leading_options = [_]u8{ 1, 1, 4, 2 };
+const mss_1460 = mssOption(1460);
+const mss_1440 = mssOption(1440);
+
+test "MSS fix clamps IPv4 SYN and SYN-ACK and keeps the checksum valid" {
+    for ([_]u8{ syn, syn_ack }) |flags| {
+        var packet = tcpPacket(.v4, flags, &(leading_options ++ mss_1460), &.{});
+        try std.testing.expectEqual(@as(u16, 0xffff), checksumSum(&packet));
+        try std.testing.expect(fix(&packet, 1300));
+        try std.testing.expectEqual(@as(u16, 1300), optionMss(&packet, leading_options.len));
+        try std.testing.expectEqual(@as(u16, 0xffff), checksumSum(&packet));
+
+        // Already small enough
+        try std.testing.expect(!fix(&packet, 1400));
+        try std.testing.expectEqual(@as(u16, 1300), optionMss(&packet, leading_options.len));
+    }
+}
+
+test "MSS fix clamps IPv6 SYN behind extension headers" {
+    var plain = tcpPacket(.v6, syn, &mss_1440, &.{});
+    try std.testing.expect(fix(&plain, 1220));
+    try std.testing.expectEqual(@as(u16, 1220), optionMss(&plain, 0));
+    try std.testing.expectEqual(@as(u16, 0xffff), checksumSum(&plain));
+
+    // Hop-by-hop (8 bytes), destination options (16 bytes), first fragment
+    const extensions = [_]u8{
+        60, 0, 1,    4,    0, 0, 0, 0,
+        44, 1, 1,    12,   0, 0, 0, 0,
+        0,  0, 0,    0,    0, 0, 0, 0,
+        6,  0, 0x00, 0x01, 0, 0, 0, 1,
+    };
+    var extended = tcpPacket(.v6, syn_ack, &(leading_options ++ mss_1440), &extensions);
+    try std.testing.expectEqual(@as(u16, 0xffff), checksumSum(&extended));
+    try std.testing.expect(fix(&extended, 1220));
+    try std.testing.expectEqual(@as(u16, 1220), optionMss(&extended, leading_options.len));
+    try std.testing.expectEqual(@as(u16, 0xffff), checksumSum(&extended));
+
+    // A later fragment carries no TCP header
+    var fragment = tcpPacket(.v6, syn, &mss_1440, &extensions);
+    fragment.bytes[40 + 24 + 3] = 0x08;
+    try std.testing.expect(!fix(&fragment, 1220));
+}
+
+test "MSS fix leaves other packets untouched" {
+    var cases = [_]Packet{
+        tcpPacket(.v4, ack, &mss_1460, &.{}),
+        tcpPacket(.v6, ack, &mss_1460, &.{}),
+        // No MSS option
+        tcpPacket(.v4, syn, &leading_options, &.{}),
+        // Option list ends before MSS
+        tcpPacket(.v4, syn, &([_]u8{ 0, 1, 1, 1 } ++ mss_1460), &.{}),
+        // Option longer than the header
+        tcpPacket(.v4, syn, &([_]u8{ 1, 1, 8, 10 } ++ mss_1460), &.{}),
+        // Zero-length option
+        tcpPacket(.v4, syn, &([_]u8{ 1, 1, 8, 0 } ++ mss_1460), &.{}),
+        // MSS with a wrong length
+        tcpPacket(.v4, syn, &[_]u8{ 2, 3, 5, 0xb4 }, &.{}),
+        // UDP
+        tcpPacket(.v4, syn, &mss_1460, &.{}),
+        // A later IPv4 fragment
+        tcpPacket(.v4, syn, &mss_1460, &.{}),
+    };
+    cases[7].bytes[9] = 17;
+    cases[8].bytes[7] = 0x10;
+
+    for (cases) |case| {
+        var packet = case;
+        try std.testing.expect(!fix(&packet, 1300));
+        try std.testing.expectEqualSlices(u8, case.bytes[0..case.len], packet.slice());
+    }
+
+    // Truncated anywhere, including before the TCP header
+    const whole = tcpPacket(.v4, syn, &(leading_options ++ mss_1460), &.{});
+    for (0..whole.len) |len| {
+        var packet = whole;
+        packet.len = len;
+        try std.testing.expect(!fix(&packet, 1300));
+        try std.testing.expectEqualSlices(u8, whole.bytes[0..len], packet.slice());
+    }
+}
+
+test "MSS fix survives fuzzed packets and only rewrites the MSS and checksum" {
+    var prng = std.Random.DefaultPrng.init(0x7e1e_0047);
+    const random = prng.random();
+    const extensions = [_]u8{ 6, 0, 1, 4, 0, 0, 0, 0 };
+    const seeds = [_]Packet{
+        tcpPacket(.v4, syn, &(leading_options ++ mss_1460), &.{}),
+        tcpPacket(.v6, syn_ack, &(leading_options ++ mss_1440), &.{}),
+        tcpPacket(.v6, syn, &mss_1440, &extensions),
+    };
+    var changed: usize = 0;
+    for (0..100_000) |_| {
+        var packet = seeds[random.uintLessThan(usize, seeds.len)];
+        // Flip a few bytes, with a bias towards the headers
+        for (0..random.intRangeAtMost(usize, 1, 4)) |_| {
+            const limit = if (random.boolean()) @min(packet.len, 64) else packet.bytes.len;
+            packet.bytes[random.uintLessThan(usize, limit)] = random.int(u8);
+        }
+        packet.len = if (random.uintLessThan(u8, 4) == 0)
+            random.uintAtMost(usize, packet.bytes.len)
+        else
+            packet.len;
+
+        const original = packet;
+        if (!fix(&packet, 1200)) {
+            try std.testing.expectEqualSlices(u8, &original.bytes, &packet.bytes);
+            continue;
+        }
+        changed += 1;
+        var differences: usize = 0;
+        for (original.bytes, packet.bytes) |before, after| {
+            if (before != after) differences += 1;
+        }
+        try std.testing.expect(differences <= 4);
+        try std.testing.expect(!fix(&packet, 1200));
+    }
+    // Most mutations miss the flags and options
+    try std.testing.expect(changed > 0);
+}
@@ -93,13 +93,13 @@ test "OpenVPN module importer reports generic parse error info" {
         error.Parsing,
         module_implementation.importModule(
             allocator,
-            "compress lzo",
+            "compress snappy",
             core.ImportContext.init(&info, null, null),
         ),
     );
 
     try std.testing.expectEqualStrings("compress", info.name);
-    try std.testing.expectEqualStrings("compress lzo", info.details);
+    try std.testing.expectEqualStrings("compress snappy", info.details);
 }
 
 test "OpenVPN module importer accepts protocol context pointer" {
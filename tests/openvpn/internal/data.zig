@@ -6,8 +6,10 @@ const std = @import("std");
 const source = @import("source");
 
 const core = source.core;
+const constants = source.openvpn_internal.constants;
 const data = source.openvpn_internal.data;
 const errors = source.openvpn_internal.errors;
+const processing = source.openvpn_internal.processing;
 const api = core.api;
 
 test "DataPath mock round-trips compound and bulk packets" {
@@ -49,9 +51,13 @@ test "DataPath mock round trips every compression framing in AEAD and HMAC modes
         .compress,
         .compressV2,
     };
+    // 0xffffff disables peer-id, selecting the DATA_V1 seal variant.
+    const peer_ids = [_]u32{ 1, 0xffffff };
     for (framings) |framing| {
-        try expectMockDataPathRoundTrip(framing, false);
-        try expectMockDataPathRoundTrip(framing, true);
+        for (peer_ids) |peer_id| {
+            try expectMockDataPathRoundTrip(framing, peer_id, false);
+            try expectMockDataPathRoundTrip(framing, peer_id, true);
+        }
     }
 }
 
@@ -79,6 +85,241 @@ test "DataPath compress-v2 mock preserves framing magic payloads" {
     for (payloads, decrypted.packets) |expected, actual| {
         try std.testing.expectEqualSlices(u8, expected, actual);
     }
+
+    const sent = try data_path.sendBatch(&payloads, 2);
+    const stored = try allocator.alloc([]u8, sent.len);
+    defer core.util.freeSliceOfStrings(allocator, stored);
+    for (sent, stored) |packet, *copy| copy.* = try allocator.dupe(u8, packet);
+    const batch = try data_path.receiveBatch(@ptrCast(stored));
+    try std.testing.expectEqual(@as(usize, payloads.len), batch.packets.len);
+    for (payloads, batch.packets) |expected, actual| {
+        try std.testing.expectEqualSlices(u8, expected, actual);
+    }
+}
+
+// "abcd" repeated by a match, then "hello"
+const lz4_block = [_]u8{ 0x48, 'a', 'b', 'c', 'd', 0x04, 0x00, 0x50, 'h', 'e', 'l', 'l', 'o' };
+// "abcd" repeated by a match, then the end marker
+const lzo_stream = [_]u8{ 0x15, 'a', 'b', 'c', 'd', 0xec, 0x00, 0x11, 0x00, 0x00 };
+
+test "DataPath decompresses inbound LZO and LZ4 packets of every framing" {
+    const allocator = std.testing.allocator;
+    const cases = [_]struct { api.OpenVPNCompressionFraming, []const u8, []const u8 }{
+        .{ .compLZO, &([_]u8{0x66} ++ lzo_stream), "abcdabcdabcd" },
+        .{ .compress, &([_]u8{0x66} ++ lzo_stream), "abcdabcdabcd" },
+        // The first byte is swapped to the tail
+        .{ .compress, &([_]u8{0x69} ++ lz4_block[1..].* ++ lz4_block[0..1].*), "abcdabcdabcdabcdhello" },
+        .{ .compressV2, &([_]u8{ 0x50, 0x01 } ++ lz4_block), "abcdabcdabcdabcdhello" },
+        .{ .compressV2, &([_]u8{ 0x50, 0x02 } ++ lzo_stream), "abcdabcdabcd" },
+    };
+    for (cases) |case| {
+        for ([_]bool{ false, true }) |authenticated| {
+            // Framing is disabled on the sender, so that frames go out verbatim
+            const sender = try data.testing.createMockDataPathWithFraming(allocator, 1, .disabled, authenticated);
+            defer sender.destroy();
+            const receiver = try data.testing.createMockDataPathWithFraming(allocator, 1, case[0], authenticated);
+            defer receiver.destroy();
+            const frames = [_][]const u8{case[1]};
+
+            const encrypted = try sender.encryptPackets(allocator, &frames, 2);
+            defer core.util.freeSliceOfStrings(allocator, encrypted);
+            var decrypted = try receiver.decryptPackets(allocator, encrypted);
+            defer decrypted.deinit(allocator);
+            try std.testing.expectEqual(@as(usize, 1), decrypted.packets.len);
+            try std.testing.expectEqualStrings(case[2], decrypted.packets[0]);
+
+            const sent = try sender.sendBatch(&frames, 2);
+            const stored = try allocator.alloc([]u8, sent.len);
+            defer core.util.freeSliceOfStrings(allocator, stored);
+            for (sent, stored) |packet, *copy| copy.* = try allocator.dupe(u8, packet);
+            const batch = try receiver.receiveBatch(@ptrCast(stored));
+            try std.testing.expectEqual(@as(usize, 1), batch.packets.len);
+            try std.testing.expectEqualStrings(case[2], batch.packets[0]);
+        }
+    }
+}
+
+test "DataPath fails on corrupt inbound compressed packets" {
+    const allocator = std.testing.allocator;
+    const sender = try data.testing.createMockDataPath(allocator, 1);
+    defer sender.destroy();
+    const receiver = try data.testing.createMockDataPathWithFraming(allocator, 1, .compressV2, false);
+    defer receiver.destroy();
+
+    // Truncated after a match, and an unknown v2 algorithm
+    const frames = [_][]const u8{
+        &([_]u8{ 0x50, 0x01 } ++ lz4_block[0..7].*),
+        &([_]u8{ 0x50, 0x03 } ++ lz4_block),
+    };
+    for (frames) |frame| {
+        const encrypted = try sender.encryptPackets(allocator, &.{frame}, 2);
+        defer core.util.freeSliceOfStrings(allocator, encrypted);
+        try std.testing.expectError(error.CompressionMismatch, receiver.decryptPackets(allocator, encrypted));
+    }
+}
+
+test "DataPath batches obfuscate outbound packets in the same stage" {
+    const allocator = std.testing.allocator;
+    const method = api.OpenVPNObfuscationMethod{
+        .xormask = .{ .mask = .{ .base64 = "AQID" } },
+    };
+    const data_path = try data.testing.createMockDataPathWithObfuscation(allocator, 1, method);
+    defer data_path.destroy();
+    var link = try processing.PacketProcessor.init(allocator, method);
+    defer link.deinit();
+
+    const payloads = [_][]const u8{
+        &.{ 0x11, 0x12, 0x13, 0x14 },
+        &.{0x22},
+        &([_]u8{0x33} ** 1500),
+    };
+    for (0..2) |_| {
+        const encrypted = try data_path.sendBatch(&payloads, 2);
+        try std.testing.expectEqual(@as(usize, payloads.len), encrypted.len);
+
+        // Undo the link obfuscation the way the inbound LinkProcessor does.
+        var received: [payloads.len][]u8 = undefined;
+        for (encrypted, &received) |packet, *copy| {
+            copy.* = try allocator.dupe(u8, packet);
+            link.processPacketInPlace(copy.*, .inbound);
+        }
+        defer for (received) |packet| allocator.free(packet);
+
+        const views: []const []u8 = &received;
+        const batch = try data_path.receiveBatch(@ptrCast(views));
+        try std.testing.expect(!batch.keep_alive);
+        try std.testing.expectEqual(@as(usize, payloads.len), batch.packets.len);
+        for (payloads, batch.packets) |expected, actual| {
+            try std.testing.expectEqualSlices(u8, expected, actual);
+        }
+    }
+}
+
+test "DataPath batches count processed and replayed packets" {
+    const allocator = std.testing.allocator;
+    const data_path = try data.testing.createMockDataPath(allocator, 1);
+    defer data_path.destroy();
+    var metrics: core.Metrics = .{};
+    data_path.metrics = &metrics;
+
+    const payloads = [_][]const u8{ &.{ 0x01, 0x02 }, &.{0x03} };
+    const sent = try data_path.sendBatch(&payloads, 2);
+    const stored = try core.util.cloneSliceOfStrings(allocator, sent);
+    defer core.util.freeSliceOfStrings(allocator, stored);
+    _ = try data_path.receiveBatch(@ptrCast(stored));
+    const replayed = try data_path.receiveBatch(@ptrCast(stored));
+    try std.testing.expectEqual(@as(usize, 0), replayed.packets.len);
+
+    const snapshot = metrics.snapshot();
+    try std.testing.expectEqual(@as(u64, 2), snapshot.get(.encrypt_packets));
+    try std.testing.expectEqual(@as(u64, 4), snapshot.get(.decrypt_packets));
+    try std.testing.expectEqual(@as(u64, 2), snapshot.get(.replay_rejects));
+    try std.testing.expectEqual(@as(u64, 0), snapshot.get(.keep_alives));
+}
+
+test "DataPath senders never reuse packet ids when encrypting concurrently" {
+    const allocator = std.testing.allocator;
+    const sender_count = 4;
+    const data_path = try data.testing.createMockDataPathWithSenders(allocator, 1, sender_count);
+    defer data_path.destroy();
+
+    // One list per sender, plus the owner sending concurrently.
+    var sent: [sender_count + 1]std.ArrayList([]u8) = @splat(.empty);
+    defer for (&sent) |*list| core.util.deinitListOfStrings(allocator, list);
+    for (&sent) |*list| try list.ensureTotalCapacity(allocator, stress_rounds * stress_payloads.len);
+
+    const Worker = struct {
+        fn run(sender: *data.DataPath.Sender, list: *std.ArrayList([]u8), failure: *?anyerror) void {
+            sendStressRounds(sender, list) catch |err| {
+                failure.* = err;
+            };
+        }
+    };
+    var failures: [sender_count]?anyerror = @splat(null);
+    var threads: [sender_count]std.Thread = undefined;
+    for (&threads, 0..) |*thread, index| {
+        thread.* = try std.Thread.spawn(.{}, Worker.run, .{
+            data_path.sender(index),
+            &sent[index],
+            &failures[index],
+        });
+    }
+    const owner_result = sendStressRounds(data_path, &sent[sender_count]);
+    for (threads) |thread| thread.join();
+    try owner_result;
+    for (failures) |failure| if (failure) |err| return err;
+
+    const total = sent.len * stress_rounds * stress_payloads.len;
+    var seen = try std.DynamicBitSet.initEmpty(allocator, total + 1);
+    defer seen.deinit();
+    for (sent) |list| {
+        for (list.items) |packet| {
+            var decrypted = try data_path.decryptAndParse(allocator, packet);
+            defer decrypted.deinit(allocator);
+            try std.testing.expect(decrypted.packet_id >= 1 and decrypted.packet_id <= total);
+            try std.testing.expect(!seen.isSet(decrypted.packet_id));
+            seen.set(decrypted.packet_id);
+        }
+    }
+    try std.testing.expectEqual(total, seen.count());
+}
+
+test "DataPath reserves packet ids up to the 32-bit limit" {
+    const allocator = std.testing.allocator;
+    const data_path = try data.testing.createMockDataPath(allocator, 1);
+    defer data_path.destroy();
+
+    try std.testing.expectEqual(@as(u32, 1), try data_path.reservePacketIds(3));
+    try std.testing.expectEqual(@as(u32, 4), try data_path.reservePacketIds(1));
+
+    data_path.out_packet_id.store(std.math.maxInt(u32) - 1, .monotonic);
+    try std.testing.expectError(error.Reconnect, data_path.reservePacketIds(2));
+    try std.testing.expectEqual(std.math.maxInt(u32), try data_path.reservePacketIds(1));
+    try std.testing.expectError(error.Reconnect, data_path.reservePacketIds(1));
+}
+
+test "DataPath pings are recognized and sent without allocations" {
+    var counter = std.testing.FailingAllocator.init(std.testing.allocator, .{});
+    const allocator = counter.allocator();
+    const method = api.OpenVPNObfuscationMethod{
+        .xormask = .{ .mask = .{ .base64 = "AQID" } },
+    };
+    const data_path = try data.testing.createMockDataPathWithObfuscation(allocator, 1, method);
+    defer data_path.destroy();
+    var metrics: core.Metrics = .{};
+    data_path.metrics = &metrics;
+    var link = try processing.PacketProcessor.init(std.testing.allocator, method);
+    defer link.deinit();
+
+    // Data resembling a ping, and a ping last, only data reaches the batch
+    const ping_string = constants.Data.ping_string;
+    const prefix = ping_string[0..2].*;
+    const longer = ping_string ++ [_]u8{0x00};
+    const payloads = [_][]const u8{ &prefix, &longer };
+    const sent = try data_path.sendBatch(&payloads, 2);
+    var received: std.ArrayList([]u8) = .empty;
+    defer core.util.deinitListOfStrings(std.testing.allocator, &received);
+    for (sent) |packet| try received.append(std.testing.allocator, try std.testing.allocator.dupe(u8, packet));
+
+    const allocations = counter.allocations;
+    for (0..1_000) |_| {
+        const sealed = try data_path.sendPing(2);
+        try std.testing.expect(sealed.len > ping_string.len);
+    }
+    try std.testing.expectEqual(allocations, counter.allocations);
+    const ping = try std.testing.allocator.dupe(u8, try data_path.sendPing(2));
+    try received.append(std.testing.allocator, ping);
+
+    for (received.items) |packet| link.processPacketInPlace(packet, .inbound);
+    const batch = try data_path.receiveBatch(@ptrCast(received.items));
+    try std.testing.expect(batch.keep_alive);
+    try std.testing.expectEqual(@as(usize, payloads.len), batch.packets.len);
+    for (payloads, batch.packets) |expected, actual| {
+        try std.testing.expectEqualSlices(u8, expected, actual);
+    }
+    const snapshot = metrics.snapshot();
+    try std.testing.expectEqual(@as(u64, 1), snapshot.get(.keep_alives));
+    try std.testing.expectEqual(@as(u64, payloads.len + 1_001), snapshot.get(.encrypt_packets));
 }
 
 test "DataLink declarations are semantically analyzed" {
@@ -93,12 +334,13 @@ test "DataLink preserves only reportable inbound failure categories" {
 
 fn expectMockDataPathRoundTrip(
     framing: api.OpenVPNCompressionFraming,
+    peer_id: u32,
     authenticated: bool,
 ) !void {
     const allocator = std.testing.allocator;
     const data_path = try data.testing.createMockDataPathWithFraming(
         allocator,
-        1,
+        peer_id,
         framing,
         authenticated,
     );
@@ -118,3 +360,20 @@ fn expectMockDataPathRoundTrip(
         try std.testing.expectEqualSlices(u8, expected, actual);
     }
 }
+
+const stress_rounds = 200;
+const stress_payloads = [_][]const u8{
+    &.{0x01},
+    &.{ 0x02, 0x02 },
+    &.{ 0x03, 0x03, 0x03 },
+    &.{0x04},
+};
+
+fn sendStressRounds(target: anytype, list: *std.ArrayList([]u8)) !void {
+    for (0..stress_rounds) |_| {
+        const encrypted = try target.sendBatch(&stress_payloads, 2);
+        for (encrypted) |packet| {
+            list.appendAssumeCapacity(try std.testing.allocator.dupe(u8, packet));
+        }
+    }
+}
@@ -205,6 +205,109 @@ test "LinkProcessor retains partial TCP frames and returns explicit ownership" {
     try std.testing.expectEqualStrings("de", completed.packets()[1]);
 }
 
+test "LinkProcessor keeps complete TCP frames when out of memory" {
+    var failing: std.testing.FailingAllocator = .init(std.testing.allocator, .{});
+    const processor = try processing.LinkProcessor.create(failing.allocator(), null, true);
+    defer processor.destroy();
+
+    // Grows the stream buffer once
+    var warm_up = try processor.processInbound(&.{&.{ 0, 1, 'x' }});
+    warm_up.deinit();
+
+    failing.fail_index = failing.alloc_index;
+    try std.testing.expectError(error.OutOfMemory, processor.processInbound(&.{&.{ 0, 3, 'a', 'b', 'c', 0, 2, 'd', 'e' }}));
+
+    failing.fail_index = std.math.maxInt(usize);
+    var retried = try processor.processInbound(&.{});
+    defer retried.deinit();
+    try std.testing.expectEqual(@as(usize, 2), retried.packets().len);
+    try std.testing.expectEqualStrings("abc", retried.packets()[0]);
+    try std.testing.expectEqualStrings("de", retried.packets()[1]);
+}
+
+test "LinkProcessor frames single packets into a caller buffer" {
+    const allocator = std.testing.allocator;
+    var buffer: [8]u8 = undefined;
+
+    const udp = try processing.LinkProcessor.create(allocator, null, false);
+    defer udp.destroy();
+    const datagram = try udp.frameOutboundInto(&buffer, "abcdefghij");
+    try std.testing.expectEqualStrings("abcdefghij", datagram);
+
+    const tcp = try processing.LinkProcessor.create(allocator, null, true);
+    defer tcp.destroy();
+    const frame = try tcp.frameOutboundInto(&buffer, "abcde");
+    try std.testing.expectEqualSlices(u8, &.{ 0x00, 0x05, 'a', 'b', 'c', 'd', 'e' }, frame);
+    try std.testing.expectError(error.PacketTooLarge, tcp.frameOutboundInto(&buffer, "abcdefg"));
+}
+
+test "StreamReassembler yields frames split across reads and rewinds" {
+    const allocator = std.testing.allocator;
+    var processor = try processing.PacketProcessor.init(allocator, null);
+    defer processor.deinit();
+
+    var payloads: [300][]u8 = undefined;
+    for (&payloads, 0..) |*payload, i| {
+        payload.* = try allocator.alloc(u8, (i * 37) % 1500);
+        @memset(payload.*, @truncate(i));
+    }
+    defer for (payloads) |payload| allocator.free(payload);
+    const stream = try processor.streamFromPackets(allocator, @ptrCast(payloads[0..]));
+    defer allocator.free(stream);
+
+    var reassembler = processing.StreamReassembler{};
+    defer reassembler.deinit(allocator);
+    var received: usize = 0;
+    var offset: usize = 0;
+    var read_size: usize = 1;
+    while (offset < stream.len) : (read_size = (read_size * 7 + 3) % 4093 + 1) {
+        const end = @min(offset + read_size, stream.len);
+        try reassembler.push(allocator, &.{stream[offset..end]});
+        offset = end;
+        while (reassembler.next()) |frame| : (received += 1) {
+            try std.testing.expectEqualSlices(u8, payloads[received], frame);
+        }
+    }
+    try std.testing.expectEqual(payloads.len, received);
+    try std.testing.expectEqual(@as(usize, 0), reassembler.pendingLength());
+    // Input far larger than the buffer never grew it beyond its initial size.
+    try std.testing.expect(reassembler.buffer.len < stream.len);
+}
+
+test "LinkProcessor round trips a large obfuscated TCP stream" {
+    const allocator = std.testing.allocator;
+    const method = api.OpenVPNObfuscationMethod{
+        .xormask = .{ .mask = .{ .base64 = "AQID" } },
+    };
+    const sender = try processing.LinkProcessor.create(allocator, method, true);
+    defer sender.destroy();
+    const receiver = try processing.LinkProcessor.create(allocator, method, true);
+    defer receiver.destroy();
+
+    var packet: [1400]u8 = undefined;
+    var received: usize = 0;
+    for (0..200) |batch| {
+        for (&packet, 0..) |*byte, i| byte.* = @truncate(i + batch);
+        var outbound = try sender.processOutbound(&.{ &packet, packet[0 .. batch % 64] });
+        defer outbound.deinit();
+        const stream = outbound.packets()[0];
+        try std.testing.expect(!std.mem.eql(u8, stream[2..][0..packet.len], &packet));
+
+        // Deliver each batch in two uneven reads.
+        const split = (batch * 131) % stream.len;
+        for ([_][]const u8{ stream[0..split], stream[split..] }) |read| {
+            var inbound = try receiver.processInbound(&.{read});
+            defer inbound.deinit();
+            for (inbound.packets()) |item| {
+                const expected = if (received % 2 == 0) packet[0..] else packet[0 .. batch % 64];
+                try std.testing.expectEqualSlices(u8, expected, item);
+                received += 1;
+            }
+        }
+    }
+    try std.testing.expectEqual(@as(usize, 400), received);
+}
+
 fn hexBytes(allocator: std.mem.Allocator, hex: []const u8) ![]u8 {
     const bytes = try allocator.alloc(u8, hex.len / 2);
     errdefer allocator.free(bytes);
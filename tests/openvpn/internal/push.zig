@@ -152,17 +152,28 @@ test "PUSH_REPLY validates compression framing and algorithms" {
         compress.options.compression_algorithm.?,
     );
 
-    try std.testing.expectError(
-        error.UnsupportedCompression,
-        push.PushReply.parse(allocator, "PUSH_REPLY,comp-lzo"),
+    // Inbound only, see the data path
+    var lz4 = (try push.PushReply.parse(
+        allocator,
+        "PUSH_REPLY,compress lz4-v2,cipher AES-256-CBC",
+    )).?;
+    defer lz4.deinit(allocator);
+    try std.testing.expectEqual(
+        api.OpenVPNCompressionFraming.compressV2,
+        lz4.options.compression_framing.?,
+    );
+    try std.testing.expectEqual(
+        api.OpenVPNCompressionAlgorithm.other,
+        lz4.options.compression_algorithm.?,
     );
+
     try std.testing.expectError(
         error.UnsupportedCompression,
-        push.PushReply.parse(allocator, "PUSH_REPLY,comp-lzo yes"),
+        push.PushReply.parse(allocator, "PUSH_REPLY,comp-lzo maybe"),
     );
     try std.testing.expectError(
         error.UnsupportedCompression,
-        push.PushReply.parse(allocator, "PUSH_REPLY,compress lz4"),
+        push.PushReply.parse(allocator, "PUSH_REPLY,compress snappy"),
     );
 }
 
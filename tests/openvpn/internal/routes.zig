@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+const source = @import("source");
+
+const api = source.core.api;
+const routes_mod = source.openvpn_internal.routes;
+const Route = routes_mod.Route;
+const RouteSet = routes_mod.RouteSet;
+
+test "RouteSet normalizes, sorts and deduplicates routes" {
+    const allocator = std.testing.allocator;
+    const included = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("10.1.2.3/8").? },
+        .{ .destination = api.Subnet.parseRaw("10.0.0.0/8").? },
+        .{ .destination = api.Subnet.parseRaw("1.1.1.0/24").?, .gateway = api.Address.parseRaw("10.8.0.1").? },
+        .{ .gateway = api.Address.parseRaw("10.8.0.1").? },
+    };
+    const excluded = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("10.0.0.0/8").? },
+    };
+    const included6 = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("2001:db8::1/32").? },
+    };
+    const ipv4 = api.IPSettings{ .included_routes = &included, .excluded_routes = &excluded };
+    const ipv6 = api.IPSettings{ .included_routes = &included6 };
+
+    var set = (try RouteSet.init(allocator, &ipv4, &ipv6)).?;
+    defer set.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 5), set.routes.len);
+    for (set.routes[1..], 0..) |route, index| {
+        try std.testing.expect(std.mem.order(
+            u8,
+            std.mem.asBytes(&set.routes[index]),
+            std.mem.asBytes(&route),
+        ) == .lt);
+    }
+
+    const network = Route.init(.v4, .included, .{ .destination = api.Subnet.parseRaw("10.255.0.0/8").? }).?;
+    try std.testing.expect(set.contains(network));
+    const excluded_network = Route.init(.v4, .excluded, .{ .destination = api.Subnet.parseRaw("10.0.0.0/8").? }).?;
+    try std.testing.expect(set.contains(excluded_network));
+    const other = Route.init(.v4, .included, .{ .destination = api.Subnet.parseRaw("10.0.0.0/16").? }).?;
+    try std.testing.expect(!set.contains(other));
+    const network6 = Route.init(.v6, .included, .{ .destination = api.Subnet.parseRaw("2001:db8::/32").? }).?;
+    try std.testing.expect(set.contains(network6));
+}
+
+test "RouteSet tells routes without destination from the default route" {
+    const allocator = std.testing.allocator;
+    const gateway = api.Address.parseRaw("10.8.0.1").?;
+    const ipv4 = api.IPSettings{ .included_routes = &.{.{ .gateway = gateway }} };
+    var set = (try RouteSet.init(allocator, &ipv4, null)).?;
+    defer set.deinit(allocator);
+
+    const default_route = Route.init(.v4, .included, .{
+        .destination = api.Subnet.parseRaw("0.0.0.0/0").?,
+        .gateway = gateway,
+    }).?;
+    try std.testing.expect(!set.contains(default_route));
+    try std.testing.expect(set.contains(Route.init(.v4, .included, .{ .gateway = gateway }).?));
+
+    const default_ipv4 = api.IPSettings{ .included_routes = &.{.{
+        .destination = api.Subnet.parseRaw("0.0.0.0/0").?,
+        .gateway = gateway,
+    }} };
+    var default_set = (try RouteSet.init(allocator, &default_ipv4, null)).?;
+    defer default_set.deinit(allocator);
+    try std.testing.expect(!set.diff(default_set).isEmpty());
+}
+
+test "RouteSet refuses routes that can't be packed" {
+    const allocator = std.testing.allocator;
+    const included = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("10.0.0.0/8").?, .gateway = api.Address.parseRaw("gateway.example.com").? },
+    };
+    const ipv4 = api.IPSettings{ .included_routes = &included };
+    try std.testing.expect(try RouteSet.init(allocator, &ipv4, null) == null);
+    // IPv4 routes in IPv6 settings
+    try std.testing.expect(try RouteSet.init(allocator, null, &.{
+        .included_routes = &.{.{ .destination = api.Subnet.parseRaw("10.0.0.0/8").? }},
+    }) == null);
+}
+
+test "RouteSet diffs 10k-route pushes" {
+    const allocator = std.testing.allocator;
+    const count = 10_000;
+    const pushed = try pushedRoutes(allocator, count, 0);
+    defer freeRoutes(allocator, pushed);
+    const repushed = try pushedRoutes(allocator, count, 0);
+    defer freeRoutes(allocator, repushed);
+    const changed = try pushedRoutes(allocator, count, 3);
+    defer freeRoutes(allocator, changed);
+
+    var old_set = (try RouteSet.init(allocator, &.{ .included_routes = pushed }, null)).?;
+    defer old_set.deinit(allocator);
+    var same_set = (try RouteSet.init(allocator, &.{ .included_routes = repushed }, null)).?;
+    defer same_set.deinit(allocator);
+    var new_set = (try RouteSet.init(allocator, &.{ .included_routes = changed }, null)).?;
+    defer new_set.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, count), old_set.routes.len);
+
+    // An unchanged push is a single comparison with no allocations
+    try std.testing.expect(old_set.eql(same_set));
+    const same = old_set.diff(same_set);
+    try std.testing.expect(same.isEmpty());
+    try std.testing.expectEqual(@as(usize, count), same.unchanged);
+
+    // Shifting the pushed range by 3 replaces 3 routes
+    try std.testing.expect(!old_set.eql(new_set));
+    const diff = old_set.diff(new_set);
+    try std.testing.expectEqual(@as(usize, 3), diff.added);
+    try std.testing.expectEqual(@as(usize, 3), diff.removed);
+    try std.testing.expectEqual(@as(usize, count - 3), diff.unchanged);
+    try std.testing.expectEqual(RouteSet.Diff{}, (RouteSet{}).diff(.{}));
+}
+
+/// Returns `count` /32 routes, starting from the `first`-th address of
+/// 10.0.0.0/8, in a scrambled order.
+fn pushedRoutes(allocator: std.mem.Allocator, count: usize, first: usize) ![]api.Route {
+    const routes = try allocator.alloc(api.Route, count);
+    var initialized: usize = 0;
+    errdefer {
+        for (routes[0..initialized]) |route| route.destination.?.deinit(allocator);
+        allocator.free(routes);
+    }
+    for (routes, 0..) |*route, index| {
+        const host = first + (index * 7919) % count;
+        const raw = try std.fmt.allocPrint(allocator, "10.{d}.{d}.{d}/32", .{
+            (host >> 16) & 0xff,
+            (host >> 8) & 0xff,
+            host & 0xff,
+        });
+        defer allocator.free(raw);
+        route.* = .{ .destination = (try api.Subnet.parseRawAlloc(allocator, raw)).? };
+        initialized += 1;
+    }
+    return routes;
+}
+
+fn freeRoutes(allocator: std.mem.Allocator, routes: []api.Route) void {
+    for (routes) |route| route.destination.?.deinit(allocator);
+    allocator.free(routes);
+}
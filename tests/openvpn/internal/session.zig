@@ -52,8 +52,6 @@ test "Session borrows an externally managed Looper" {
         .configuration = .{},
         .credentials = null,
         .prng = PRNG.system(),
-        .caches_directory = "",
-        .ca_filename = "11111111-1111-4111-8111-111111111111-ca.pem",
         .options = .{ .backend = .mock },
     });
     var session_destroyed = false;
@@ -113,8 +111,6 @@ test "Session reports protocol failures without owning shutdown policy" {
         .configuration = .{},
         .credentials = null,
         .prng = PRNG.system(),
-        .caches_directory = "",
-        .ca_filename = "11111111-1111-4111-8111-111111111111-ca.pem",
         .options = .{ .backend = .mock },
     });
     var session_destroyed = false;
@@ -152,3 +148,84 @@ test "session sends exit notification only for requested and network-change shut
         try std.testing.expect(!shouldSendExitNotification(cause));
     }
 }
+
+test "session defers pings while data goes out within the interval" {
+    const pingDeferralMs = session_testing.pingDeferralMs;
+    const ms = std.time.ns_per_ms;
+    const last_sent: u64 = 100_000 * ms;
+
+    // Nothing sent yet, or sent at least one interval ago
+    try std.testing.expectEqual(@as(?u64, null), pingDeferralMs(null, last_sent, 10_000));
+    try std.testing.expectEqual(@as(?u64, null), pingDeferralMs(last_sent, last_sent + 10_000 * ms, 10_000));
+    try std.testing.expectEqual(@as(?u64, null), pingDeferralMs(last_sent, last_sent + 60_000 * ms, 10_000));
+
+    // Deferred to one interval after the last data, rounding up
+    try std.testing.expectEqual(@as(?u64, 10_000), pingDeferralMs(last_sent, last_sent, 10_000));
+    try std.testing.expectEqual(@as(?u64, 4_000), pingDeferralMs(last_sent, last_sent + 6_000 * ms, 10_000));
+    try std.testing.expectEqual(@as(?u64, 1), pingDeferralMs(last_sent, last_sent + 10_000 * ms - 1, 10_000));
+}
+
+test "session memory returns to zero over 10k reconnections" {
+    const Callbacks = struct {
+        fn onFinish(_: ?*anyopaque, _: ?net.Looper.Failure) void {}
+
+        fn established(
+            _: ?*anyopaque,
+            _: *anyopaque,
+            _: source.core.api.ExtendedEndpoint,
+            _: *const source.core.api.OpenVPNConfiguration,
+        ) void {}
+
+        fn failed(_: ?*anyopaque, _: *anyopaque, _: Session.Error) void {}
+
+        fn dataCount(_: ?*anyopaque, _: *anyopaque, _: source.core.api.DataCount) void {}
+    };
+
+    // Stands for an RSS soak: every reconnection creates and destroys a
+    // session, which must give back all it allocated without growing
+    const allocator = std.testing.allocator;
+    const metrics = try allocator.create(source.core.Metrics);
+    defer allocator.destroy(metrics);
+    metrics.* = .{};
+    var looper = try net.Looper.init(allocator, .{
+        .on_finish = .{ .callback = Callbacks.onFinish },
+        .metrics = metrics,
+    });
+    defer looper.deinit();
+    try looper.start();
+    var looper_started = true;
+    defer if (looper_started) looper.stop() catch {};
+
+    var first_usage: source.core.memory.Usage = .{};
+    var first_peak: u64 = 0;
+    for (0..10_000) |index| {
+        const session = try Session.create(allocator, .{
+            .looper = &looper,
+            .events = .{
+                .established = Callbacks.established,
+                .failed = Callbacks.failed,
+                .data_count = Callbacks.dataCount,
+            },
+            .configuration = .{},
+            .credentials = null,
+            .prng = PRNG.system(),
+            .options = .{ .backend = .mock },
+        });
+        const usage = session.memoryUsage();
+        session.destroy();
+
+        const snapshot = metrics.snapshot();
+        try std.testing.expectEqual(@as(u64, 0), snapshot.gauge(.memory_bytes));
+        try std.testing.expectEqual(@as(u64, 0), snapshot.gauge(.native_memory_bytes));
+        if (index == 0) {
+            try std.testing.expect(usage.bytes > 0);
+            first_usage = usage;
+            first_peak = snapshot.gauge(.memory_peak_bytes);
+        }
+        try std.testing.expectEqual(first_usage, usage);
+    }
+    try std.testing.expectEqual(first_peak, metrics.snapshot().gauge(.memory_peak_bytes));
+
+    try looper.stop();
+    looper_started = false;
+}
@@ -5,11 +5,25 @@
 const std = @import("std");
 const source = @import("source");
 
-const session_negotiator = source.openvpn_internal.session_negotiator;
+const api = source.core.api;
+const c_crypto = source.c_crypto;
+const internal = source.openvpn_internal;
+const net = source.net;
+const session_negotiator = internal.session_negotiator;
 
+const AccountingAllocator = source.core.AccountingAllocator;
+const ControlChannel = internal.control.ControlChannel(internal.control_serializers.Serializer);
+const DataChannel = internal.data.DataChannel;
+const Keys = internal.constants.Keys;
+const LinkProcessor = internal.processing.LinkProcessor;
 const Negotiator = session_negotiator.Negotiator;
 const NegotiatorState = session_negotiator.NegotiatorState;
+const PRNG = internal.crypto.PRNG;
+const PushReply = internal.push.PushReply;
 const RenegotiationType = session_negotiator.RenegotiationType;
+const SessionError = internal.errors.SessionError;
+const TLSContextCache = internal.tls.TLSContextCache;
+const TLSWrapper = internal.tls.TLSWrapper;
 
 test "renegotiation initiator is explicit" {
     try std.testing.expect(RenegotiationType.client != .server);
@@ -33,3 +47,149 @@ test "early-negotiation TLV requests wrapped-key resend" {
     try std.testing.expect(session_negotiator.testing.requestsWrappedKeyResend(&payload));
     try std.testing.expect(!session_negotiator.testing.requestsWrappedKeyResend(payload[0..5]));
 }
+
+test "negotiator completes the connection and gives back its scratch memory" {
+    // The handshake is skipped, the TLS session is only created and freed
+    const FakeTLS = struct {
+        fn createContext(
+            _: [*c]const c_crypto.pp_tls_options,
+            code: [*c]c_crypto.pp_tls_error_code,
+        ) callconv(.c) c_crypto.pp_tls_ctx {
+            code[0] = c_crypto.PPTLSErrorNone;
+            return @ptrFromInt(0x1000);
+        }
+
+        fn freeContext(_: c_crypto.pp_tls_ctx) callconv(.c) void {}
+
+        fn create(
+            opt: [*c]const c_crypto.pp_tls_options,
+            _: c_crypto.pp_tls_ctx,
+            code: [*c]c_crypto.pp_tls_error_code,
+        ) callconv(.c) c_crypto.pp_tls {
+            code[0] = c_crypto.PPTLSErrorNone;
+            return @ptrCast(@alignCast(@constCast(opt)));
+        }
+
+        fn free(tls: c_crypto.pp_tls) callconv(.c) void {
+            c_crypto.pp_tls_options_free(@ptrCast(@alignCast(tls.?)));
+        }
+    };
+    const Callbacks = struct {
+        var connections: usize = 0;
+        var peer_id: ?u32 = null;
+        var failure: ?SessionError = null;
+
+        fn onFinish(_: ?*anyopaque, _: ?net.Looper.Failure) void {}
+
+        fn scheduleCheck(_: ?*anyopaque, _: u64) net.Looper.ScheduleTimerError!void {}
+
+        fn onConnected(
+            _: ?*anyopaque,
+            _: u8,
+            data_channel: *DataChannel,
+            push_reply: *const PushReply,
+        ) SessionError!void {
+            connections += 1;
+            peer_id = push_reply.options.peer_id;
+            data_channel.destroy();
+        }
+
+        fn onError(_: ?*anyopaque, _: u8, err: SessionError) void {
+            failure = err;
+        }
+    };
+
+    var looper = try net.Looper.init(std.testing.allocator, .{
+        .on_finish = .{ .callback = Callbacks.onFinish },
+    });
+    defer looper.deinit();
+    var contexts = TLSContextCache{ .allocator = std.testing.allocator };
+    defer contexts.deinit();
+
+    var memory: AccountingAllocator = .init(std.testing.allocator, null);
+    const allocator = memory.allocator();
+    const native = memory.enterNative();
+    defer native.leave();
+
+    const configuration = api.OpenVPNConfiguration{
+        .ca = .{ .pem = "-----BEGIN CERTIFICATE-----\nmock\n-----END CERTIFICATE-----\n" },
+        .cipher = .aes256gcm,
+    };
+    {
+        const remote_endpoint = api.ExtendedEndpoint.init("192.0.2.1", .init(.udp, 1194)).?;
+        const link_processor = try LinkProcessor.create(allocator, null, false);
+        defer link_processor.destroy();
+        const channel = try ControlChannel.create(
+            allocator,
+            PRNG.system(),
+            try .forConfiguration(allocator, .mock, &configuration),
+        );
+        defer channel.destroy();
+        try channel.reset(true);
+        try channel.setRemoteSessionId("remote01");
+
+        var functions = c_crypto.pp_crypto_fnt_mock().tls;
+        functions.ctx_create = FakeTLS.createContext;
+        functions.ctx_free = FakeTLS.freeContext;
+        functions.create = FakeTLS.create;
+        functions.free = FakeTLS.free;
+        const tls = try TLSWrapper.testing.createWithFunctions(allocator, .{
+            .backend = .mock,
+            .configuration = &configuration,
+            .contexts = &contexts,
+        }, functions);
+        const negotiator = Negotiator.create(allocator, .{
+            .looper = &looper,
+            .link_processor = link_processor,
+            .remote_endpoint = &remote_endpoint,
+            .channel = channel,
+            .prng = PRNG.system(),
+            .tls = tls,
+            .options = .{
+                .configuration = &configuration,
+                .credentials = null,
+                .with_local_options = true,
+                .session_options = .{ .backend = .mock },
+                .callback_context = null,
+                .schedule_negotiation_check = Callbacks.scheduleCheck,
+                .on_connected = Callbacks.onConnected,
+                .on_error = Callbacks.onError,
+            },
+        }) catch |err| {
+            tls.destroy();
+            return err;
+        };
+        defer negotiator.destroy();
+
+        // Auth reply with the server randoms and options, then the push reply
+        const server_options = "V4,cipher AES-256-GCM,auth SHA256\x00";
+        var reply: std.ArrayList(u8) = .empty;
+        defer reply.deinit(std.testing.allocator);
+        try reply.appendSlice(std.testing.allocator, &internal.constants.Control.tls_prefix);
+        try reply.appendNTimes(std.testing.allocator, 0x11, Keys.random_length);
+        try reply.appendNTimes(std.testing.allocator, 0x22, Keys.random_length);
+        var options_length: [2]u8 = undefined;
+        std.mem.writeInt(u16, &options_length, server_options.len, .big);
+        try reply.appendSlice(std.testing.allocator, &options_length);
+        try reply.appendSlice(std.testing.allocator, server_options);
+
+        try session_negotiator.testing.startAuthentication(negotiator);
+        try session_negotiator.testing.handleControlData(negotiator, reply.items);
+        try std.testing.expectEqual(NegotiatorState.push, negotiator.state);
+        try session_negotiator.testing.handleControlData(
+            negotiator,
+            "PUSH_REPLY,topology subnet,ifconfig 10.9.0.7 255.255.255.0,route-gateway 10.9.0.1,peer-id 7\x00",
+        );
+        try std.testing.expectEqual(@as(?SessionError, null), Callbacks.failure);
+        try std.testing.expectEqual(@as(usize, 1), Callbacks.connections);
+        try std.testing.expectEqual(@as(?u32, 7), Callbacks.peer_id);
+        try std.testing.expect(negotiator.isConnected());
+
+        // Nothing is left in the scratch arena once connected
+        const connected_bytes = memory.usage().bytes;
+        _ = negotiator.scratch.reset(.free_all);
+        try std.testing.expectEqual(connected_bytes, memory.usage().bytes);
+    }
+    try std.testing.expectEqual(@as(u64, 0), memory.usage().bytes);
+    try std.testing.expectEqual(@as(u64, 0), memory.usage().native_bytes);
+}
@@ -8,6 +8,7 @@ const source = @import("source");
 const api = source.core.api;
 const util = source.core.util;
 const NetworkSettingsBuilder = source.openvpn_internal.settings.NetworkSettingsBuilder;
+const SettingsSummary = source.openvpn_internal.settings.SettingsSummary;
 
 test "NetworkSettingsBuilder requires a remote tunnel address for IP settings" {
     const allocator = std.testing.allocator;
@@ -359,3 +360,109 @@ test "NetworkSettingsBuilder accepts an empty PAC URL" {
     try std.testing.expectEqual(@as(usize, 1), result.len);
     try std.testing.expectEqualStrings("", result[0].HTTPProxy.pac_url.?);
 }
+
+test "SettingsSummary compares sessions regardless of module ids" {
+    const allocator = std.testing.allocator;
+    const subnets = [_]api.Subnet{api.Subnet.parseRaw("100.1.2.3/32").?};
+    const routes = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("3.3.3.0/24").? },
+        .{ .destination = api.Subnet.parseRaw("4.4.4.4/32").? },
+    };
+    const servers = [_][]const u8{"9.9.9.9"};
+    const other_servers = [_][]const u8{"1.1.1.1"};
+    const local = api.OpenVPNConfiguration{};
+    const remote = api.OpenVPNConfiguration{
+        .ipv4 = .{ .subnets = &subnets },
+        .routes4 = &routes,
+        .dns_servers = &servers,
+    };
+    var changed_remote = remote;
+    changed_remote.dns_servers = &other_servers;
+
+    var summaries: [3]SettingsSummary = undefined;
+    for ([_]*const api.OpenVPNConfiguration{ &remote, &remote, &changed_remote }, 0..) |options, index| {
+        const modules = try NetworkSettingsBuilder.init(&local, options).modules(allocator);
+        defer util.freeSlice(api.TaggedModule, allocator, modules);
+        summaries[index] = try SettingsSummary.init(allocator, modules);
+    }
+    defer for (&summaries) |*summary| summary.deinit(allocator);
+
+    try std.testing.expectEqual(@as(usize, 2), summaries[0].routes.?.routes.len);
+    try std.testing.expectEqual(summaries[0].digest, summaries[1].digest);
+    try std.testing.expect(summaries[0].routes.?.eql(summaries[1].routes.?));
+    try std.testing.expect(summaries[0].digest != summaries[2].digest);
+    try std.testing.expect(summaries[0].routes.?.eql(summaries[2].routes.?));
+}
+
+test "NetworkSettingsBuilder only drops exact duplicate routes by default" {
+    const allocator = std.testing.allocator;
+    const subnets = [_]api.Subnet{api.Subnet.parseRaw("100.1.2.3/32").?};
+    const gateway = api.Address.parseRaw("100.1.2.1").?;
+    const remote_routes = [_]api.Route{
+        // def1, which must keep beating the system default route
+        .{ .destination = api.Subnet.parseRaw("0.0.0.0/1").? },
+        .{ .destination = api.Subnet.parseRaw("128.0.0.0/1").? },
+        // Covered, but more specific than a LAN route like 10.0.0.0/12
+        .{ .destination = api.Subnet.parseRaw("10.0.0.0/8").? },
+        .{ .destination = api.Subnet.parseRaw("10.1.0.0/16").? },
+        .{ .destination = api.Subnet.parseRaw("10.1.0.0/16").? },
+        .{ .destination = api.Subnet.parseRaw("10.1.0.0/16").?, .gateway = gateway },
+    };
+    const local = api.OpenVPNConfiguration{};
+    const remote = api.OpenVPNConfiguration{
+        .ipv4 = .{ .subnets = &subnets },
+        .routes4 = &remote_routes,
+    };
+    const result = try NetworkSettingsBuilder.init(&local, &remote).modules(allocator);
+    defer util.freeSlice(api.TaggedModule, allocator, result);
+
+    const routes = result[0].IP.ipv4.?.included_routes;
+    const expected = [_]struct { []const u8, u8, bool }{
+        .{ "0.0.0.0", 1, false },
+        .{ "128.0.0.0", 1, false },
+        .{ "10.0.0.0", 8, false },
+        .{ "10.1.0.0", 16, false },
+        .{ "10.1.0.0", 16, true },
+    };
+    try std.testing.expectEqual(expected.len, routes.len);
+    for (expected, routes) |item, route| {
+        try std.testing.expectEqualStrings(item[0], route.destination.?.address.raw);
+        try std.testing.expectEqual(item[1], route.destination.?.prefix_length);
+        try std.testing.expectEqual(item[2], route.gateway != null);
+    }
+}
+
+test "NetworkSettingsBuilder aggregates routes that excluded routes do not overlap" {
+    const allocator = std.testing.allocator;
+    const subnets = [_]api.Subnet{api.Subnet.parseRaw("100.1.2.3/32").?};
+    const excluded = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("20.0.0.128/26").? },
+    };
+    const remote_routes = [_]api.Route{
+        .{ .destination = api.Subnet.parseRaw("10.0.0.0/25").? },
+        .{ .destination = api.Subnet.parseRaw("10.0.0.128/25").? },
+        .{ .destination = api.Subnet.parseRaw("10.0.0.128/25").? },
+        .{ .destination = api.Subnet.parseRaw("10.0.0.0/28").? },
+        .{ .destination = api.Subnet.parseRaw("20.0.0.0/25").? },
+        .{ .destination = api.Subnet.parseRaw("20.0.0.128/25").? },
+    };
+    const local = api.OpenVPNConfiguration{};
+    const remote = api.OpenVPNConfiguration{
+        .ipv4 = .{ .subnets = &subnets, .excluded_routes = &excluded },
+        .routes4 = &remote_routes,
+    };
+    var builder = NetworkSettingsBuilder.init(&local, &remote);
+    builder.aggregates_routes = true;
+    const result = try builder.modules(allocator);
+    defer util.freeSlice(api.TaggedModule, allocator, result);
+
+    const routes = result[0].IP.ipv4.?.included_routes;
+    try std.testing.expectEqual(@as(usize, 3), routes.len);
+    try std.testing.expectEqualStrings("10.0.0.0", routes[0].destination.?.address.raw);
+    try std.testing.expectEqual(@as(u8, 24), routes[0].destination.?.prefix_length);
+    try std.testing.expectEqualStrings("20.0.0.0", routes[1].destination.?.address.raw);
+    try std.testing.expectEqual(@as(u8, 25), routes[1].destination.?.prefix_length);
+    try std.testing.expectEqualStrings("20.0.0.128", routes[2].destination.?.address.raw);
+    try std.testing.expectEqual(@as(u8, 25), routes[2].destination.?.prefix_length);
+    try std.testing.expectEqual(@as(usize, 1), result[0].IP.ipv4.?.excluded_routes.len);
+}
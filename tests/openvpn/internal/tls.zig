@@ -8,8 +8,126 @@ const source = @import("source");
 const api = source.core.api;
 const c_common = source.c_common;
 const c_crypto = source.c_crypto;
+const TLSContextCache = source.openvpn_internal.tls.TLSContextCache;
 const TLSWrapper = source.openvpn_internal.tls.TLSWrapper;
 
+const FakeContexts = struct {
+    var created: usize = 0;
+    var freed: usize = 0;
+    var fails = false;
+
+    fn reset() void {
+        created = 0;
+        freed = 0;
+        fails = false;
+    }
+
+    fn create(
+        _: [*c]const c_crypto.pp_tls_options,
+        code: [*c]c_crypto.pp_tls_error_code,
+    ) callconv(.c) c_crypto.pp_tls_ctx {
+        if (fails) {
+            code[0] = c_crypto.PPTLSErrorCAUse;
+            return null;
+        }
+        code[0] = c_crypto.PPTLSErrorNone;
+        created += 1;
+        return @ptrFromInt(0x1000 + created);
+    }
+
+    fn free(_: c_crypto.pp_tls_ctx) callconv(.c) void {
+        freed += 1;
+    }
+
+    fn createTLS(
+        opt: [*c]const c_crypto.pp_tls_options,
+        _: c_crypto.pp_tls_ctx,
+        code: [*c]c_crypto.pp_tls_error_code,
+    ) callconv(.c) c_crypto.pp_tls {
+        code[0] = c_crypto.PPTLSErrorNone;
+        return @ptrCast(@alignCast(@constCast(opt)));
+    }
+
+    fn freeTLS(tls: c_crypto.pp_tls) callconv(.c) void {
+        c_crypto.pp_tls_options_free(@ptrCast(@alignCast(tls.?)));
+    }
+
+    fn functions() c_crypto.pp_crypto_tls_fnt {
+        var table = c_crypto.pp_crypto_fnt_mock().tls;
+        table.ctx_create = create;
+        table.ctx_free = free;
+        table.create = createTLS;
+        table.free = freeTLS;
+        return table;
+    }
+};
+
+const FakeSessions = struct {
+    var created: usize = 0;
+    var freed: usize = 0;
+    var offered: c_crypto.pp_tls_session = null;
+    var connected = true;
+    var fails_put = false;
+
+    fn reset() void {
+        created = 0;
+        freed = 0;
+        offered = null;
+        connected = true;
+        fails_put = false;
+    }
+
+    fn get(_: c_crypto.pp_tls) callconv(.c) c_crypto.pp_tls_session {
+        created += 1;
+        return @ptrFromInt(0x2000 + created);
+    }
+
+    fn set(_: c_crypto.pp_tls, session: c_crypto.pp_tls_session) callconv(.c) void {
+        offered = session;
+    }
+
+    fn free(_: c_crypto.pp_tls_session) callconv(.c) void {
+        freed += 1;
+    }
+
+    fn isResumed(_: c_crypto.pp_tls) callconv(.c) bool {
+        return offered != null;
+    }
+
+    fn isConnected(_: c_crypto.pp_tls) callconv(.c) bool {
+        return connected;
+    }
+
+    fn put(
+        _: c_crypto.pp_tls,
+        _: [*c]const u8,
+        _: usize,
+        code: [*c]c_crypto.pp_tls_error_code,
+    ) callconv(.c) bool {
+        code[0] = if (fails_put) c_crypto.PPTLSErrorServerEKU else c_crypto.PPTLSErrorNone;
+        return !fails_put;
+    }
+
+    fn functions() c_crypto.pp_crypto_tls_fnt {
+        var table = FakeContexts.functions();
+        table.get_session = get;
+        table.set_session = set;
+        table.session_free = free;
+        table.is_resumed = isResumed;
+        table.is_connected = isConnected;
+        table.put_cipher = put;
+        return table;
+    }
+};
+
+fn clientConfiguration(cert_pem: []const u8) api.OpenVPNConfiguration {
+    return .{
+        .ca = .{ .pem = "-----BEGIN CERTIFICATE-----\nca\n-----END CERTIFICATE-----\n" },
+        .client_certificate = .{ .pem = cert_pem },
+        .checks_eku = true,
+    };
+}
+
 test "TLSWrapper delegates its complete TLS surface to the C table" {
     const Fake = struct {
         fn options(tls: c_crypto.pp_tls) [*c]c_crypto.pp_tls_options {
@@ -18,6 +136,7 @@ test "TLSWrapper delegates its complete TLS surface to the C table" {
 
         fn create(
             opt: [*c]const c_crypto.pp_tls_options,
+            _: c_crypto.pp_tls_ctx,
             code: [*c]c_crypto.pp_tls_error_code,
         ) callconv(.c) c_crypto.pp_tls {
             code[0] = c_crypto.PPTLSErrorNone;
@@ -69,16 +188,17 @@ test "TLSWrapper delegates its complete TLS surface to the C table" {
     };
 
     const allocator = std.testing.allocator;
-    var tmp = std.testing.tmpDir(.{});
-    defer tmp.cleanup();
-    const caches_directory = try std.fmt.allocPrint(allocator, ".zig-cache/tmp/{s}", .{tmp.sub_path});
-    defer allocator.free(caches_directory);
+    FakeContexts.reset();
+    var contexts = TLSContextCache{ .allocator = allocator };
+    defer contexts.deinit();
 
     var verification_failures: usize = 0;
     const configuration = api.OpenVPNConfiguration{
         .ca = .{ .pem = "-----BEGIN CERTIFICATE-----\nmock\n-----END CERTIFICATE-----\n" },
     };
     var functions = c_crypto.pp_crypto_fnt_mock().tls;
+    functions.ctx_create = FakeContexts.create;
+    functions.ctx_free = FakeContexts.free;
     functions.create = Fake.create;
     functions.free = Fake.free;
     functions.start = Fake.start;
@@ -88,24 +208,21 @@ test "TLSWrapper delegates its complete TLS surface to the C table" {
     functions.put_plain = Fake.put;
     functions.put_cipher = Fake.put;
     functions.ca_md5 = Fake.caMD5;
-    const ca_filename = "11111111-1111-4111-8111-111111111111-ca.pem";
     const tls = try TLSWrapper.testing.createWithFunctions(allocator, .{
         .backend = .mock,
-        .caches_directory = caches_directory,
-        .ca_filename = ca_filename,
         .configuration = &configuration,
+        .contexts = &contexts,
         .verification = .{
             .context = &verification_failures,
             .callback = Fake.verificationFailed,
         },
     }, functions);
     defer tls.destroy();
-    const expected_ca_path = try std.fs.path.join(
-        allocator,
-        &.{ caches_directory, ca_filename },
+    const options = Fake.options(tls.tls);
+    try std.testing.expectEqualStrings(
+        configuration.ca.?.pem,
+        std.mem.span(@as([*:0]const u8, @ptrCast(options.*.ca_pem))),
     );
-    defer allocator.free(expected_ca_path);
-    try std.testing.expectEqualStrings(expected_ca_path, tls.ca_path);
 
     try tls.start();
     try std.testing.expect(tls.isConnected());
@@ -123,3 +240,162 @@ test "TLSWrapper delegates its complete TLS surface to the C table" {
     defer allocator.free(md5);
     try std.testing.expectEqualStrings("0123456789abcdef", md5);
 }
+
+test "TLSContextCache shares one context across engines and reconnections" {
+    const allocator = std.testing.allocator;
+    FakeContexts.reset();
+    var contexts = TLSContextCache{ .allocator = allocator };
+    defer contexts.deinit();
+
+    const configuration = clientConfiguration("cert");
+    const parameters = source.openvpn_internal.tls.TLSParameters{
+        .backend = .mock,
+        .configuration = &configuration,
+        .contexts = &contexts,
+    };
+    const first = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeContexts.functions());
+    const second = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeContexts.functions());
+    try std.testing.expectEqual(first.context, second.context);
+    try std.testing.expectEqual(@as(usize, 2), first.context.refs);
+    first.destroy();
+    second.destroy();
+
+    // A reconnection picks the idle context up again.
+    const third = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeContexts.functions());
+    third.destroy();
+    try std.testing.expectEqual(@as(usize, 1), FakeContexts.created);
+    try std.testing.expectEqual(@as(usize, 0), FakeContexts.freed);
+
+    contexts.purge();
+    try std.testing.expectEqual(@as(usize, 0), contexts.count());
+    try std.testing.expectEqual(@as(usize, 1), FakeContexts.freed);
+}
+
+test "TLSContextCache keys contexts by identity and bounds idle ones" {
+    const allocator = std.testing.allocator;
+    FakeContexts.reset();
+    var contexts = TLSContextCache{ .allocator = allocator };
+    defer contexts.deinit();
+
+    const certificates = [_][]const u8{ "a", "b", "c", "d", "e", "f" };
+    var wrappers: [certificates.len]*TLSWrapper = undefined;
+    var configurations: [certificates.len]api.OpenVPNConfiguration = undefined;
+    for (certificates, 0..) |cert, i| {
+        configurations[i] = clientConfiguration(cert);
+        wrappers[i] = try TLSWrapper.testing.createWithFunctions(allocator, .{
+            .backend = .mock,
+            .configuration = &configurations[i],
+            .contexts = &contexts,
+        }, FakeContexts.functions());
+    }
+    try std.testing.expectEqual(certificates.len, FakeContexts.created);
+    try std.testing.expectEqual(certificates.len, contexts.count());
+
+    for (wrappers) |wrapper| wrapper.destroy();
+    try std.testing.expectEqual(TLSContextCache.max_idle, contexts.count());
+    try std.testing.expectEqual(certificates.len - TLSContextCache.max_idle, FakeContexts.freed);
+
+    // The least recently released contexts were evicted first.
+    const last = try TLSWrapper.testing.createWithFunctions(allocator, .{
+        .backend = .mock,
+        .configuration = &configurations[certificates.len - 1],
+        .contexts = &contexts,
+    }, FakeContexts.functions());
+    last.destroy();
+    try std.testing.expectEqual(certificates.len, FakeContexts.created);
+}
+
+test "TLSContextCache does not retain failed contexts" {
+    const allocator = std.testing.allocator;
+    FakeContexts.reset();
+    FakeContexts.fails = true;
+    var contexts = TLSContextCache{ .allocator = allocator };
+    defer contexts.deinit();
+
+    const configuration = clientConfiguration("cert");
+    try std.testing.expectError(error.TLSFailure, TLSWrapper.testing.createWithFunctions(allocator, .{
+        .backend = .mock,
+        .configuration = &configuration,
+        .contexts = &contexts,
+    }, FakeContexts.functions()));
+    try std.testing.expectEqual(@as(usize, 0), contexts.count());
+}
+
+test "TLSWrapper resumes the last session negotiated with the same remote" {
+    const allocator = std.testing.allocator;
+    FakeContexts.reset();
+    FakeSessions.reset();
+    var contexts = TLSContextCache{ .allocator = allocator };
+    defer contexts.deinit();
+
+    const configuration = clientConfiguration("cert");
+    const remote = api.ExtendedEndpoint.init("vpn.example.com", .init(.udp, 1194)).?;
+    const other_remote = api.ExtendedEndpoint.init("vpn.example.com", .init(.tcp, 443)).?;
+    var handshakes = source.openvpn_internal.tls.HandshakeStats{};
+    var parameters = source.openvpn_internal.tls.TLSParameters{
+        .backend = .mock,
+        .configuration = &configuration,
+        .contexts = &contexts,
+        .remote = &remote,
+        .handshakes = &handshakes,
+    };
+
+    const first = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeSessions.functions());
+    try std.testing.expect(FakeSessions.offered == null);
+    try std.testing.expect(!first.recordHandshake());
+    first.destroy();
+
+    const second = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeSessions.functions());
+    try std.testing.expectEqual(@as(usize, 1), FakeSessions.created);
+    try std.testing.expect(FakeSessions.offered != null);
+    try std.testing.expect(second.recordHandshake());
+    second.destroy();
+    try std.testing.expectEqual(@as(u64, 1), handshakes.full.load(.monotonic));
+    try std.testing.expectEqual(@as(u64, 1), handshakes.resumed.load(.monotonic));
+    // The newer session replaced the one stored for the same remote.
+    try std.testing.expectEqual(@as(usize, 1), FakeSessions.freed);
+
+    FakeSessions.offered = null;
+    parameters.remote = &other_remote;
+    const third = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeSessions.functions());
+    try std.testing.expect(FakeSessions.offered == null);
+    third.destroy();
+
+    contexts.purge();
+    try std.testing.expectEqual(FakeSessions.created, FakeSessions.freed);
+}
+
+test "TLSWrapper never stores sessions of failed or unfinished handshakes" {
+    const allocator = std.testing.allocator;
+    FakeContexts.reset();
+    FakeSessions.reset();
+    var contexts = TLSContextCache{ .allocator = allocator };
+    defer contexts.deinit();
+
+    const configuration = clientConfiguration("cert");
+    const remote = api.ExtendedEndpoint.init("vpn.example.com", .init(.udp, 1194)).?;
+    const parameters = source.openvpn_internal.tls.TLSParameters{
+        .backend = .mock,
+        .configuration = &configuration,
+        .contexts = &contexts,
+        .remote = &remote,
+    };
+
+    // Not connected yet
+    FakeSessions.connected = false;
+    const unfinished = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeSessions.functions());
+    unfinished.destroy();
+    try std.testing.expectEqual(@as(usize, 0), FakeSessions.created);
+
+    // Connected, then failed a peer check
+    FakeSessions.connected = true;
+    FakeSessions.fails_put = true;
+    const rejected = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeSessions.functions());
+    try std.testing.expectError(error.TLSFailure, rejected.putCipherText("cipher"));
+    rejected.destroy();
+    try std.testing.expectEqual(@as(usize, 0), FakeSessions.created);
+
+    const next = try TLSWrapper.testing.createWithFunctions(allocator, parameters, FakeSessions.functions());
+    try std.testing.expect(FakeSessions.offered == null);
+    next.destroy();
+}
@@ -173,10 +173,24 @@ test "OpenVPNParser leaves client completeness to module import" {
     try std.testing.expect(without_remote.remotes == null);
 }
 
-test "OpenVPNParser rejects enabled LZO compression" {
+test "OpenVPNParser accepts LZO and LZ4 compression for inbound packets" {
     const allocator = std.testing.allocator;
-    try std.testing.expectError(error.UnsupportedCompression, OpenVPNParser.parse(allocator, "comp-lzo"));
-    try std.testing.expectError(error.UnsupportedCompression, OpenVPNParser.parse(allocator, "compress lzo"));
+    const cases = [_]struct { []const u8, api.OpenVPNCompressionFraming, api.OpenVPNCompressionAlgorithm }{
+        .{ "comp-lzo", .compLZO, .LZO },
+        .{ "comp-lzo yes", .compLZO, .LZO },
+        .{ "comp-lzo adaptive", .compLZO, .LZO },
+        .{ "compress lzo", .compress, .LZO },
+        .{ "compress lz4", .compress, .other },
+        .{ "compress lz4-v2", .compressV2, .other },
+    };
+    for (cases) |case| {
+        var configuration = try OpenVPNParser.parse(allocator, case[0]);
+        defer configuration.deinit(allocator);
+        try std.testing.expectEqual(case[1], configuration.compression_framing.?);
+        try std.testing.expectEqual(case[2], configuration.compression_algorithm.?);
+    }
+    try std.testing.expectError(error.UnsupportedCompression, OpenVPNParser.parse(allocator, "comp-lzo maybe"));
+    try std.testing.expectError(error.UnsupportedCompression, OpenVPNParser.parse(allocator, "compress snappy"));
 }
 
 test "OpenVPNParser treats keepalive as ping plus ping-restart" {
@@ -269,7 +283,7 @@ test "OpenVPNParser stores scramble masks as UTF-8 SecureData" {
 
 test "OpenVPNParser reports parse error info" {
     try expectParseErrorInfo(error.MalformedOption, "cipher", "cipher", "cipher");
-    try expectParseErrorInfo(error.UnsupportedCompression, "compress lzo", "compress", "compress lzo");
+    try expectParseErrorInfo(error.UnsupportedCompression, "compress snappy", "compress", "compress snappy");
     try expectParseErrorInfo(error.UnsupportedConfiguration, "proto sctp", "proto", "proto sctp");
 }
 
@@ -579,6 +593,85 @@ test "OpenVPNParser decrypts encrypted client key" {
     try std.testing.expectEqualStrings(decrypted_private_key, configuration.client_key.?.pem);
 }
 
+test "OpenVPNParser parses a profile from a reader" {
+    const allocator = std.testing.allocator;
+    var key_hex: [512]u8 = undefined;
+    @memset(&key_hex, '0');
+    const contents = try std.fmt.allocPrint(
+        allocator,
+        "remote a.example.com 1194 udp\r\n<tls-auth>\n-----BEGIN OpenVPN Static key V1-----\n{s}\n-----END OpenVPN Static key V1-----\n</tls-auth>\n" ++
+            "topology subnet\nifconfig 10.8.0.2 255.255.255.0\n<ca>\nabc\n</ca>\nremote b.example.com 443 tcp",
+        .{&key_hex},
+    );
+    defer allocator.free(contents);
+
+    var reader: std.Io.Reader = .fixed(contents);
+    var configuration = try (OpenVPNParser{}).parseReader(allocator, &reader, .{});
+    defer configuration.deinit(allocator);
+    var expected = try OpenVPNParser.parse(allocator, contents);
+    defer expected.deinit(allocator);
+
+    const remotes = configuration.remotes.?;
+    try std.testing.expectEqual(@as(usize, 2), remotes.len);
+    try std.testing.expectEqualStrings("a.example.com", remotes[0].address);
+    try std.testing.expectEqualStrings("b.example.com", remotes[1].address);
+    try std.testing.expectEqual(api.IPSocketType.tcp, remotes[1].proto.socket_type);
+    try std.testing.expectEqualStrings(expected.ca.?.pem, configuration.ca.?.pem);
+    try std.testing.expectEqual(api.OpenVPNTLSWrapStrategy.auth, configuration.tls_wrap.?.strategy);
+    try std.testing.expectEqualStrings(
+        expected.ipv4.?.subnets[0].address.raw,
+        configuration.ipv4.?.subnets[0].address.raw,
+    );
+}
+
+test "OpenVPNParser keeps the last inline TLS key block" {
+    const allocator = std.testing.allocator;
+    var first_hex: [512]u8 = undefined;
+    var last_hex: [512]u8 = undefined;
+    @memset(&first_hex, '0');
+    @memset(&last_hex, '1');
+    const contents = try std.fmt.allocPrint(
+        allocator,
+        "client\n<tls-crypt>\n-----BEGIN OpenVPN Static key V1-----\n{s}\n-----END OpenVPN Static key V1-----\n</tls-crypt>\n" ++
+            "<tls-crypt>\n-----BEGIN OpenVPN Static key V1-----\n{s}\n-----END OpenVPN Static key V1-----\n</tls-crypt>",
+        .{ &first_hex, &last_hex },
+    );
+    defer allocator.free(contents);
+    var configuration = try OpenVPNParser.parse(allocator, contents);
+    defer configuration.deinit(allocator);
+    const key_hex = try configuration.tls_wrap.?.key.data.hexAlloc(allocator);
+    defer allocator.free(key_hex);
+    try std.testing.expectEqualStrings(&last_hex, key_hex);
+}
+
+test "OpenVPNParser imports large provider profiles" {
+    const allocator = std.testing.allocator;
+    var aw: std.Io.Writer.Allocating = .init(allocator);
+    defer aw.deinit();
+    for (0..200) |index| {
+        try aw.writer.print("remote vpn{d}.example.com {d} udp\n", .{ index, 1000 + index });
+    }
+    for (0..5000) |index| {
+        try aw.writer.print("route 10.{d}.{d}.0 255.255.255.0\n", .{ index / 256, index % 256 });
+    }
+    try aw.writer.writeAll("<ca>\n");
+    for (0..64) |_| try aw.writer.writeAll("MIIBszCCAVmgAwIBAgIUQk9yZ2FuaXphdGlvbiBDQSAxMB4XDTI2MDEwMTAw\n");
+    try aw.writer.writeAll("</ca>\n");
+    const contents = aw.written();
+
+    var configuration = try OpenVPNParser.parse(allocator, contents);
+    defer configuration.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 200), configuration.remotes.?.len);
+    try std.testing.expectEqual(@as(usize, 5000), configuration.routes4.?.len);
+    try std.testing.expectEqualStrings("vpn199.example.com", configuration.remotes.?[199].address);
+
+    var reader: std.Io.Reader = .fixed(contents);
+    var streamed = try (OpenVPNParser{}).parseReader(allocator, &reader, .{});
+    defer streamed.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 5000), streamed.routes4.?.len);
+    try std.testing.expectEqualStrings(configuration.ca.?.pem, streamed.ca.?.pem);
+}
+
 const encrypted_key_configuration =
     \\client
     \\<key>
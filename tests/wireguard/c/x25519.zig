@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2026 Davide De Rosa
+//
+// SPDX-License-Identifier: GPL-3.0
+
+const std = @import("std");
+
+const c = @cImport({
+    @cInclude("wireguard/x25519.h");
+});
+
+fn key(comptime text: []const u8) [32]u8 {
+    var bytes: [32]u8 = undefined;
+    _ = std.fmt.hexToBytes(&bytes, text) catch unreachable;
+    return bytes;
+}
+
+test "x25519 matches the RFC 7748 scalar multiplication vectors" {
+    const vectors = [_]struct { scalar: [32]u8, point: [32]u8, expected: [32]u8 }{
+        .{
+            .scalar = key("a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4"),
+            .point = key("e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c"),
+            .expected = key("c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552"),
+        },
+        .{
+            .scalar = key("4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d"),
+            .point = key("e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493"),
+            .expected = key("95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957"),
+        },
+    };
+    for (vectors) |vector| {
+        var output: [32]u8 = undefined;
+        c.curve25519_shared_secret(&output, &vector.scalar, &vector.point);
+        try std.testing.expectEqualSlices(u8, &vector.expected, &output);
+    }
+}
+
+test "x25519 matches the RFC 7748 iterated vector" {
+    var scalar: [32]u8 = key("0900000000000000000000000000000000000000000000000000000000000000");
+    var point = scalar;
+    for (0..1000) |_| {
+        var output: [32]u8 = undefined;
+        c.curve25519_shared_secret(&output, &scalar, &point);
+        point = scalar;
+        scalar = output;
+    }
+    try std.testing.expectEqualSlices(
+        u8,
+        &key("684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51"),
+        &scalar,
+    );
+}
+
+test "x25519 derives the RFC 7748 Diffie-Hellman keys" {
+    const alice_private = key("77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a");
+    const bob_private = key("5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb");
+    var alice_public: [32]u8 = undefined;
+    var bob_public: [32]u8 = undefined;
+    c.curve25519_derive_public_key(&alice_public, &alice_private);
+    c.curve25519_derive_public_key(&bob_public, &bob_private);
+    try std.testing.expectEqualSlices(
+        u8,
+        &key("8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a"),
+        &alice_public,
+    );
+    try std.testing.expectEqualSlices(
+        u8,
+        &key("de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f"),
+        &bob_public,
+    );
+
+    var alice_shared: [32]u8 = undefined;
+    var bob_shared: [32]u8 = undefined;
+    c.curve25519_shared_secret(&alice_shared, &alice_private, &bob_public);
+    c.curve25519_shared_secret(&bob_shared, &bob_private, &alice_public);
+    const expected = key("4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742");
+    try std.testing.expectEqualSlices(u8, &expected, &alice_shared);
+    try std.testing.expectEqualSlices(u8, &expected, &bob_shared);
+}
+
+test "x25519 batch key pairs match single derivation" {
+    // Spans more than one shared-inversion batch.
+    var private_keys: [37][32]u8 = undefined;
+    var public_keys: [37][32]u8 = undefined;
+    c.curve25519_generate_keypairs(&private_keys, &public_keys, private_keys.len);
+    for (private_keys, public_keys) |private_key, public_key| {
+        try std.testing.expectEqual(@as(u8, 0), private_key[0] & 7);
+        try std.testing.expectEqual(@as(u8, 64), private_key[31] & 192);
+        var expected: [32]u8 = undefined;
+        c.curve25519_derive_public_key(&expected, &private_key);
+        try std.testing.expectEqualSlices(u8, &expected, &public_key);
+    }
+}
@@ -14,9 +14,11 @@ const core = @import("source").core;
 const io = @import("source").net_io;
 const sandbox = @import("source").net_sandbox;
 const tunnel_info = wireguard_internal.tunnel_info;
-const uapi = wireguard_internal.uapi;
 
 const api = core.api;
+const c = @cImport({
+    @cInclude("wireguard/backend.h");
+});
 const AtomicBool = std.atomic.Value(bool);
 
 fn waitUntil(value: *const AtomicBool) void {
@@ -165,14 +167,51 @@ test "WireGuard connection folds active IP and VPN DNS routes into every peer" {
     }
 }
 
-test "WireGuard connection parses runtime data count" {
-    const data_count = uapi.parseRuntimeDataCount(
-        \\public_key=abc
+test "WireGuard backend parses runtime stats of every peer" {
+    var stats: c.pp_wg_stats = undefined;
+    var peers: [1]c.pp_wg_peer_stats = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), c.pp_wg_parse_stats(
+        \\private_key=abc
+        \\listen_port=51820
+        \\public_key=0101010101010101010101010101010101010101010101010101010101010101
         \\rx_bytes=1234
         \\tx_bytes=5678
-    ) orelse return error.TestUnexpectedResult;
-    try std.testing.expectEqual(@as(u64, 1234), data_count.received);
-    try std.testing.expectEqual(@as(u64, 5678), data_count.sent);
+        \\last_handshake_time_sec=100
+        \\last_handshake_time_nsec=5
+        \\public_key=0202020202020202020202020202020202020202020202020202020202020202
+        \\rx_bytes=1
+        \\tx_bytes=2
+        \\last_handshake_time_sec=200
+        \\errno=0
+    , &stats, &peers, peers.len));
+    try std.testing.expectEqual(@as(u64, 1235), stats.rx_bytes);
+    try std.testing.expectEqual(@as(u64, 5680), stats.tx_bytes);
+    try std.testing.expectEqual(@as(i64, 200), stats.last_handshake_sec);
+    try std.testing.expectEqual(@as(usize, 2), stats.peers_count);
+    try std.testing.expectEqual(@as(u8, 1), peers[0].public_key[0]);
+    try std.testing.expectEqual(@as(u64, 1234), peers[0].rx_bytes);
+    try std.testing.expectEqual(@as(i64, 5), peers[0].last_handshake_nsec);
+}
+
+test "WireGuard backend sums runtime stats of many peers" {
+    const allocator = std.testing.allocator;
+    const peers_count = 500;
+    var aw: std.Io.Writer.Allocating = .init(allocator);
+    defer aw.deinit();
+    for (0..peers_count) |index| {
+        try aw.writer.print(
+            "public_key={x:0>64}\nendpoint=10.0.0.1:51820\nallowed_ip=10.{d}.0.0/16\nrx_bytes={d}\ntx_bytes=1\n",
+            .{ index, index % 256, index },
+        );
+    }
+    const text = try aw.toOwnedSliceSentinel(0);
+    defer allocator.free(text);
+
+    var stats: c.pp_wg_stats = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), c.pp_wg_parse_stats(text.ptr, &stats, null, 0));
+    try std.testing.expectEqual(@as(usize, peers_count), stats.peers_count);
+    try std.testing.expectEqual(@as(u64, peers_count * (peers_count - 1) / 2), stats.rx_bytes);
+    try std.testing.expectEqual(@as(u64, peers_count), stats.tx_bytes);
 }
 
 test "WireGuard connection erases backend activation errors at the generic boundary" {
@@ -664,6 +703,7 @@ const fake_backend_vtable = backend_mod.Backend.VTable{
     .turn_on = fakeTurnOn,
     .turn_off = fakeTurnOff,
     .get_config = fakeGetConfig,
+    .get_stats = fakeGetStats,
     .set_config = fakeSetConfig,
     .socket_descriptors = fakeSocketDescriptors,
     .bump_sockets = fakeBumpSockets,
@@ -699,6 +739,10 @@ fn fakeGetConfig(_: ?*anyopaque, allocator: std.mem.Allocator, _: i32) backend_m
     );
 }
 
+fn fakeGetStats(_: ?*anyopaque, _: i32) ?backend_mod.Stats {
+    return .{ .received = 10, .sent = 20, .peers_count = 1 };
+}
+
 fn fakeSetConfig(ptr: ?*anyopaque, allocator: std.mem.Allocator, _: i32, settings: [:0]const u8) backend_mod.Error!i64 {
     const self: *FakeBackend = @ptrCast(@alignCast(ptr.?));
     self.set_config_count += 1;
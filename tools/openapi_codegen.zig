@@ -454,6 +454,12 @@ fn renderRuntime(w: *std.Io.Writer) WriterError!void {
         \\    return out.toOwnedSliceSentinel(0) catch error.OutOfMemory;
         \\}
         \\
+        \\/// Encodes into a caller-owned writer, e.g. a buffered file or socket
+        \\/// writer, without an intermediate allocation.
+        \\pub fn encodeJsonWriter(writer: *std.Io.Writer, value: anytype) EncodeError!void {
+        \\    std.json.Stringify.value(value, .{}, writer) catch |err| return mapJsonStringifyError(err);
+        \\}
+        \\
         \\fn mapJsonStringifyError(err: JsonStringifyError) EncodeError {
         \\    return switch (err) {
         \\        error.WriteFailed => error.Stringify,
@@ -642,6 +648,302 @@ fn renderRuntime(w: *std.Io.Writer) WriterError!void {
         \\    };
         \\}
         \\
+        \\// Streaming decoding
+        \\//
+        \\// Generated types read straight from a `std.json.Scanner`, without building
+        \\// a `std.json.Value` tree first. Manual types that are not strings, flattened
+        \\// unions and values of wrapped unions preceding their discriminator still
+        \\// go through a tree, limited to their subtree and freed right after.
+        \\
+        \\const JsonString = struct {
+        \\    bytes: []const u8,
+        \\    owned: bool,
+        \\
+        \\    fn deinit(self: JsonString, allocator: std.mem.Allocator) void {
+        \\        if (self.owned) allocator.free(self.bytes);
+        \\    }
+        \\};
+        \\
+        \\fn parseJsonText(comptime T: type, allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!T {
+        \\    var source = std.json.Scanner.initCompleteInput(allocator, text);
+        \\    defer source.deinit();
+        \\    var result = try parseTokens(T, allocator, &source, error_info);
+        \\    errdefer deinitJson(T, allocator, &result);
+        \\    const token = source.next() catch return error.InvalidJson;
+        \\    return switch (token) {
+        \\        .end_of_document => result,
+        \\        else => error.InvalidJson,
+        \\    };
+        \\}
+        \\
+        \\fn parseTokens(comptime T: type, allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!T {
+        \\    if (comptime T == uuid.UUID) {
+        \\        const raw = try nextJsonString(allocator, source) orelse return error.InvalidModel;
+        \\        defer raw.deinit(allocator);
+        \\        return uuid.parse(raw.bytes) orelse error.InvalidModel;
+        \\    }
+        \\
+        \\    if (comptime std.meta.hasFn(T, "parseTokensWithErrorInfo")) {
+        \\        return T.parseTokensWithErrorInfo(allocator, source, error_info);
+        \\    }
+        \\
+        \\    if (comptime std.meta.hasFn(T, "parseFromRaw")) {
+        \\        return parseEnumTokens(T, allocator, source);
+        \\    }
+        \\
+        \\    if (comptime std.meta.hasFn(T, "parseValueWithErrorInfo") or std.meta.hasFn(T, "parseValue")) {
+        \\        // Most manual types are strings, which need no tree
+        \\        const next = source.peekNextTokenType() catch |err| return mapJsonTokenError(err);
+        \\        if (next == .string) {
+        \\            const raw = (try nextJsonString(allocator, source)).?;
+        \\            defer raw.deinit(allocator);
+        \\            return parseJsonWithErrorInfo(T, allocator, .{ .string = raw.bytes }, error_info);
+        \\        }
+        \\        var arena = std.heap.ArenaAllocator.init(allocator);
+        \\        defer arena.deinit();
+        \\        const value = try parseJsonTree(arena.allocator(), source);
+        \\        return parseJsonWithErrorInfo(T, allocator, value, error_info);
+        \\    }
+        \\
+        \\    switch (@typeInfo(T)) {
+        \\        .bool => {
+        \\            const token = try nextJsonToken(allocator, source);
+        \\            defer freeJsonToken(allocator, token);
+        \\            return switch (token) {
+        \\                .true => true,
+        \\                .false => false,
+        \\                else => error.InvalidModel,
+        \\            };
+        \\        },
+        \\        .int, .comptime_int => {
+        \\            const token = try nextJsonToken(allocator, source);
+        \\            defer freeJsonToken(allocator, token);
+        \\            const raw = numberToken(token) orelse return error.InvalidModel;
+        \\            return std.fmt.parseInt(T, raw, 10) catch error.InvalidModel;
+        \\        },
+        \\        .float, .comptime_float => {
+        \\            const token = try nextJsonToken(allocator, source);
+        \\            defer freeJsonToken(allocator, token);
+        \\            const raw = numberToken(token) orelse return error.InvalidModel;
+        \\            return std.fmt.parseFloat(T, raw) catch error.InvalidModel;
+        \\        },
+        \\        .pointer => |pointer| {
+        \\            if (pointer.size != .slice) @compileError("only slices are supported");
+        \\            if (pointer.child == u8) {
+        \\                const raw = try nextJsonString(allocator, source) orelse return error.InvalidModel;
+        \\                if (raw.owned) return raw.bytes;
+        \\                return try allocator.dupe(u8, raw.bytes);
+        \\            }
+        \\            const token = try nextJsonToken(allocator, source);
+        \\            switch (token) {
+        \\                .array_begin => {},
+        \\                else => {
+        \\                    freeJsonToken(allocator, token);
+        \\                    return error.InvalidModel;
+        \\                },
+        \\            }
+        \\            var items: std.ArrayList(pointer.child) = .empty;
+        \\            errdefer {
+        \\                for (items.items) |*item| deinitJson(pointer.child, allocator, item);
+        \\                items.deinit(allocator);
+        \\            }
+        \\            while (true) {
+        \\                const next = source.peekNextTokenType() catch |err| return mapJsonTokenError(err);
+        \\                if (next == .array_end) break;
+        \\                try items.ensureUnusedCapacity(allocator, 1);
+        \\                items.appendAssumeCapacity(try parseTokens(pointer.child, allocator, source, error_info));
+        \\            }
+        \\            _ = source.next() catch |err| return mapJsonTokenError(err);
+        \\            return try items.toOwnedSlice(allocator);
+        \\        },
+        \\        else => @compileError("unsupported generated OpenAPI type: " ++ @typeName(T)),
+        \\    }
+        \\}
+        \\
+        \\fn parseEnumTokens(comptime T: type, allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!T {
+        \\    const Raw = @typeInfo(@TypeOf(T.parseFromRaw)).@"fn".params[0].type.?;
+        \\    if (comptime Raw == []const u8) {
+        \\        const raw = try nextJsonString(allocator, source) orelse return error.InvalidModel;
+        \\        defer raw.deinit(allocator);
+        \\        return T.parseFromRaw(raw.bytes) orelse error.UnsupportedModel;
+        \\    } else {
+        \\        const token = try nextJsonToken(allocator, source);
+        \\        defer freeJsonToken(allocator, token);
+        \\        const raw = numberToken(token) orelse return error.InvalidModel;
+        \\        const raw_value = std.fmt.parseInt(Raw, raw, 10) catch return error.InvalidModel;
+        \\        return T.parseFromRaw(raw_value) orelse error.UnsupportedModel;
+        \\    }
+        \\}
+        \\
+        \\/// Parses a required (`nullable = false`) or optional field value into
+        \\/// `field`, rejecting repeated keys like the tree parser does.
+        \\fn parseTokensField(comptime T: type, comptime nullable: bool, allocator: std.mem.Allocator, source: *std.json.Scanner, field: *?T, key: []const u8, error_info: ?*JsonErrorInfo) DecodeError!void {
+        \\    if (field.* != null) return error.InvalidJson;
+        \\    if (nullable) {
+        \\        const next = source.peekNextTokenType() catch |err| return mapJsonTokenError(err);
+        \\        if (next == .null) return skipJsonValue(source);
+        \\    }
+        \\    field.* = parseTokens(T, allocator, source, error_info) catch |err| {
+        \\        setJsonErrorKeyForError(error_info, key, err);
+        \\        return err;
+        \\    };
+        \\}
+        \\
+        \\fn missingJsonField(error_info: ?*JsonErrorInfo, key: []const u8) DecodeError {
+        \\    setJsonErrorKey(error_info, key);
+        \\    return error.InvalidModel;
+        \\}
+        \\
+        \\/// A wrapped union object, read up to the value of its variant.
+        \\///
+        \\/// The value is left in the scanner when the discriminator precedes it, as
+        \\/// in encoded output, and held as a tree otherwise.
+        \\const TaggedJsonObject = struct {
+        \\    allocator: std.mem.Allocator,
+        \\    source: *std.json.Scanner,
+        \\    discriminator: []const u8,
+        \\    value_key: []const u8,
+        \\    raw_type: JsonString,
+        \\    at_value: bool,
+        \\    arena: std.heap.ArenaAllocator,
+        \\    held_value: ?std.json.Value,
+        \\
+        \\    fn begin(allocator: std.mem.Allocator, source: *std.json.Scanner, discriminator: []const u8, value_key: []const u8, error_info: ?*JsonErrorInfo) DecodeError!TaggedJsonObject {
+        \\        try beginJsonObject(allocator, source);
+        \\        var arena = std.heap.ArenaAllocator.init(allocator);
+        \\        errdefer arena.deinit();
+        \\        var raw_type: ?JsonString = null;
+        \\        errdefer if (raw_type) |value| value.deinit(allocator);
+        \\        var held_value: ?std.json.Value = null;
+        \\        var at_value = false;
+        \\        while (try nextJsonObjectKey(allocator, source)) |key| {
+        \\            defer key.deinit(allocator);
+        \\            if (std.mem.eql(u8, key.bytes, discriminator)) {
+        \\                if (raw_type != null) return error.InvalidJson;
+        \\                raw_type = try nextJsonString(allocator, source) orelse {
+        \\                    setJsonErrorKey(error_info, discriminator);
+        \\                    return error.InvalidModel;
+        \\                };
+        \\            } else if (std.mem.eql(u8, key.bytes, value_key)) {
+        \\                if (held_value != null) return error.InvalidJson;
+        \\                if (raw_type != null) {
+        \\                    at_value = true;
+        \\                    break;
+        \\                }
+        \\                held_value = try parseJsonTree(arena.allocator(), source);
+        \\            } else {
+        \\                try skipJsonValue(source);
+        \\            }
+        \\        }
+        \\        return .{
+        \\            .allocator = allocator,
+        \\            .source = source,
+        \\            .discriminator = discriminator,
+        \\            .value_key = value_key,
+        \\            .raw_type = raw_type orelse return missingJsonField(error_info, discriminator),
+        \\            .at_value = at_value,
+        \\            .arena = arena,
+        \\            .held_value = held_value,
+        \\        };
+        \\    }
+        \\
+        \\    fn deinit(self: *TaggedJsonObject) void {
+        \\        self.raw_type.deinit(self.allocator);
+        \\        self.arena.deinit();
+        \\    }
+        \\
+        \\    fn parseValue(self: *TaggedJsonObject, comptime T: type, error_info: ?*JsonErrorInfo) DecodeError!T {
+        \\        if (!self.at_value) {
+        \\            const value = self.held_value orelse return missingJsonField(error_info, self.value_key);
+        \\            return parseJsonWithErrorInfo(T, self.allocator, value, error_info) catch |err| {
+        \\                setJsonErrorKeyForError(error_info, self.value_key, err);
+        \\                return err;
+        \\            };
+        \\        }
+        \\        var result = parseTokens(T, self.allocator, self.source, error_info) catch |err| {
+        \\            setJsonErrorKeyForError(error_info, self.value_key, err);
+        \\            return err;
+        \\        };
+        \\        errdefer deinitJson(T, self.allocator, &result);
+        \\        while (try nextJsonObjectKey(self.allocator, self.source)) |key| {
+        \\            defer key.deinit(self.allocator);
+        \\            if (std.mem.eql(u8, key.bytes, self.discriminator) or std.mem.eql(u8, key.bytes, self.value_key)) {
+        \\                return error.InvalidJson;
+        \\            }
+        \\            try skipJsonValue(self.source);
+        \\        }
+        \\        return result;
+        \\    }
+        \\};
+        \\
+        \\fn parseJsonTree(arena: std.mem.Allocator, source: *std.json.Scanner) DecodeError!std.json.Value {
+        \\    return std.json.innerParse(std.json.Value, arena, source, .{
+        \\        .max_value_len = std.json.default_max_value_len,
+        \\        .allocate = .alloc_always,
+        \\        .parse_numbers = false,
+        \\    }) catch |err| mapJsonTokenError(err);
+        \\}
+        \\
+        \\fn beginJsonObject(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!void {
+        \\    const token = try nextJsonToken(allocator, source);
+        \\    defer freeJsonToken(allocator, token);
+        \\    switch (token) {
+        \\        .object_begin => {},
+        \\        else => return error.InvalidModel,
+        \\    }
+        \\}
+        \\
+        \\fn nextJsonObjectKey(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!?JsonString {
+        \\    return switch (try nextJsonToken(allocator, source)) {
+        \\        .object_end => null,
+        \\        .string => |bytes| .{ .bytes = bytes, .owned = false },
+        \\        .allocated_string => |bytes| .{ .bytes = bytes, .owned = true },
+        \\        else => error.InvalidJson,
+        \\    };
+        \\}
+        \\
+        \\fn nextJsonString(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!?JsonString {
+        \\    const token = try nextJsonToken(allocator, source);
+        \\    return switch (token) {
+        \\        .string => |bytes| .{ .bytes = bytes, .owned = false },
+        \\        .allocated_string => |bytes| .{ .bytes = bytes, .owned = true },
+        \\        else => {
+        \\            freeJsonToken(allocator, token);
+        \\            return null;
+        \\        },
+        \\    };
+        \\}
+        \\
+        \\fn nextJsonToken(allocator: std.mem.Allocator, source: *std.json.Scanner) DecodeError!std.json.Token {
+        \\    return source.nextAllocMax(allocator, .alloc_if_needed, std.json.default_max_value_len) catch |err| mapJsonTokenError(err);
+        \\}
+        \\
+        \\fn freeJsonToken(allocator: std.mem.Allocator, token: std.json.Token) void {
+        \\    switch (token) {
+        \\        .allocated_number, .allocated_string => |bytes| allocator.free(bytes),
+        \\        else => {},
+        \\    }
+        \\}
+        \\
+        \\fn numberToken(token: std.json.Token) ?[]const u8 {
+        \\    return switch (token) {
+        \\        .number => |bytes| bytes,
+        \\        .allocated_number => |bytes| bytes,
+        \\        else => null,
+        \\    };
+        \\}
+        \\
+        \\fn skipJsonValue(source: *std.json.Scanner) DecodeError!void {
+        \\    source.skipValue() catch |err| return mapJsonTokenError(err);
+        \\}
+        \\
+        \\fn mapJsonTokenError(err: anyerror) DecodeError {
+        \\    return switch (err) {
+        \\        error.OutOfMemory => error.OutOfMemory,
+        \\        else => error.InvalidJson,
+        \\    };
+        \\}
+        \\
     );
 }
 
@@ -799,9 +1101,7 @@ fn renderStructMethods(w: *std.Io.Writer, doc: Document, schema_item: Schema, om
         \\
         \\    pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!{s} {{
         \\        resetJsonErrorInfo(error_info);
-        \\        var parsed = try util.parseJsonValue(allocator, text);
-        \\        defer parsed.deinit();
-        \\        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        \\        return parseJsonText({s}, allocator, text, error_info);
         \\    }}
         \\
         \\    pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!{s} {{
@@ -811,7 +1111,7 @@ fn renderStructMethods(w: *std.Io.Writer, doc: Document, schema_item: Schema, om
         \\    pub fn parseValueWithErrorInfo(allocator: std.mem.Allocator, value: std.json.Value, error_info: ?*JsonErrorInfo) DecodeError!{s} {{
         \\        resetJsonErrorInfo(error_info);
         \\
-    , .{ name, name, name, name });
+    , .{ name, name, name, name, name });
     if (property_count == 0) {
         try w.writeAll(
             \\        _ = objectValue(value) orelse return error.InvalidModel;
@@ -885,6 +1185,8 @@ fn renderStructMethods(w: *std.Io.Writer, doc: Document, schema_item: Schema, om
         \\
     );
     try w.writeAll("\n");
+    try renderStructTokens(w, doc, schema_item, omit_discriminator, exclusions);
+    try w.writeAll("\n");
     try w.print(
         \\    pub fn clone(self: {s}, allocator: std.mem.Allocator) DecodeError!@This() {{
         \\
@@ -973,6 +1275,93 @@ fn renderStructMethods(w: *std.Io.Writer, doc: Document, schema_item: Schema, om
     );
 }
 
+fn renderStructTokens(w: *std.Io.Writer, doc: Document, schema_item: Schema, omit_discriminator: bool, exclusions: SchemaExclusions) RenderError!void {
+    const name = zigTypeName(schema_item.name);
+    try w.print(
+        \\    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!{s} {{
+        \\        try beginJsonObject(allocator, source);
+        \\
+    , .{name});
+    if (effectivePropertyCount(schema_item, omit_discriminator) == 0) {
+        try w.writeAll(
+            \\        _ = error_info;
+            \\        while (try nextJsonObjectKey(allocator, source)) |key| {
+            \\            key.deinit(allocator);
+            \\            try skipJsonValue(source);
+            \\        }
+            \\        return .{};
+            \\    }
+            \\
+        );
+        return;
+    }
+
+    // Fields are collected as optionals, then checked for presence
+    var index: usize = 0;
+    for (schema_item.properties.items) |property| {
+        if (omit_discriminator and std.mem.eql(u8, property.name, "type")) continue;
+        const field_type = try typeExprAlloc(std.heap.page_allocator, doc, property.spec, exclusions);
+        defer std.heap.page_allocator.free(field_type);
+        try w.print(
+            \\        var field_{d}: ?{s} = null;
+            \\        errdefer if (field_{d}) |*value| deinitJson({s}, allocator, value);
+            \\
+        , .{ index, field_type, index, field_type });
+        index += 1;
+    }
+    try w.writeAll(
+        \\        while (try nextJsonObjectKey(allocator, source)) |key| {
+        \\            defer key.deinit(allocator);
+        \\
+    );
+    index = 0;
+    for (schema_item.properties.items) |property| {
+        if (omit_discriminator and std.mem.eql(u8, property.name, "type")) continue;
+        const field_type = try typeExprAlloc(std.heap.page_allocator, doc, property.spec, exclusions);
+        defer std.heap.page_allocator.free(field_type);
+        try w.print(
+            \\            {s}if (std.mem.eql(u8, key.bytes, "{s}")) {{
+            \\                try parseTokensField({s}, {s}, allocator, source, &field_{d}, "{s}", error_info);
+            \\
+        , .{
+            if (index == 0) "" else "} else ",
+            property.name,
+            field_type,
+            if (isRequired(schema_item, property.name)) "false" else "true",
+            index,
+            property.name,
+        });
+        index += 1;
+    }
+    try w.writeAll(
+        \\            } else {
+        \\                try skipJsonValue(source);
+        \\            }
+        \\        }
+        \\        return .{
+        \\
+    );
+    index = 0;
+    for (schema_item.properties.items) |property| {
+        if (omit_discriminator and std.mem.eql(u8, property.name, "type")) continue;
+        const field = zigFieldName(property.name);
+        if (isRequired(schema_item, property.name)) {
+            try w.print(
+                \\            .{s} = field_{d} orelse return missingJsonField(error_info, "{s}"),
+                \\
+            , .{ field, index, property.name });
+        } else {
+            try w.print("            .{s} = field_{d},\n", .{ field, index });
+        }
+        index += 1;
+    }
+    try w.writeAll(
+        \\        };
+        \\    }
+        \\
+    );
+}
+
 fn effectivePropertyCount(schema_item: Schema, omit_discriminator: bool) usize {
     var count: usize = 0;
     for (schema_item.properties.items) |property| {
@@ -1021,9 +1410,7 @@ fn renderUnion(w: *std.Io.Writer, doc: Document, schema_item: Schema, exclusions
         \\
         \\    pub fn parseWithErrorInfo(allocator: std.mem.Allocator, text: []const u8, error_info: ?*JsonErrorInfo) DecodeError!{s} {{
         \\        resetJsonErrorInfo(error_info);
-        \\        var parsed = try util.parseJsonValue(allocator, text);
-        \\        defer parsed.deinit();
-        \\        return parseValueWithErrorInfo(allocator, parsed.value, error_info);
+        \\        return parseJsonText({s}, allocator, text, error_info);
         \\    }}
         \\
         \\    pub fn parseValue(allocator: std.mem.Allocator, value: std.json.Value) DecodeError!{s} {{
@@ -1042,7 +1429,7 @@ fn renderUnion(w: *std.Io.Writer, doc: Document, schema_item: Schema, exclusions
         \\            return error.InvalidModel;
         \\        }};
         \\
-    , .{ name, name, name, name, discriminator, discriminator, discriminator });
+    , .{ name, name, name, name, name, discriminator, discriminator, discriminator });
 
     for (schema_item.variants.items) |variant| {
         if (exclusions.contains(variant.schema)) continue;
@@ -1076,6 +1463,7 @@ fn renderUnion(w: *std.Io.Writer, doc: Document, schema_item: Schema, exclusions
         \\
     );
     try w.writeAll("\n");
+    if (try renderUnionTokens(w, doc, schema_item, exclusions)) try w.writeAll("\n");
     try w.print(
         \\    pub fn clone(self: {s}, allocator: std.mem.Allocator) DecodeError!@This() {{
         \\
@@ -1184,6 +1572,47 @@ fn renderUnion(w: *std.Io.Writer, doc: Document, schema_item: Schema, exclusions
     );
 }
 
+/// Renders the streaming parser of unions whose variants are all wrapped,
+/// and reports whether it did. Flattened unions decode through a tree.
+fn renderUnionTokens(w: *std.Io.Writer, doc: Document, schema_item: Schema, exclusions: SchemaExclusions) RenderError!bool {
+    var value_key: ?[]const u8 = null;
+    for (schema_item.variants.items) |variant| {
+        if (exclusions.contains(variant.schema)) continue;
+        const variant_schema = doc.schema(variant.schema) orelse return ParseError.InvalidSchema;
+        const value_property = variantValueProperty(variant_schema) orelse return false;
+        if (value_key) |key| {
+            if (!std.mem.eql(u8, key, value_property.name)) return false;
+        }
+        value_key = value_property.name;
+    }
+    const name = zigTypeName(schema_item.name);
+    const discriminator = schema_item.discriminator_property orelse "type";
+    try w.print(
+        \\    pub fn parseTokensWithErrorInfo(allocator: std.mem.Allocator, source: *std.json.Scanner, error_info: ?*JsonErrorInfo) DecodeError!{s} {{
+        \\        var object = try TaggedJsonObject.begin(allocator, source, "{s}", "{s}", error_info);
+        \\        defer object.deinit();
+        \\        const raw_type = object.raw_type.bytes;
+        \\
+    , .{ name, discriminator, value_key orelse return false });
+    for (schema_item.variants.items) |variant| {
+        if (exclusions.contains(variant.schema)) continue;
+        const variant_schema = doc.schema(variant.schema) orelse return ParseError.InvalidSchema;
+        const payload_type = try unionPayloadType(std.heap.page_allocator, doc, variant_schema.*, exclusions);
+        defer std.heap.page_allocator.free(payload_type);
+        try w.print(
+            \\        if (std.mem.eql(u8, raw_type, "{s}")) return .{{ .{s} = try object.parseValue({s}, error_info) }};
+            \\
+        , .{ variant.raw, zigEnumField(variant.raw), payload_type });
+    }
+    try w.print(
+        \\        setJsonErrorKey(error_info, "{s}");
+        \\        return error.UnsupportedModel;
+        \\    }}
+        \\
+    , .{discriminator});
+    return true;
+}
+
 fn unionPayloadType(allocator: std.mem.Allocator, doc: Document, schema_item: Schema, exclusions: SchemaExclusions) AllocError![]u8 {
     if (variantValueProperty(&schema_item)) |property| {
         return typeExprAlloc(allocator, doc, property.spec, exclusions);